@@ -0,0 +1,65 @@
+#pragma once
+
+#include "core.h"
+#include <cstdint>
+
+namespace CinemaProHDR {
+
+/**
+ * @brief 片段处理的帧来源
+ *
+ * ReadFrame 由片段调度器串行调用（同一时刻只有一个线程），帧按顺序读取。
+ * 实现可以是解码器、图像序列读取或内存帧列表。抛出的异常被记录到错误历史，片段处理随即中止。
+ */
+class FrameSource {
+public:
+    virtual ~FrameSource() = default;
+
+    /**
+     * @brief 读取下一帧
+     * @param frame 输出帧（调度器复用的缓冲，尺寸可逐帧不同）
+     * @return false 表示片段结束
+     */
+    virtual bool ReadFrame(Image& frame) = 0;
+};
+
+/**
+ * @brief 片段处理的帧去向
+ *
+ * WriteFrame 由片段调度器串行调用，并严格按帧序号递增顺序交付。抛出异常与返回false同样中止片段。
+ */
+class FrameSink {
+public:
+    virtual ~FrameSink() = default;
+
+    /**
+     * @brief 写出一帧处理结果
+     * @param index 帧序号（从0开始）
+     * @return false 表示写出失败，片段处理随即中止
+     */
+    virtual bool WriteFrame(int64_t index, const Image& frame) = 0;
+};
+
+/**
+ * @brief 片段处理选项
+ *
+ * 帧级并行：每个工作线程独立处理整帧，帧间有状态的部分通过显式的逐帧依赖衔接：
+ * - 统计：每帧单独累计，在写出时按帧序合并（与逐帧调用 ProcessFrame 的结果一致）
+ * - 运动保护：帧i的分块运动图依赖帧i-1的亮度金字塔与之前的运动能量历史
+ */
+struct ClipOptions {
+    int worker_count = 0;          // 工作线程数（<=0 表示使用硬件线程数）
+    int max_frames_in_flight = 0;  // 已读取未写出的最大帧数（<=0 表示工作线程数的2倍）
+    bool motion_protection = false; // 按分块帧间运动能量局部降低高光细节强度
+};
+
+/**
+ * @brief 片段处理结果
+ */
+struct ClipResult {
+    bool success = false;
+    int64_t frames_read = 0;
+    int64_t frames_written = 0;
+};
+
+} // namespace CinemaProHDR
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core.h"
+#include <cstdint>
 
 namespace CinemaProHDR {
 
@@ -15,6 +16,16 @@ public:
     static void PQ_EOTF_RGB(const float* pq_rgb, float* linear_rgb);
     static void PQ_OETF_RGB(const float* linear_rgb, float* pq_rgb);
     
+    // Exact PQ tables for integer code values (10/12/16-bit, built on first use).
+    // EOTF: codes[i * code_stride] -> PQ_EOTF(code / (2^bit_depth - 1)), bit-identical.
+    // OETF: monotone segmented inverse; exact for every code point's linear value,
+    // within one code of round(PQ_OETF(x) * max) elsewhere (only at decision boundaries).
+    static bool HasPQCodeTables(int bit_depth);
+    static void PQ_EOTF_Codes(const uint16_t* codes, size_t code_stride, float* linear,
+                              size_t count, int bit_depth);
+    static void PQ_OETF_Codes(const float* linear, uint16_t* codes, size_t code_stride,
+                              size_t count, int bit_depth);
+    
     // Color space transformation matrices
     static void BT2020_to_P3D65(const float* bt2020, float* p3d65);
     static void P3D65_to_BT2020(const float* p3d65, float* bt2020);
@@ -33,15 +44,51 @@ public:
     static void ToWorkingDomain(const Image& input, Image& output);
     static void FromWorkingDomain(const Image& input, Image& output, ColorSpace target_cs);
     
+    // In-place working domain conversions (no intermediate frame allocation)
+    static void ToWorkingDomainInPlace(Image& image);
+    static void FromWorkingDomainInPlace(Image& image, ColorSpace target_cs);
+    
+    // Per-pixel working domain conversions (src and dst may alias)
+    static void ToWorkingPixel(const float* src_pixel, float* dst_pixel, ColorSpace source_cs);
+    static void FromWorkingPixel(const float* src_pixel, float* dst_pixel, ColorSpace target_cs);
+    
+    // Planar (SoA) kernels: r/g/b are separate planes of count samples, processed in place
+    static void ToWorkingPlanar(float* r, float* g, float* b, size_t count, ColorSpace source_cs);
+    static void FromWorkingPlanar(float* r, float* g, float* b, size_t count, ColorSpace target_cs);
+    static void MultiplyMatrix3x3Planar(const float* matrix, float* r, float* g, float* b, size_t count);
+    
+    // Integer-coded sources/sinks: samples are PQ code values in the primaries of cs,
+    // interleaved with pixel_stride uint16 per pixel. Transfer functions use the exact
+    // code tables above; r/g/b are working-domain planes (FromWorking uses them as scratch).
+    // Like ToWorkingPixel, only P3_D65 and ACESG codes go through the EOTF and a matrix;
+    // BT2020_PQ and REC709 codes are the signal itself and are only normalized.
+    static void ToWorkingPlanarFromCodes(const uint16_t* codes, size_t pixel_stride,
+                                         float* r, float* g, float* b, size_t count,
+                                         ColorSpace source_cs, int bit_depth);
+    static void FromWorkingPlanarToCodes(float* r, float* g, float* b, uint16_t* codes,
+                                         size_t pixel_stride, size_t count,
+                                         ColorSpace target_cs, int bit_depth);
+    
     // OKLab color space functions
     static void RGB_to_OKLab(const float* rgb, float* oklab);
     static void OKLab_to_RGB(const float* oklab, float* rgb);
     
+    // Planar OKLab conversions (outputs may alias inputs)
+    static void RGB_to_OKLab_Planar(const float* r, const float* g, const float* b,
+                                    float* L, float* a, float* ok_b, size_t count);
+    static void OKLab_to_RGB_Planar(const float* L, const float* a, const float* ok_b,
+                                    float* r, float* g, float* b, size_t count);
+    
     // Saturation processing in OKLab
     static void ApplySaturation(float* rgb, float sat_base, float sat_hi, float pivot_pq, float x_luminance);
     static void ApplyBaseSaturation(float* oklab, float saturation);
     static void ApplyHighlightSaturation(float* oklab, float saturation, float weight);
     
+    // Planar saturation + two-level gamut handling in the working domain
+    // (same result as per-pixel ApplySaturation + ApplyGamutProcessing + [0,1] clamp)
+    static void ApplySaturationPlanar(float* r, float* g, float* b, size_t count,
+                                      float sat_base, float sat_hi, float pivot_pq, bool dci_compliance);
+    
     // Two-level gamut handling
     static bool ApplyGamutProcessing(float* rgb, ColorSpace target_cs, bool dci_compliance);
     static void LinearGamutCompression(float* rgb, ColorSpace target_cs);
@@ -3,7 +3,9 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <cstdint>
 #include <memory>
+#include "image_pool.h"
 
 namespace CinemaProHDR {
 
@@ -70,16 +72,62 @@ struct CphParams {
     void ClampToValidRange();
 };
 
+// Inclusive valid range of one float parameter. The tables below are the single source
+// of truth for CphParams::IsValid/ClampToValidRange, ParamValidator and the sidecar validator.
+struct ParamRange {
+    const char* name;            // CphParams field name, used in error reports
+    float CphParams::* field;
+    float min_value;
+    float max_value;
+
+    // NaN and Inf are never in range
+    constexpr bool Contains(float value) const { return value >= min_value && value <= max_value; }
+    constexpr float Midpoint() const { return (min_value + max_value) * 0.5f; }
+};
+
+namespace ParamRanges {
+    inline constexpr ParamRange PIVOT_PQ{"pivot_pq", &CphParams::pivot_pq, 0.05f, 0.30f};
+    inline constexpr ParamRange GAMMA_S{"gamma_s", &CphParams::gamma_s, 1.0f, 1.6f};
+    inline constexpr ParamRange GAMMA_H{"gamma_h", &CphParams::gamma_h, 0.8f, 1.4f};
+    inline constexpr ParamRange SHOULDER_H{"shoulder_h", &CphParams::shoulder_h, 0.5f, 3.0f};
+    inline constexpr ParamRange RLOG_A{"rlog_a", &CphParams::rlog_a, 1.0f, 16.0f};
+    inline constexpr ParamRange RLOG_B{"rlog_b", &CphParams::rlog_b, 0.8f, 1.2f};
+    inline constexpr ParamRange RLOG_C{"rlog_c", &CphParams::rlog_c, 0.5f, 3.0f};
+    inline constexpr ParamRange RLOG_T{"rlog_t", &CphParams::rlog_t, 0.4f, 0.7f};
+    inline constexpr ParamRange BLACK_LIFT{"black_lift", &CphParams::black_lift, 0.0f, 0.02f};
+    inline constexpr ParamRange HIGHLIGHT_DETAIL{"highlight_detail", &CphParams::highlight_detail, 0.0f, 1.0f};
+    inline constexpr ParamRange SAT_BASE{"sat_base", &CphParams::sat_base, 0.0f, 2.0f};
+    inline constexpr ParamRange SAT_HI{"sat_hi", &CphParams::sat_hi, 0.0f, 2.0f};
+    inline constexpr ParamRange YKNEE{"yknee", &CphParams::yknee, 0.95f, 0.99f};
+    inline constexpr ParamRange ALPHA{"alpha", &CphParams::alpha, 0.2f, 1.0f};
+    inline constexpr ParamRange TOE{"toe", &CphParams::toe, 0.0f, 0.01f};
+
+    // Groups in validation order
+    inline constexpr ParamRange PPR[] = {GAMMA_S, GAMMA_H, SHOULDER_H};
+    inline constexpr ParamRange RLOG[] = {RLOG_A, RLOG_B, RLOG_C, RLOG_T};
+    inline constexpr ParamRange COMMON[] = {PIVOT_PQ, BLACK_LIFT, HIGHLIGHT_DETAIL, SAT_BASE, SAT_HI,
+                                            YKNEE, ALPHA, TOE};
+}
+
+// Image storage initialization policy
+enum class ImageInit {
+    ZERO,           // Zero-fill (default)
+    UNINITIALIZED   // Caller overwrites every sample; skips zeroing
+};
+
 // Image data structure
 struct Image {
     int width = 0;
     int height = 0;
     int channels = 3;  // RGB
-    std::vector<float> data;
+    // Pooled, 64-byte aligned. Not std::vector<float>: hosts must take it as ImageBuffer
+    // (or copy via data.begin()/end()); element access and data()/size() are unchanged.
+    ImageBuffer data;
     ColorSpace color_space = ColorSpace::BT2020_PQ;
     
     Image() = default;
     Image(int w, int h, int c = 3);
+    Image(int w, int h, int c, ImageInit init);
     
     // Pixel access
     float* GetPixel(int x, int y);
@@ -91,6 +139,27 @@ struct Image {
     size_t GetDataSize() const { return width * height * channels; }
 };
 
+// Pixel rectangle, half-open [x1, x2) x [y1, y2) (same convention as OfxRectI)
+struct RenderRect {
+    int x1 = 0;
+    int y1 = 0;
+    int x2 = 0;
+    int y2 = 0;
+    
+    RenderRect() = default;
+    RenderRect(int left, int top, int right, int bottom) : x1(left), y1(top), x2(right), y2(bottom) {}
+    
+    static RenderRect FromImage(const Image& image) { return RenderRect(0, 0, image.width, image.height); }
+    
+    int Width() const { return x2 > x1 ? x2 - x1 : 0; }
+    int Height() const { return y2 > y1 ? y2 - y1 : 0; }
+    bool IsEmpty() const { return Width() == 0 || Height() == 0; }
+    size_t GetPixelCount() const { return static_cast<size_t>(Width()) * Height(); }
+    
+    RenderRect Intersect(const RenderRect& other) const;
+    RenderRect Expand(int margin) const { return RenderRect(x1 - margin, y1 - margin, x2 + margin, y2 + margin); }
+};
+
 // Statistics structure
 struct Statistics {
     struct PQStats {
@@ -112,6 +181,74 @@ struct Statistics {
     bool IsValid() const;
 };
 
+// Mergeable frame statistics: collects MaxRGB samples (e.g. per render region) and
+// computes the 1% trimmed PQ statistics once per frame. Merging regions that cover a
+// frame gives exactly the same result as accumulating the whole frame at once.
+class StatisticsAccumulator {
+public:
+    void Add(float max_rgb) { samples_.push_back(max_rgb); }
+    
+    // Adds MaxRGB of every finite pixel of three planes
+    void AddPixels(const float* r, const float* g, const float* b, size_t count);
+    
+    void Merge(const StatisticsAccumulator& other);
+    void Reserve(size_t count) { samples_.reserve(count); }
+    void Clear() { samples_.clear(); }
+    size_t GetSampleCount() const { return samples_.size(); }
+    
+    // Writes trimmed min/avg/max/variance; leaves pq_stats untouched when empty
+    bool Finalize(Statistics::PQStats& pq_stats);
+    
+private:
+    std::vector<float> samples_;
+};
+
+// Fixed-memory counterpart of StatisticsAccumulator for streaming (scanline) processing.
+// MaxRGB samples are binned over [0,1]; each bin keeps count, sum, sum of squares and its
+// value range. Trimmed mean/variance use exact per-bin sums except for the two partially
+// trimmed bins, and trimmed min/max are interpolated inside their bin, so results differ
+// from the exact accumulator by well under 1/kBins.
+class StatisticsHistogram {
+public:
+    static constexpr int kBins = 4096;
+    
+    StatisticsHistogram();
+    
+    // Adds one finite MaxRGB sample
+    void Add(float max_rgb);
+    
+    // Adds MaxRGB of every finite pixel of three planes; with samples the same values are
+    // also appended to that accumulator, so exact statistics and the histogram share one pass
+    void AddPixels(const float* r, const float* g, const float* b, size_t count,
+                   StatisticsAccumulator* samples = nullptr);
+    
+    // Adds the bins of other (e.g. per render region); memory stays fixed
+    void Merge(const StatisticsHistogram& other);
+    
+    void Clear();
+    uint64_t GetSampleCount() const { return total_; }
+    
+    // Writes trimmed min/avg/max/variance; leaves pq_stats untouched when empty
+    bool Finalize(Statistics::PQStats& pq_stats) const;
+    
+    // Folds the bins into `bins` equal ranges (kBins must be a multiple) normalized to sum 1;
+    // all zero when empty
+    void GetDistribution(float* distribution, int bins) const;
+    
+private:
+    struct Bin {
+        uint64_t count = 0;
+        double sum = 0.0;
+        double sum_sq = 0.0;
+        float min = 0.0f;
+        float max = 0.0f;
+    };
+    std::vector<Bin> bins_;
+    uint64_t total_ = 0;
+    
+    void AddToBin(int index, float value);
+};
+
 // Error reporting structure
 struct ErrorReport {
     ErrorCode code = ErrorCode::SUCCESS;
@@ -121,12 +258,14 @@ struct ErrorReport {
     std::string action_taken;
     std::string clip_guid;
     std::string timecode;
+    int64_t frame_index = -1;  // Frame the error occurred on (-1 if not frame related)
     std::chrono::system_clock::time_point timestamp;
     
     ErrorReport() = default;
     ErrorReport(ErrorCode c, const std::string& msg);
     
     bool IsError() const { return code != ErrorCode::SUCCESS; }
+    const char* GetLevel() const;  // "INFO" / "WARN" / "ERROR"
     std::string ToString() const;
 };
 
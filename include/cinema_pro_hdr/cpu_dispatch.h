@@ -0,0 +1,101 @@
+#pragma once
+
+#include <string>
+
+/**
+ * 多版本内核的编译器属性
+ *
+ * 热点循环写成一份 CPH_KERNEL_INLINE 的 <名字>Body，再由 CPH_DISPATCH_KERNEL 生成
+ * 各指令集层级的 target 包装：同一份源码在每个包装内按对应指令集重新向量化，
+ * 单个 .so 即可在不同代际的节点上跑出各自的最优代码。
+ * 核心库以 -ffp-contract=off 编译，FMA 层级不会把乘加融合，各层级结果逐位一致。
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CPH_CPU_DISPATCH_X86 1
+#define CPH_KERNEL_INLINE inline __attribute__((always_inline))
+#define CPH_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define CPH_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define CPH_TARGET_AVX512 \
+    __attribute__((target("avx512f,avx512vl,avx512bw,avx512dq,avx2,fma,prefer-vector-width=512")))
+#else
+#define CPH_KERNEL_INLINE inline
+#endif
+
+namespace CinemaProHDR {
+
+/**
+ * @brief CPU指令集层级（按能力递增）
+ */
+enum class CpuTier {
+    BASELINE = 0,  // 编译基线（x86-64 为 SSE2，其他架构为编译器默认）
+    SSE42,
+    AVX2,          // AVX2 + FMA
+    AVX512         // AVX-512 F/VL/BW/DQ
+};
+
+/**
+ * @brief 运行时CPU特性分派
+ *
+ * 首次使用时用 cpuid 检测硬件层级（含操作系统对 AVX/AVX-512 状态的支持），
+ * 环境变量 CPH_CPU_TIER（baseline / sse4.2 / avx2 / avx512）可以强制更低的层级，
+ * 用于在同一台机器上复现其他代际节点的结果或排查分派问题。
+ *
+ * 用途：CPH_DISPATCH_KERNEL 生成的内核在每次调用时据此选择实现
+ * 不是：编译期开关——不依赖 -march，基线构建即可在新硬件上使用宽向量
+ */
+namespace CpuDispatch {
+
+/**
+ * @brief 硬件支持的最高层级（检测一次后缓存）
+ */
+CpuTier GetHardwareTier();
+
+/**
+ * @brief 当前生效的层级（默认为硬件层级与 CPH_CPU_TIER 中较低者）
+ */
+CpuTier GetActiveTier();
+
+/**
+ * @brief 强制层级（高于硬件层级时钳制到硬件层级）
+ * @return 实际生效的层级
+ */
+CpuTier SetActiveTier(CpuTier tier);
+
+/**
+ * @brief 恢复默认层级（重新读取 CPH_CPU_TIER）
+ */
+void ResetActiveTier();
+
+const char* TierToString(CpuTier tier);
+
+/**
+ * @brief 解析层级名称（不区分大小写，接受 "sse42" 与 "sse4.2" 两种写法）
+ */
+bool ParseTier(const std::string& name, CpuTier& tier);
+
+} // namespace CpuDispatch
+
+} // namespace CinemaProHDR
+
+/**
+ * @brief 定义分派入口 Name，按当前层级调用 Name##Body 的各指令集版本
+ * @param Params 带括号的参数声明
+ * @param Args 带括号的实参列表
+ */
+#if defined(CPH_CPU_DISPATCH_X86)
+#define CPH_DISPATCH_KERNEL(Name, Params, Args)                                  \
+    CPH_TARGET_SSE42 void Name##SSE42 Params { Name##Body Args; }               \
+    CPH_TARGET_AVX2 void Name##AVX2 Params { Name##Body Args; }                 \
+    CPH_TARGET_AVX512 void Name##AVX512 Params { Name##Body Args; }             \
+    void Name Params {                                                           \
+        switch (::CinemaProHDR::CpuDispatch::GetActiveTier()) {                 \
+            case ::CinemaProHDR::CpuTier::AVX512: Name##AVX512 Args; return;    \
+            case ::CinemaProHDR::CpuTier::AVX2: Name##AVX2 Args; return;        \
+            case ::CinemaProHDR::CpuTier::SSE42: Name##SSE42 Args; return;      \
+            default: Name##Body Args; return;                                   \
+        }                                                                        \
+    }
+#else
+#define CPH_DISPATCH_KERNEL(Name, Params, Args) \
+    void Name Params { Name##Body Args; }
+#endif
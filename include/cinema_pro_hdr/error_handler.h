@@ -1,7 +1,8 @@
 #pragma once
 
 #include "cinema_pro_hdr/core.h"
-#include <unordered_map>
+#include "cinema_pro_hdr/log_sink.h"
+#include <atomic>
 #include <mutex>
 #include <chrono>
 #include <functional>
@@ -29,15 +30,22 @@ enum class FallbackStrategy {
  * 实现日志节流策略，防止相同错误码的日志洪水：
  * - 每个错误码每秒最多10条日志
  * - 超出限制时输出聚合报告
- * - 线程安全的计数和时间窗口管理
+ * - 无锁：每个错误码一个定长原子槽位，ShouldLog 步数有上界（wait-free）
+ *
+ * 窗口起点与计数打包在一个64位原子量中：窗口过期时由一次CAS翻转，
+ * 计数用 fetch_add 领取名额。窗口翻转的瞬间与之竞争失败的调用按节流处理，
+ * 因此不会超出限制，只可能在窗口边界少记一条。
  */
 class LogThrottler {
 public:
     LogThrottler();
     ~LogThrottler() = default;
 
+    LogThrottler(const LogThrottler&) = delete;
+    LogThrottler& operator=(const LogThrottler&) = delete;
+
     /**
-     * @brief 检查是否应该记录日志
+     * @brief 检查是否应该记录日志（任意线程，无锁）
      * @param error_code 错误码
      * @return true 如果应该记录，false 如果应该节流
      */
@@ -51,26 +59,33 @@ public:
     std::string GetAggregateReport(ErrorCode error_code);
 
     /**
-     * @brief 重置节流器状态
+     * @brief 重置节流器状态（与 ShouldLog 并发调用时，并发中的事件可能计入重置前或后）
      */
     void Reset();
 
 private:
-    struct ThrottleInfo {
-        int count = 0;
-        std::chrono::steady_clock::time_point window_start;
-        int throttled_count = 0;
-        std::chrono::steady_clock::time_point first_throttled;
-        std::chrono::steady_clock::time_point last_throttled;
+    static constexpr int MAX_LOGS_PER_SECOND = 10;
+    static constexpr int64_t WINDOW_DURATION_MS = 1000;
+
+    // window 打包格式：高位为窗口起点（steady_clock 毫秒），低 COUNT_BITS 位为本窗口已领取的名额
+    // 只有观察到 count < MAX 的调用才会递增，计数最多超出并发线程数，不会溢出到起点位
+    static constexpr int COUNT_BITS = 20;
+    static constexpr uint64_t COUNT_MASK = (uint64_t(1) << COUNT_BITS) - 1;
+
+    // 每个错误码独占一条缓存行，不同错误码互不干扰
+    struct alignas(64) ThrottleSlot {
+        std::atomic<uint64_t> window{0};
+        std::atomic<uint64_t> throttled_count{0};
+        std::atomic<int64_t> first_throttled_ns{0};   // 0 表示尚未节流
+        std::atomic<int64_t> last_throttled_ns{0};
     };
 
-    static constexpr int MAX_LOGS_PER_SECOND = 10;
-    static constexpr std::chrono::seconds WINDOW_DURATION{1};
+    // ErrorCode 连续且从0开始；越界值共用最后一个槽位
+    static constexpr size_t SLOT_COUNT = static_cast<size_t>(ErrorCode::GAMUT_OOG) + 2;
 
-    std::unordered_map<ErrorCode, ThrottleInfo> throttle_map_;
-    std::mutex mutex_;
+    ThrottleSlot slots_[SLOT_COUNT];
 
-    void UpdateWindow(ThrottleInfo& info);
+    ThrottleSlot& SlotFor(ErrorCode error_code);
 };
 
 /**
@@ -213,10 +228,17 @@ public:
 
     /**
      * @brief 设置错误回调函数
-     * @param callback 错误发生时调用的回调函数
+     * @param callback 错误发生时调用的回调函数（在内部锁之外调用，可重入本处理器）
      */
     void SetErrorCallback(std::function<void(const ErrorReport&)> callback);
 
+    /**
+     * @brief 设置日志汇
+     * @param sink 异步日志汇，错误日志与参数修正信息都写入其中；
+     *             nullptr 恢复默认：错误日志写 AsyncLogSink::Default()（std::cerr），参数修正写 std::cout
+     */
+    void SetLogSink(std::shared_ptr<AsyncLogSink> sink);
+
     /**
      * @brief 获取所有聚合报告
      * @return 聚合报告的向量
@@ -228,6 +250,7 @@ private:
     FallbackStrategy current_strategy_;
     LogThrottler throttler_;
     std::function<void(const ErrorReport&)> error_callback_;
+    std::shared_ptr<AsyncLogSink> log_sink_;
     std::mutex mutex_;
 
     // 参数验证辅助函数
@@ -237,8 +260,9 @@ private:
     // 回退策略决策
     FallbackStrategy DetermineFallbackStrategy(ErrorCode error_code);
     
-    // 日志记录
+    // 日志记录（投递到异步日志汇，调用方持有 mutex_）
     void LogError(const ErrorReport& error);
+    AsyncLogSink& Sink();
 };
 
 /**
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "core.h"
+#include "mpsc_ring.h"
+#include <atomic>
+#include <mutex>
+#include <string_view>
+
+namespace CinemaProHDR {
+
+/**
+ * @brief 错误事件关联的参数字段（与 ParamRanges 一一对应）
+ */
+enum class ErrorField : uint8_t {
+    NONE = 0,
+    PIVOT_PQ,
+    GAMMA_S,
+    GAMMA_H,
+    SHOULDER_H,
+    RLOG_A,
+    RLOG_B,
+    RLOG_C,
+    RLOG_T,
+    BLACK_LIFT,
+    HIGHLIGHT_DETAIL,
+    SAT_BASE,
+    SAT_HI,
+    YKNEE,
+    ALPHA,
+    TOE
+};
+
+/**
+ * @brief 字段名（NONE 返回空串）
+ */
+const char* ErrorFieldName(ErrorField field);
+
+/**
+ * @brief 按 CphParams 字段名查找（未知名称返回 NONE）
+ */
+ErrorField ErrorFieldFromName(std::string_view name);
+
+/**
+ * @brief 定长错误事件
+ *
+ * 记录时不做堆分配：消息为静态字符串指针，动态细节（异常文本、子模块错误）截断复制到内联缓冲。
+ * 只有读取历史时才拼装成 ErrorReport。
+ */
+struct ErrorEvent {
+    static constexpr size_t kDetailLength = 63;
+
+    int64_t timestamp_ns = 0;        // system_clock 纪元以来的纳秒
+    int64_t frame_index = -1;        // 无关联帧为-1
+    const char* message = "";        // 必须具有静态存储期（字符串字面量）
+    ErrorCode code = ErrorCode::SUCCESS;
+    ErrorField field = ErrorField::NONE;
+    float value = 0.0f;
+    char detail[kDetailLength + 1] = {};
+
+    /**
+     * @brief 展开为 ErrorReport（消息为 "message: detail"）
+     */
+    ErrorReport ToReport() const;
+};
+
+/**
+ * @brief 错误事件环：渲染线程无锁记录，由 ErrorEventLog 在读取历史时排空
+ */
+using ErrorRing = MpscRing<ErrorEvent, 256>;
+
+/**
+ * @brief 错误事件计数
+ */
+struct ErrorEventCounters {
+    uint64_t recorded = 0;  // 成功写入环的事件数
+    uint64_t dropped = 0;   // 环满被丢弃（两次读取之间错误过多；仍会更新最新事件）
+    uint64_t evicted = 0;   // 超出保留窗口被挤出的旧事件
+};
+
+/**
+ * @brief 有界错误历史
+ *
+ * 记录端只触碰无锁环与最新事件槽；读取端（GetHistory/GetCounters/Clear）在自己的互斥锁下
+ * 把环排空到定长保留窗口（最近 kCapacity 条），再按需生成字符串。内存占用固定，与错误数量无关。
+ * 最新事件槽由序号锁保护、每次记录都会覆盖，因此环满丢弃时 GetLastError 仍是最新错误。
+ *
+ * 用途：CphProcessor 的错误历史，损坏片段每帧报错也不会无限增长或与渲染线程争锁
+ * 不是：日志输出——事件只在被读取时格式化
+ */
+class ErrorEventLog {
+public:
+    static constexpr size_t kCapacity = ErrorRing::kCapacity;
+
+    ErrorEventLog() = default;
+
+    ErrorEventLog(const ErrorEventLog&) = delete;
+    ErrorEventLog& operator=(const ErrorEventLog&) = delete;
+
+    /**
+     * @brief 记录一个事件（任意线程，无锁，不分配内存）
+     * @param message 静态字符串
+     * @param detail 动态细节，超过 ErrorEvent::kDetailLength 的部分被截断（按UTF-8字符边界）
+     */
+    void Record(ErrorCode code, const char* message, std::string_view detail = {},
+                ErrorField field = ErrorField::NONE, float value = 0.0f, int64_t frame_index = -1);
+
+    /**
+     * @brief 保留窗口中的事件（按记录顺序）
+     */
+    std::vector<ErrorReport> GetHistory() const;
+
+    /**
+     * @brief 最近一个事件的 ToString（无事件时为空串；不排空环）
+     *
+     * 并发记录的事件之间没有先后，此时返回其中任意一个。
+     */
+    std::string GetLastError() const;
+
+    ErrorEventCounters GetCounters() const;
+
+    /**
+     * @brief 清空历史与计数
+     */
+    void Clear();
+
+private:
+    mutable ErrorRing ring_;
+    std::atomic<uint64_t> recorded_{0};
+
+    // 最新事件槽（序号锁：写入期间序号为奇数；按字原子存取以免读写竞争）
+    static constexpr size_t kEventWords = (sizeof(ErrorEvent) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    std::atomic<uint64_t> latest_sequence_{0};
+    std::atomic<uint64_t> latest_words_[kEventWords]{};
+
+    // 读取端状态（consumer_mutex_ 保护，生产者从不访问）
+    mutable std::mutex consumer_mutex_;
+    mutable ErrorEvent window_[kCapacity];
+    mutable size_t window_start_ = 0;
+    mutable size_t window_size_ = 0;
+    mutable uint64_t evicted_ = 0;
+
+    void DrainLocked() const;
+
+    /**
+     * @brief 写入最新事件槽
+     * @param wait 为false时若另一写入者正持有槽位则放弃（其事件同样是最新的）
+     */
+    void StoreLatest(const ErrorEvent& event, bool wait);
+    bool LoadLatest(ErrorEvent& event) const;
+};
+
+} // namespace CinemaProHDR
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "core.h"
+#include <cstdint>
+
+namespace CinemaProHDR {
+
+// 半精度像素存储：池化、对齐、resize不清零
+using HalfBuffer = std::vector<uint16_t, PoolAllocator<uint16_t>>;
+
+/**
+ * @brief 半精度（IEEE 754 binary16）交错图像
+ *
+ * 与 Image 布局相同（交错，通道数可变），每个样本占2字节：
+ * - 宿主（Resolve/OFX）常见的 RGBA half 缓冲可直接包装
+ * - 帧缓存占用与内存带宽均减半（8K RGB 约200MB）
+ *
+ * 用途：帧存储与宿主I/O格式；进入管线时解码为FP32工作缓冲
+ * 不是：计算格式——各处理阶段的中间结果仍为FP32
+ */
+struct ImageHalf {
+    int width = 0;
+    int height = 0;
+    int channels = 3;
+    HalfBuffer data;
+    ColorSpace color_space = ColorSpace::BT2020_PQ;
+
+    ImageHalf() = default;
+    ImageHalf(int w, int h, int c = 3);
+    ImageHalf(int w, int h, int c, ImageInit init);
+
+    uint16_t* GetPixel(int x, int y);
+    const uint16_t* GetPixel(int x, int y) const;
+
+    /**
+     * @brief 尺寸一致且不含NaN/Inf编码
+     */
+    bool IsValid() const;
+    size_t GetDataSize() const { return static_cast<size_t>(width) * height * channels; }
+};
+
+/**
+ * @brief 半精度与单精度互转
+ *
+ * 批量接口在运行时检测到F16C（x86）时使用 VCVTPH2PS/VCVTPS2PH，
+ * AArch64 上使用 NEON FCVT，其余平台回退到标量实现。
+ * 所有路径均为就近舍入到偶数，结果逐位一致。
+ */
+namespace HalfFloat {
+
+    /**
+     * @brief 单个float → half（就近舍入到偶数，溢出为Inf，保留NaN）
+     */
+    uint16_t FromFloat(float value);
+
+    /**
+     * @brief 单个half → float（精确）
+     */
+    float ToFloat(uint16_t value);
+
+    /**
+     * @brief 批量 float → half
+     */
+    void FloatToHalf(const float* src, uint16_t* dst, size_t count);
+
+    /**
+     * @brief 批量 half → float
+     */
+    void HalfToFloat(const uint16_t* src, float* dst, size_t count);
+
+    /**
+     * @brief 当前平台批量转换是否使用硬件指令
+     */
+    bool HasHardwareConversion();
+
+    /**
+     * @brief 整帧转换（尺寸、通道数、色彩空间保持一致）
+     */
+    void ToImage(const ImageHalf& input, Image& output);
+    void FromImage(const Image& input, ImageHalf& output);
+}
+
+} // namespace CinemaProHDR
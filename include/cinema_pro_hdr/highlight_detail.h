@@ -1,10 +1,40 @@
 #pragma once
 
 #include "core.h"
+#include "image_planar.h"
+#include "motion_history.h"
 #include <vector>
 
 namespace CinemaProHDR {
 
+/**
+ * @brief USM模糊的实现方式
+ *
+ * RECURSIVE 只在较大σ（约3像素以上）时划算：σ=1时5抽头直接卷积更快也更精确。
+ * 扫描线流式处理无法做反因果递推，总是使用直接卷积核。
+ */
+enum class GaussianMethod {
+    DIRECT,     // 直接卷积（ComputeGaussianKernel，代价随半径线性增长）
+    RECURSIVE   // Young–van Vliet 递归IIR（每像素代价与σ无关，见 RecursiveGaussian）
+};
+
+/**
+ * @brief USM细节层的提取域
+ */
+enum class DetailDomain {
+    RGB,    // 三个通道各自模糊、各自提取细节
+    LUMA    // 只模糊MaxRGB平面，细节以比例作用于RGB（模糊量为1/3，不改变高光色相）
+};
+
+/**
+ * @brief USM内核选项
+ */
+struct UnsharpMaskOptions {
+    GaussianMethod gaussian_method = GaussianMethod::DIRECT;
+    DetailDomain detail_domain = DetailDomain::RGB;
+    float sigma = 1.0f;  // 全分辨率高斯σ（像素，钳制到[kMinUSMSigma, kMaxUSMSigma]），直接卷积半径为ceil(2σ)
+};
+
 /**
  * @brief 高光细节处理模块
  * 
@@ -29,6 +59,17 @@ namespace CinemaProHDR {
  */
 class HighlightDetailProcessor {
 public:
+    // 默认USM高斯核（σ=1像素，半径2像素）；σ可经 UnsharpMaskOptions 调整
+    static constexpr int kUSMRadius = 2;
+    static constexpr float kMinUSMSigma = 0.25f;
+    static constexpr float kMaxUSMSigma = 16.0f;
+    
+    // 运动保护阈值（帧差RMS，PQ归一化单位）
+    static constexpr float kMotionThreshold = 0.02f;
+    
+    // 运动保护参考的运动能量历史长度（帧）
+    static constexpr size_t kMotionHistoryLength = MotionHistory::kDefaultEnergyCapacity;
+    
     HighlightDetailProcessor();
     ~HighlightDetailProcessor();
     
@@ -48,10 +89,126 @@ public:
      */
     bool ProcessFrame(const Image& input, Image& output, float pivot_threshold);
     
+    /**
+     * @brief 平面布局的单帧高光细节处理（结果与 ProcessFrame 一致）
+     * @param input 平面输入（工作域；带亮度平面时直接用作高光掩码来源）
+     * @param output 平面输出（不能与input为同一对象，不含亮度平面）
+     * @param pivot_threshold 高光阈值（PQ归一化）
+     * @param scale 相对全分辨率的缩放比例（代理分辨率时<1，USM半径与σ按比例缩小）
+     * @return 处理是否成功
+     */
+    bool ProcessFramePlanar(const ImagePlanar& input, ImagePlanar& output, float pivot_threshold,
+                            float scale = 1.0f);
+    
+    /**
+     * @brief 以显式强度执行平面高光细节处理（强度由调用方决定，如运动保护后的强度）
+     * @param intensity 细节强度（<=0时原样复制输入）
+     */
+    bool ProcessFramePlanar(const ImagePlanar& input, ImagePlanar& output, float pivot_threshold,
+                            float scale, float intensity);
+    
+    /**
+     * @brief 平面USM内核（无状态，可并发调用；异常由调用方处理）
+     *
+     * ProcessFramePlanar 的计算主体，供共享的编译管线直接调用。
+     * @param motion_map 分块运动图（可选，尺寸与input一致时按块降低细节强度）
+     * @param options 模糊实现（σ低于 RecursiveGaussian::kMinSigma 时总是直接卷积）与细节提取域
+     */
+    static void UnsharpMaskPlanar(const ImagePlanar& input, ImagePlanar& output, float pivot_threshold,
+                                  float intensity, float scale, const MotionMap* motion_map = nullptr,
+                                  const UnsharpMaskOptions& options = UnsharpMaskOptions());
+    
+    /**
+     * @brief USM高斯核（按代理缩放比例缩小半径与σ）
+     * @param sigma 全分辨率σ（像素）
+     * @return 核半径
+     */
+    static int ComputeUSMKernel(float scale, std::vector<float>& kernel, float sigma = 1.0f);
+    
+    // 行级USM内核：UnsharpMaskPlanar 与流式扫描线处理共用，保证两条路径逐位一致
+    
+    /**
+     * @brief 一行的高光掩码（luma为nullptr时取MaxRGB）
+     */
+    static void HighlightMaskRow(const float* luma, const float* r, const float* g, const float* b,
+                                 float* mask, size_t count, float pivot_threshold);
+    
+    /**
+     * @brief 一行的水平模糊（边界钳制）
+     */
+    static void BlurRowHorizontal(const float* row, float* out, int width, const std::vector<float>& kernel);
+    
+    /**
+     * @brief 由 kernel.size() 个已水平模糊的行（按抽头顺序，边界行由调用方钳制）合成一行垂直模糊
+     */
+    static void BlurRowVertical(const float* const* rows, const std::vector<float>& kernel, float* out, int width);
+    
+    /**
+     * @brief 细节层（thr=0.03）按掩码叠加回原值
+     */
+    static void ComposeDetailRow(const float* src, const float* blurred, const float* mask, float* dst,
+                                 size_t count, float intensity);
+    
+    /**
+     * @brief LUMA域细节：亮度细节按掩码叠加得到目标亮度，RGB按目标/原亮度等比缩放（亮度为0时加偏移）
+     */
+    static void ComposeLumaDetailRow(const float* luma, const float* blurred, const float* mask,
+                                     const float* const* src, float* const* dst, size_t count, float intensity);
+    
+    /**
+     * @brief 帧间运动能量（亮度平面版本，与 ProcessFrameWithMotionProtection 的定义一致）
+     *
+     * 无状态，可并发调用：前一帧由调用方作为显式依赖传入。
+     * @param current_luma 当前帧MaxRGB亮度
+     * @param previous_luma 前一帧MaxRGB亮度（同尺寸）
+     * @return 高光区域（当前亮度>pivot）帧差RMS，[0,1]
+     */
+    static float ComputeMotionEnergyLuma(const float* current_luma, const float* previous_luma,
+                                         size_t count, float pivot_threshold);
+    
+    /**
+     * @brief 推入一帧亮度并估计分块运动（无状态，前一帧由调用方的历史提供）
+     *
+     * 依次：亮度金字塔入环 → 由粗到细计算运动图 → 全帧能量入历史 → 逐块抑制决策。
+     * @param luma 本帧MaxRGB亮度（色调映射后）
+     * @return 有可比的前一帧时返回map，否则nullptr（整帧按原强度处理）
+     */
+    static const MotionMap* UpdateMotionProtection(MotionHistory& history, const float* luma, int width, int height,
+                                                   float pivot_threshold, MotionMap& map);
+    
+    /**
+     * @brief 分块运动保护决策（写入 map.detail_scale）
+     * @return 是否有块被抑制
+     */
+    static bool ShouldSuppressDetail(MotionMap& map, const MotionHistory& history);
+    
+    /**
+     * @brief 运动保护后的有效细节强度（整帧版本）
+     * @param history 运动历史（最新能量为当前帧；没有能量记录表示没有前一帧）
+     */
+    static float MotionProtectedIntensity(float intensity, const MotionHistory& history);
+    
+    /**
+     * @brief 给定缩放比例与全分辨率σ下的USM直接卷积核半径（ceil(2σ×scale)，至少1像素）
+     */
+    static int ScaledUSMRadius(float scale, float sigma = 1.0f);
+    
+    /**
+     * @brief 区域处理需要的输入光晕（像素）：直接卷积为核半径，递归实现为 kPaddingSigmas×σ
+     *        （IIR支撑无限长，区域边界处的结果与整帧近似一致）
+     */
+    static int USMHaloRadius(const UnsharpMaskOptions& options);
+    
+    /**
+     * @brief 把σ钳制到[kMinUSMSigma, kMaxUSMSigma]（非有限值取默认1像素）
+     */
+    static float ClampUSMSigma(float sigma);
+    
     /**
      * @brief 处理带运动保护的帧序列
      * @param current_frame 当前帧
-     * @param previous_frame 前一帧（可选，用于运动检测）
+     * @param previous_frame 前一帧（可选，非空时启用运动检测；像素取自内部历史中
+     *                       上一次处理的帧的降采样亮度，不再整帧复制）
      * @param output 输出帧
      * @param pivot_threshold 高光阈值
      * @return 处理是否成功
@@ -75,6 +232,24 @@ public:
      */
     const CphParams& GetParams() const { return params_; }
     
+    /**
+     * @brief 整体设置USM内核选项（CphProcessor::SetUnsharpMaskOptions 经此下发到交错路径）
+     */
+    void SetUnsharpMaskOptions(const UnsharpMaskOptions& options) { usm_options_ = options; }
+    const UnsharpMaskOptions& GetUnsharpMaskOptions() const { return usm_options_; }
+    
+    /**
+     * @brief 选择USM模糊实现（默认直接卷积，对所有处理路径生效）
+     */
+    void SetGaussianMethod(GaussianMethod method) { usm_options_.gaussian_method = method; }
+    GaussianMethod GetGaussianMethod() const { return usm_options_.gaussian_method; }
+    
+    /**
+     * @brief 选择细节提取域（默认RGB，对所有处理路径生效）
+     */
+    void SetDetailDomain(DetailDomain domain) { usm_options_.detail_domain = domain; }
+    DetailDomain GetDetailDomain() const { return usm_options_.detail_domain; }
+    
     /**
      * @brief 获取最后的错误信息
      * @return 错误信息字符串
@@ -90,25 +265,27 @@ private:
     CphParams params_;
     std::string last_error_;
     bool initialized_ = false;
+    UnsharpMaskOptions usm_options_;
     
-    // 运动保护相关
-    Image previous_frame_;
-    bool has_previous_frame_ = false;
-    std::vector<float> motion_energy_history_;
+    // 运动保护相关（亮度金字塔与能量的环形历史，及最近一帧的分块运动图）
+    MotionHistory motion_history_;
+    MotionMap motion_map_;
     
     // USM算法实现
     bool ApplyUSM(const Image& input, Image& output, float pivot_threshold, float intensity);
+    bool ApplyUSMPlanar(const ImagePlanar& input, ImagePlanar& output, float pivot_threshold, float intensity,
+                        float scale);
     
     // 运动检测
-    float ComputeMotionEnergy(const Image& current, const Image& previous, float pivot_threshold);
-    bool ShouldSuppressDetail(float motion_energy);
+    static bool ShouldSuppressDetail(float motion_energy, const MotionHistory& history);
+    static bool EstimateMotion(MotionHistory& history, float pivot_threshold, MotionMap& map);
     
     // 频域分析
     std::vector<float> ComputeTemporalSpectrum(const std::vector<Image>& frames, int x, int y) const;
     float ComputeEnergyInBand(const std::vector<float>& spectrum, float fps, float low_freq, float high_freq) const;
     
     // 辅助函数
-    void ComputeGaussianKernel(std::vector<float>& kernel, int radius, float sigma);
+    static void ComputeGaussianKernel(std::vector<float>& kernel, int radius, float sigma);
     void ApplyGaussianBlur(const Image& input, Image& output, int radius, float sigma);
     void ComputeUnsharpMask(const Image& original, const Image& blurred, Image& mask, float amount, float threshold);
     
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "core.h"
+#include "half_float.h"
+
+namespace CinemaProHDR {
+
+/**
+ * @brief 平面（SoA）图像布局
+ *
+ * R、G、B 各自存放在独立的连续平面中（来自 ImagePool，64字节对齐），
+ * 另有可选的亮度平面（MaxRGB，与管线其余部分的亮度定义一致）：
+ * - 逐通道内核可以直接按连续向量处理，无需跨步聚集
+ * - 亮度平面由色调映射阶段顺带生成，供高光掩码复用
+ *
+ * 用途：CphProcessor 内部的工作布局（在边界处与交错 Image 相互转换）
+ * 不是：对外的帧交换格式——宿主仍以交错 Image 传入传出
+ *
+ * 额外通道（如Alpha）不进入平面布局，交错回写时从源图像原样复制。
+ */
+struct ImagePlanar {
+    int width = 0;
+    int height = 0;
+    ImageBuffer planes[3];  // R, G, B
+    ImageBuffer luma;       // 可选 MaxRGB 平面（空表示不存在）
+    ColorSpace color_space = ColorSpace::BT2020_PQ;
+
+    ImagePlanar() = default;
+    ImagePlanar(int w, int h, ImageInit init = ImageInit::ZERO);
+
+    size_t GetPixelCount() const { return static_cast<size_t>(width) * height; }
+
+    float* Plane(int c) { return planes[c].data(); }
+    const float* Plane(int c) const { return planes[c].data(); }
+
+    /**
+     * @brief 结构检查（尺寸与平面长度），O(1)
+     *
+     * 不扫描样本：数值有效性在进入平面布局前由交错输入的 IsValid 检查一次，
+     * 各阶段之间只做结构检查。手工填充平面的调用方需要时使用 HasFiniteSamples。
+     */
+    bool IsValid() const;
+
+    /**
+     * @brief 所有RGB样本均为有限值（全平面扫描）
+     */
+    bool HasFiniteSamples() const;
+
+    bool HasLuma() const { return luma.size() == GetPixelCount() && !luma.empty(); }
+
+    /**
+     * @brief 由当前RGB平面计算 MaxRGB 亮度平面
+     */
+    void ComputeLuma();
+
+    /**
+     * @brief 丢弃亮度平面（RGB被修改且未同步更新亮度时调用）
+     */
+    void DropLuma() { luma = ImageBuffer(); }
+};
+
+/**
+ * @brief 交错/平面布局转换内核
+ */
+namespace PlanarLayout {
+
+    /**
+     * @brief 交错像素 → 三个平面（取前三个通道；供扫描线等行级处理使用）
+     */
+    void DeinterleavePixels(const float* src, int channels, float* r, float* g, float* b, size_t count);
+
+    /**
+     * @brief 三个平面 → 交错像素（只写前三个通道，其余通道保持不变）
+     */
+    void InterleavePixels(const float* r, const float* g, const float* b, float* dst, int channels, size_t count);
+
+    /**
+     * @brief 交错图像 → 平面图像（取前三个通道）
+     * @param input 交错输入（至少3通道）
+     * @param output 平面输出（尺寸不符时重新分配，不清零）
+     */
+    void Deinterleave(const Image& input, ImagePlanar& output);
+
+    /**
+     * @brief 平面图像 → 交错图像
+     * @param input 平面输入
+     * @param output 交错输出（尺寸或通道数不符时重新分配）
+     * @param passthrough 额外通道来源（可为nullptr；可与output为同一图像）
+     */
+    void Interleave(const ImagePlanar& input, Image& output, const Image* passthrough = nullptr);
+
+    /**
+     * @brief 半精度交错图像 → 平面图像（解码与拆分在同一遍内分块完成）
+     */
+    void Deinterleave(const ImageHalf& input, ImagePlanar& output);
+
+    /**
+     * @brief 平面图像 → 半精度交错图像（编码与交错在同一遍内分块完成）
+     * @param passthrough 额外通道来源（按原始位模式复制，可与output为同一图像）
+     */
+    void Interleave(const ImagePlanar& input, ImageHalf& output, const ImageHalf* passthrough = nullptr);
+}
+
+} // namespace CinemaProHDR
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace CinemaProHDR {
+
+/**
+ * @brief 图像缓冲池统计信息（快照）
+ */
+struct ImagePoolStats {
+    uint64_t hits = 0;               // 命中缓存的分配次数
+    uint64_t misses = 0;             // 需要向系统申请的分配次数
+    uint64_t releases = 0;           // 归还到池中的次数
+    uint64_t evictions = 0;          // 因超出缓存上限而释放的块数（最久未用的空闲块或归还的块）
+    uint64_t huge_page_blocks = 0;   // 已申请大页建议（MADV_HUGEPAGE）的块数
+    size_t cached_bytes = 0;         // 当前缓存（空闲）字节数
+    size_t outstanding_bytes = 0;    // 当前借出字节数
+    size_t cache_limit_bytes = 0;    // 当前生效的空闲缓存上限
+
+    double HitRate() const {
+        uint64_t total = hits + misses;
+        return total > 0 ? static_cast<double>(hits) / total : 0.0;
+    }
+};
+
+/**
+ * @brief 进程级图像缓冲池
+ *
+ * 按尺寸级别回收帧缓冲，避免每帧向系统申请并清零数百MB内存：
+ * - 所有块64字节对齐，满足 SSE/AVX/AVX-512 与缓存行对齐
+ * - 小于2MB的请求按 1/4 二次幂步长分级，2MB以上按2MB粒度分级
+ * - Linux下 ≥2MB 的块按2MB对齐并以 madvise(MADV_HUGEPAGE) 建议使用透明大页
+ * - 空闲缓存总量受上限约束，超出时先释放最久未用的空闲块；默认上限自适应：
+ *   至少256MB，并随已申请的最大尺寸级别增长到可容纳两块（8K RGB float 约两帧800MB）
+ *
+ * 用途：Image 的底层存储分配器（经 PoolAllocator）
+ * 不是：通用内存分配器——仅适合少量、尺寸重复的大块
+ *
+ * 线程安全：所有接口均可并发调用（内部互斥，仅在分配/归还时加锁）
+ */
+class ImagePool {
+public:
+    static constexpr size_t kAlignment = 64;
+    static constexpr size_t kHugePageSize = 2u * 1024u * 1024u;
+
+    // SetMaxCachedBytes 的特殊值：自适应上限（默认）
+    static constexpr size_t kAdaptiveCacheLimit = static_cast<size_t>(-1);
+    // 自适应上限的下限
+    static constexpr size_t kMinAdaptiveCacheBytes = size_t(256) << 20;
+
+    /**
+     * @brief 获取进程级实例（永不析构，避免静态析构顺序问题）
+     */
+    static ImagePool& Instance();
+
+    /**
+     * @brief 申请至少 bytes 字节的对齐块（内容未初始化）
+     * @throws std::bad_alloc 系统内存不足
+     */
+    void* Acquire(size_t bytes);
+
+    /**
+     * @brief 归还块；bytes 必须与 Acquire 时一致
+     */
+    void Release(void* ptr, size_t bytes);
+
+    /**
+     * @brief 释放全部空闲缓存
+     */
+    void Trim();
+
+    /**
+     * @brief 设置空闲缓存上限（字节），超出部分立即按最久未用释放
+     * @param bytes 0 表示不缓存（每次归还都释放）；kAdaptiveCacheLimit 恢复自适应上限：
+     *        max(kMinAdaptiveCacheBytes, 2×已申请的最大尺寸级别)
+     */
+    void SetMaxCachedBytes(size_t bytes);
+
+    /**
+     * @brief 设置值（自适应时为 kAdaptiveCacheLimit；生效值见 ImagePoolStats::cache_limit_bytes）
+     */
+    size_t GetMaxCachedBytes() const;
+
+    /**
+     * @brief 启用/禁用大页建议（仅影响之后新申请的块）
+     */
+    void SetHugePagesEnabled(bool enabled);
+    bool IsHugePagesEnabled() const;
+
+    ImagePoolStats GetStats() const;
+    void ResetStats();
+
+    /**
+     * @brief 计算请求字节数所属的尺寸级别（实际分配字节数）
+     */
+    static size_t SizeClass(size_t bytes);
+
+    ImagePool(const ImagePool&) = delete;
+    ImagePool& operator=(const ImagePool&) = delete;
+
+private:
+    ImagePool();
+    ~ImagePool();
+
+    // 空闲块及其归还序号（用于按最久未用淘汰）
+    struct CachedBlock {
+        void* ptr;
+        uint64_t tick;
+    };
+
+    void* AllocateBlock(size_t class_bytes);
+    static void FreeBlock(void* ptr);
+    size_t CacheLimitLocked() const;
+    bool EvictOldestLocked();
+
+    mutable std::mutex mutex_;
+    std::unordered_map<size_t, std::vector<CachedBlock>> free_lists_;  // 每级内按归还顺序排列
+    ImagePoolStats stats_;
+    size_t max_cached_bytes_;
+    size_t largest_class_ = 0;
+    uint64_t release_tick_ = 0;
+    bool huge_pages_enabled_;
+};
+
+/**
+ * @brief 基于 ImagePool 的标准分配器
+ *
+ * 与 std::allocator 的区别：
+ * - 存储来自 ImagePool（64字节对齐、可回收）
+ * - 无参构造为默认初始化：resize(n) 不清零，由调用方负责写入
+ *   （需要清零时使用 assign(n, 0.0f) 或 resize(n, 0.0f)）
+ */
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(ImagePool::Instance().Acquire(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        ImagePool::Instance().Release(ptr, n * sizeof(T));
+    }
+
+    template <typename U>
+    void construct(U* ptr) noexcept {
+        ::new (static_cast<void*>(ptr)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* ptr, Args&&... args) {
+        ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept { return true; }
+
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept { return false; }
+
+// 图像像素存储：池化、对齐、resize不清零
+using ImageBuffer = std::vector<float, PoolAllocator<float>>;
+
+} // namespace CinemaProHDR
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "core.h"
+#include "mpsc_ring.h"
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <thread>
+
+namespace CinemaProHDR {
+
+/**
+ * @brief 日志行格式
+ */
+enum class LogFormat {
+    TEXT,   // 规范格式：[ts][level][clip_guid][tc] code=..., field=..., val=..., action=...
+    JSON    // 每行一个JSON对象，字段与 TEXT 相同，便于日志系统解析
+};
+
+/**
+ * @brief 日志输出端（只在后台线程上调用，无需线程安全）
+ */
+class LogOutput {
+public:
+    virtual ~LogOutput() = default;
+
+    /**
+     * @brief 写出一行（line 不含换行符）
+     */
+    virtual bool Write(std::string_view line) = 0;
+
+    /**
+     * @brief 把已写出的行交给操作系统（队列排空后调用）
+     */
+    virtual void Flush() {}
+};
+
+/**
+ * @brief 输出到已有的流（默认 std::cerr）
+ */
+class StreamLogOutput : public LogOutput {
+public:
+    explicit StreamLogOutput(std::ostream& stream) : stream_(stream) {}
+
+    bool Write(std::string_view line) override;
+    void Flush() override;
+
+private:
+    std::ostream& stream_;
+};
+
+/**
+ * @brief 追加写入单个文件
+ */
+class FileLogOutput : public LogOutput {
+public:
+    explicit FileLogOutput(const std::string& path);
+
+    bool IsOpen() const { return file_.is_open(); }
+    bool Write(std::string_view line) override;
+    void Flush() override;
+
+private:
+    std::ofstream file_;
+};
+
+/**
+ * @brief 按大小滚动的文件输出
+ *
+ * 当前文件超过 max_bytes 时依次改名为 path.1 … path.N（N = max_files，最旧的被删除），
+ * 然后重新创建 path。单行超过 max_bytes 时仍完整写入。
+ */
+class RotatingFileLogOutput : public LogOutput {
+public:
+    RotatingFileLogOutput(const std::string& path, size_t max_bytes, int max_files = 5);
+
+    bool IsOpen() const { return file_.is_open(); }
+    bool Write(std::string_view line) override;
+    void Flush() override;
+
+private:
+    std::string path_;
+    size_t max_bytes_;
+    int max_files_;
+    size_t size_ = 0;
+    std::ofstream file_;
+
+    void Rotate();
+};
+
+/**
+ * @brief 把错误报告格式化为一行（不含换行符）
+ */
+std::string FormatLogLine(const ErrorReport& report, LogFormat format);
+
+/**
+ * @brief 异步日志汇
+ *
+ * 调用线程只把记录投进无锁有界队列（MpscRing），格式化与终端/磁盘I/O全部在后台线程完成：
+ * - Submit 从不等待锁或I/O；队列满时丢弃并计数
+ * - 后台线程被投递唤醒，或每 flush_interval 醒来一次（唤醒信号丢失时延迟有上界）
+ * - 队列排空后 Flush 输出端；析构/Shutdown 最多再用 shutdown_timeout 写完剩余记录
+ *
+ * 用途：ErrorHandler 的日志输出，渲染线程报错不阻塞在 std::cerr 或日志文件上
+ * 不是：可靠传输——进程崩溃时队列中的记录会丢失
+ */
+class AsyncLogSink {
+public:
+    static constexpr size_t kQueueCapacity = 1024;
+
+    struct Config {
+        LogFormat format = LogFormat::TEXT;
+        std::chrono::milliseconds flush_interval{100};
+        std::chrono::milliseconds shutdown_timeout{500};
+    };
+
+    explicit AsyncLogSink(std::unique_ptr<LogOutput> output);
+    AsyncLogSink(std::unique_ptr<LogOutput> output, const Config& config);
+    ~AsyncLogSink();
+
+    AsyncLogSink(const AsyncLogSink&) = delete;
+    AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+    /**
+     * @brief 投递一条错误报告（任意线程，不阻塞）
+     * @return 队列满或已关闭时返回false
+     */
+    bool Submit(ErrorReport report);
+
+    /**
+     * @brief 投递一行已格式化的文本（如聚合摘要），原样写出
+     */
+    bool SubmitLine(std::string line);
+
+    /**
+     * @brief 等待此前投递的记录全部写出并刷新（最多等待 timeout）
+     * @return 是否在超时前完成
+     */
+    bool Flush(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief 停止后台线程：在 shutdown_timeout 内写完剩余记录，超时未写出的计入丢弃
+     */
+    void Shutdown();
+
+    uint64_t GetWrittenCount() const { return written_.load(std::memory_order_relaxed); }
+    uint64_t GetDroppedCount() const { return queue_.GetDroppedCount() + abandoned_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 进程级默认日志汇（std::cerr，TEXT），首次使用时启动，进程退出时刷新
+     */
+    static AsyncLogSink& Default();
+
+private:
+    struct Entry {
+        bool raw = false;     // true 时 line 原样写出
+        std::string line;
+        ErrorReport report;
+    };
+
+    std::unique_ptr<LogOutput> output_;
+    Config config_;
+    MpscRing<Entry, kQueueCapacity> queue_;
+
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> abandoned_{0};  // 关闭超时未写出的记录
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> sleeping_{false};
+
+    // 只用于后台线程休眠与 Flush 等待，Submit 不获取
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable flushed_cv_;
+    uint64_t flushed_ = 0;       // 已写出并刷新的投递序号（wake_mutex_ 保护）
+    bool flush_requested_ = false;
+
+    std::thread worker_;
+
+    bool Enqueue(Entry entry);
+    void Run();
+    size_t DrainBatch();
+};
+
+} // namespace CinemaProHDR
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "core.h"
+#include <string>
+#include <vector>
+
+namespace CinemaProHDR {
+
+/**
+ * @brief .cube LUT 数据结构
+ *
+ * 保存解析后的 .cube 文件内容（Adobe/Resolve 格式）：
+ * - 可选的1D整形LUT（LUT_1D_SIZE）
+ * - 可选的3D LUT（LUT_3D_SIZE），R通道变化最快
+ * - 输入域（DOMAIN_MIN/DOMAIN_MAX 或 LUT_xD_INPUT_RANGE）
+ *
+ * 同时存在1D和3D时，按 Resolve 约定先应用1D整形再应用3D。
+ */
+struct CubeLUT {
+    std::string title;
+    int size_1d = 0;
+    int size_3d = 0;
+    float domain_min_1d[3] = {0.0f, 0.0f, 0.0f};
+    float domain_max_1d[3] = {1.0f, 1.0f, 1.0f};
+    float domain_min_3d[3] = {0.0f, 0.0f, 0.0f};
+    float domain_max_3d[3] = {1.0f, 1.0f, 1.0f};
+    std::vector<float> table_1d;  // size_1d * 3，RGB交错
+    std::vector<float> table_3d;  // size_3d^3 * 3，RGB交错，R最快
+
+    bool Has1D() const { return size_1d > 0; }
+    bool Has3D() const { return size_3d > 0; }
+    bool IsValid() const;
+};
+
+/**
+ * @brief .cube LUT 解析工具
+ */
+namespace CubeLUTIO {
+
+    /**
+     * @brief 从文本解析 .cube 内容
+     * @param text 文件内容
+     * @param lut 输出LUT
+     * @param error 错误信息（失败时填写）
+     * @return 解析是否成功
+     */
+    bool ParseCube(const std::string& text, CubeLUT& lut, std::string& error);
+
+    /**
+     * @brief 从文件读取 .cube
+     * @param path 文件路径
+     * @param lut 输出LUT
+     * @param error 错误信息（失败时填写）
+     * @return 读取是否成功
+     */
+    bool LoadCubeFile(const std::string& path, CubeLUT& lut, std::string& error);
+}
+
+/**
+ * @brief 3D LUT 快速应用引擎（预览路径）
+ *
+ * 将烘焙好的 .cube 直接应用到图像上，替代完整解析管线：
+ * - 1D整形LUT：逐通道线性插值
+ * - 3D LUT：四面体插值，格点按RGBA四元组交错存储并64字节对齐
+ * - 插值内核使用SSE/NEON，按行多线程执行
+ *
+ * 用途：样片/dailies 的低成本预览，或应用调色师提供的LUT
+ * 不是：CphProcessor 的替代品——LUT 无法表达空间算子（高光细节USM），
+ *       也不产生统计信息
+ *
+ * 适用场景：
+ * - 逐像素变换（色调映射+饱和度+色域）已烘焙为LUT
+ * - 交互预览需要数量级更低的开销
+ *
+ * 不适用场景：
+ * - 需要高光细节增强或运动保护的最终渲染
+ * - 交付母版（应使用完整解析管线）
+ */
+class LutProcessor {
+public:
+    LutProcessor();
+    ~LutProcessor();
+
+    LutProcessor(const LutProcessor&) = delete;
+    LutProcessor& operator=(const LutProcessor&) = delete;
+
+    /**
+     * @brief 从已解析的LUT初始化（构建对齐的交错格点）
+     * @param lut 输入LUT
+     * @return 初始化是否成功
+     */
+    bool Initialize(const CubeLUT& lut);
+
+    /**
+     * @brief 从 .cube 文件初始化
+     */
+    bool LoadCubeFile(const std::string& path);
+
+    /**
+     * @brief 从 .cube 文本初始化
+     */
+    bool LoadCubeFromString(const std::string& text);
+
+    /**
+     * @brief 对整帧应用LUT
+     * @param input 输入图像（至少3通道，额外通道原样复制）
+     * @param output 输出图像（尺寸、通道数、色彩空间与输入一致）
+     * @return 处理是否成功
+     */
+    bool ProcessFrame(const Image& input, Image& output);
+
+    /**
+     * @brief 对交错像素跨度应用LUT（可原地处理）
+     * @param input 输入像素（pixel_count * channels）
+     * @param output 输出像素（pixel_count * channels）
+     * @param pixel_count 像素数量
+     * @param channels 每像素通道数（>=3）
+     */
+    void Apply(const float* input, float* output, size_t pixel_count, int channels = 3) const;
+
+    /**
+     * @brief 对单个RGB像素应用LUT
+     */
+    void ApplyPixel(const float* rgb_in, float* rgb_out) const;
+
+    /**
+     * @brief 设置工作线程数（<=0 表示使用硬件线程数）
+     */
+    void SetThreadCount(int threads) { thread_count_ = threads; }
+
+    bool IsInitialized() const;
+    int GetLatticeSize() const;
+    std::string GetLastError() const { return last_error_; }
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> pImpl;
+    std::string last_error_;
+    int thread_count_ = 0;
+};
+
+} // namespace CinemaProHDR
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "core.h"
+#include <vector>
+
+namespace CinemaProHDR {
+
+/**
+ * @brief 分块运动图
+ *
+ * 按 tile_size×tile_size（源像素）分块记录帧间运动能量与细节强度系数：
+ * - 先在金字塔最粗层筛查：没有高光的块直接跳过，粗层能量已超过阈值的块不再细化，
+ *   其余高光块回到第0层（粗层均值看不到样本内部、均值不变的移动）
+ * - detail_scale 由 HighlightDetailProcessor::ShouldSuppressDetail 写入，
+ *   USM按块中心双线性插值得到逐像素系数，只在运动区域降低细节强度
+ */
+struct MotionMap {
+    int tile_size = 0;
+    int tiles_x = 0;
+    int tiles_y = 0;
+    int source_width = 0;
+    int source_height = 0;
+    std::vector<float> energy;        // 每块高光区帧差RMS
+    std::vector<float> weight;        // 每块参与计算的样本数（第0层样本单位）
+    std::vector<float> detail_scale;  // 每块细节强度系数（1为不抑制）
+    int refined_tiles = 0;            // 回到第0层细化的块数
+
+    bool Matches(int width, int height) const {
+        return tiles_x > 0 && source_width == width && source_height == height;
+    }
+
+    /**
+     * @brief 全帧运动能量（按样本数加权合并各块的均方值）
+     */
+    float GlobalEnergy() const;
+
+    /**
+     * @brief 计算一行像素的细节强度系数（块中心之间双线性插值）
+     */
+    void FillRowScale(int y, int width, float* out) const;
+};
+
+/**
+ * @brief 运动保护的时域历史
+ *
+ * 只保存最近K帧的亮度金字塔，不保存整帧RGB：
+ * - 第0层为 kDownsampleFactor×kDownsampleFactor 盒式平均，之后每层由上一层2×2增量构建，
+ *   每层同时保存均值与块内最大值（最大值用于粗层判断块内是否存在高光）
+ * - 金字塔组成环形缓冲，推入新帧时复用最旧槽位的内存，只移动表头索引
+ * - 运动能量历史同为定长环形缓冲，维护累加和，平均值O(1)可得
+ *
+ * 用途：HighlightDetailProcessor、StreamState 与片段处理的帧间运动检测；
+ *       金字塔各层也可供其他需要低分辨率亮度的阶段读取
+ * 不是：逐像素精确的帧差——盒式平均会抹平小于块尺寸的运动
+ */
+class MotionHistory {
+public:
+    static constexpr int kDownsampleFactor = 4;
+    static constexpr int kPyramidLevels = 3;              // 1/4、1/8、1/16
+    static constexpr int kTileSize = 64;                  // 运动图块尺寸（源像素）
+    static constexpr size_t kDefaultFrameCapacity = 2;    // 当前帧 + 前一帧
+    static constexpr size_t kDefaultEnergyCapacity = 10;  // 最近10帧的运动能量
+
+    /**
+     * @brief 金字塔单层
+     */
+    struct LumaPlane {
+        int width = 0;
+        int height = 0;
+        std::vector<float> mean;
+        std::vector<float> peak;
+    };
+
+    /**
+     * @brief 单帧亮度金字塔
+     */
+    struct LumaFrame {
+        int source_width = 0;   // 原始帧尺寸（用于判断前后帧是否可比）
+        int source_height = 0;
+        LumaPlane levels[kPyramidLevels];
+
+        /**
+         * @brief 第level层一个样本覆盖的源像素边长
+         */
+        static int LevelFactor(int level) { return kDownsampleFactor << level; }
+    };
+
+    explicit MotionHistory(size_t frame_capacity = kDefaultFrameCapacity,
+                           size_t energy_capacity = kDefaultEnergyCapacity);
+
+    /**
+     * @brief 推入一帧的MaxRGB亮度平面（降采样后写入最旧的槽位，并增量构建各层）
+     */
+    void PushLuma(const float* luma, int width, int height);
+
+    /**
+     * @brief 推入交错RGB帧（降采样时顺带计算MaxRGB）
+     */
+    void PushFrame(const Image& frame);
+
+    /**
+     * @brief 按时间倒序取帧（0为最新，超出已有帧数时返回nullptr）
+     */
+    const LumaFrame* GetFrame(size_t age) const;
+    size_t GetFrameCount() const { return frame_count_; }
+
+    /**
+     * @brief 最新帧与前一帧是否存在且尺寸一致
+     */
+    bool HasPrevious() const;
+
+    /**
+     * @brief 最新帧相对前一帧的运动能量（第0层高光区帧差RMS；无可比前一帧时为0）
+     */
+    float ComputeMotionEnergy(float pivot_threshold) const;
+
+    /**
+     * @brief 由粗到细计算分块运动图（无可比前一帧时返回false）
+     * @param motion_threshold 运动阈值（粗层能量未超过阈值的高光块回到第0层细化）
+     * @param map 输出（缓冲跨帧复用，detail_scale初始化为1）
+     */
+    bool ComputeMotionMap(float pivot_threshold, float motion_threshold, MotionMap& map) const;
+
+    // 运动能量环形缓冲
+    void PushEnergy(float energy);
+    size_t GetEnergyCount() const { return energy_count_; }
+    float GetLatestEnergy() const;
+    float GetAverageEnergy() const;
+
+    /**
+     * @brief 清空历史（保留已分配的平面内存）
+     */
+    void Clear();
+
+private:
+    std::vector<LumaFrame> frames_;
+    size_t frame_head_ = 0;   // 最新帧所在槽位
+    size_t frame_count_ = 0;
+
+    std::vector<float> energies_;
+    size_t energy_head_ = 0;  // 下一个写入位置
+    size_t energy_count_ = 0;
+    double energy_sum_ = 0.0;
+
+    LumaFrame& AdvanceFrame(int width, int height);
+    static void BuildCoarseLevels(LumaFrame& frame);
+};
+
+} // namespace CinemaProHDR
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace CinemaProHDR {
+
+/**
+ * @brief 定容无锁多生产者单消费者环
+ *
+ * 每个槽位带序号（Vyukov 有界队列）：生产者以CAS领取写位置后写入元素再发布序号，
+ * 环满时放弃本元素并计入丢弃计数，从不等待。消费者按写入顺序取出已发布的元素。
+ * 元素在槽位中原地构造一次并被反复赋值，取出时可被移走（非平凡类型同样适用）。
+ *
+ * 用途：渲染线程向诊断设施（错误历史、异步日志）投递数据，不因读取端变慢而阻塞
+ * 不是：多消费者队列——Drain 须由调用方串行化
+ */
+template <typename T, size_t Capacity>
+class MpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    static constexpr size_t kCapacity = Capacity;
+
+    MpscRing() {
+        for (size_t i = 0; i < kCapacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    /**
+     * @brief 追加元素（任意线程，无锁）
+     * @return 环满时返回false（元素被丢弃）
+     */
+    template <typename U>
+    bool Push(U&& value) {
+        // 槽位序号等于写位置时可领取；小于说明消费者尚未取走上一轮的元素（环满）
+        uint64_t position = tail_.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        while (true) {
+            slot = &slots_[position & (kCapacity - 1)];
+            const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const int64_t diff = static_cast<int64_t>(sequence - position);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = std::forward<U>(value);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 依次取出已发布的元素（单消费者）；fn 收到可移走的引用
+     * @param max_count 本次最多取出的元素数
+     * @return 取出的元素数
+     */
+    template <typename Fn>
+    size_t Drain(Fn&& fn, size_t max_count = SIZE_MAX) {
+        size_t count = 0;
+        while (count < max_count) {
+            Slot& slot = slots_[head_ & (kCapacity - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != head_ + 1) {
+                break;  // 空，或该位置的生产者尚未发布
+            }
+            fn(slot.value);
+            slot.sequence.store(head_ + kCapacity, std::memory_order_release);
+            head_++;
+            count++;
+        }
+        return count;
+    }
+
+    /**
+     * @brief 是否没有已领取的写位置（消费者调用；生产者可能正在写入尚未发布）
+     */
+    bool IsEmpty() const { return tail_.load(std::memory_order_acquire) == head_; }
+
+    uint64_t GetDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    void ResetDroppedCount() { dropped_.store(0, std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        T value{};
+    };
+
+    Slot slots_[kCapacity];
+    alignas(64) std::atomic<uint64_t> tail_{0};   // 生产者共享的写位置
+    alignas(64) uint64_t head_ = 0;               // 消费者私有的读位置
+    std::atomic<uint64_t> dropped_{0};
+};
+
+} // namespace CinemaProHDR
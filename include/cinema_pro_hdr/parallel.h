@@ -0,0 +1,41 @@
+#pragma once
+
+#include <functional>
+
+namespace CinemaProHDR {
+
+/**
+ * @brief 简单的行级并行工具
+ *
+ * 将 [begin, end) 区间切分为连续块，分发到多个工作线程执行：
+ * - 每个块调用一次 body(block_begin, block_end)
+ * - 调用线程本身也参与计算，返回前等待所有块完成
+ * - 其余块由进程内常驻的工作线程执行（首次需要时创建，按请求的线程数增长），逐帧调用不再创建线程
+ * - 线程数为1或区间过小时直接在调用线程串行执行
+ * - 块内抛出的异常在所有块结束后由调用线程重新抛出
+ *
+ * 用途：逐行/逐像素无依赖的图像内核（LUT应用、逐点变换等）
+ * 不是：通用任务调度器，不支持任务间依赖；块之间不能相互等待（不保证同时运行）
+ */
+namespace Parallel {
+
+    /**
+     * @brief 获取可用的硬件线程数（至少为1）
+     */
+    int HardwareThreads();
+
+    /**
+     * @brief 并行执行区间循环
+     * @param begin 区间起点（包含）
+     * @param end 区间终点（不包含）
+     * @param body 处理函数，参数为块的 [block_begin, block_end)
+     * @param num_threads 线程数（<=0 表示使用硬件线程数）
+     * @param min_block 每块最少元素数，避免过细切分
+     */
+    void ParallelFor(int begin, int end,
+                     const std::function<void(int, int)>& body,
+                     int num_threads = 0,
+                     int min_block = 1);
+}
+
+} // namespace CinemaProHDR
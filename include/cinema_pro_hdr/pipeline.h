@@ -0,0 +1,130 @@
+#pragma once
+
+#include "core.h"
+#include "error_ring.h"
+#include "highlight_detail.h"
+#include "image_planar.h"
+#include "motion_history.h"
+#include "processor.h"
+#include "shot_analyzer.h"
+#include "tone_mapping.h"
+#include <memory>
+
+namespace CinemaProHDR {
+
+/**
+ * @brief 单条处理流的可变状态
+ *
+ * 每个渲染线程（或每条帧序列）持有一份，与共享的 CompiledPipeline 配合使用：
+ * - 工作缓冲跨帧复用
+ * - 帧统计与错误历史只属于本流
+ * - 运动保护所需的前一帧亮度与运动能量历史
+ *
+ * 用途：CompiledPipeline::ProcessFrame 的逐流上下文
+ * 不是：线程安全对象——同一StreamState同一时刻只能被一个线程使用
+ */
+struct StreamState {
+    bool motion_protection = false;  // 按帧间运动能量降低高光细节强度（配置项，Reset不清除）
+
+    Statistics stats;
+    ErrorEventLog errors;  // 有界错误历史（与 CphProcessor 相同，损坏片段逐帧报错也不会增长）
+
+    // 工作缓冲
+    ImagePlanar planar;
+    ImagePlanar scratch;
+
+    // 运动保护历史（色调映射后MaxRGB亮度金字塔与运动能量）及最近一帧的分块运动图
+    MotionHistory motion;
+    MotionMap motion_map;
+
+    // 逐镜头元数据分析（可选，非拥有；统计阶段每帧喂入一次，Reset不清除）
+    ShotAnalyzer* shot_analyzer = nullptr;
+    StatisticsHistogram histogram;  // 喂给分析器的工作直方图（与帧统计同一遍填充，跨帧复用）
+
+    /**
+     * @brief 清除统计、错误与运动历史（保留工作缓冲与配置）
+     */
+    void Reset();
+
+    std::string GetLastError() const;
+
+    /**
+     * @brief 记录错误（同 CphProcessor：message 须为字符串字面量，动态内容放在 detail）
+     */
+    void LogError(ErrorCode code, const char* message, std::string_view detail = {});
+};
+
+/**
+ * @brief 编译后的不可变处理管线
+ *
+ * 由参数一次编译得到：已初始化的色调映射器、各输入色彩空间的渲染计划
+ * （平面布局，源/目标色彩空间相同）与曲线验证结果。编译后所有成员只读：
+ * - 多个渲染线程可以并发调用同一实例的 ProcessFrame，热路径上没有锁
+ * - 可变状态全部放在调用方传入的 StreamState 中
+ *
+ * 用途：OFX等多线程宿主在所有渲染线程间共享一份管线，每线程一个StreamState
+ * 不是：参数可变的处理器——参数变化时重新Compile并替换共享指针
+ */
+class CompiledPipeline {
+public:
+    /**
+     * @brief 编译管线
+     * @param params 处理参数（先校验再钳制到有效范围）
+     * @param errors 校验或初始化失败时的错误
+     * @param usm_options 高光细节USM内核选项（模糊实现与细节提取域，对所有阶段路径生效）
+     * @return 失败时返回nullptr
+     */
+    static std::shared_ptr<const CompiledPipeline> Compile(const CphParams& params,
+                                                           std::vector<ErrorReport>& errors,
+                                                           const UnsharpMaskOptions& usm_options = UnsharpMaskOptions());
+
+    /**
+     * @brief 处理单帧（可并发调用，每个线程使用自己的StreamState）
+     */
+    bool ProcessFrame(const Image& input, Image& output, StreamState& state) const;
+
+    /**
+     * @brief 执行单个平面阶段（STATISTICS除外，统计归调用方所有）
+     * @param detail_scale 高光细节的空间缩放（代理分辨率时<1）
+     * @param motion_map 运动保护的分块运动图（可选，按块降低高光细节强度）
+     * @param error 失败时的错误信息
+     */
+    bool RunStage(RenderStage stage, const RenderPlan& plan, ImagePlanar& planar, ImagePlanar& scratch,
+                  float detail_scale, const MotionMap* motion_map, std::string& error) const;
+
+    /**
+     * @brief 平面色调映射（MaxRGB缩放，同时写出映射后的亮度平面）
+     */
+    void ApplyToneMappingPlanar(ImagePlanar& working_image) const;
+    
+    /**
+     * @brief 对连续的三个平面片段做色调映射（扫描线等行级处理使用）
+     * @param luma 输出映射后的MaxRGB亮度（count个）
+     */
+    void ApplyToneMappingPixels(float* r, float* g, float* b, float* luma, size_t count) const;
+
+    /**
+     * @brief 指定帧色彩空间的渲染计划（源/目标相同，平面布局）
+     */
+    const RenderPlan& GetPlan(ColorSpace cs) const;
+
+    const CphParams& GetParams() const { return params_; }
+    const UnsharpMaskOptions& GetUnsharpMaskOptions() const { return usm_options_; }
+    const ToneMapper& GetToneMapper() const { return tone_mapper_; }
+    bool IsMonotonic() const { return monotonic_; }
+    bool IsC1Continuous() const { return c1_continuous_; }
+
+private:
+    static constexpr int kColorSpaceCount = 4;
+
+    CompiledPipeline() = default;
+
+    CphParams params_;
+    UnsharpMaskOptions usm_options_;
+    ToneMapper tone_mapper_;
+    RenderPlan plans_[kColorSpaceCount];
+    bool monotonic_ = true;
+    bool c1_continuous_ = true;
+};
+
+} // namespace CinemaProHDR
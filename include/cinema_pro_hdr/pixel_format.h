@@ -0,0 +1,96 @@
+#pragma once
+
+#include "core.h"
+#include "image_planar.h"
+#include <cstdint>
+
+namespace CinemaProHDR {
+
+/**
+ * @brief 打包整数像素格式
+ *
+ * 所有格式承载的都是 PQ 编码信号；默认原色为 BT.2020（即工作域信号本身）：
+ * - RGB48：每像素3个16位分量（主机字节序），bit_depth为10/12/16时按LSB对齐；
+ *   也可承载其他原色（color_space），传递函数经精确码值查找表转换
+ * - P010：4:2:0 YCbCr，亮度平面后接CbCr交错平面，10位MSB对齐于16位容器
+ * - V210：4:2:2 YCbCr 10位，每16字节打包6个像素，行跨度按128字节对齐
+ *
+ * YCbCr 使用 BT.2020 非恒定亮度矩阵与窄范围量化（Y 64–940，C 64–960 @10bit）。
+ */
+enum class PixelFormat {
+    RGB48,
+    P010,
+    V210
+};
+
+// 打包像素存储（池化、64字节对齐）
+using PackedBuffer = std::vector<uint8_t, PoolAllocator<uint8_t>>;
+
+/**
+ * @brief 打包整数图像
+ *
+ * 用途：宿主/解码器给出的整数视频帧的零拷贝承载
+ * 不是：处理格式——进入管线时直接解码为工作域平面，输出时再编码回同一格式
+ */
+struct PackedImage {
+    PixelFormat format = PixelFormat::RGB48;
+    int width = 0;
+    int height = 0;
+    int bit_depth = 16;   // RGB48: 10/12/16；P010/V210 固定为10
+    size_t stride = 0;    // 每行字节数（P010为亮度平面行跨度，色度平面相同）
+    ColorSpace color_space = ColorSpace::BT2020_PQ;  // 码值所在原色（YCbCr格式仅限BT2020_PQ；REC709码值与浮点源一样只做归一化）
+    PackedBuffer data;
+
+    PackedImage() = default;
+
+    /**
+     * @brief 按格式分配（最小行跨度，内容清零）
+     * @param bit_depth RGB48的有效位数（<=0时使用格式默认值）
+     */
+    PackedImage(PixelFormat fmt, int w, int h, int bit_depth = 0);
+
+    bool IsValid() const;
+    size_t GetDataSize() const;
+
+    /**
+     * @brief 格式要求的最小行跨度（字节）
+     */
+    static size_t MinStride(PixelFormat format, int width);
+};
+
+/**
+ * @brief 打包格式与工作域之间的解码/编码
+ *
+ * 解码结果为工作域（BT2020_PQ，归一化码值）；BT.2020 PQ信号无需EOTF/OETF，
+ * 仅做归一化与（YCbCr时的）矩阵变换（REC709同浮点路径，只做归一化）；P3/ACEScg原色的RGB48经 ColorSpaceConverter
+ * 的整数码值路径（精确PQ查找表）进出工作域。色度上采样为就近复制，
+ * 编码时色度取2×1（V210）或2×2（P010）块的平均。
+ */
+namespace PixelFormatIO {
+
+    /**
+     * @brief 解码到平面工作缓冲
+     * @return 输入有效时返回true
+     */
+    bool Decode(const PackedImage& input, ImagePlanar& output);
+
+    /**
+     * @brief 解码到交错RGB图像
+     */
+    bool Decode(const PackedImage& input, Image& output);
+
+    /**
+     * @brief 从平面工作缓冲编码
+     * @param output 目标图像（按其format/bit_depth/color_space编码；尺寸不符时重新分配）
+     */
+    bool Encode(const ImagePlanar& input, PackedImage& output);
+
+    /**
+     * @brief 从交错RGB图像编码
+     */
+    bool Encode(const Image& input, PackedImage& output);
+
+    std::string PixelFormatToString(PixelFormat format);
+}
+
+} // namespace CinemaProHDR
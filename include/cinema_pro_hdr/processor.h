@@ -1,9 +1,112 @@
 #pragma once
 
 #include "core.h"
+#include "clip.h"
+#include "error_ring.h"
+#include "half_float.h"
+#include "highlight_detail.h"
+#include "pixel_format.h"
+#include "stage_cache.h"
 
 namespace CinemaProHDR {
 
+struct ImagePlanar;
+class CompiledPipeline;
+class ShotAnalyzer;
+
+/**
+ * @brief 渲染阶段标识
+ *
+ * 对应需求3.1的处理顺序：输入域→工作域→曲线→高光细节→饱和度→输出域
+ */
+enum class RenderStage {
+    TO_WORKING_DOMAIN,    // 输入域→工作域（矩阵+PQ OETF）
+    WORKING_DOMAIN_CLAMP, // 输入已是BT2020_PQ：仅原地NaN保护与[0,1]钳制
+    TONE_MAPPING,         // PPR/RLOG曲线（MaxRGB亮度）
+    HIGHLIGHT_DETAIL,     // 高光细节USM（仅x>p）
+    SATURATION,           // OKLab饱和度+两级色域处理
+    FROM_WORKING_DOMAIN,  // 工作域→输出域（PQ EOTF+矩阵）
+    STATISTICS            // PqEncodedMaxRGB统计
+};
+
+/**
+ * @brief 工作缓冲布局
+ *
+ * 平面布局需要在边界处各做一次交错/平面转换，仅当计划中包含
+ * 高光细节或饱和度这类重负载阶段时才划算。
+ */
+enum class PixelLayout {
+    AUTO,         // 由渲染计划按阶段自动选择
+    INTERLEAVED,  // 交错RGB(A)，直接在输出缓冲上原地处理
+    PLANAR        // 平面SoA（ImagePlanar），边界处转换一次
+};
+
+/**
+ * @brief 处理质量（交互拖动时的代理分辨率）
+ *
+ * 代理模式先做盒式降采样，在代理分辨率下执行全部阶段（USM半径按比例缩小），
+ * 再可选地双线性上采样回原尺寸。与全质量路径共用同一份参数快照：
+ * 切换质量不需要重新Initialize，松开旋钮后切回FULL即可得到全分辨率结果。
+ *
+ * 用途：调色时拖动参数的即时预览（1/2分辨率约4倍、1/4分辨率约16倍像素量缩减）
+ * 不是：最终输出路径——代理帧的统计仅为近似值
+ */
+enum class ProcessingQuality {
+    FULL,         // 全分辨率
+    PROXY_HALF,   // 1/2分辨率（2×2盒式降采样）
+    PROXY_QUARTER // 1/4分辨率（4×4盒式降采样）
+};
+
+/**
+ * @brief 代理质量对应的降采样因子（FULL为1）
+ */
+int ProxyScaleFactor(ProcessingQuality quality);
+
+/**
+ * @brief 渲染计划：按参数与色彩空间裁剪后的最小阶段列表
+ *
+ * 在Initialize时编译，数学上为恒等的阶段不进入列表：
+ * - BT2020_PQ输入：整帧转换退化为原地钳制
+ * - BT2020_PQ输出：所有阶段都保证输出有限且在[0,1]内，回转换为恒等
+ * - sat_base==1 && sat_hi==1 且非DCI模式：饱和度与色域处理为恒等
+ * - highlight_detail==0：跳过USM
+ *
+ * 用途：避免无效整帧遍历与拷贝，并可供调用方检查实际执行路径
+ * 不是：改变处理顺序或算法结果的优化（被裁剪的阶段均为恒等）
+ */
+struct RenderPlan {
+    std::vector<RenderStage> stages;
+    ColorSpace source_cs = ColorSpace::BT2020_PQ;
+    ColorSpace target_cs = ColorSpace::BT2020_PQ;
+    PixelLayout layout = PixelLayout::INTERLEAVED;  // 编译后不会是AUTO
+    
+    /**
+     * @brief 根据参数和源/目标色彩空间编译渲染计划
+     * @param preferred_layout 期望布局（AUTO时按阶段选择）
+     */
+    static RenderPlan Compile(const CphParams& params, ColorSpace source_cs, ColorSpace target_cs,
+                              PixelLayout preferred_layout = PixelLayout::AUTO);
+    
+    bool HasStage(RenderStage stage) const;
+    std::string ToString() const;
+    
+    /**
+     * @brief 区域处理时输入需向外扩展的像素数（邻域阶段的支撑半径；逐像素阶段为0）
+     * @param usm_options 高光细节USM选项（光晕随σ与模糊实现变化）
+     */
+    int HaloRadius(const UnsharpMaskOptions& usm_options = UnsharpMaskOptions()) const;
+};
+
+/**
+ * @brief 获取阶段名称（用于日志与调试输出）
+ */
+std::string RenderStageToString(RenderStage stage);
+
+/**
+ * @brief 阶段失败时记录的错误码（高光细节为 HL_FLICKER，其余为 NAN_INF）
+ */
+ErrorCode RenderStageErrorCode(RenderStage stage);
+
 // Main processor class
 class CphProcessor {
 public:
@@ -17,18 +120,91 @@ public:
     // Frame processing
     bool ProcessFrame(const Image& input, Image& output);
     
+    // Half-float frame processing (decode/encode fused into the layout conversion;
+    // intermediates stay FP32)
+    bool ProcessFrame(const ImageHalf& input, ImageHalf& output);
+    
+    // Packed integer frame processing (RGB48/P010/V210 decoded straight into
+    // working-domain planes; output is encoded in the input's format, bit depth and color space)
+    bool ProcessFrame(const PackedImage& input, PackedImage& output);
+    
+    // Region (render window) processing: input is the full source frame and only the
+    // pixels of output inside rect are written. output must already match the input size,
+    // channel count and color space (PrepareRegionOutput does this once per frame, before
+    // any region call); otherwise ProcessRegion fails without touching it. Neighbourhood
+    // stages read a halo around rect from input, so the result equals the same window of
+    // ProcessFrame. Concurrent calls on one processor are safe for disjoint rects: the only
+    // writes to output are to the pixels inside each rect. Statistics are binned per
+    // region into a fixed-size StatisticsHistogram and committed as one frame by EndFrame()
+    // (memory stays bounded when the host never calls it).
+    void PrepareRegionOutput(const Image& input, Image& output) const;
+    bool ProcessRegion(const Image& input, Image& output, const RenderRect& rect);
+    void EndFrame();
+    
+    // Incremental re-render of a paused frame: frame_id identifies the input content
+    // (the caller changes it whenever the pixels change). Stage outputs are cached per
+    // (frame_id, hash of the parameters each stage depends on), so after Initialize with
+    // only downstream changes (e.g. sat_base/sat_hi) only those stages run again.
+    // Caching is off by default (every processor instance would otherwise hold its own
+    // full-frame checkpoints); hosts opt in with SetStageCacheBudget, e.g.
+    // StageCache::SuggestedMaxBytes(width, height). Without a budget this is plain ProcessFrame.
+    // A checkpoint larger than the whole budget is never cached (counted in StageCacheStats::rejected).
+    bool ProcessFrame(const Image& input, Image& output, uint64_t frame_id);
+    void SetStageCacheBudget(size_t max_bytes);  // 0 disables caching (default)
+    void ClearStageCache();
+    StageCacheStats GetStageCacheStats() const;
+    
+    // Clip processing: frames are read from source in order, processed in parallel at frame
+    // granularity (always full quality, planar layout) and delivered to sink in order.
+    // Statistics are merged per frame in frame order and motion protection uses the previous
+    // frame as an explicit dependency, so results match processing the frames one by one.
+    ClipResult ProcessClip(FrameSource& source, FrameSink& sink, const ClipOptions& options = ClipOptions());
+    
+    // Immutable pipeline compiled at Initialize (nullptr before). It can be shared with other
+    // render threads, each calling CompiledPipeline::ProcessFrame with its own StreamState.
+    std::shared_ptr<const CompiledPipeline> GetCompiledPipeline() const;
+    
+    // Render plan inspection (compiled at Initialize, recompiled on mode/color space change)
+    const RenderPlan& GetRenderPlan() const;
+    
     // Statistics and monitoring
     Statistics GetStatistics() const;
     void ResetStatistics();
     
-    // Error handling
+    // Shot analysis (optional, non-owning; nullptr detaches). Every committed full-quality frame
+    // (ProcessFrame, EndFrame after regions, ProcessClip in frame order) feeds the analyzer a
+    // histogram filled in the same pass as the frame statistics; proxy frames are not fed.
+    // The analyzer callback runs on the committing thread while the statistics lock is held.
+    void SetShotAnalyzer(ShotAnalyzer* analyzer);
+    
+    // Error handling. Errors are recorded lock-free into a fixed-size ring; the history keeps the
+    // most recent ErrorEventLog::kCapacity events and reports are only formatted when requested.
+    // GetLastError always reflects the newest error, even when the ring was full and dropped it.
     std::string GetLastError() const;
     std::vector<ErrorReport> GetErrorHistory() const;
+    ErrorEventCounters GetErrorCounters() const;  // recorded / dropped / evicted events
     void ClearErrors();
     
     // Configuration
     void SetDeterministicMode(bool enabled);
     void SetDCIComplianceMode(bool enabled);
+    void SetPreferredLayout(PixelLayout layout);
+    
+    // Highlight detail USM kernel options (blur method, detail domain and sigma). Applies to every
+    // path: interleaved, planar, region, proxy, clip, the stage cache and pipelines obtained
+    // from GetCompiledPipeline() afterwards (the compiled pipeline is rebuilt when initialized).
+    void SetUnsharpMaskOptions(const UnsharpMaskOptions& options);
+    const UnsharpMaskOptions& GetUnsharpMaskOptions() const;
+    
+    // Proxy quality for interactive scrubbing (applies to ProcessFrame(const Image&)).
+    // With upsample enabled the proxy result is returned at the input size, otherwise
+    // at proxy size. Parameters are shared with the full-quality path.
+    void SetProcessingQuality(ProcessingQuality quality, bool upsample = true);
+    ProcessingQuality GetProcessingQuality() const;
+    
+    // True while the most recent frame was rendered at proxy quality (the host should
+    // switch back to FULL and re-render once interaction ends)
+    bool NeedsFullQualityRender() const;
     
 private:
     struct Impl;
@@ -36,12 +212,21 @@ private:
     
     // Internal processing functions
     bool ProcessFrameInternal(const Image& input, Image& output);
+    void ProcessInterleaved(const Image& input, Image& output);
+    void RunPlanarStages();
+    void RunPlanarStages(const RenderPlan& plan, ImagePlanar& planar, ImagePlanar& scratch,
+                         float detail_scale = 1.0f);
+    void RunPlanarStage(RenderStage stage, const RenderPlan& plan, ImagePlanar& planar, ImagePlanar& scratch,
+                        float detail_scale);
+    void RunInterleavedDetailStage(const RenderPlan& plan, Image& image);
+    bool ProcessProxy(const Image& input, Image& output);
     void UpdateStatistics(const Image& processed_frame);
     void LogError(ErrorCode code, const std::string& message, 
                   const std::string& field = "", float value = 0.0f);
     
     // Tone mapping functions
     void ApplyToneMappingToImage(Image& working_image);
+    void ApplyToneMappingPlanar(ImagePlanar& working_image);
     void ValidateCurveProperties();
     
     // Saturation processing functions
@@ -59,6 +244,12 @@ public:
     // Range validation helpers
     static bool ValidateRange(float value, float min_val, float max_val, 
                              const std::string& param_name, std::vector<ErrorReport>& errors);
+
+private:
+    // Validates every range of one ParamRanges group (reports all failures, not just the first)
+    template <size_t N>
+    static bool ValidateRanges(const CphParams& params, const ParamRange (&ranges)[N],
+                               std::vector<ErrorReport>& errors);
 };
 
 } // namespace CinemaProHDR
\ No newline at end of file
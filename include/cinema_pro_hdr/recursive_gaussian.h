@@ -0,0 +1,59 @@
+#pragma once
+
+#include "image_pool.h"
+
+namespace CinemaProHDR {
+
+/**
+ * @brief 递归高斯模糊（Young–van Vliet 三阶IIR）
+ *
+ * 每个方向先因果、后反因果各递推一次，每像素固定7次乘加，与σ无关：
+ * - 垂直方向按整行递推，行内对x连续访问，编译器可直接向量化
+ * - 水平方向先分块转置成列，复用同一个按行递推的内核，再转置回来
+ * - 边界按钳制（复制边缘像素）处理：因果初值取首样本的稳态响应；
+ *   因果递推越过末端再延拓 kPaddingSigmas×σ 行，反因果从延拓区末端的稳态开始
+ *
+ * 用途：大σ高光细节模糊（直接卷积的代价随半径线性增长）
+ * 不是：小σ的精确替代——σ<kMinSigma时系数失效；硬边缘处与直接卷积的差异
+ *       σ≈1时约为边缘反差的5%，σ≥4时降到2%以下，小半径仍应使用直接卷积核
+ */
+class RecursiveGaussian {
+public:
+    static constexpr float kMinSigma = 0.5f;
+    static constexpr float kPaddingSigmas = 3.0f;  // 末端延拓长度（σ的倍数）
+
+    /**
+     * @brief 按σ计算递推系数（σ低于kMinSigma时钳制到kMinSigma）
+     */
+    explicit RecursiveGaussian(float sigma);
+
+    float GetSigma() const { return sigma_; }
+
+    /**
+     * @brief 模糊单个平面
+     * @param src 输入平面（width×height，行优先）
+     * @param dst 输出平面（可以与src相同）
+     * @param scratch 转置与延拓缓冲（按需扩容，跨调用复用）
+     */
+    void BlurPlane(const float* src, float* dst, int width, int height, ImageBuffer& scratch) const;
+
+private:
+    float sigma_;
+    float b_;        // 输入增益 B
+    float a_[3];     // 反馈系数 b1/b0, b2/b0, b3/b0
+
+    /**
+     * @brief 末端延拓行数（至少覆盖三阶递推的状态）
+     */
+    int GetPadding() const;
+
+    /**
+     * @brief 沿行方向（对每列）做因果+反因果递推
+     * @param src 输入（rows×cols）
+     * @param dst 输出（rows×cols，可与src相同）
+     * @param work (3+GetPadding())×cols 的暂存
+     */
+    void FilterColumns(const float* src, float* dst, int cols, int rows, float* work) const;
+};
+
+} // namespace CinemaProHDR
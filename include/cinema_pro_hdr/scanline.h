@@ -0,0 +1,106 @@
+#pragma once
+
+#include "core.h"
+#include "pipeline.h"
+#include <memory>
+
+namespace CinemaProHDR {
+
+/**
+ * @brief 扫描线处理的行来源
+ *
+ * ReadRow 按行号递增顺序调用，每行恰好一次。实现可以是逐行解码器或分块读取的文件。
+ */
+class ScanlineSource {
+public:
+    virtual ~ScanlineSource() = default;
+
+    /**
+     * @brief 读取一行交错像素
+     * @param y 行号（从0开始）
+     * @param row 输出（width×channels个float）
+     * @return false 表示读取失败，本帧处理随即中止
+     */
+    virtual bool ReadRow(int y, float* row) = 0;
+};
+
+/**
+ * @brief 扫描线处理的行去向
+ *
+ * WriteRow 按行号递增顺序调用；row 指向的缓冲只在调用期间有效。
+ */
+class ScanlineSink {
+public:
+    virtual ~ScanlineSink() = default;
+
+    /**
+     * @brief 写出一行处理结果（通道数与输入相同，额外通道原样保留）
+     * @return false 表示写出失败，本帧处理随即中止
+     */
+    virtual bool WriteRow(int y, const float* row) = 0;
+};
+
+/**
+ * @brief 扫描线帧格式
+ */
+struct ScanlineFormat {
+    int width = 0;
+    int height = 0;
+    int channels = 3;                                // 至少3（RGB在前，其余通道原样保留）
+    ColorSpace color_space = ColorSpace::BT2020_PQ;  // 输入与输出色彩空间（同 CompiledPipeline::GetPlan）
+};
+
+/**
+ * @brief 有界内存的流式扫描线处理
+ *
+ * 行依次进入、离开，整帧从不驻留内存：
+ * - 高光细节之前的阶段（入域、色调映射）逐行执行，随后立即做水平模糊
+ * - 高光细节只需 2×半径+1 行水平模糊结果的滑动窗口，行y在行y+半径进入后即可输出
+ * - 之后的阶段（饱和度、出域、统计）逐行执行后写出
+ * 峰值工作内存为 O(宽度×窗口行数)，与帧高无关，结果与 CompiledPipeline::ProcessFrame 逐位一致
+ * （GaussianMethod::RECURSIVE 除外：流式路径总是用同σ的直接卷积核）；
+ * 统计改用定长直方图（StatisticsHistogram），与整帧统计的差异小于1/kBins。
+ *
+ * 用途：8K及以上分辨率、单节点大量并发流（每流一个实例）
+ * 不是：运动保护的载体——运动估计需要整帧亮度金字塔，StreamState::motion_protection 在此被忽略
+ */
+class ScanlineStream {
+public:
+    explicit ScanlineStream(std::shared_ptr<const CompiledPipeline> pipeline);
+
+    /**
+     * @brief 流式处理一帧
+     * @param state 统计与错误写入其中（与 ProcessFrame 相同的逐流状态）
+     * @return 处理是否成功（来源或去向失败时返回false）
+     */
+    bool ProcessFrame(const ScanlineFormat& format, ScanlineSource& source, ScanlineSink& sink,
+                      StreamState& state);
+
+    /**
+     * @brief 行从进入到离开之间驻留的行数（无高光细节阶段时为1）
+     */
+    int GetWindowRows() const { return input_rows_; }
+
+    /**
+     * @brief 当前分配的工作缓冲字节数（不含统计直方图）
+     */
+    size_t GetWorkingMemoryBytes() const;
+
+private:
+    std::shared_ptr<const CompiledPipeline> pipeline_;
+
+    int width_ = 0;
+    int channels_ = 0;
+    int input_rows_ = 0;  // 输入行与工作行的环形槽位数（半径+1）
+    int blur_rows_ = 0;   // 水平模糊行的环形槽位数（2×半径+1）
+
+    ImageBuffer input_ring_;    // 原始交错输入行（额外通道在输出时带回）
+    ImageBuffer work_ring_[4];  // R、G、B、亮度
+    ImageBuffer blur_ring_[3];  // 水平模糊后的R、G、B（LUMA域只用第0个，存亮度）
+    ImageBuffer row_buffers_;   // 掩码、垂直模糊、输出R/G/B 与交错输出行
+    StatisticsHistogram histogram_;
+
+    void Allocate(const ScanlineFormat& format, int radius);
+};
+
+} // namespace CinemaProHDR
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "core.h"
+#include <functional>
+
+namespace CinemaProHDR {
+
+/**
+ * @brief 单个镜头的 ST 2094-10 元数据记录
+ *
+ * 基础统计（Level 1）取自逐帧 PqEncodedMaxRGB 的1%截尾统计：镜头最小值取各帧最小值的最小，
+ * 最大值取各帧最大值的最大，平均值取各帧平均值的均值。
+ * 映射参数（Level 2 风格的 offset/gain/gamma）把镜头映射到目标显示：
+ *   y = target_min + (target_max - target_min) × clamp(gain × x + offset, 0, 1)^gamma
+ * 其中 x、y 均为PQ码值：gain/offset 把镜头的 [min, max] 归一化，gamma 让镜头平均值落在目标平均值上。
+ * 三者受侧车Schema范围约束（gain≤4、offset≥-1、gamma∈[0.5,2.5]），动态范围很窄或整体很亮的镜头
+ * 不再拉伸到满幅。
+ */
+struct ShotMetadata {
+    uint64_t first_frame = 0;  // 镜头首帧在分析序列中的序号
+    uint64_t frame_count = 0;
+
+    float min_pq = 0.0f;
+    float avg_pq = 0.0f;
+    float max_pq = 0.0f;
+
+    float offset = 0.0f;
+    float gain = 1.0f;
+    float gamma = 1.0f;
+};
+
+/**
+ * @brief 镜头分析配置
+ */
+struct ShotAnalyzerConfig {
+    // 切点判定：相邻帧粗直方图的全变差距离（[0,1]）须同时超过绝对阈值与镜头内平均距离的倍数
+    float cut_threshold = 0.35f;
+    float adaptive_ratio = 3.0f;
+    int min_shot_frames = 6;  // 镜头最短帧数，避免闪光、快速摇镜造成连续误切
+
+    // 目标显示（cd/m²），用于拟合 offset/gain/gamma
+    float target_min_nits = 0.005f;
+    float target_avg_nits = 10.0f;
+    float target_max_nits = 100.0f;
+};
+
+/**
+ * @brief 流式镜头分析器：切点检测 + 逐镜头 ST 2094-10 元数据
+ *
+ * 每帧只消费统计阶段已经生成的定长直方图（StatisticsHistogram），不再访问像素：
+ * - 4096箱直方图折叠成 kDistributionBins 箱的归一化分布，与上一帧比较全变差距离
+ * - 距离超过阈值且镜头已满 min_shot_frames 帧时判定切点，上一镜头的记录随即交给回调
+ * 每帧代价与分辨率无关（O(kBins)），两小时正片（约17万帧）的分析开销在秒级。
+ *
+ * 用途：挂在 StreamState::shot_analyzer 或 CphProcessor::SetShotAnalyzer 上，由各处理路径在统计阶段
+ *       用与帧统计同一遍填充的直方图喂入
+ * 不是：线程安全对象，也不是闪光/溶解检测——渐变转场按距离累积不一定被判为切点
+ */
+class ShotAnalyzer {
+public:
+    static constexpr int kDistributionBins = 64;
+    static constexpr float kMinGamma = 0.5f;
+    static constexpr float kMaxGamma = 2.5f;
+    static constexpr float kMaxGain = 4.0f;
+
+    using ShotCallback = std::function<void(const ShotMetadata&)>;
+
+    explicit ShotAnalyzer(const ShotAnalyzerConfig& config = ShotAnalyzerConfig(), ShotCallback callback = nullptr);
+
+    /**
+     * @brief 设置镜头完成时的回调（记录按镜头顺序交付）
+     */
+    void SetCallback(ShotCallback callback) { callback_ = std::move(callback); }
+
+    /**
+     * @brief 喂入一帧的统计直方图
+     * @return 本帧是否为新镜头的首帧（此时上一镜头的记录已交付）
+     */
+    bool AddFrame(const StatisticsHistogram& histogram);
+
+    /**
+     * @brief 结束序列，交付尚未完成的最后一个镜头
+     * @return 是否交付了记录
+     */
+    bool Flush();
+
+    /**
+     * @brief 清除所有状态（配置与回调保留）
+     */
+    void Reset();
+
+    uint64_t GetFrameCount() const { return frame_index_; }
+    uint64_t GetShotCount() const { return shot_count_; }
+
+    /**
+     * @brief 最近一帧与前一帧的直方图距离（首帧为0）
+     */
+    float GetLastDistance() const { return last_distance_; }
+
+    /**
+     * @brief 按镜头统计拟合 offset/gain/gamma（写入 shot 的映射参数）
+     */
+    void FitToneMapping(ShotMetadata& shot) const;
+
+private:
+    ShotAnalyzerConfig config_;
+    ShotCallback callback_;
+    float target_min_pq_;
+    float target_avg_pq_;
+    float target_max_pq_;
+
+    float previous_[kDistributionBins];
+    bool has_previous_ = false;
+    float last_distance_ = 0.0f;
+    uint64_t frame_index_ = 0;
+    uint64_t shot_count_ = 0;
+
+    // 当前镜头
+    ShotMetadata shot_;
+    uint64_t stats_frames_ = 0;  // 有有效统计的帧数（空帧不计入平均）
+    double avg_sum_ = 0.0;
+    double distance_sum_ = 0.0;
+    uint64_t distance_count_ = 0;
+
+    void CloseShot();
+};
+
+} // namespace CinemaProHDR
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "core.h"
+#include <string>
+#include <vector>
+
+namespace CinemaProHDR {
+
+/**
+ * @brief 侧车JSON校验结果
+ */
+struct SidecarCheckResult {
+    bool valid = false;
+    size_t record_count = 0;            // 已解析的记录数（单记录文档为1）
+    std::vector<ErrorReport> errors;    // 逐字段错误，field_name 为JSON路径（如 segments[3].cph_meta.pivot）
+};
+
+/**
+ * @brief 侧车Schema校验器（cph_json_check 的核心）
+ *
+ * 手写的单遍解析器，只认识侧车Schema：边扫描边校验，不构建DOM，
+ * 键与无转义字符串直接以视图比较，数值用 from_chars 解析（与区域设置无关）。
+ * 接受两种文档：单条记录 {"st2094_10": {...}, "cph_meta": {...}}，
+ * 以及 SidecarWriter 写出的 {"segments": [记录, ...]}。
+ *
+ * 错误码与渲染端一致：
+ * - SCHEMA_MISSING：语法错误、缺少必需字段、未知字段、重复字段、类型/枚举/格式不符
+ * - RANGE_PIVOT：数值越界（与 ParamValidator 相同），cph_meta 范围取自 ParamRanges，
+ *   st2094_10 的 gain/gamma 上下限取自 ShotAnalyzer
+ * - NAN_INF：数值超出浮点表示范围
+ * 语法错误会终止本文档的解析，其余错误逐字段全部报告。
+ *
+ * 用途：交付时批量校验归档中的侧车文件；各函数无共享状态，可在多个线程上并发调用
+ * 不是：通用JSON解析器，也不把侧车内容还原为 CphParams
+ */
+namespace SidecarValidator {
+    /**
+     * @brief 校验内存中的侧车文本
+     */
+    SidecarCheckResult Validate(const char* text, size_t size);
+
+    /**
+     * @brief 读入并校验一个侧车文件（无法读取时报告 SCHEMA_MISSING）
+     */
+    SidecarCheckResult ValidateFile(const std::string& path);
+}
+
+} // namespace CinemaProHDR
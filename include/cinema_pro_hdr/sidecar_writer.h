@@ -0,0 +1,94 @@
+#pragma once
+
+#include "core.h"
+#include "shot_analyzer.h"
+#include <fstream>
+#include <string_view>
+
+namespace CinemaProHDR {
+
+/**
+ * @brief 侧车文件的片段信息
+ */
+struct SidecarClipInfo {
+    std::string clip_guid;              // hash_clip_guid（UUID，8-4-4-4-12 十六进制）
+    int fps = 24;                       // 整数帧率（非丢帧时间码）
+    uint64_t start_frame = 0;           // 序列首帧对应的时间码帧数（如 01:00:00:00@24 为 86400）
+    std::string generator = "CinemaProHDR";  // 最长 kMaxGeneratorLength 字符
+};
+
+/**
+ * @brief 流式侧车JSON写出器
+ *
+ * 文档结构为 {"segments": [记录, ...]}，每条记录占一行且自身符合侧车Schema
+ * （st2094_10 + cph_meta 两个块，cph_meta 带 timecode_inout、hash_clip_guid 与 generator）。
+ * 记录在定长缓冲中格式化后立即追加写出，打开之后的写出路径不做堆分配，
+ * 内存占用与段数无关；Close 写出数组与对象的结尾。
+ *
+ * 用途：挂在 ShotAnalyzer 的回调上，随处理进度逐镜头/逐段写出
+ * 不是：JSON读取或校验器；也不是崩溃安全的——未 Close 的文件缺少结尾
+ */
+class SidecarWriter {
+public:
+    static constexpr size_t kRecordBufferSize = 4096;  // 容纳最长生成器名全部转义后的记录
+    static constexpr size_t kTimecodeLength = 11;  // HH:MM:SS:FF
+    static constexpr size_t kMaxGeneratorLength = 256;
+
+    SidecarWriter() = default;
+    ~SidecarWriter();
+
+    SidecarWriter(const SidecarWriter&) = delete;
+    SidecarWriter& operator=(const SidecarWriter&) = delete;
+
+    /**
+     * @brief 创建文件并写出文档头
+     * @param params 写入每条记录 cph_meta 的调色参数
+     * @return 片段信息不合法或文件无法创建时返回false
+     */
+    bool Open(const std::string& path, const CphParams& params, const SidecarClipInfo& clip);
+
+    /**
+     * @brief 追加一条记录（时间码区间取自 shot 的首帧与帧数，出点含在区间内）
+     */
+    bool WriteRecord(const ShotMetadata& shot);
+
+    /**
+     * @brief 写出文档结尾并关闭文件
+     */
+    bool Close();
+
+    bool IsOpen() const { return file_.is_open(); }
+    uint64_t GetRecordCount() const { return record_count_; }
+    std::string GetLastError() const { return last_error_; }
+
+    /**
+     * @brief 帧数格式化为 HH:MM:SS:FF（写入 kTimecodeLength 个字符，不含结尾0）
+     * @return 帧率非正或超过 24 小时返回false
+     */
+    static bool FormatTimecode(uint64_t frame, int fps, char* out);
+
+    /**
+     * @brief 检查 UUID 文本格式（8-4-4-4-12 十六进制）
+     */
+    static bool IsValidGuid(std::string_view guid);
+
+private:
+    std::ofstream file_;
+    CphParams params_;
+    SidecarClipInfo clip_;
+    uint64_t record_count_ = 0;
+    std::string last_error_;
+
+    // 记录格式化缓冲
+    char buffer_[kRecordBufferSize];
+    size_t length_ = 0;
+
+    void Append(const char* text);
+    void AppendString(const std::string& text);
+    void AppendNumber(float value);
+    void AppendInteger(long long value);
+    void AppendField(const char* name, float value, bool last = false);
+    bool Flush();
+};
+
+} // namespace CinemaProHDR
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "image_planar.h"
+#include <cstdint>
+#include <list>
+
+namespace CinemaProHDR {
+
+enum class RenderStage;
+
+/**
+ * @brief 阶段缓存统计
+ */
+struct StageCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t stores = 0;
+    uint64_t evictions = 0;
+    uint64_t rejected = 0;   // 单项超出预算而未保存的检查点（持续增长说明预算小于一个检查点）
+    size_t entries = 0;
+    size_t cached_bytes = 0;
+};
+
+/**
+ * @brief 阶段输出缓存（按 帧ID × 阶段 × 该阶段依赖参数的哈希 索引）
+ *
+ * 暂停帧调色时，只改动下游参数（如饱和度）不会改变上游阶段的输出，
+ * 命中缓存后只需从检查点继续执行下游阶段：
+ * - 每个(帧, 阶段)最多保留一项，参数变化后新结果覆盖旧结果
+ * - 超出字节预算时按最近最少使用淘汰
+ * - 默认预算为0（禁用）：每个检查点是整帧平面副本，宿主应按实例数量显式开启，
+ *   例如 SetMaxBytes(SuggestedMaxBytes(width, height))
+ * - 单个检查点大于预算时不保存（Store返回false并计入 rejected）：8K下一个检查点约530MB
+ *
+ * 用途：CphProcessor 带帧ID的处理路径的检查点存储
+ * 不是：线程安全的共享缓存——与其所属处理器的逐帧路径一样单线程使用
+ */
+class StageCache {
+public:
+    static constexpr size_t kDefaultMaxBytes = 0;     // 默认禁用
+    static constexpr int kCheckpointsPerFrame = 2;    // 色调映射与高光细节
+
+    /**
+     * @brief 容纳一帧全部检查点的建议预算（每个检查点为RGB与亮度四个float平面）
+     */
+    static size_t SuggestedMaxBytes(int width, int height);
+
+    explicit StageCache(size_t max_bytes = kDefaultMaxBytes) : max_bytes_(max_bytes) {}
+
+    /**
+     * @brief 查找检查点
+     * @return 命中时返回缓存的平面图像（在下一次Store/Clear前有效），否则nullptr
+     */
+    const ImagePlanar* Find(uint64_t frame_id, RenderStage stage, uint64_t param_hash);
+
+    /**
+     * @brief 保存检查点（复制image）
+     * @return 单项超出预算时不保存并返回false
+     */
+    bool Store(uint64_t frame_id, RenderStage stage, uint64_t param_hash, const ImagePlanar& image);
+
+    void InvalidateFrame(uint64_t frame_id);
+    void Clear();
+
+    /**
+     * @brief 设置字节预算（0表示禁用缓存），立即淘汰超出部分
+     */
+    void SetMaxBytes(size_t max_bytes);
+    size_t GetMaxBytes() const { return max_bytes_; }
+    bool IsEnabled() const { return max_bytes_ > 0; }
+
+    StageCacheStats GetStats() const;
+
+private:
+    struct Entry {
+        uint64_t frame_id;
+        RenderStage stage;
+        uint64_t param_hash;
+        size_t bytes;
+        ImagePlanar image;
+    };
+
+    static size_t ImageBytes(const ImagePlanar& image);
+    void EvictToFit(size_t incoming_bytes);
+
+    std::list<Entry> entries_;  // 表头为最近使用
+    size_t max_bytes_;
+    size_t cached_bytes_ = 0;
+    StageCacheStats stats_;
+};
+
+} // namespace CinemaProHDR
@@ -1,6 +1,9 @@
 #include "cinema_pro_hdr/color_space.h"
+#include "cinema_pro_hdr/cpu_dispatch.h"
 #include <cmath>
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 
 namespace CinemaProHDR {
 
@@ -86,8 +89,117 @@ void ColorSpaceConverter::ACEScg_to_BT2020(const float* acesg, float* bt2020) {
     MultiplyMatrix3x3(ACESG_TO_BT2020_MATRIX, acesg, bt2020);
 }
 
+void ColorSpaceConverter::ToWorkingPixel(const float* src_pixel, float* dst_pixel, ColorSpace source_cs) {
+    // 源与目标可以是同一块内存（原地转换）
+    
+    // Validate input pixel
+    if (!NumericalUtils::IsFiniteRGB(src_pixel)) {
+        // Handle NaN/Inf input - set to black
+        dst_pixel[0] = dst_pixel[1] = dst_pixel[2] = 0.0f;
+        return;
+    }
+    
+    // Convert to working domain (BT.2020 + PQ normalized)
+    switch (source_cs) {
+        case ColorSpace::BT2020_PQ:
+            // Already in working domain
+            dst_pixel[0] = src_pixel[0];
+            dst_pixel[1] = src_pixel[1];
+            dst_pixel[2] = src_pixel[2];
+            break;
+            
+        case ColorSpace::P3_D65: {
+            // P3-D65 linear to BT.2020 linear
+            float bt2020_linear[3];
+            P3D65_to_BT2020(src_pixel, bt2020_linear);
+            
+            // Apply PQ OETF to get normalized PQ values
+            PQ_OETF_RGB(bt2020_linear, dst_pixel);
+            break;
+        }
+        
+        case ColorSpace::ACESG: {
+            // ACEScg to BT.2020 linear
+            float bt2020_linear[3];
+            ACEScg_to_BT2020(src_pixel, bt2020_linear);
+            
+            // Apply PQ OETF to get normalized PQ values
+            PQ_OETF_RGB(bt2020_linear, dst_pixel);
+            break;
+        }
+        
+        default:
+            // Fallback: assume already in correct format but validate
+            dst_pixel[0] = src_pixel[0];
+            dst_pixel[1] = src_pixel[1];
+            dst_pixel[2] = src_pixel[2];
+            break;
+    }
+    
+    // Validate output and ensure values are in valid range [0, 1]
+    if (!NumericalUtils::IsFiniteRGB(dst_pixel)) {
+        dst_pixel[0] = dst_pixel[1] = dst_pixel[2] = 0.0f;
+    } else {
+        NumericalUtils::SaturateRGB(dst_pixel);
+    }
+}
+
+void ColorSpaceConverter::FromWorkingPixel(const float* src_pixel, float* dst_pixel, ColorSpace target_cs) {
+    // 源与目标可以是同一块内存（原地转换）
+    
+    // Validate input pixel
+    if (!NumericalUtils::IsFiniteRGB(src_pixel)) {
+        // Handle NaN/Inf input - set to black
+        dst_pixel[0] = dst_pixel[1] = dst_pixel[2] = 0.0f;
+        return;
+    }
+    
+    switch (target_cs) {
+        case ColorSpace::BT2020_PQ:
+            // Already in working domain
+            dst_pixel[0] = src_pixel[0];
+            dst_pixel[1] = src_pixel[1];
+            dst_pixel[2] = src_pixel[2];
+            break;
+            
+        case ColorSpace::P3_D65: {
+            // Apply PQ EOTF first to get linear BT.2020
+            float bt2020_linear[3];
+            PQ_EOTF_RGB(src_pixel, bt2020_linear);
+            
+            // BT.2020 linear to P3-D65 linear
+            BT2020_to_P3D65(bt2020_linear, dst_pixel);
+            break;
+        }
+        
+        case ColorSpace::ACESG: {
+            // Apply PQ EOTF first to get linear BT.2020
+            float bt2020_linear[3];
+            PQ_EOTF_RGB(src_pixel, bt2020_linear);
+            
+            // BT.2020 linear to ACEScg
+            BT2020_to_ACEScg(bt2020_linear, dst_pixel);
+            break;
+        }
+        
+        default:
+            // Fallback: direct copy with validation
+            dst_pixel[0] = src_pixel[0];
+            dst_pixel[1] = src_pixel[1];
+            dst_pixel[2] = src_pixel[2];
+            break;
+    }
+    
+    // Validate output and clamp to target color space gamut
+    if (!NumericalUtils::IsFiniteRGB(dst_pixel)) {
+        dst_pixel[0] = dst_pixel[1] = dst_pixel[2] = 0.0f;
+    } else {
+        ClampToGamut(dst_pixel, target_cs);
+    }
+}
+
 void ColorSpaceConverter::ToWorkingDomain(const Image& input, Image& output) {
-    output = Image(input.width, input.height, input.channels);
+    output = Image(input.width, input.height, input.channels, ImageInit::UNINITIALIZED);
     output.color_space = ColorSpace::BT2020_PQ;
     
     for (int y = 0; y < input.height; ++y) {
@@ -96,55 +208,10 @@ void ColorSpaceConverter::ToWorkingDomain(const Image& input, Image& output) {
             float* dst_pixel = output.GetPixel(x, y);
             
             if (src_pixel && dst_pixel) {
-                // Validate input pixel
-                if (!NumericalUtils::IsFiniteRGB(src_pixel)) {
-                    // Handle NaN/Inf input - set to black
-                    dst_pixel[0] = dst_pixel[1] = dst_pixel[2] = 0.0f;
-                    continue;
-                }
-                
-                // Convert to working domain (BT.2020 + PQ normalized)
-                switch (input.color_space) {
-                    case ColorSpace::BT2020_PQ:
-                        // Already in working domain
-                        dst_pixel[0] = src_pixel[0];
-                        dst_pixel[1] = src_pixel[1];
-                        dst_pixel[2] = src_pixel[2];
-                        break;
-                        
-                    case ColorSpace::P3_D65: {
-                        // P3-D65 linear to BT.2020 linear
-                        float bt2020_linear[3];
-                        P3D65_to_BT2020(src_pixel, bt2020_linear);
-                        
-                        // Apply PQ OETF to get normalized PQ values
-                        PQ_OETF_RGB(bt2020_linear, dst_pixel);
-                        break;
-                    }
-                    
-                    case ColorSpace::ACESG: {
-                        // ACEScg to BT.2020 linear
-                        float bt2020_linear[3];
-                        ACEScg_to_BT2020(src_pixel, bt2020_linear);
-                        
-                        // Apply PQ OETF to get normalized PQ values
-                        PQ_OETF_RGB(bt2020_linear, dst_pixel);
-                        break;
-                    }
-                    
-                    default:
-                        // Fallback: assume already in correct format but validate
-                        dst_pixel[0] = src_pixel[0];
-                        dst_pixel[1] = src_pixel[1];
-                        dst_pixel[2] = src_pixel[2];
-                        break;
-                }
-                
-                // Validate output and ensure values are in valid range [0, 1]
-                if (!NumericalUtils::IsFiniteRGB(dst_pixel)) {
-                    dst_pixel[0] = dst_pixel[1] = dst_pixel[2] = 0.0f;
-                } else {
-                    NumericalUtils::SaturateRGB(dst_pixel);
+                ToWorkingPixel(src_pixel, dst_pixel, input.color_space);
+                // 输出未清零：alpha 及其余通道原样复制
+                for (int c = 3; c < input.channels; ++c) {
+                    dst_pixel[c] = src_pixel[c];
                 }
             }
         }
@@ -152,7 +219,7 @@ void ColorSpaceConverter::ToWorkingDomain(const Image& input, Image& output) {
 }
 
 void ColorSpaceConverter::FromWorkingDomain(const Image& input, Image& output, ColorSpace target_cs) {
-    output = Image(input.width, input.height, input.channels);
+    output = Image(input.width, input.height, input.channels, ImageInit::UNINITIALIZED);
     output.color_space = target_cs;
     
     for (int y = 0; y < input.height; ++y) {
@@ -161,60 +228,138 @@ void ColorSpaceConverter::FromWorkingDomain(const Image& input, Image& output, C
             float* dst_pixel = output.GetPixel(x, y);
             
             if (src_pixel && dst_pixel) {
-                // Validate input pixel
-                if (!NumericalUtils::IsFiniteRGB(src_pixel)) {
-                    // Handle NaN/Inf input - set to black
-                    dst_pixel[0] = dst_pixel[1] = dst_pixel[2] = 0.0f;
-                    continue;
-                }
-                
-                switch (target_cs) {
-                    case ColorSpace::BT2020_PQ:
-                        // Already in working domain
-                        dst_pixel[0] = src_pixel[0];
-                        dst_pixel[1] = src_pixel[1];
-                        dst_pixel[2] = src_pixel[2];
-                        break;
-                        
-                    case ColorSpace::P3_D65: {
-                        // Apply PQ EOTF first to get linear BT.2020
-                        float bt2020_linear[3];
-                        PQ_EOTF_RGB(src_pixel, bt2020_linear);
-                        
-                        // BT.2020 linear to P3-D65 linear
-                        BT2020_to_P3D65(bt2020_linear, dst_pixel);
-                        break;
-                    }
-                    
-                    case ColorSpace::ACESG: {
-                        // Apply PQ EOTF first to get linear BT.2020
-                        float bt2020_linear[3];
-                        PQ_EOTF_RGB(src_pixel, bt2020_linear);
-                        
-                        // BT.2020 linear to ACEScg
-                        BT2020_to_ACEScg(bt2020_linear, dst_pixel);
-                        break;
-                    }
-                    
-                    default:
-                        // Fallback: direct copy with validation
-                        dst_pixel[0] = src_pixel[0];
-                        dst_pixel[1] = src_pixel[1];
-                        dst_pixel[2] = src_pixel[2];
-                        break;
-                }
-                
-                // Validate output and clamp to target color space gamut
-                if (!NumericalUtils::IsFiniteRGB(dst_pixel)) {
-                    dst_pixel[0] = dst_pixel[1] = dst_pixel[2] = 0.0f;
-                } else {
-                    ClampToGamut(dst_pixel, target_cs);
+                FromWorkingPixel(src_pixel, dst_pixel, target_cs);
+                // 输出未清零：alpha 及其余通道原样复制
+                for (int c = 3; c < input.channels; ++c) {
+                    dst_pixel[c] = src_pixel[c];
                 }
             }
         }
     }
 }
 
+void ColorSpaceConverter::ToWorkingDomainInPlace(Image& image) {
+    const ColorSpace source_cs = image.color_space;
+    const size_t pixel_count = static_cast<size_t>(image.width) * image.height;
+    float* data = image.data.data();
+    
+    for (size_t i = 0; i < pixel_count; ++i) {
+        float* pixel = data + i * image.channels;
+        ToWorkingPixel(pixel, pixel, source_cs);
+    }
+    image.color_space = ColorSpace::BT2020_PQ;
+}
+
+void ColorSpaceConverter::FromWorkingDomainInPlace(Image& image, ColorSpace target_cs) {
+    const size_t pixel_count = static_cast<size_t>(image.width) * image.height;
+    float* data = image.data.data();
+    
+    for (size_t i = 0; i < pixel_count; ++i) {
+        float* pixel = data + i * image.channels;
+        FromWorkingPixel(pixel, pixel, target_cs);
+    }
+    image.color_space = target_cs;
+}
+
+namespace {
+
+CPH_KERNEL_INLINE void MatrixPlanarKernelBody(const float* matrix, float* r, float* g, float* b, size_t count) {
+    const float m0 = matrix[0], m1 = matrix[1], m2 = matrix[2];
+    const float m3 = matrix[3], m4 = matrix[4], m5 = matrix[5];
+    const float m6 = matrix[6], m7 = matrix[7], m8 = matrix[8];
+    
+    // 连续平面上的逐元素运算，编译器可直接向量化
+    for (size_t i = 0; i < count; ++i) {
+        float x = r[i], y = g[i], z = b[i];
+        r[i] = m0 * x + m1 * y + m2 * z;
+        g[i] = m3 * x + m4 * y + m5 * z;
+        b[i] = m6 * x + m7 * y + m8 * z;
+    }
+}
+
+CPH_DISPATCH_KERNEL(MatrixPlanarKernel, (const float* matrix, float* r, float* g, float* b, size_t count),
+                    (matrix, r, g, b, count))
+
+} // namespace
+
+void ColorSpaceConverter::MultiplyMatrix3x3Planar(const float* matrix, float* r, float* g, float* b, size_t count) {
+    MatrixPlanarKernel(matrix, r, g, b, count);
+}
+
+void ColorSpaceConverter::ToWorkingPlanar(float* r, float* g, float* b, size_t count, ColorSpace source_cs) {
+    // 与 ToWorkingPixel 逐像素等价：非有限输入置黑，输出钳制到[0,1]
+    for (size_t i = 0; i < count; ++i) {
+        if (!std::isfinite(r[i]) || !std::isfinite(g[i]) || !std::isfinite(b[i])) {
+            r[i] = g[i] = b[i] = 0.0f;
+        }
+    }
+    
+    const float* matrix = nullptr;
+    switch (source_cs) {
+        case ColorSpace::P3_D65: matrix = P3D65_TO_BT2020_MATRIX; break;
+        case ColorSpace::ACESG: matrix = ACESG_TO_BT2020_MATRIX; break;
+        default: break;
+    }
+    
+    if (matrix) {
+        MultiplyMatrix3x3Planar(matrix, r, g, b, count);
+        float* planes[3] = {r, g, b};
+        for (float* plane : planes) {
+            for (size_t i = 0; i < count; ++i) {
+                plane[i] = PQ_OETF(plane[i]);
+            }
+        }
+    }
+    
+    for (size_t i = 0; i < count; ++i) {
+        if (!std::isfinite(r[i]) || !std::isfinite(g[i]) || !std::isfinite(b[i])) {
+            r[i] = g[i] = b[i] = 0.0f;
+        } else {
+            r[i] = std::clamp(r[i], 0.0f, 1.0f);
+            g[i] = std::clamp(g[i], 0.0f, 1.0f);
+            b[i] = std::clamp(b[i], 0.0f, 1.0f);
+        }
+    }
+}
+
+void ColorSpaceConverter::FromWorkingPlanar(float* r, float* g, float* b, size_t count, ColorSpace target_cs) {
+    // 与 FromWorkingPixel 逐像素等价：非有限输入置黑，输出钳制到目标色域
+    for (size_t i = 0; i < count; ++i) {
+        if (!std::isfinite(r[i]) || !std::isfinite(g[i]) || !std::isfinite(b[i])) {
+            r[i] = g[i] = b[i] = 0.0f;
+        }
+    }
+    
+    const float* matrix = nullptr;
+    switch (target_cs) {
+        case ColorSpace::P3_D65: matrix = BT2020_TO_P3D65_MATRIX; break;
+        case ColorSpace::ACESG: matrix = BT2020_TO_ACESG_MATRIX; break;
+        default: break;
+    }
+    
+    if (matrix) {
+        float* planes[3] = {r, g, b};
+        for (float* plane : planes) {
+            for (size_t i = 0; i < count; ++i) {
+                plane[i] = PQ_EOTF(plane[i]);
+            }
+        }
+        MultiplyMatrix3x3Planar(matrix, r, g, b, count);
+    }
+    
+    const float lo = target_cs == ColorSpace::ACESG ? -0.5f : 0.0f;
+    const float hi = target_cs == ColorSpace::ACESG ? 2.0f : 1.0f;
+    for (size_t i = 0; i < count; ++i) {
+        if (!std::isfinite(r[i]) || !std::isfinite(g[i]) || !std::isfinite(b[i])) {
+            r[i] = g[i] = b[i] = 0.0f;
+        } else {
+            r[i] = std::clamp(r[i], lo, hi);
+            g[i] = std::clamp(g[i], lo, hi);
+            b[i] = std::clamp(b[i], lo, hi);
+        }
+    }
+}
+
 bool ColorSpaceConverter::IsValidColorSpace(ColorSpace cs) {
     switch (cs) {
         case ColorSpace::BT2020_PQ:
@@ -432,13 +577,54 @@ float NumericalUtils::ClampToRange(float value, float min_val, float max_val) {
     return std::clamp(value, min_val, max_val);
 }
 
+namespace {
+
+// 非负数立方根：位运算初值（指数除以3）+ 三次牛顿迭代，相对误差约1ulp。
+// 无分支、无库调用，逐像素与平面路径共用同一实现，平面循环可直接向量化
+CPH_KERNEL_INLINE float CubeRootNonNegative(float x) {
+    int32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    bits = bits / 3 + 709921077;
+    float y;
+    std::memcpy(&y, &bits, sizeof(y));
+    for (int i = 0; i < 3; ++i) {
+        y = (2.0f * y + x / (y * y)) * (1.0f / 3.0f);
+    }
+    return x > 0.0f ? y : 0.0f;
+}
+
+CPH_KERNEL_INLINE void CubeRootPlanarKernelBody(float* plane, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        plane[i] = CubeRootNonNegative(std::max(0.0f, plane[i]));
+    }
+}
+
+CPH_KERNEL_INLINE void CubePlanarKernelBody(float* plane, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const float x = plane[i];
+        plane[i] = x * x * x;
+    }
+}
+
+CPH_DISPATCH_KERNEL(CubeRootPlanarKernel, (float* plane, size_t count), (plane, count))
+CPH_DISPATCH_KERNEL(CubePlanarKernel, (float* plane, size_t count), (plane, count))
+
+// 三个平面中任一非有限的像素整体置黑（输出可与输入是同一组平面）
+void CopyFinitePlanar(const float* x, const float* y, const float* z, float* ox, float* oy, float* oz, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const float vx = x[i], vy = y[i], vz = z[i];
+        const bool finite = std::isfinite(vx) && std::isfinite(vy) && std::isfinite(vz);
+        ox[i] = finite ? vx : 0.0f;
+        oy[i] = finite ? vy : 0.0f;
+        oz[i] = finite ? vz : 0.0f;
+    }
+}
+
+} // namespace
+
 // OKLab conversion helper functions
 float ColorSpaceConverter::CubeRoot(float x) {
-    if (x >= 0.0f) {
-        return std::pow(x, 1.0f / 3.0f);
-    } else {
-        return -std::pow(-x, 1.0f / 3.0f);
-    }
+    return x >= 0.0f ? CubeRootNonNegative(x) : -CubeRootNonNegative(-x);
 }
 
 float ColorSpaceConverter::CubePower(float x) {
@@ -584,6 +770,86 @@ void ColorSpaceConverter::ApplySaturation(float* rgb, float sat_base, float sat_
     }
 }
 
+void ColorSpaceConverter::RGB_to_OKLab_Planar(const float* r, const float* g, const float* b,
+                                              float* L, float* a, float* ok_b, size_t count) {
+    // RGB → LMS → LMS'（立方根）→ OKLab，与 RGB_to_OKLab 相同的步骤，每步是一遍整平面运算。
+    // 非有限输入置黑后各步输出为0，与逐像素版本的提前返回等价
+    CopyFinitePlanar(r, g, b, L, a, ok_b, count);
+    MultiplyMatrix3x3Planar(RGB_TO_LMS_MATRIX, L, a, ok_b, count);
+    CubeRootPlanarKernel(L, count);
+    CubeRootPlanarKernel(a, count);
+    CubeRootPlanarKernel(ok_b, count);
+    MultiplyMatrix3x3Planar(LMS_TO_OKLAB_MATRIX, L, a, ok_b, count);
+    CopyFinitePlanar(L, a, ok_b, L, a, ok_b, count);
+}
+
+void ColorSpaceConverter::OKLab_to_RGB_Planar(const float* L, const float* a, const float* ok_b,
+                                              float* r, float* g, float* b, size_t count) {
+    // OKLab → LMS'→ LMS（立方）→ RGB，整平面逐步执行
+    CopyFinitePlanar(L, a, ok_b, r, g, b, count);
+    MultiplyMatrix3x3Planar(OKLAB_TO_LMS_MATRIX, r, g, b, count);
+    CubePlanarKernel(r, count);
+    CubePlanarKernel(g, count);
+    CubePlanarKernel(b, count);
+    MultiplyMatrix3x3Planar(LMS_TO_RGB_MATRIX, r, g, b, count);
+    CopyFinitePlanar(r, g, b, r, g, b, count);
+}
+
+void ColorSpaceConverter::ApplySaturationPlanar(float* r, float* g, float* b, size_t count,
+                                                float sat_base, float sat_hi, float pivot_pq, bool dci_compliance) {
+    // 参数钳制与 ApplySaturation 一致
+    sat_base = std::clamp(sat_base, 0.0f, 2.0f);
+    sat_hi = std::clamp(sat_hi, 0.0f, 2.0f);
+    pivot_pq = std::clamp(pivot_pq, 0.05f, 0.30f);
+    
+    // 分块处理：OKLab中间值与高光权重留在栈上的小块缓冲中
+    constexpr size_t kChunk = 256;
+    float ok_l[kChunk], ok_a[kChunk], ok_b[kChunk], w_hi[kChunk];
+    
+    for (size_t begin = 0; begin < count; begin += kChunk) {
+        const size_t n = std::min(kChunk, count - begin);
+        float* cr = r + begin;
+        float* cg = g + begin;
+        float* cb = b + begin;
+        
+        for (size_t i = 0; i < n; ++i) {
+            if (!std::isfinite(cr[i]) || !std::isfinite(cg[i]) || !std::isfinite(cb[i])) {
+                cr[i] = cg[i] = cb[i] = 0.0f;
+            }
+            float x_luminance = std::clamp(std::max(cr[i], std::max(cg[i], cb[i])), 0.0f, 1.0f);
+            w_hi[i] = NumericalUtils::SmoothStep(pivot_pq, 1.0f, x_luminance);
+        }
+        
+        RGB_to_OKLab_Planar(cr, cg, cb, ok_l, ok_a, ok_b, n);
+        
+        // 基础饱和度（全局）+ 高光饱和度（按权重混合）
+        for (size_t i = 0; i < n; ++i) {
+            float a = ok_a[i] * sat_base;
+            float bb = ok_b[i] * sat_base;
+            ok_a[i] = NumericalUtils::Mix(a, a * sat_hi, w_hi[i]);
+            ok_b[i] = NumericalUtils::Mix(bb, bb * sat_hi, w_hi[i]);
+        }
+        
+        OKLab_to_RGB_Planar(ok_l, ok_a, ok_b, cr, cg, cb, n);
+        
+        // 两级色域处理：色域内且非DCI模式时为恒等，仅越界像素走逐像素路径
+        for (size_t i = 0; i < n; ++i) {
+            bool in_gamut = cr[i] >= 0.0f && cr[i] <= 1.0f &&
+                            cg[i] >= 0.0f && cg[i] <= 1.0f &&
+                            cb[i] >= 0.0f && cb[i] <= 1.0f;
+            if (in_gamut && !dci_compliance) {
+                continue;
+            }
+            
+            float rgb[3] = {cr[i], cg[i], cb[i]};
+            ApplyGamutProcessing(rgb, ColorSpace::BT2020_PQ, dci_compliance);
+            cr[i] = std::clamp(rgb[0], 0.0f, 1.0f);
+            cg[i] = std::clamp(rgb[1], 0.0f, 1.0f);
+            cb[i] = std::clamp(rgb[2], 0.0f, 1.0f);
+        }
+    }
+}
+
 // 线性色域压制（第一级处理）
 void ColorSpaceConverter::LinearGamutCompression(float* rgb, ColorSpace target_cs) {
     // 验证输入
@@ -0,0 +1,242 @@
+#include "cinema_pro_hdr/pipeline.h"
+#include "cinema_pro_hdr/color_space.h"
+#include "cinema_pro_hdr/cpu_dispatch.h"
+#include "cinema_pro_hdr/highlight_detail.h"
+#include <algorithm>
+#include <cmath>
+
+namespace CinemaProHDR {
+
+namespace {
+
+// 色调映射前后的逐元素循环（曲线本身逐样本求值，不在此列）
+CPH_KERNEL_INLINE void CollectMaxRGBKernelBody(float* r, float* g, float* b, float* max_rgb, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        // NaN/Inf保护：设置为安全值
+        if (!std::isfinite(r[i]) || !std::isfinite(g[i]) || !std::isfinite(b[i])) {
+            r[i] = g[i] = b[i] = 0.0f;
+        }
+        max_rgb[i] = std::max(r[i], std::max(g[i], b[i]));
+    }
+}
+
+CPH_KERNEL_INLINE void ApplyToneScaleKernelBody(float* r, float* g, float* b, float* luma, const float* max_rgb,
+                                                const float* mapped, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (max_rgb[i] > 0.0f) {
+            float scale_factor = mapped[i] / max_rgb[i];
+            r[i] = std::clamp(r[i] * scale_factor, 0.0f, 1.0f);
+            g[i] = std::clamp(g[i] * scale_factor, 0.0f, 1.0f);
+            b[i] = std::clamp(b[i] * scale_factor, 0.0f, 1.0f);
+        }
+        luma[i] = std::max(r[i], std::max(g[i], b[i]));
+    }
+}
+
+CPH_DISPATCH_KERNEL(CollectMaxRGBKernel, (float* r, float* g, float* b, float* max_rgb, size_t count),
+                    (r, g, b, max_rgb, count))
+
+CPH_DISPATCH_KERNEL(ApplyToneScaleKernel,
+                    (float* r, float* g, float* b, float* luma, const float* max_rgb, const float* mapped,
+                     size_t count),
+                    (r, g, b, luma, max_rgb, mapped, count))
+
+} // namespace
+
+// ============================================================================
+// StreamState
+// ============================================================================
+
+void StreamState::Reset() {
+    stats = Statistics();
+    errors.Clear();
+    motion.Clear();
+}
+
+std::string StreamState::GetLastError() const {
+    return errors.GetLastError();
+}
+
+void StreamState::LogError(ErrorCode code, const char* message, std::string_view detail) {
+    errors.Record(code, message, detail);
+}
+
+// ============================================================================
+// CompiledPipeline
+// ============================================================================
+
+std::shared_ptr<const CompiledPipeline> CompiledPipeline::Compile(const CphParams& params,
+                                                                  std::vector<ErrorReport>& errors,
+                                                                  const UnsharpMaskOptions& usm_options) {
+    if (!ParamValidator::ValidateCphParams(params, errors)) {
+        return nullptr;
+    }
+
+    std::shared_ptr<CompiledPipeline> pipeline(new CompiledPipeline());
+    pipeline->params_ = params;
+    pipeline->params_.ClampToValidRange();
+    pipeline->usm_options_ = usm_options;
+
+    if (!pipeline->tone_mapper_.Initialize(pipeline->params_)) {
+        errors.emplace_back(ErrorCode::SCHEMA_MISSING,
+                            "Failed to initialize tone mapper: " + pipeline->tone_mapper_.GetLastError());
+        return nullptr;
+    }
+
+    for (int i = 0; i < kColorSpaceCount; ++i) {
+        ColorSpace cs = static_cast<ColorSpace>(i);
+        pipeline->plans_[i] = RenderPlan::Compile(pipeline->params_, cs, cs, PixelLayout::PLANAR);
+    }
+
+    // 曲线性质只取决于参数，编译时验证一次
+    pipeline->monotonic_ = pipeline->tone_mapper_.ValidateMonotonicity();
+    pipeline->c1_continuous_ = pipeline->tone_mapper_.ValidateC1Continuity();
+
+    return pipeline;
+}
+
+const RenderPlan& CompiledPipeline::GetPlan(ColorSpace cs) const {
+    int index = static_cast<int>(cs);
+    return plans_[(index >= 0 && index < kColorSpaceCount) ? index : 0];
+}
+
+bool CompiledPipeline::ProcessFrame(const Image& input, Image& output, StreamState& state) const {
+    if (!input.IsValid()) {
+        state.LogError(ErrorCode::NAN_INF, "Invalid input image");
+        return false;
+    }
+
+    try {
+        const RenderPlan& plan = GetPlan(input.color_space);
+        ImagePlanar& planar = state.planar;
+        PlanarLayout::Deinterleave(input, planar);
+
+        for (RenderStage stage : plan.stages) {
+            if (stage == RenderStage::STATISTICS) {
+                StatisticsAccumulator accumulator;
+                accumulator.Reserve(planar.GetPixelCount());
+                if (state.shot_analyzer) {
+                    // 镜头分析的直方图与精确统计在同一遍读取中填充
+                    state.histogram.Clear();
+                    state.histogram.AddPixels(planar.Plane(0), planar.Plane(1), planar.Plane(2),
+                                              planar.GetPixelCount(), &accumulator);
+                    state.shot_analyzer->AddFrame(state.histogram);
+                } else {
+                    accumulator.AddPixels(planar.Plane(0), planar.Plane(1), planar.Plane(2), planar.GetPixelCount());
+                }
+                accumulator.Finalize(state.stats.pq_stats);
+                state.stats.frame_count++;
+                state.stats.timestamp = std::chrono::system_clock::now();
+                state.stats.monotonic = monotonic_;
+                state.stats.c1_continuous = c1_continuous_;
+                continue;
+            }
+
+            const MotionMap* motion_map = nullptr;
+            if (stage == RenderStage::HIGHLIGHT_DETAIL && state.motion_protection) {
+                // 前一帧亮度来自本流的历史，不同流之间互不影响
+                if (!planar.HasLuma()) {
+                    planar.ComputeLuma();
+                }
+                motion_map = HighlightDetailProcessor::UpdateMotionProtection(
+                    state.motion, planar.luma.data(), planar.width, planar.height, params_.pivot_pq, state.motion_map);
+            }
+
+            std::string error;
+            if (!RunStage(stage, plan, planar, state.scratch, 1.0f, motion_map, error)) {
+                state.LogError(RenderStageErrorCode(stage), "Render stage failed", RenderStageToString(stage) + ": " + error);
+            }
+        }
+
+        PlanarLayout::Interleave(planar, output, &input);
+        output.color_space = plan.target_cs;
+        return true;
+    }
+    catch (const std::exception& e) {
+        state.LogError(ErrorCode::NAN_INF, "Processing exception", e.what());
+        return false;
+    }
+}
+
+bool CompiledPipeline::RunStage(RenderStage stage, const RenderPlan& plan, ImagePlanar& planar, ImagePlanar& scratch,
+                                float detail_scale, const MotionMap* motion_map, std::string& error) const {
+    const size_t count = planar.GetPixelCount();
+
+    switch (stage) {
+        case RenderStage::TO_WORKING_DOMAIN:
+        case RenderStage::WORKING_DOMAIN_CLAMP:
+            ColorSpaceConverter::ToWorkingPlanar(planar.Plane(0), planar.Plane(1), planar.Plane(2),
+                                                 count, plan.source_cs);
+            planar.color_space = ColorSpace::BT2020_PQ;
+            break;
+
+        case RenderStage::TONE_MAPPING:
+            // 同时生成MaxRGB亮度平面，供高光掩码复用
+            ApplyToneMappingPlanar(planar);
+            break;
+
+        case RenderStage::HIGHLIGHT_DETAIL: {
+            if (!planar.IsValid()) {
+                error = "Highlight detail processing failed: invalid input";
+                return false;
+            }
+            if (params_.highlight_detail <= 0.0f) {
+                planar.DropLuma();
+                break;
+            }
+            HighlightDetailProcessor::UnsharpMaskPlanar(planar, scratch, params_.pivot_pq, params_.highlight_detail,
+                                                        detail_scale, motion_map, usm_options_);
+            std::swap(planar, scratch);
+            break;
+        }
+
+        case RenderStage::SATURATION:
+            ColorSpaceConverter::ApplySaturationPlanar(planar.Plane(0), planar.Plane(1), planar.Plane(2), count,
+                                                       params_.sat_base, params_.sat_hi, params_.pivot_pq,
+                                                       params_.dci_compliance);
+            planar.DropLuma();
+            break;
+
+        case RenderStage::FROM_WORKING_DOMAIN:
+            ColorSpaceConverter::FromWorkingPlanar(planar.Plane(0), planar.Plane(1), planar.Plane(2),
+                                                   count, plan.target_cs);
+            planar.color_space = plan.target_cs;
+            planar.DropLuma();
+            break;
+
+        case RenderStage::STATISTICS:
+            // 统计属于调用方（处理器或StreamState）
+            break;
+    }
+    return true;
+}
+
+void CompiledPipeline::ApplyToneMappingPlanar(ImagePlanar& working_image) const {
+    const size_t count = working_image.GetPixelCount();
+    if (working_image.luma.size() != count) {
+        working_image.luma = ImageBuffer(count);
+    }
+    ApplyToneMappingPixels(working_image.Plane(0), working_image.Plane(1), working_image.Plane(2),
+                           working_image.luma.data(), count);
+}
+
+void CompiledPipeline::ApplyToneMappingPixels(float* r, float* g, float* b, float* luma, size_t count) const {
+    /**
+     * 逐像素色调映射的平面版本：
+     * MaxRGB按块收集后批量求曲线，再按比例缩放三个平面，
+     * 顺带写出缩放后的MaxRGB亮度平面
+     */
+
+    constexpr size_t kChunk = 256;
+    float max_rgb[kChunk];
+    float mapped[kChunk];
+
+    for (size_t begin = 0; begin < count; begin += kChunk) {
+        const size_t n = std::min(kChunk, count - begin);
+        CollectMaxRGBKernel(r + begin, g + begin, b + begin, max_rgb, n);
+        tone_mapper_.ApplyToneMappingBatch(max_rgb, mapped, n);
+        ApplyToneScaleKernel(r + begin, g + begin, b + begin, luma + begin, max_rgb, mapped, n);
+    }
+}
+
+} // namespace CinemaProHDR
@@ -1,88 +1,435 @@
 #include "cinema_pro_hdr/processor.h"
+#include "cinema_pro_hdr/pipeline.h"
 #include "cinema_pro_hdr/color_space.h"
 #include "cinema_pro_hdr/tone_mapping.h"
 #include "cinema_pro_hdr/highlight_detail.h"
+#include "cinema_pro_hdr/image_planar.h"
+#include "cinema_pro_hdr/parallel.h"
+#include "cinema_pro_hdr/shot_analyzer.h"
 #include <vector>
 #include <mutex>
 #include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <cstring>
+#include <condition_variable>
+#include <atomic>
+#include <map>
+#include <optional>
+#include <thread>
 
 namespace CinemaProHDR {
 
+// ============================================================================
+// RenderPlan Implementation
+// ============================================================================
+
+RenderPlan RenderPlan::Compile(const CphParams& params, ColorSpace source_cs, ColorSpace target_cs,
+                               PixelLayout preferred_layout) {
+    RenderPlan plan;
+    plan.source_cs = source_cs;
+    plan.target_cs = target_cs;
+    
+    // 输入域→工作域：BT2020_PQ输入只需原地NaN保护与钳制
+    plan.stages.push_back(source_cs == ColorSpace::BT2020_PQ ? 
+                          RenderStage::WORKING_DOMAIN_CLAMP : RenderStage::TO_WORKING_DOMAIN);
+    
+    // 色调映射总是生效（toe/软膝不是恒等）
+    plan.stages.push_back(RenderStage::TONE_MAPPING);
+    
+    if (params.highlight_detail > 0.0f) {
+        plan.stages.push_back(RenderStage::HIGHLIGHT_DETAIL);
+    }
+    
+    // sat_base==sat_hi==1时OKLab往返与色域处理对[0,1]内的值为恒等；
+    // DCI模式下二级感知夹持总是执行，不能裁剪
+    bool saturation_identity = params.sat_base == 1.0f && params.sat_hi == 1.0f && !params.dci_compliance;
+    if (!saturation_identity) {
+        plan.stages.push_back(RenderStage::SATURATION);
+    }
+    
+    // 前序阶段均保证输出有限且在[0,1]内，BT2020_PQ输出无需再转换
+    if (target_cs != ColorSpace::BT2020_PQ) {
+        plan.stages.push_back(RenderStage::FROM_WORKING_DOMAIN);
+    }
+    
+    plan.stages.push_back(RenderStage::STATISTICS);
+    
+    // 平面布局的两次边界转换只有在重负载阶段存在时才能摊销
+    if (preferred_layout == PixelLayout::AUTO) {
+        bool heavy = plan.HasStage(RenderStage::HIGHLIGHT_DETAIL) || plan.HasStage(RenderStage::SATURATION);
+        plan.layout = heavy ? PixelLayout::PLANAR : PixelLayout::INTERLEAVED;
+    } else {
+        plan.layout = preferred_layout;
+    }
+    return plan;
+}
+
+bool RenderPlan::HasStage(RenderStage stage) const {
+    return std::find(stages.begin(), stages.end(), stage) != stages.end();
+}
+
+std::string RenderPlan::ToString() const {
+    std::ostringstream oss;
+    oss << ColorSpaceConverter::ColorSpaceToString(source_cs) << " -> "
+        << ColorSpaceConverter::ColorSpaceToString(target_cs) << ": ";
+    for (size_t i = 0; i < stages.size(); ++i) {
+        if (i > 0) oss << " -> ";
+        oss << RenderStageToString(stages[i]);
+    }
+    oss << (layout == PixelLayout::PLANAR ? " [planar]" : " [interleaved]");
+    return oss.str();
+}
+
+int ProxyScaleFactor(ProcessingQuality quality) {
+    switch (quality) {
+        case ProcessingQuality::PROXY_HALF: return 2;
+        case ProcessingQuality::PROXY_QUARTER: return 4;
+        default: return 1;
+    }
+}
+
+int RenderPlan::HaloRadius(const UnsharpMaskOptions& usm_options) const {
+    // 仅USM读取邻域像素；其余阶段均为逐像素运算
+    return HasStage(RenderStage::HIGHLIGHT_DETAIL) ? HighlightDetailProcessor::USMHaloRadius(usm_options) : 0;
+}
+
+std::string RenderStageToString(RenderStage stage) {
+    switch (stage) {
+        case RenderStage::TO_WORKING_DOMAIN: return "ToWorkingDomain";
+        case RenderStage::WORKING_DOMAIN_CLAMP: return "WorkingDomainClamp";
+        case RenderStage::TONE_MAPPING: return "ToneMapping";
+        case RenderStage::HIGHLIGHT_DETAIL: return "HighlightDetail";
+        case RenderStage::SATURATION: return "Saturation";
+        case RenderStage::FROM_WORKING_DOMAIN: return "FromWorkingDomain";
+        case RenderStage::STATISTICS: return "Statistics";
+        default: return "Unknown";
+    }
+}
+
+ErrorCode RenderStageErrorCode(RenderStage stage) {
+    return stage == RenderStage::HIGHLIGHT_DETAIL ? ErrorCode::HL_FLICKER : ErrorCode::NAN_INF;
+}
+
+// ============================================================================
+// Proxy resampling
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief factor×factor 盒式降采样到平面缓冲（帧边缘不完整的块按实际像素数平均）
+ * @param extra 额外通道（Alpha等）的交错降采样结果，可为nullptr
+ */
+void BoxDownsample(const Image& input, int factor, ImagePlanar& output, ImageBuffer* extra) {
+    const int pw = (input.width + factor - 1) / factor;
+    const int ph = (input.height + factor - 1) / factor;
+    const int channels = input.channels;
+    const int extra_channels = channels - 3;
+    
+    if (output.width != pw || output.height != ph || output.planes[0].size() != output.GetPixelCount()) {
+        output = ImagePlanar(pw, ph, ImageInit::UNINITIALIZED);
+    }
+    output.color_space = input.color_space;
+    output.DropLuma();
+    if (extra) {
+        extra->resize(static_cast<size_t>(pw) * ph * std::max(extra_channels, 0));
+    }
+    
+    std::vector<float> sums(static_cast<size_t>(pw) * channels);
+    for (int py = 0; py < ph; ++py) {
+        const int y0 = py * factor;
+        const int y1 = std::min(y0 + factor, input.height);
+        std::fill(sums.begin(), sums.end(), 0.0f);
+
+        // 先按行累加整块，再逐块归一化：每个输入样本只读取一次
+        for (int y = y0; y < y1; ++y) {
+            const float* row = input.data.data() + static_cast<size_t>(y) * input.width * channels;
+            for (int px = 0; px < pw; ++px) {
+                float* sum = sums.data() + static_cast<size_t>(px) * channels;
+                const int x_end = std::min((px + 1) * factor, input.width);
+                for (int x = px * factor; x < x_end; ++x) {
+                    const float* pixel = row + static_cast<size_t>(x) * channels;
+                    for (int c = 0; c < channels; ++c) {
+                        sum[c] += pixel[c];
+                    }
+                }
+            }
+        }
+
+        for (int px = 0; px < pw; ++px) {
+            const int block_w = std::min(factor, input.width - px * factor);
+            const float inv_count = 1.0f / static_cast<float>(block_w * (y1 - y0));
+            const float* sum = sums.data() + static_cast<size_t>(px) * channels;
+            const size_t i = static_cast<size_t>(py) * pw + px;
+            output.Plane(0)[i] = sum[0] * inv_count;
+            output.Plane(1)[i] = sum[1] * inv_count;
+            output.Plane(2)[i] = sum[2] * inv_count;
+            for (int c = 0; extra && c < extra_channels; ++c) {
+                (*extra)[i * extra_channels + c] = sum[3 + c] * inv_count;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 平面代理结果双线性上采样到全尺寸交错输出（像素中心对齐，边缘钳制）
+ * @param passthrough 额外通道来源（全分辨率输入）
+ */
+void BilinearUpsample(const ImagePlanar& input, int factor, const Image& passthrough, Image& output) {
+    const int width = passthrough.width;
+    const int height = passthrough.height;
+    const int channels = passthrough.channels;
+    
+    if (output.width != width || output.height != height || output.channels != channels ||
+        output.data.size() != passthrough.GetDataSize()) {
+        output = Image(width, height, channels, ImageInit::UNINITIALIZED);
+    }
+    
+    const float inv_factor = 1.0f / static_cast<float>(factor);
+    auto sample_position = [inv_factor](int i, int limit, int& i0, int& i1, float& t) {
+        float pos = std::max((i + 0.5f) * inv_factor - 0.5f, 0.0f);
+        i0 = std::min(static_cast<int>(pos), limit - 1);
+        i1 = std::min(i0 + 1, limit - 1);
+        t = pos - static_cast<float>(i0);
+    };
+    
+    std::vector<int> x0s(width), x1s(width);
+    std::vector<float> txs(width);
+    for (int x = 0; x < width; ++x) {
+        sample_position(x, input.width, x0s[x], x1s[x], txs[x]);
+    }
+    
+    for (int y = 0; y < height; ++y) {
+        int y0, y1;
+        float ty;
+        sample_position(y, input.height, y0, y1, ty);
+
+        float* dst = output.data.data() + static_cast<size_t>(y) * width * channels;
+        const float* src = passthrough.data.data() + static_cast<size_t>(y) * width * channels;
+        for (int c = 0; c < 3; ++c) {
+            const float* top = input.Plane(c) + static_cast<size_t>(y0) * input.width;
+            const float* bottom = input.Plane(c) + static_cast<size_t>(y1) * input.width;
+            for (int x = 0; x < width; ++x) {
+                float a = top[x0s[x]] + (top[x1s[x]] - top[x0s[x]]) * txs[x];
+                float b = bottom[x0s[x]] + (bottom[x1s[x]] - bottom[x0s[x]]) * txs[x];
+                dst[static_cast<size_t>(x) * channels + c] = a + (b - a) * ty;
+            }
+        }
+        for (int x = 0; x < width; ++x) {
+            for (int c = 3; c < channels; ++c) {
+                dst[static_cast<size_t>(x) * channels + c] = src[static_cast<size_t>(x) * channels + c];
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Stage dependency hashes (stage cache keys)
+// ============================================================================
+
+// FNV-1a，逐字段混入（浮点按位模式，-0/+0视为不同不影响正确性）
+class ParamHasher {
+public:
+    template <typename T>
+    ParamHasher& Add(const T& value) {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        for (unsigned char byte : bytes) {
+            hash_ = (hash_ ^ byte) * 1099511628211ull;
+        }
+        return *this;
+    }
+    uint64_t Value() const { return hash_; }
+    
+private:
+    uint64_t hash_ = 14695981039346656037ull;
+};
+
+/**
+ * @brief 检查点阶段输出所依赖参数的哈希（含上游阶段的全部依赖）
+ * @return 非检查点阶段返回0
+ */
+uint64_t StageDependencyHash(RenderStage stage, const CphParams& params, const RenderPlan& plan,
+                             const UnsharpMaskOptions& usm_options) {
+    ParamHasher hasher;
+    hasher.Add(static_cast<int>(plan.source_cs));
+    
+    // 色调映射：曲线与软膝/toe参数
+    hasher.Add(static_cast<int>(params.curve)).Add(params.pivot_pq)
+          .Add(params.gamma_s).Add(params.gamma_h).Add(params.shoulder_h).Add(params.black_lift)
+          .Add(params.rlog_a).Add(params.rlog_b).Add(params.rlog_c).Add(params.rlog_t)
+          .Add(params.yknee).Add(params.alpha).Add(params.toe);
+    if (stage == RenderStage::TONE_MAPPING) {
+        return hasher.Value();
+    }
+    
+    // 高光细节：再加上强度与USM内核选项
+    hasher.Add(params.highlight_detail)
+          .Add(static_cast<int>(usm_options.gaussian_method)).Add(static_cast<int>(usm_options.detail_domain))
+          .Add(usm_options.sigma);
+    if (stage == RenderStage::HIGHLIGHT_DETAIL) {
+        return hasher.Value();
+    }
+    
+    return 0;
+}
+
+bool IsCacheCheckpoint(RenderStage stage) {
+    return stage == RenderStage::TONE_MAPPING || stage == RenderStage::HIGHLIGHT_DETAIL;
+}
+
+// ============================================================================
+// Clip scheduling (frame-level parallelism)
+// ============================================================================
+
+/**
+ * @brief 片段处理的调度状态（除标注外均由mutex保护）
+ *
+ * 帧间依赖按帧序号显式记录，工作线程之间不共享可变的处理状态：
+ * - motion[i]：帧i之后的运动历史（降采样亮度与能量），由帧i+1接管
+ * - pending[i]：已处理、等待按序写出的帧及其统计样本
+ */
+struct ClipSchedule {
+    struct MotionState {
+        MotionHistory history;
+    };
+    
+    struct PendingFrame {
+        Image output;
+        StatisticsAccumulator stats;
+        std::optional<StatisticsHistogram> histogram;  // 挂有镜头分析器时与stats同一遍填充
+    };
+    
+    std::mutex mutex;
+    std::condition_variable cv;
+    int max_in_flight = 1;
+    int in_flight = 0;
+    int64_t next_write = 0;
+    int64_t frames_written = 0;
+    bool writing = false;
+    // 在mutex下写入（与cv配合），读帧时在source_mutex下读取，故为原子量
+    std::atomic<bool> end_of_clip{false};
+    bool aborted = false;
+    std::map<int64_t, MotionState> motion;
+    std::map<int64_t, PendingFrame> pending;
+    
+    // 帧来源串行读取（source_mutex保护）
+    std::mutex source_mutex;
+    int64_t next_read = 0;
+    
+    void Abort() {
+        std::lock_guard<std::mutex> lock(mutex);
+        aborted = true;
+        cv.notify_all();
+    }
+};
+
+} // namespace
+
+// ============================================================================
+// CphProcessor Implementation
+// ============================================================================
+
 // Implementation details (PIMPL pattern)
 struct CphProcessor::Impl {
     CphParams current_params;
     Statistics current_stats;
-    std::vector<ErrorReport> error_history;
-    std::string last_error;
+    ErrorEventLog errors;  // 有界错误历史（渲染线程无锁记录）
     std::mutex stats_mutex;
-    std::mutex error_mutex;
     bool initialized = false;
     
-    // 色调映射器
-    ToneMapper tone_mapper;
+    // 高光细节USM选项（Initialize前也可设置，编译管线时下发）
+    UnsharpMaskOptions usm_options;
     
-    // 高光细节处理器
-    HighlightDetailProcessor highlight_processor;
+    // 不可变的编译管线（Initialize时编译）：色调映射器与各阶段内核的唯一来源，可与其他线程共享
+    std::shared_ptr<const CompiledPipeline> pipeline;
     
-    void LogError(ErrorCode code, const std::string& message, 
-                  const std::string& field = "", float value = 0.0f) {
-        std::lock_guard<std::mutex> lock(error_mutex);
-        ErrorReport error(code, message);
-        error.field_name = field;
-        error.invalid_value = value;
-        error_history.push_back(error);
-        last_error = error.ToString();
+    // 渲染计划（Initialize时编译）
+    RenderPlan plan;
+    PixelLayout preferred_layout = PixelLayout::AUTO;
+    
+    // 平面工作缓冲（跨帧复用）
+    ImagePlanar planar;
+    ImagePlanar planar_scratch;
+    Image half_scratch;  // 交错布局下半精度帧的FP32工作缓冲
+    
+    // 区域处理累计的统计直方图（stats_mutex保护，EndFrame时提交为帧统计）；
+    // 定长内存，宿主不调用 EndFrame（如OFX无帧结束回调）时也不会增长
+    StatisticsHistogram region_stats;
+    
+    // 镜头分析器（非拥有，可选）与逐帧路径喂给它的工作直方图
+    ShotAnalyzer* shot_analyzer = nullptr;
+    StatisticsHistogram frame_histogram;
+    
+    // 代理质量（与全质量路径共享参数与计划）
+    ProcessingQuality quality = ProcessingQuality::FULL;
+    bool proxy_upsample = true;
+    bool last_frame_proxy = false;
+    ImageBuffer proxy_extra;  // 降采样后的额外通道（不上采样时输出）
+    
+    // 阶段检查点缓存（带帧ID的处理路径；跨Initialize保留，按参数哈希判定有效性）
+    StageCache stage_cache;
+    
+    void CompilePlan(ColorSpace source_cs, ColorSpace target_cs) {
+        plan = RenderPlan::Compile(current_params, source_cs, target_cs, preferred_layout);
+    }
+    
+    // message 须为字符串字面量，动态内容放在 detail（记录路径无锁、不分配内存）
+    void LogError(ErrorCode code, const char* message, std::string_view detail = {},
+                  ErrorField field = ErrorField::NONE, float value = 0.0f, int64_t frame_index = -1) {
+        errors.Record(code, message, detail, field, value, frame_index);
     }
     
     void UpdateStatistics(const Image& processed_frame) {
-        std::lock_guard<std::mutex> lock(stats_mutex);
-        
-        // Calculate PQ statistics
-        std::vector<float> max_rgb_values;
-        max_rgb_values.reserve(processed_frame.width * processed_frame.height);
-        
+        // Calculate PQ statistics (and the shot analyzer histogram in the same pass)
+        StatisticsAccumulator accumulator;
+        accumulator.Reserve(static_cast<size_t>(processed_frame.width) * processed_frame.height);
+        const bool analyze = shot_analyzer != nullptr;
+        if (analyze) {
+            frame_histogram.Clear();
+        }
+
         for (int y = 0; y < processed_frame.height; ++y) {
             for (int x = 0; x < processed_frame.width; ++x) {
                 const float* pixel = processed_frame.GetPixel(x, y);
                 if (pixel && NumericalUtils::IsFiniteRGB(pixel)) {
-                    float max_rgb = std::max(pixel[0], std::max(pixel[1], pixel[2]));
-                    max_rgb_values.push_back(max_rgb);
+                    const float max_rgb = std::max(pixel[0], std::max(pixel[1], pixel[2]));
+                    accumulator.Add(max_rgb);
+                    if (analyze) {
+                        frame_histogram.Add(max_rgb);
+                    }
                 }
             }
         }
-        
-        if (!max_rgb_values.empty()) {
-            // Sort for percentile calculation
-            std::sort(max_rgb_values.begin(), max_rgb_values.end());
-            
-            // Calculate 1% trimmed statistics
-            size_t trim_count = max_rgb_values.size() / 100; // 1%
-            size_t start_idx = trim_count;
-            size_t end_idx = max_rgb_values.size() - trim_count;
-            
-            if (start_idx < end_idx) {
-                current_stats.pq_stats.min_pq = max_rgb_values[start_idx];
-                current_stats.pq_stats.max_pq = max_rgb_values[end_idx - 1];
-                
-                // Calculate trimmed mean
-                float sum = 0.0f;
-                for (size_t i = start_idx; i < end_idx; ++i) {
-                    sum += max_rgb_values[i];
-                }
-                current_stats.pq_stats.avg_pq = sum / (end_idx - start_idx);
-                
-                // Calculate variance
-                float variance_sum = 0.0f;
-                for (size_t i = start_idx; i < end_idx; ++i) {
-                    float diff = max_rgb_values[i] - current_stats.pq_stats.avg_pq;
-                    variance_sum += diff * diff;
-                }
-                current_stats.pq_stats.variance = variance_sum / (end_idx - start_idx);
-            }
+
+        CommitStatistics(accumulator, analyze ? &frame_histogram : nullptr);
+    }
+    
+    void UpdateStatistics(const ImagePlanar& processed_frame) {
+        StatisticsAccumulator accumulator;
+        accumulator.Reserve(processed_frame.GetPixelCount());
+        // 代理帧只是交互预览，不进入镜头分析
+        if (shot_analyzer && quality == ProcessingQuality::FULL) {
+            frame_histogram.Clear();
+            frame_histogram.AddPixels(processed_frame.Plane(0), processed_frame.Plane(1), processed_frame.Plane(2),
+                                      processed_frame.GetPixelCount(), &accumulator);
+            CommitStatistics(accumulator, &frame_histogram);
+            return;
         }
-        
+        accumulator.AddPixels(processed_frame.Plane(0), processed_frame.Plane(1), processed_frame.Plane(2),
+                              processed_frame.GetPixelCount());
+        CommitStatistics(accumulator);
+    }
+    
+    void CommitStatistics(StatisticsAccumulator& accumulator, const StatisticsHistogram* histogram = nullptr) {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        accumulator.Finalize(current_stats.pq_stats);
         current_stats.frame_count++;
         current_stats.timestamp = std::chrono::system_clock::now();
+        if (histogram && shot_analyzer) {
+            shot_analyzer->AddFrame(*histogram);
+        }
     }
 };
 
@@ -95,7 +442,8 @@ bool CphProcessor::Initialize(const CphParams& params) {
     std::vector<ErrorReport> validation_errors;
     if (!ParamValidator::ValidateCphParams(params, validation_errors)) {
         for (const auto& error : validation_errors) {
-            pImpl->LogError(error.code, error.message, error.field_name, error.invalid_value);
+            pImpl->LogError(error.code, "Invalid parameter", error.message, ErrorFieldFromName(error.field_name),
+                            error.invalid_value);
         }
         return false;
     }
@@ -103,19 +451,20 @@ bool CphProcessor::Initialize(const CphParams& params) {
     pImpl->current_params = params;
     pImpl->current_params.ClampToValidRange(); // Ensure all parameters are in valid range
     
-    // 初始化色调映射器
-    if (!pImpl->tone_mapper.Initialize(pImpl->current_params)) {
-        pImpl->LogError(ErrorCode::SCHEMA_MISSING, "Failed to initialize tone mapper: " + 
-                       pImpl->tone_mapper.GetLastError());
+    // 色调映射器与各阶段配置只存在于编译管线中
+    std::vector<ErrorReport> compile_errors;
+    std::shared_ptr<const CompiledPipeline> pipeline =
+        CompiledPipeline::Compile(pImpl->current_params, compile_errors, pImpl->usm_options);
+    if (!pipeline) {
+        for (const auto& error : compile_errors) {
+            pImpl->LogError(error.code, "Pipeline compilation failed", error.message);
+        }
         return false;
     }
+    pImpl->pipeline = std::move(pipeline);
     
-    // 初始化高光细节处理器
-    if (!pImpl->highlight_processor.Initialize(pImpl->current_params)) {
-        pImpl->LogError(ErrorCode::SCHEMA_MISSING, "Failed to initialize highlight detail processor: " + 
-                       pImpl->highlight_processor.GetLastError());
-        return false;
-    }
+    // 编译渲染计划（默认BT2020_PQ输入输出，帧色彩空间不同时重新编译）
+    pImpl->CompilePlan(ColorSpace::BT2020_PQ, ColorSpace::BT2020_PQ);
     
     pImpl->current_stats.Reset();
     pImpl->initialized = true;
@@ -139,52 +488,673 @@ bool CphProcessor::ProcessFrame(const Image& input, Image& output) {
         return false;
     }
     
+    if (pImpl->quality != ProcessingQuality::FULL) {
+        return ProcessProxy(input, output);
+    }
+    
     return ProcessFrameInternal(input, output);
 }
 
-bool CphProcessor::ProcessFrameInternal(const Image& input, Image& output) {
+bool CphProcessor::ProcessFrame(const ImageHalf& input, ImageHalf& output) {
+    if (!pImpl->initialized) {
+        pImpl->LogError(ErrorCode::SCHEMA_MISSING, "Processor not initialized");
+        return false;
+    }
+    
+    if (!input.IsValid()) {
+        pImpl->LogError(ErrorCode::NAN_INF, "Invalid input image");
+        return false;
+    }
+    
+    try {
+        if (pImpl->plan.source_cs != input.color_space || pImpl->plan.target_cs != input.color_space) {
+            pImpl->CompilePlan(input.color_space, input.color_space);
+        }
+        const RenderPlan& plan = pImpl->plan;
+
+        if (plan.layout == PixelLayout::PLANAR) {
+            // 半精度解码/编码与布局转换融合，中间结果保持FP32
+            PlanarLayout::Deinterleave(input, pImpl->planar);
+            RunPlanarStages();
+            PlanarLayout::Interleave(pImpl->planar, output, &input);
+        } else {
+            Image& working = pImpl->half_scratch;
+            HalfFloat::ToImage(input, working);
+            ProcessInterleaved(working, working);
+            HalfFloat::FromImage(working, output);
+        }
+        output.color_space = plan.target_cs;
+        pImpl->last_frame_proxy = false;
+
+        if (pImpl->current_stats.frame_count == 1) {
+            ValidateCurveProperties();
+        }
+
+        return true;
+    }
+    catch (const std::exception& e) {
+        pImpl->LogError(ErrorCode::NAN_INF, "Processing exception", e.what());
+        return false;
+    }
+}
+
+bool CphProcessor::ProcessFrame(const PackedImage& input, PackedImage& output) {
+    if (!pImpl->initialized) {
+        pImpl->LogError(ErrorCode::SCHEMA_MISSING, "Processor not initialized");
+        return false;
+    }
+    
+    if (!input.IsValid()) {
+        pImpl->LogError(ErrorCode::NAN_INF, "Invalid packed input image");
+        return false;
+    }
+    
+    try {
+        // 解码/编码已完成进出工作域的转换：始终走平面布局，计划中无域转换阶段
+        if (pImpl->plan.source_cs != ColorSpace::BT2020_PQ || pImpl->plan.target_cs != ColorSpace::BT2020_PQ) {
+            pImpl->CompilePlan(ColorSpace::BT2020_PQ, ColorSpace::BT2020_PQ);
+        }
+
+        PixelFormatIO::Decode(input, pImpl->planar);
+        RunPlanarStages();
+
+        output.format = input.format;
+        output.bit_depth = input.bit_depth;
+        output.color_space = input.color_space;
+        if (!PixelFormatIO::Encode(pImpl->planar, output)) {
+            pImpl->LogError(ErrorCode::NAN_INF, "Packed output encoding failed");
+            return false;
+        }
+        pImpl->last_frame_proxy = false;
+
+        if (pImpl->current_stats.frame_count == 1) {
+            ValidateCurveProperties();
+        }
+
+        return true;
+    }
+    catch (const std::exception& e) {
+        pImpl->LogError(ErrorCode::NAN_INF, "Processing exception", e.what());
+        return false;
+    }
+}
+
+void CphProcessor::PrepareRegionOutput(const Image& input, Image& output) const {
+    if (output.width != input.width || output.height != input.height ||
+        output.channels != input.channels || output.data.size() != input.GetDataSize()) {
+        output = Image(input.width, input.height, input.channels);
+    }
+    // 区域计划的源与目标色彩空间相同
+    output.color_space = input.color_space;
+}
+
+bool CphProcessor::ProcessRegion(const Image& input, Image& output, const RenderRect& rect) {
+    if (!pImpl->initialized) {
+        pImpl->LogError(ErrorCode::SCHEMA_MISSING, "Processor not initialized");
+        return false;
+    }
+    
+    if (input.width <= 0 || input.height <= 0 || input.channels < 3 ||
+        input.data.size() != input.GetDataSize()) {
+        pImpl->LogError(ErrorCode::NAN_INF, "Invalid input image");
+        return false;
+    }
+    
+    // 输出由宿主预先分配（PrepareRegionOutput）：并发的区域调用只写各自窗口内的像素
+    if (output.width != input.width || output.height != input.height || output.channels != input.channels ||
+        output.data.size() != input.GetDataSize() || output.color_space != input.color_space) {
+        pImpl->LogError(ErrorCode::NAN_INF, "Region output not prepared for the input frame");
+        return false;
+    }
+    
+    const RenderRect frame = RenderRect::FromImage(input);
+    const RenderRect window = rect.Intersect(frame);
+    if (window.IsEmpty()) {
+        pImpl->LogError(ErrorCode::NAN_INF, "Render window outside the frame");
+        return false;
+    }
+    
     try {
-        // 转换到工作域（BT.2020+PQ归一化）
-        Image working_image;
-        ColorSpaceConverter::ToWorkingDomain(input, working_image);
-        
-        // 应用色调映射到亮度通道
-        ApplyToneMappingToImage(working_image);
-        
-        // 应用高光细节处理（仅在x>p区域）
-        if (pImpl->current_params.highlight_detail > 0.0f) {
-            Image detail_enhanced;
-            if (!pImpl->highlight_processor.ProcessFrame(working_image, detail_enhanced, pImpl->current_params.pivot_pq)) {
-                pImpl->LogError(ErrorCode::HL_FLICKER, "Highlight detail processing failed: " + 
-                               pImpl->highlight_processor.GetLastError());
-                // 继续处理，使用原图像
-                detail_enhanced = working_image;
+        // 区域按局部计划执行（不修改共享计划与缓冲），可被宿主多线程并发调用
+        RenderPlan plan = RenderPlan::Compile(pImpl->current_params, input.color_space, input.color_space,
+                                              PixelLayout::PLANAR);
+        plan.stages.erase(std::remove(plan.stages.begin(), plan.stages.end(), RenderStage::STATISTICS),
+                          plan.stages.end());
+
+        // 邻域阶段需要窗口外的光晕像素；帧边界处与整帧处理一样做边缘钳制
+        const RenderRect padded = window.Expand(plan.HaloRadius(pImpl->usm_options)).Intersect(frame);
+        const int pw = padded.Width();
+        const int ph = padded.Height();
+        const int channels = input.channels;
+
+        ImagePlanar planar(pw, ph, ImageInit::UNINITIALIZED);
+        planar.color_space = input.color_space;
+        for (int y = 0; y < ph; ++y) {
+            const float* src = input.data.data() +
+                (static_cast<size_t>(padded.y1 + y) * input.width + padded.x1) * channels;
+            float* r = planar.Plane(0) + static_cast<size_t>(y) * pw;
+            float* g = planar.Plane(1) + static_cast<size_t>(y) * pw;
+            float* b = planar.Plane(2) + static_cast<size_t>(y) * pw;
+            for (int x = 0; x < pw; ++x) {
+                const float* pixel = src + static_cast<size_t>(x) * channels;
+                if (!NumericalUtils::IsFiniteRGB(pixel)) {
+                    pImpl->LogError(ErrorCode::NAN_INF, "Invalid input image");
+                    return false;
+                }
+                r[x] = pixel[0];
+                g[x] = pixel[1];
+                b[x] = pixel[2];
+            }
+        }
+
+        ImagePlanar scratch;
+        RunPlanarStages(plan, planar, scratch);
+
+        // 只写回窗口内像素；额外通道（Alpha）从输入原样复制
+        StatisticsHistogram stats;
+        const int ox = window.x1 - padded.x1;
+        const int oy = window.y1 - padded.y1;
+        for (int y = 0; y < window.Height(); ++y) {
+            const size_t row = static_cast<size_t>(oy + y) * pw + ox;
+            const float* r = planar.Plane(0) + row;
+            const float* g = planar.Plane(1) + row;
+            const float* b = planar.Plane(2) + row;
+            const size_t offset = (static_cast<size_t>(window.y1 + y) * input.width + window.x1) * channels;
+            const float* src = input.data.data() + offset;
+            float* dst = output.data.data() + offset;
+            for (int x = 0; x < window.Width(); ++x) {
+                float* pixel = dst + static_cast<size_t>(x) * channels;
+                pixel[0] = r[x];
+                pixel[1] = g[x];
+                pixel[2] = b[x];
+                for (int c = 3; c < channels; ++c) {
+                    pixel[c] = src[static_cast<size_t>(x) * channels + c];
+                }
             }
-            working_image = detail_enhanced;
-        }
-        
-        // 应用饱和度处理（OKLab色彩空间）
-        ApplySaturationProcessing(working_image);
-        
-        // 转换回目标色彩空间
-        ColorSpaceConverter::FromWorkingDomain(working_image, output, input.color_space);
-        
-        // 更新统计信息
-        UpdateStatistics(output);
-        
+            stats.AddPixels(r, g, b, window.Width());
+        }
+
+        std::lock_guard<std::mutex> lock(pImpl->stats_mutex);
+        pImpl->region_stats.Merge(stats);
+        return true;
+    }
+    catch (const std::exception& e) {
+        pImpl->LogError(ErrorCode::NAN_INF, "Processing exception", e.what());
+        return false;
+    }
+}
+
+bool CphProcessor::ProcessFrame(const Image& input, Image& output, uint64_t frame_id) {
+    if (!pImpl->initialized) {
+        pImpl->LogError(ErrorCode::SCHEMA_MISSING, "Processor not initialized");
+        return false;
+    }
+    
+    if (!input.IsValid()) {
+        pImpl->LogError(ErrorCode::NAN_INF, "Invalid input image", {}, ErrorField::NONE, 0.0f, static_cast<int64_t>(frame_id));
+        return false;
+    }
+    
+    if (pImpl->quality != ProcessingQuality::FULL || !pImpl->stage_cache.IsEnabled()) {
+        return ProcessFrame(input, output);
+    }
+    
+    try {
+        if (pImpl->plan.source_cs != input.color_space || pImpl->plan.target_cs != input.color_space) {
+            pImpl->CompilePlan(input.color_space, input.color_space);
+        }
+        const RenderPlan& plan = pImpl->plan;
+        const CphParams& params = pImpl->current_params;
+        ImagePlanar& planar = pImpl->planar;
+
+        // 从最深的有效检查点恢复；全部未命中时从输入开始
+        size_t next_stage = 0;
+        for (size_t i = plan.stages.size(); i-- > 0;) {
+            RenderStage stage = plan.stages[i];
+            if (!IsCacheCheckpoint(stage)) {
+                continue;
+            }
+            const ImagePlanar* cached = pImpl->stage_cache.Find(frame_id, stage, StageDependencyHash(stage, params, plan, pImpl->usm_options));
+            if (cached && cached->width == input.width && cached->height == input.height) {
+                planar = *cached;
+                next_stage = i + 1;
+                break;
+            }
+        }
+        if (next_stage == 0) {
+            PlanarLayout::Deinterleave(input, planar);
+        }
+
+        // 检查点缓存使用平面布局执行，结果与平面整帧路径一致
+        for (size_t i = next_stage; i < plan.stages.size(); ++i) {
+            RenderStage stage = plan.stages[i];
+            RunPlanarStage(stage, plan, planar, pImpl->planar_scratch, 1.0f);
+            if (IsCacheCheckpoint(stage)) {
+                pImpl->stage_cache.Store(frame_id, stage, StageDependencyHash(stage, params, plan, pImpl->usm_options), planar);
+            }
+        }
+
+        PlanarLayout::Interleave(planar, output, &input);
+        output.color_space = plan.target_cs;
+        pImpl->last_frame_proxy = false;
+
+        if (pImpl->current_stats.frame_count == 1) {
+            ValidateCurveProperties();
+        }
+
+        return true;
+    }
+    catch (const std::exception& e) {
+        pImpl->LogError(ErrorCode::NAN_INF, "Processing exception", e.what(), ErrorField::NONE, 0.0f,
+                        static_cast<int64_t>(frame_id));
+        return false;
+    }
+}
+
+void CphProcessor::SetStageCacheBudget(size_t max_bytes) {
+    pImpl->stage_cache.SetMaxBytes(max_bytes);
+}
+
+void CphProcessor::ClearStageCache() {
+    pImpl->stage_cache.Clear();
+}
+
+StageCacheStats CphProcessor::GetStageCacheStats() const {
+    return pImpl->stage_cache.GetStats();
+}
+
+ClipResult CphProcessor::ProcessClip(FrameSource& source, FrameSink& sink, const ClipOptions& options) {
+    ClipResult result;
+    if (!pImpl->initialized) {
+        pImpl->LogError(ErrorCode::SCHEMA_MISSING, "Processor not initialized");
+        return result;
+    }
+    
+    const int workers = options.worker_count > 0 ? options.worker_count : Parallel::HardwareThreads();
+    ClipSchedule schedule;
+    schedule.max_in_flight = options.max_frames_in_flight > 0 ? options.max_frames_in_flight : 2 * workers;
+    const CphParams& params = pImpl->current_params;
+    
+    // 帧i的运动图：接管帧i-1发布的运动历史，推入本帧亮度后再发布（依赖链只含金字塔构建与分块帧差）
+    auto resolve_motion = [&](int64_t index, ImagePlanar& planar, MotionMap& map, const MotionMap*& motion_map) {
+        if (!planar.HasLuma()) {
+            planar.ComputeLuma();
+        }
+        ClipSchedule::MotionState state;
+        if (index > 0) {
+            std::unique_lock<std::mutex> lock(schedule.mutex);
+            schedule.cv.wait(lock, [&]() { return schedule.aborted || schedule.motion.count(index - 1) > 0; });
+            if (schedule.aborted) {
+                return false;
+            }
+            auto it = schedule.motion.find(index - 1);
+            state = std::move(it->second);
+            schedule.motion.erase(it);
+        }
+
+        motion_map = HighlightDetailProcessor::UpdateMotionProtection(state.history, planar.luma.data(), planar.width,
+                                                                      planar.height, params.pivot_pq, map);
+
+        std::lock_guard<std::mutex> lock(schedule.mutex);
+        schedule.motion[index] = std::move(state);
+        schedule.cv.notify_all();
+        return true;
+    };
+    
+    // 宿主回调（FrameSource/FrameSink）与帧处理的异常不能逸出工作线程（否则 std::terminate）：
+    // 记录后返回false，由调用方中止片段
+    auto guarded = [&](const char* message, int64_t index, auto&& call) {
+        try {
+            call();
+            return true;
+        }
+        catch (const std::exception& e) {
+            pImpl->LogError(ErrorCode::NAN_INF, message, e.what(), ErrorField::NONE, 0.0f, index);
+        }
+        catch (...) {
+            pImpl->LogError(ErrorCode::NAN_INF, message, "unknown exception", ErrorField::NONE, 0.0f, index);
+        }
+        return false;
+    };
+    
+    // 处理单帧：局部计划与缓冲，统计样本随帧交给写出环节
+    auto process_frame = [&](int64_t index, const Image& input, ClipSchedule::PendingFrame& frame) {
+        if (!input.IsValid()) {
+            pImpl->LogError(ErrorCode::NAN_INF, "Invalid input image", {}, ErrorField::NONE, 0.0f, index);
+            return false;
+        }
+
+        RenderPlan plan = RenderPlan::Compile(params, input.color_space, input.color_space, PixelLayout::PLANAR);
+        const bool collect_stats = plan.HasStage(RenderStage::STATISTICS);
+        plan.stages.erase(std::remove(plan.stages.begin(), plan.stages.end(), RenderStage::STATISTICS),
+                          plan.stages.end());
+
+        ImagePlanar planar;
+        ImagePlanar scratch;
+        PlanarLayout::Deinterleave(input, planar);
+        for (RenderStage stage : plan.stages) {
+            if (stage != RenderStage::HIGHLIGHT_DETAIL || !options.motion_protection) {
+                RunPlanarStage(stage, plan, planar, scratch, 1.0f);
+                continue;
+            }
+            MotionMap map;
+            const MotionMap* motion_map = nullptr;
+            if (!resolve_motion(index, planar, map, motion_map)) {
+                return false;
+            }
+            std::string error;
+            if (!pImpl->pipeline->RunStage(stage, plan, planar, scratch, 1.0f, motion_map, error)) {
+                pImpl->LogError(RenderStageErrorCode(stage), "Render stage failed",
+                                RenderStageToString(stage) + ": " + error, ErrorField::NONE, 0.0f, index);
+                return false;
+            }
+        }
+
+        PlanarLayout::Interleave(planar, frame.output, &input);
+        frame.output.color_space = plan.target_cs;
+        if (collect_stats) {
+            frame.stats.Reserve(planar.GetPixelCount());
+            if (pImpl->shot_analyzer) {
+                frame.histogram.emplace();
+                frame.histogram->AddPixels(planar.Plane(0), planar.Plane(1), planar.Plane(2),
+                                           planar.GetPixelCount(), &frame.stats);
+            } else {
+                frame.stats.AddPixels(planar.Plane(0), planar.Plane(1), planar.Plane(2), planar.GetPixelCount());
+            }
+        }
+        return true;
+    };
+    
+    // 按帧序写出并合并统计；同一时刻只有一个线程承担写出
+    auto deliver = [&](std::unique_lock<std::mutex>& lock) {
+        if (schedule.writing) {
+            return;
+        }
+        schedule.writing = true;
+        while (!schedule.aborted && schedule.pending.count(schedule.next_write) > 0) {
+            auto it = schedule.pending.find(schedule.next_write);
+            ClipSchedule::PendingFrame frame = std::move(it->second);
+            schedule.pending.erase(it);
+            const int64_t index = schedule.next_write;
+            lock.unlock();
+            
+            bool written = false;
+            const bool sink_ok = guarded("Frame sink exception", index, [&]() {
+                written = sink.WriteFrame(index, frame.output);
+            });
+            if (written && frame.stats.GetSampleCount() > 0) {
+                pImpl->CommitStatistics(frame.stats, frame.histogram ? &*frame.histogram : nullptr);
+                if (pImpl->current_stats.frame_count == 1) {
+                    ValidateCurveProperties();
+                }
+            }
+            
+            lock.lock();
+            if (!written) {
+                if (sink_ok) {
+                    pImpl->LogError(ErrorCode::NAN_INF, "Frame sink rejected frame", {}, ErrorField::NONE, 0.0f, index);
+                }
+                schedule.aborted = true;
+                break;
+            }
+            schedule.next_write++;
+            schedule.frames_written++;
+            schedule.in_flight--;
+        }
+        schedule.writing = false;
+        schedule.cv.notify_all();
+    };
+    
+    auto worker = [&]() {
+        Image input;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(schedule.mutex);
+                schedule.cv.wait(lock, [&]() {
+                    return schedule.aborted || schedule.end_of_clip || schedule.in_flight < schedule.max_in_flight;
+                });
+                if (schedule.aborted || schedule.end_of_clip) {
+                    return;
+                }
+                schedule.in_flight++;
+            }
+            
+            int64_t index = -1;
+            bool source_ok = true;
+            {
+                std::lock_guard<std::mutex> lock(schedule.source_mutex);
+                source_ok = guarded("Frame source exception", schedule.next_read, [&]() {
+                    if (!schedule.end_of_clip && source.ReadFrame(input)) {
+                        index = schedule.next_read++;
+                    }
+                });
+            }
+            if (!source_ok) {
+                schedule.Abort();
+                return;
+            }
+            if (index < 0) {
+                std::lock_guard<std::mutex> lock(schedule.mutex);
+                schedule.end_of_clip = true;
+                schedule.in_flight--;
+                schedule.cv.notify_all();
+                return;
+            }
+            
+            ClipSchedule::PendingFrame frame;
+            bool ok = false;
+            if (!guarded("Processing exception", index, [&]() { ok = process_frame(index, input, frame); }) || !ok) {
+                schedule.Abort();
+                return;
+            }
+            
+            std::unique_lock<std::mutex> lock(schedule.mutex);
+            schedule.pending.emplace(index, std::move(frame));
+            deliver(lock);
+        }
+    };
+    
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (int t = 1; t < workers; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    pImpl->last_frame_proxy = false;
+    result.frames_read = schedule.next_read;
+    result.frames_written = schedule.frames_written;
+    result.success = !schedule.aborted && result.frames_written == result.frames_read;
+    return result;
+}
+
+void CphProcessor::EndFrame() {
+    {
+        std::lock_guard<std::mutex> lock(pImpl->stats_mutex);
+        pImpl->region_stats.Finalize(pImpl->current_stats.pq_stats);
+        if (pImpl->shot_analyzer) {
+            pImpl->shot_analyzer->AddFrame(pImpl->region_stats);
+        }
+        pImpl->region_stats.Clear();
+        pImpl->current_stats.frame_count++;
+        pImpl->current_stats.timestamp = std::chrono::system_clock::now();
+    }
+    
+    if (pImpl->current_stats.frame_count == 1) {
+        ValidateCurveProperties();
+    }
+}
+
+bool CphProcessor::ProcessProxy(const Image& input, Image& output) {
+    try {
+        if (pImpl->plan.source_cs != input.color_space || pImpl->plan.target_cs != input.color_space) {
+            pImpl->CompilePlan(input.color_space, input.color_space);
+        }
+        const RenderPlan& plan = pImpl->plan;
+        const int factor = ProxyScaleFactor(pImpl->quality);
+
+        // 代理分辨率下始终使用平面布局；USM半径按 1/factor 缩小
+        ImageBuffer* extra = pImpl->proxy_upsample ? nullptr : &pImpl->proxy_extra;
+        BoxDownsample(input, factor, pImpl->planar, extra);
+        RunPlanarStages(plan, pImpl->planar, pImpl->planar_scratch, 1.0f / static_cast<float>(factor));
+
+        if (pImpl->proxy_upsample) {
+            BilinearUpsample(pImpl->planar, factor, input, output);
+        } else {
+            const ImagePlanar& planar = pImpl->planar;
+            const int extra_channels = input.channels - 3;
+            PlanarLayout::Interleave(planar, output);
+            if (extra_channels > 0) {
+                // 交错输出按输入通道数分配，额外通道取降采样结果
+                Image proxy(planar.width, planar.height, input.channels, ImageInit::UNINITIALIZED);
+                for (size_t i = 0; i < planar.GetPixelCount(); ++i) {
+                    float* pixel = proxy.data.data() + i * input.channels;
+                    const float* rgb = output.data.data() + i * 3;
+                    pixel[0] = rgb[0];
+                    pixel[1] = rgb[1];
+                    pixel[2] = rgb[2];
+                    for (int c = 0; c < extra_channels; ++c) {
+                        pixel[3 + c] = pImpl->proxy_extra[i * extra_channels + c];
+                    }
+                }
+                output = std::move(proxy);
+            }
+        }
+        output.color_space = plan.target_cs;
+        pImpl->last_frame_proxy = true;
+
+        if (pImpl->current_stats.frame_count == 1) {
+            ValidateCurveProperties();
+        }
+
+        return true;
+    }
+    catch (const std::exception& e) {
+        pImpl->LogError(ErrorCode::NAN_INF, "Processing exception", e.what());
+        return false;
+    }
+}
+
+bool CphProcessor::ProcessFrameInternal(const Image& input, Image& output) {
+    try {
+        // 输出色彩空间与输入一致；色彩空间变化时重新编译计划
+        if (pImpl->plan.source_cs != input.color_space || pImpl->plan.target_cs != input.color_space) {
+            pImpl->CompilePlan(input.color_space, input.color_space);
+        }
+        const RenderPlan& plan = pImpl->plan;
+
+        // 按计划选择的布局执行各阶段；平面布局在边界处各转换一次
+        if (plan.layout == PixelLayout::PLANAR) {
+            PlanarLayout::Deinterleave(input, pImpl->planar);
+            RunPlanarStages();
+            PlanarLayout::Interleave(pImpl->planar, output, &input);
+        } else {
+            ProcessInterleaved(input, output);
+        }
+        output.color_space = plan.target_cs;
+        pImpl->last_frame_proxy = false;
+
         // 验证曲线特性（仅在调试模式或首次处理时）
         if (pImpl->current_stats.frame_count == 1) {
             ValidateCurveProperties();
         }
-        
+
         return true;
     }
     catch (const std::exception& e) {
-        pImpl->LogError(ErrorCode::NAN_INF, std::string("Processing exception: ") + e.what());
+        pImpl->LogError(ErrorCode::NAN_INF, "Processing exception", e.what());
         return false;
     }
 }
 
+void CphProcessor::ProcessInterleaved(const Image& input, Image& output) {
+    const RenderPlan& plan = pImpl->plan;
+    
+    // 输出缓冲即工作缓冲：整帧只拷贝一次，其余阶段原地执行
+    if (&output != &input) {
+        output = input;
+    }
+    
+    for (RenderStage stage : plan.stages) {
+        switch (stage) {
+            case RenderStage::TO_WORKING_DOMAIN:
+            case RenderStage::WORKING_DOMAIN_CLAMP:
+                // 转换到工作域（BT.2020+PQ归一化）
+                ColorSpaceConverter::ToWorkingDomainInPlace(output);
+                break;
+                
+            case RenderStage::TONE_MAPPING:
+                // 应用色调映射到亮度通道
+                ApplyToneMappingToImage(output);
+                break;
+                
+            case RenderStage::HIGHLIGHT_DETAIL:
+                // 应用高光细节处理（仅在x>p区域）：邻域阶段在编译管线的平面内核上执行，
+                // 失败时记录错误并继续使用原图像
+                RunInterleavedDetailStage(plan, output);
+                break;
+                
+            case RenderStage::SATURATION:
+                // 应用饱和度处理（OKLab色彩空间）
+                ApplySaturationProcessing(output);
+                break;
+                
+            case RenderStage::FROM_WORKING_DOMAIN:
+                // 转换回目标色彩空间
+                ColorSpaceConverter::FromWorkingDomainInPlace(output, plan.target_cs);
+                break;
+                
+            case RenderStage::STATISTICS:
+                // 更新统计信息
+                UpdateStatistics(output);
+                break;
+        }
+    }
+}
+
+void CphProcessor::RunPlanarStages() {
+    RunPlanarStages(pImpl->plan, pImpl->planar, pImpl->planar_scratch);
+}
+
+void CphProcessor::RunPlanarStages(const RenderPlan& plan, ImagePlanar& planar, ImagePlanar& scratch,
+                                   float detail_scale) {
+    for (RenderStage stage : plan.stages) {
+        RunPlanarStage(stage, plan, planar, scratch, detail_scale);
+    }
+}
+
+void CphProcessor::RunPlanarStage(RenderStage stage, const RenderPlan& plan, ImagePlanar& planar,
+                                  ImagePlanar& scratch, float detail_scale) {
+    if (stage == RenderStage::STATISTICS) {
+        // 统计直接在平面上计算，与交错路径结果一致
+        pImpl->UpdateStatistics(planar);
+        return;
+    }
+    
+    std::string error;
+    if (!pImpl->pipeline->RunStage(stage, plan, planar, scratch, detail_scale, nullptr, error)) {
+        pImpl->LogError(RenderStageErrorCode(stage), "Render stage failed", RenderStageToString(stage) + ": " + error);
+    }
+}
+
+void CphProcessor::RunInterleavedDetailStage(const RenderPlan& plan, Image& image) {
+    ImagePlanar& planar = pImpl->planar;
+    PlanarLayout::Deinterleave(image, planar);
+    std::string error;
+    if (!pImpl->pipeline->RunStage(RenderStage::HIGHLIGHT_DETAIL, plan, planar, pImpl->planar_scratch, 1.0f,
+                                   nullptr, error)) {
+        pImpl->LogError(RenderStageErrorCode(RenderStage::HIGHLIGHT_DETAIL), "Render stage failed",
+                        RenderStageToString(RenderStage::HIGHLIGHT_DETAIL) + ": " + error);
+        return;
+    }
+    const ColorSpace color_space = image.color_space;
+    PlanarLayout::Interleave(planar, image, &image);
+    image.color_space = color_space;
+}
+
 void CphProcessor::UpdateStatistics(const Image& processed_frame) {
     pImpl->UpdateStatistics(processed_frame);
 }
@@ -194,33 +1164,90 @@ Statistics CphProcessor::GetStatistics() const {
     return pImpl->current_stats;
 }
 
+void CphProcessor::SetShotAnalyzer(ShotAnalyzer* analyzer) {
+    std::lock_guard<std::mutex> lock(pImpl->stats_mutex);
+    pImpl->shot_analyzer = analyzer;
+}
+
 void CphProcessor::ResetStatistics() {
     std::lock_guard<std::mutex> lock(pImpl->stats_mutex);
     pImpl->current_stats.Reset();
+    pImpl->region_stats.Clear();
 }
 
 std::string CphProcessor::GetLastError() const {
-    std::lock_guard<std::mutex> lock(pImpl->error_mutex);
-    return pImpl->last_error;
+    return pImpl->errors.GetLastError();
 }
 
 std::vector<ErrorReport> CphProcessor::GetErrorHistory() const {
-    std::lock_guard<std::mutex> lock(pImpl->error_mutex);
-    return pImpl->error_history;
+    return pImpl->errors.GetHistory();
+}
+
+ErrorEventCounters CphProcessor::GetErrorCounters() const {
+    return pImpl->errors.GetCounters();
 }
 
 void CphProcessor::ClearErrors() {
-    std::lock_guard<std::mutex> lock(pImpl->error_mutex);
-    pImpl->error_history.clear();
-    pImpl->last_error.clear();
+    pImpl->errors.Clear();
 }
 
 void CphProcessor::SetDeterministicMode(bool enabled) {
     pImpl->current_params.deterministic = enabled;
+    pImpl->CompilePlan(pImpl->plan.source_cs, pImpl->plan.target_cs);
 }
 
 void CphProcessor::SetDCIComplianceMode(bool enabled) {
     pImpl->current_params.dci_compliance = enabled;
+    pImpl->CompilePlan(pImpl->plan.source_cs, pImpl->plan.target_cs);
+}
+
+void CphProcessor::SetPreferredLayout(PixelLayout layout) {
+    pImpl->preferred_layout = layout;
+    pImpl->CompilePlan(pImpl->plan.source_cs, pImpl->plan.target_cs);
+}
+
+void CphProcessor::SetUnsharpMaskOptions(const UnsharpMaskOptions& options) {
+    pImpl->usm_options = options;
+    if (!pImpl->initialized) {
+        return;
+    }
+    
+    // 编译管线不可变：带新选项重新编译（参数已校验，不会失败；失败时保留旧管线并记录错误）
+    std::vector<ErrorReport> compile_errors;
+    std::shared_ptr<const CompiledPipeline> pipeline =
+        CompiledPipeline::Compile(pImpl->current_params, compile_errors, options);
+    if (!pipeline) {
+        for (const auto& error : compile_errors) {
+            pImpl->LogError(error.code, "Pipeline compilation failed", error.message);
+        }
+        return;
+    }
+    pImpl->pipeline = std::move(pipeline);
+}
+
+const UnsharpMaskOptions& CphProcessor::GetUnsharpMaskOptions() const {
+    return pImpl->usm_options;
+}
+
+void CphProcessor::SetProcessingQuality(ProcessingQuality quality, bool upsample) {
+    pImpl->quality = quality;
+    pImpl->proxy_upsample = upsample;
+}
+
+ProcessingQuality CphProcessor::GetProcessingQuality() const {
+    return pImpl->quality;
+}
+
+bool CphProcessor::NeedsFullQualityRender() const {
+    return pImpl->last_frame_proxy;
+}
+
+std::shared_ptr<const CompiledPipeline> CphProcessor::GetCompiledPipeline() const {
+    return pImpl->pipeline;
+}
+
+const RenderPlan& CphProcessor::GetRenderPlan() const {
+    return pImpl->plan;
 }
 
 void CphProcessor::ApplyToneMappingToImage(Image& working_image) {
@@ -233,6 +1260,7 @@ void CphProcessor::ApplyToneMappingToImage(Image& working_image) {
      * 3. 按比例缩放RGB通道
      */
     
+    const ToneMapper& tone_mapper = pImpl->pipeline->GetToneMapper();
     for (int y = 0; y < working_image.height; ++y) {
         for (int x = 0; x < working_image.width; ++x) {
             float* pixel = working_image.GetPixel(x, y);
@@ -253,7 +1281,7 @@ void CphProcessor::ApplyToneMappingToImage(Image& working_image) {
             }
             
             // 应用色调映射
-            float mapped_luminance = pImpl->tone_mapper.ApplyToneMapping(max_rgb);
+            float mapped_luminance = tone_mapper.ApplyToneMapping(max_rgb);
             
             // 计算缩放比例
             float scale_factor = (max_rgb > 0.0f) ? (mapped_luminance / max_rgb) : 1.0f;
@@ -271,6 +1299,10 @@ void CphProcessor::ApplyToneMappingToImage(Image& working_image) {
     }
 }
 
+void CphProcessor::ApplyToneMappingPlanar(ImagePlanar& working_image) {
+    pImpl->pipeline->ApplyToneMappingPlanar(working_image);
+}
+
 void CphProcessor::ApplySaturationProcessing(Image& working_image) {
     /**
      * 在工作域中应用OKLab饱和度处理
@@ -339,7 +1371,8 @@ void CphProcessor::ValidateCurveProperties() {
      */
     
     // 验证单调性
-    bool is_monotonic = pImpl->tone_mapper.ValidateMonotonicity();
+    // 曲线性质在编译管线时已验证
+    bool is_monotonic = pImpl->pipeline->IsMonotonic();
     pImpl->current_stats.monotonic = is_monotonic;
     
     if (!is_monotonic) {
@@ -347,7 +1380,7 @@ void CphProcessor::ValidateCurveProperties() {
     }
     
     // 验证C¹连续性
-    bool is_c1_continuous = pImpl->tone_mapper.ValidateC1Continuity();
+    bool is_c1_continuous = pImpl->pipeline->IsC1Continuous();
     pImpl->current_stats.c1_continuous = is_c1_continuous;
     
     if (!is_c1_continuous) {
@@ -370,40 +1403,26 @@ bool ParamValidator::ValidateCphParams(const CphParams& params, std::vector<Erro
     return valid;
 }
 
-bool ParamValidator::ValidatePPRParams(const CphParams& params, std::vector<ErrorReport>& errors) {
+template <size_t N>
+bool ParamValidator::ValidateRanges(const CphParams& params, const ParamRange (&ranges)[N],
+                                    std::vector<ErrorReport>& errors) {
     bool valid = true;
-    
-    valid &= ValidateRange(params.gamma_s, 1.0f, 1.6f, "gamma_s", errors);
-    valid &= ValidateRange(params.gamma_h, 0.8f, 1.4f, "gamma_h", errors);
-    valid &= ValidateRange(params.shoulder_h, 0.5f, 3.0f, "shoulder_h", errors);
-    
+    for (const ParamRange& range : ranges) {
+        valid &= ValidateRange(params.*range.field, range.min_value, range.max_value, range.name, errors);
+    }
     return valid;
 }
 
+bool ParamValidator::ValidatePPRParams(const CphParams& params, std::vector<ErrorReport>& errors) {
+    return ValidateRanges(params, ParamRanges::PPR, errors);
+}
+
 bool ParamValidator::ValidateRLOGParams(const CphParams& params, std::vector<ErrorReport>& errors) {
-    bool valid = true;
-    
-    valid &= ValidateRange(params.rlog_a, 1.0f, 16.0f, "rlog_a", errors);
-    valid &= ValidateRange(params.rlog_b, 0.8f, 1.2f, "rlog_b", errors);
-    valid &= ValidateRange(params.rlog_c, 0.5f, 3.0f, "rlog_c", errors);
-    valid &= ValidateRange(params.rlog_t, 0.4f, 0.7f, "rlog_t", errors);
-    
-    return valid;
+    return ValidateRanges(params, ParamRanges::RLOG, errors);
 }
 
 bool ParamValidator::ValidateCommonParams(const CphParams& params, std::vector<ErrorReport>& errors) {
-    bool valid = true;
-    
-    valid &= ValidateRange(params.pivot_pq, 0.05f, 0.30f, "pivot_pq", errors);
-    valid &= ValidateRange(params.black_lift, 0.0f, 0.02f, "black_lift", errors);
-    valid &= ValidateRange(params.highlight_detail, 0.0f, 1.0f, "highlight_detail", errors);
-    valid &= ValidateRange(params.sat_base, 0.0f, 2.0f, "sat_base", errors);
-    valid &= ValidateRange(params.sat_hi, 0.0f, 2.0f, "sat_hi", errors);
-    valid &= ValidateRange(params.yknee, 0.95f, 0.99f, "yknee", errors);
-    valid &= ValidateRange(params.alpha, 0.2f, 1.0f, "alpha", errors);
-    valid &= ValidateRange(params.toe, 0.0f, 0.01f, "toe", errors);
-    
-    return valid;
+    return ValidateRanges(params, ParamRanges::COMMON, errors);
 }
 
 bool ParamValidator::ValidateRange(float value, float min_val, float max_val, 
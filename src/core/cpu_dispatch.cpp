@@ -0,0 +1,102 @@
+#include "cinema_pro_hdr/cpu_dispatch.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+
+namespace CinemaProHDR {
+
+namespace CpuDispatch {
+
+namespace {
+
+CpuTier DetectHardwareTier() {
+#if defined(CPH_CPU_DISPATCH_X86)
+    // __builtin_cpu_supports 已检查 XGETBV，操作系统未保存 AVX/AVX-512 状态时不会报告支持
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") &&
+        __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq")) {
+        return CpuTier::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return CpuTier::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return CpuTier::SSE42;
+    }
+#endif
+    return CpuTier::BASELINE;
+}
+
+CpuTier ClampToHardware(CpuTier tier) {
+    return static_cast<CpuTier>(std::min(static_cast<int>(tier), static_cast<int>(GetHardwareTier())));
+}
+
+CpuTier DefaultTier() {
+    CpuTier tier = GetHardwareTier();
+    const char* env = std::getenv("CPH_CPU_TIER");
+    CpuTier requested;
+    if (env && ParseTier(env, requested)) {
+        tier = ClampToHardware(requested);
+    }
+    return tier;
+}
+
+std::atomic<int>& ActiveTier() {
+    static std::atomic<int> tier{static_cast<int>(DefaultTier())};
+    return tier;
+}
+
+} // namespace
+
+CpuTier GetHardwareTier() {
+    static const CpuTier tier = DetectHardwareTier();
+    return tier;
+}
+
+CpuTier GetActiveTier() {
+    return static_cast<CpuTier>(ActiveTier().load(std::memory_order_relaxed));
+}
+
+CpuTier SetActiveTier(CpuTier tier) {
+    CpuTier effective = ClampToHardware(tier);
+    ActiveTier().store(static_cast<int>(effective), std::memory_order_relaxed);
+    return effective;
+}
+
+void ResetActiveTier() {
+    ActiveTier().store(static_cast<int>(DefaultTier()), std::memory_order_relaxed);
+}
+
+const char* TierToString(CpuTier tier) {
+    switch (tier) {
+        case CpuTier::BASELINE: return "baseline";
+        case CpuTier::SSE42: return "sse4.2";
+        case CpuTier::AVX2: return "avx2";
+        case CpuTier::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+bool ParseTier(const std::string& name, CpuTier& tier) {
+    std::string key;
+    for (char c : name) {
+        key += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    if (key == "baseline" || key == "scalar") {
+        tier = CpuTier::BASELINE;
+    } else if (key == "sse4.2" || key == "sse42") {
+        tier = CpuTier::SSE42;
+    } else if (key == "avx2") {
+        tier = CpuTier::AVX2;
+    } else if (key == "avx512") {
+        tier = CpuTier::AVX512;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace CpuDispatch
+
+} // namespace CinemaProHDR
@@ -11,68 +11,91 @@ namespace CinemaProHDR {
 
 LogThrottler::LogThrottler() = default;
 
+namespace {
+
+int64_t SteadyNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 未设置日志汇时参数修正信息仍写到 std::cout（与错误日志的 std::cerr 分开），首次使用时启动
+AsyncLogSink& DefaultCorrectionSink() {
+    static AsyncLogSink sink(std::make_unique<StreamLogOutput>(std::cout));
+    return sink;
+}
+
+} // namespace
+
+LogThrottler::ThrottleSlot& LogThrottler::SlotFor(ErrorCode error_code) {
+    const size_t index = static_cast<size_t>(error_code);
+    return slots_[index < SLOT_COUNT ? index : SLOT_COUNT - 1];
+}
+
 bool LogThrottler::ShouldLog(ErrorCode error_code) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    ThrottleSlot& slot = SlotFor(error_code);
+    const int64_t now_ns = SteadyNanoseconds();
+    const uint64_t now_ms = static_cast<uint64_t>(now_ns / 1000000);
     
-    auto& info = throttle_map_[error_code];
-    auto now = std::chrono::steady_clock::now();
+    uint64_t state = slot.window.load(std::memory_order_acquire);
     
-    // 更新时间窗口
-    UpdateWindow(info);
+    // 更新时间窗口：过期时尝试一次CAS翻转（计数清零）；失败时 state 为胜者写入的新值
+    if (now_ms - (state >> COUNT_BITS) >= static_cast<uint64_t>(WINDOW_DURATION_MS)) {
+        const uint64_t fresh = now_ms << COUNT_BITS;
+        if (slot.window.compare_exchange_strong(state, fresh, std::memory_order_acq_rel)) {
+            state = fresh;
+        }
+    }
     
-    // 检查是否超过限制
-    if (info.count >= MAX_LOGS_PER_SECOND) {
-        // 记录被节流的信息
-        info.throttled_count++;
-        if (info.throttled_count == 1) {
-            info.first_throttled = now;
+    // 当前窗口仍有名额时领取；领取时窗口已被他人翻转或名额已被抢完则按节流处理
+    const uint64_t window_start = state >> COUNT_BITS;
+    if (now_ms - window_start < static_cast<uint64_t>(WINDOW_DURATION_MS) &&
+        (state & COUNT_MASK) < static_cast<uint64_t>(MAX_LOGS_PER_SECOND)) {
+        const uint64_t previous = slot.window.fetch_add(1, std::memory_order_acq_rel);
+        if ((previous >> COUNT_BITS) == window_start &&
+            (previous & COUNT_MASK) < static_cast<uint64_t>(MAX_LOGS_PER_SECOND)) {
+            return true;
         }
-        info.last_throttled = now;
-        return false;
     }
     
-    info.count++;
-    return true;
+    // 记录被节流的信息
+    slot.throttled_count.fetch_add(1, std::memory_order_relaxed);
+    int64_t unset = 0;
+    slot.first_throttled_ns.compare_exchange_strong(unset, now_ns, std::memory_order_relaxed);
+    slot.last_throttled_ns.store(now_ns, std::memory_order_relaxed);
+    return false;
 }
 
 std::string LogThrottler::GetAggregateReport(ErrorCode error_code) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    const ThrottleSlot& slot = SlotFor(error_code);
     
-    auto it = throttle_map_.find(error_code);
-    if (it == throttle_map_.end() || it->second.throttled_count == 0) {
+    const uint64_t throttled_count = slot.throttled_count.load(std::memory_order_relaxed);
+    if (throttled_count == 0) {
         return "";
     }
     
-    const auto& info = it->second;
     std::ostringstream oss;
     
     oss << "聚合报告: 错误码 " << static_cast<int>(error_code) 
-        << " 被节流 " << info.throttled_count << " 次";
+        << " 被节流 " << throttled_count << " 次";
     
-    // 计算时间范围
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-        info.last_throttled - info.first_throttled);
+    // 计算时间范围（并发写入时 last 可能略早于最新一次节流）
+    const int64_t first = slot.first_throttled_ns.load(std::memory_order_relaxed);
+    const int64_t last = slot.last_throttled_ns.load(std::memory_order_relaxed);
+    const int64_t duration_ms = (last - first) / 1000000;
     
-    if (duration.count() > 0) {
-        oss << ", 时间范围: " << duration.count() << "ms";
+    if (duration_ms > 0) {
+        oss << ", 时间范围: " << duration_ms << "ms";
     }
     
     return oss.str();
 }
 
 void LogThrottler::Reset() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    throttle_map_.clear();
-}
-
-void LogThrottler::UpdateWindow(ThrottleInfo& info) {
-    auto now = std::chrono::steady_clock::now();
-    
-    // 如果是新的时间窗口，重置计数
-    if (now - info.window_start >= WINDOW_DURATION) {
-        info.count = 0;
-        info.window_start = now;
-        // 不重置throttled_count，保留用于聚合报告
+    for (ThrottleSlot& slot : slots_) {
+        slot.window.store(0, std::memory_order_release);
+        slot.throttled_count.store(0, std::memory_order_relaxed);
+        slot.first_throttled_ns.store(0, std::memory_order_relaxed);
+        slot.last_throttled_ns.store(0, std::memory_order_relaxed);
     }
 }
 
@@ -157,7 +180,7 @@ FallbackStrategy ErrorHandler::HandleError(
     const std::string& clip_guid,
     const std::string& timecode) {
     
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
     
     // 创建错误报告
     ErrorReport error(error_code, message);
@@ -190,9 +213,11 @@ FallbackStrategy ErrorHandler::HandleError(
         LogError(error);
     }
     
-    // 调用错误回调
-    if (error_callback_) {
-        error_callback_(error);
+    // 调用错误回调：复制后在锁外执行，慢回调不阻塞其他线程报错，回调内也可再调用本处理器
+    std::function<void(const ErrorReport&)> callback = error_callback_;
+    lock.unlock();
+    if (callback) {
+        callback(error);
     }
     
     return strategy;
@@ -201,26 +226,15 @@ FallbackStrategy ErrorHandler::HandleError(
 bool ErrorHandler::ValidateAndCorrectParams(CphParams& params) {
     bool corrected = false;
     
-    // 验证PPR参数 - 直接传递参数引用
-    corrected |= ValidateFloatRange(params.pivot_pq, 0.05f, 0.30f, "pivot_pq");
-    corrected |= ValidateFloatRange(params.gamma_s, 1.0f, 1.6f, "gamma_s");
-    corrected |= ValidateFloatRange(params.gamma_h, 0.8f, 1.4f, "gamma_h");
-    corrected |= ValidateFloatRange(params.shoulder_h, 0.5f, 3.0f, "shoulder_h");
-    corrected |= ValidateFloatRange(params.black_lift, 0.0f, 0.02f, "black_lift");
-    corrected |= ValidateFloatRange(params.highlight_detail, 0.0f, 1.0f, "highlight_detail");
-    corrected |= ValidateFloatRange(params.sat_base, 0.0f, 2.0f, "sat_base");
-    corrected |= ValidateFloatRange(params.sat_hi, 0.0f, 2.0f, "sat_hi");
-    
-    // 验证RLOG参数
-    corrected |= ValidateFloatRange(params.rlog_a, 1.0f, 16.0f, "rlog_a");
-    corrected |= ValidateFloatRange(params.rlog_b, 0.8f, 1.2f, "rlog_b");
-    corrected |= ValidateFloatRange(params.rlog_c, 0.5f, 3.0f, "rlog_c");
-    corrected |= ValidateFloatRange(params.rlog_t, 0.4f, 0.7f, "rlog_t");
-    
-    // 验证软膝参数
-    corrected |= ValidateFloatRange(params.yknee, 0.95f, 0.99f, "yknee");
-    corrected |= ValidateFloatRange(params.alpha, 0.2f, 1.0f, "alpha");
-    corrected |= ValidateFloatRange(params.toe, 0.0f, 0.01f, "toe");
+    // 范围取自 ParamRanges（与 ParamValidator 及钳制共用同一份定义）
+    auto correct_group = [&](const auto& ranges) {
+        for (const ParamRange& range : ranges) {
+            corrected |= ValidateFloatRange(params.*range.field, range.min_value, range.max_value, range.name);
+        }
+    };
+    correct_group(ParamRanges::PPR);
+    correct_group(ParamRanges::RLOG);
+    correct_group(ParamRanges::COMMON);
     
     return corrected;
 }
@@ -237,6 +251,11 @@ void ErrorHandler::SetErrorCallback(std::function<void(const ErrorReport&)> call
     error_callback_ = callback;
 }
 
+void ErrorHandler::SetLogSink(std::shared_ptr<AsyncLogSink> sink) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    log_sink_ = std::move(sink);
+}
+
 std::vector<std::string> ErrorHandler::GetAggregateReports() {
     std::vector<std::string> reports;
     
@@ -292,7 +311,9 @@ void ErrorHandler::CorrectParameter(float& param, float min, float max, const st
     
     // 这里可以添加详细的日志记录
     if (throttler_.ShouldLog(ErrorCode::RANGE_PIVOT)) {
-        std::cout << "[参数修正] " << oss.str() << std::endl;
+        std::lock_guard<std::mutex> lock(mutex_);
+        AsyncLogSink& sink = log_sink_ ? *log_sink_ : DefaultCorrectionSink();
+        sink.SubmitLine("[参数修正] " + oss.str());
     }
 }
 
@@ -319,13 +340,12 @@ FallbackStrategy ErrorHandler::DetermineFallbackStrategy(ErrorCode error_code) {
 }
 
 void ErrorHandler::LogError(const ErrorReport& error) {
-    // 输出到标准错误流
-    std::cerr << error.ToString() << std::endl;
-    
-    // 这里可以添加更复杂的日志记录逻辑，比如：
-    // - 写入日志文件
-    // - 发送到日志服务
-    // - 触发监控告警等
+    // 只入队，不等待I/O；格式化与写出在日志汇的后台线程完成，队列满时丢弃并计数
+    Sink().Submit(error);
+}
+
+AsyncLogSink& ErrorHandler::Sink() {
+    return log_sink_ ? *log_sink_ : AsyncLogSink::Default();
 }
 
 // ============================================================================
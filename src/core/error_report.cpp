@@ -8,6 +8,20 @@ ErrorReport::ErrorReport(ErrorCode c, const std::string& msg)
     : code(c), message(msg), timestamp(std::chrono::system_clock::now()) {
 }
 
+const char* ErrorReport::GetLevel() const {
+    switch (code) {
+        case ErrorCode::SUCCESS:
+            return "INFO";
+        case ErrorCode::RANGE_PIVOT:
+        case ErrorCode::RANGE_KNEE:
+        case ErrorCode::DET_MISMATCH:
+        case ErrorCode::HL_FLICKER:
+            return "WARN";
+        default:
+            return "ERROR";
+    }
+}
+
 std::string ErrorReport::ToString() const {
     std::ostringstream oss;
     
@@ -18,20 +32,7 @@ std::string ErrorReport::ToString() const {
     oss << "[" << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << "]";
     
     // Add error level
-    switch (code) {
-        case ErrorCode::SUCCESS:
-            oss << "[INFO]";
-            break;
-        case ErrorCode::RANGE_PIVOT:
-        case ErrorCode::RANGE_KNEE:
-        case ErrorCode::DET_MISMATCH:
-        case ErrorCode::HL_FLICKER:
-            oss << "[WARN]";
-            break;
-        default:
-            oss << "[ERROR]";
-            break;
-    }
+    oss << "[" << GetLevel() << "]";
     
     // Add clip GUID and timecode if available
     if (!clip_guid.empty()) {
@@ -43,6 +44,9 @@ std::string ErrorReport::ToString() const {
     
     // Add error code
     oss << " code=" << static_cast<int>(code);
+    if (frame_index >= 0) {
+        oss << ", frame=" << frame_index;
+    }
     
     // Add field and value if available
     if (!field_name.empty()) {
@@ -0,0 +1,190 @@
+#include "cinema_pro_hdr/error_ring.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace CinemaProHDR {
+
+namespace {
+
+// 与 ErrorField 枚举顺序一致
+const char* const kFieldNames[] = {
+    "",
+    ParamRanges::PIVOT_PQ.name,
+    ParamRanges::GAMMA_S.name,
+    ParamRanges::GAMMA_H.name,
+    ParamRanges::SHOULDER_H.name,
+    ParamRanges::RLOG_A.name,
+    ParamRanges::RLOG_B.name,
+    ParamRanges::RLOG_C.name,
+    ParamRanges::RLOG_T.name,
+    ParamRanges::BLACK_LIFT.name,
+    ParamRanges::HIGHLIGHT_DETAIL.name,
+    ParamRanges::SAT_BASE.name,
+    ParamRanges::SAT_HI.name,
+    ParamRanges::YKNEE.name,
+    ParamRanges::ALPHA.name,
+    ParamRanges::TOE.name
+};
+
+constexpr size_t kFieldCount = sizeof(kFieldNames) / sizeof(kFieldNames[0]);
+static_assert(kFieldCount == static_cast<size_t>(ErrorField::TOE) + 1, "kFieldNames out of sync with ErrorField");
+static_assert(std::is_trivially_copyable<ErrorEvent>::value, "ErrorEvent is copied word by word");
+
+} // namespace
+
+const char* ErrorFieldName(ErrorField field) {
+    const size_t index = static_cast<size_t>(field);
+    return index < kFieldCount ? kFieldNames[index] : "";
+}
+
+ErrorField ErrorFieldFromName(std::string_view name) {
+    for (size_t i = 1; i < kFieldCount; ++i) {
+        if (name == kFieldNames[i]) {
+            return static_cast<ErrorField>(i);
+        }
+    }
+    return ErrorField::NONE;
+}
+
+ErrorReport ErrorEvent::ToReport() const {
+    std::string text = message;
+    if (detail[0] != '\0') {
+        text += ": ";
+        text += detail;
+    }
+    ErrorReport report(code, text);
+    report.field_name = ErrorFieldName(field);
+    report.invalid_value = value;
+    report.frame_index = frame_index;
+    report.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(timestamp_ns)));
+    return report;
+}
+
+void ErrorEventLog::Record(ErrorCode code, const char* message, std::string_view detail,
+                           ErrorField field, float value, int64_t frame_index) {
+    ErrorEvent event;
+    event.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    event.frame_index = frame_index;
+    event.message = message ? message : "";
+    event.code = code;
+    event.field = field;
+    event.value = value;
+    size_t length = std::min(detail.size(), ErrorEvent::kDetailLength);
+    // 截断落在UTF-8多字节字符中间时退回到该字符起始处（续字节为 10xxxxxx）
+    if (length < detail.size()) {
+        while (length > 0 && (static_cast<unsigned char>(detail[length]) & 0xC0) == 0x80) {
+            --length;
+        }
+    }
+    std::memcpy(event.detail, detail.data(), length);
+    event.detail[length] = '\0';
+
+    StoreLatest(event, false);
+    if (ring_.Push(event)) {
+        recorded_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void ErrorEventLog::StoreLatest(const ErrorEvent& event, bool wait) {
+    uint64_t sequence = latest_sequence_.load(std::memory_order_relaxed);
+    while (true) {
+        if (sequence & 1) {
+            if (!wait) {
+                return;
+            }
+            std::this_thread::yield();
+            sequence = latest_sequence_.load(std::memory_order_relaxed);
+        } else if (latest_sequence_.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire,
+                                                          std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    uint64_t words[kEventWords] = {};
+    std::memcpy(words, &event, sizeof(ErrorEvent));
+    for (size_t i = 0; i < kEventWords; ++i) {
+        latest_words_[i].store(words[i], std::memory_order_relaxed);
+    }
+    latest_sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+bool ErrorEventLog::LoadLatest(ErrorEvent& event) const {
+    uint64_t words[kEventWords];
+    while (true) {
+        const uint64_t before = latest_sequence_.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (size_t i = 0; i < kEventWords; ++i) {
+            words[i] = latest_words_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (latest_sequence_.load(std::memory_order_relaxed) == before) {
+            break;
+        }
+    }
+    std::memcpy(&event, words, sizeof(ErrorEvent));
+    return event.timestamp_ns != 0;  // Clear 写入的默认事件表示无事件
+}
+
+void ErrorEventLog::DrainLocked() const {
+    ring_.Drain([this](const ErrorEvent& event) {
+        if (window_size_ == kCapacity) {
+            // 窗口已满：覆盖最旧的事件
+            window_[window_start_] = event;
+            window_start_ = (window_start_ + 1) % kCapacity;
+            evicted_++;
+        } else {
+            window_[(window_start_ + window_size_) % kCapacity] = event;
+            window_size_++;
+        }
+    });
+}
+
+std::vector<ErrorReport> ErrorEventLog::GetHistory() const {
+    std::lock_guard<std::mutex> lock(consumer_mutex_);
+    DrainLocked();
+    std::vector<ErrorReport> history;
+    history.reserve(window_size_);
+    for (size_t i = 0; i < window_size_; ++i) {
+        history.push_back(window_[(window_start_ + i) % kCapacity].ToReport());
+    }
+    return history;
+}
+
+std::string ErrorEventLog::GetLastError() const {
+    ErrorEvent event;
+    if (!LoadLatest(event)) {
+        return std::string();
+    }
+    return event.ToReport().ToString();
+}
+
+ErrorEventCounters ErrorEventLog::GetCounters() const {
+    std::lock_guard<std::mutex> lock(consumer_mutex_);
+    DrainLocked();
+    ErrorEventCounters counters;
+    counters.recorded = recorded_.load(std::memory_order_relaxed);
+    counters.dropped = ring_.GetDroppedCount();
+    counters.evicted = evicted_;
+    return counters;
+}
+
+void ErrorEventLog::Clear() {
+    std::lock_guard<std::mutex> lock(consumer_mutex_);
+    ring_.Drain([](const ErrorEvent&) {});
+    window_start_ = 0;
+    window_size_ = 0;
+    evicted_ = 0;
+    recorded_.store(0, std::memory_order_relaxed);
+    ring_.ResetDroppedCount();
+    StoreLatest(ErrorEvent(), true);
+}
+
+} // namespace CinemaProHDR
@@ -0,0 +1,251 @@
+#include "cinema_pro_hdr/half_float.h"
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CPH_HALF_F16C_RUNTIME 1
+#elif defined(_MSC_VER) && defined(__AVX2__)
+#include <immintrin.h>
+#define CPH_HALF_F16C_ALWAYS 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CPH_HALF_NEON 1
+#endif
+
+namespace CinemaProHDR {
+
+// ============================================================================
+// ImageHalf
+// ============================================================================
+
+ImageHalf::ImageHalf(int w, int h, int c)
+    : width(w), height(h), channels(c) {
+    data.resize(GetDataSize(), uint16_t(0));
+}
+
+ImageHalf::ImageHalf(int w, int h, int c, ImageInit init)
+    : width(w), height(h), channels(c) {
+    if (init == ImageInit::ZERO) {
+        data.resize(GetDataSize(), uint16_t(0));
+    } else {
+        data.resize(GetDataSize());
+    }
+}
+
+uint16_t* ImageHalf::GetPixel(int x, int y) {
+    if (x < 0 || x >= width || y < 0 || y >= height) {
+        return nullptr;
+    }
+    return &data[(static_cast<size_t>(y) * width + x) * channels];
+}
+
+const uint16_t* ImageHalf::GetPixel(int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height) {
+        return nullptr;
+    }
+    return &data[(static_cast<size_t>(y) * width + x) * channels];
+}
+
+bool ImageHalf::IsValid() const {
+    if (width <= 0 || height <= 0 || channels <= 0) {
+        return false;
+    }
+
+    if (data.size() != GetDataSize()) {
+        return false;
+    }
+
+    // 指数全1即为 Inf/NaN
+    for (uint16_t value : data) {
+        if ((value & 0x7c00u) == 0x7c00u) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// ============================================================================
+// HalfFloat
+// ============================================================================
+
+namespace HalfFloat {
+
+namespace {
+
+inline uint32_t FloatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float BitsFloat(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+#if defined(CPH_HALF_F16C_RUNTIME)
+#define CPH_HALF_F16C_TARGET __attribute__((target("avx,f16c")))
+#else
+#define CPH_HALF_F16C_TARGET
+#endif
+
+#if defined(CPH_HALF_F16C_RUNTIME) || defined(CPH_HALF_F16C_ALWAYS)
+
+CPH_HALF_F16C_TARGET
+void HalfToFloatF16C(const uint16_t* src, float* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+    }
+    for (; i < count; ++i) {
+        dst[i] = ToFloat(src[i]);
+    }
+}
+
+CPH_HALF_F16C_TARGET
+void FloatToHalfF16C(const float* src, uint16_t* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+    }
+    for (; i < count; ++i) {
+        dst[i] = FromFloat(src[i]);
+    }
+}
+
+#endif
+
+bool DetectHardware() {
+#if defined(CPH_HALF_F16C_RUNTIME)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+#elif defined(CPH_HALF_F16C_ALWAYS) || defined(CPH_HALF_NEON)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool UseHardware() {
+    static const bool supported = DetectHardware();
+    return supported;
+}
+
+} // namespace
+
+uint16_t FromFloat(float value) {
+    // 就近舍入到偶数；与 VCVTPS2PH(imm=0) 逐位一致
+    uint32_t bits = FloatBits(value);
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t abs_bits = bits & 0x7fffffffu;
+
+    if (abs_bits >= 0x47800000u) {            // |x| >= 65536 或 Inf/NaN
+        if (abs_bits > 0x7f800000u) {
+            return static_cast<uint16_t>(sign | 0x7e00u | ((abs_bits >> 13) & 0x3ffu));
+        }
+        return static_cast<uint16_t>(sign | 0x7c00u);
+    }
+
+    if (abs_bits < 0x38800000u) {             // 结果为半精度非规格化数或0
+        // 借助浮点加法完成对齐与舍入
+        const float denorm_magic = BitsFloat(((127u - 15u) + (23u - 10u) + 1u) << 23);
+        uint32_t rounded = FloatBits(BitsFloat(abs_bits) + denorm_magic) - FloatBits(denorm_magic);
+        return static_cast<uint16_t>(sign | rounded);
+    }
+
+    uint32_t mant_odd = (abs_bits >> 13) & 1u;
+    abs_bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xfffu + mant_odd;
+    return static_cast<uint16_t>(sign | (abs_bits >> 13));
+}
+
+float ToFloat(uint16_t value) {
+    const uint32_t shifted_exp = 0x7c00u << 13;
+    uint32_t bits = (static_cast<uint32_t>(value) & 0x7fffu) << 13;
+    uint32_t exp = bits & shifted_exp;
+    bits += (127u - 15u) << 23;
+
+    if (exp == shifted_exp) {                 // Inf/NaN（NaN置静默位）
+        bits += (128u - 16u) << 23;
+        if (value & 0x3ffu) {
+            bits |= 0x400000u;
+        }
+    } else if (exp == 0) {                    // 非规格化数：借助浮点减法归一化
+        bits += 1u << 23;
+        bits = FloatBits(BitsFloat(bits) - BitsFloat(113u << 23));
+    }
+
+    bits |= (static_cast<uint32_t>(value) & 0x8000u) << 16;
+    return BitsFloat(bits);
+}
+
+void FloatToHalf(const float* src, uint16_t* dst, size_t count) {
+#if defined(CPH_HALF_F16C_RUNTIME) || defined(CPH_HALF_F16C_ALWAYS)
+    if (UseHardware()) {
+        FloatToHalfF16C(src, dst, count);
+        return;
+    }
+#elif defined(CPH_HALF_NEON)
+    size_t done = 0;
+    for (; done + 4 <= count; done += 4) {
+        float16x4_t h = vcvt_f16_f32(vld1q_f32(src + done));
+        vst1_u16(dst + done, vreinterpret_u16_f16(h));
+    }
+    src += done;
+    dst += done;
+    count -= done;
+#endif
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = FromFloat(src[i]);
+    }
+}
+
+void HalfToFloat(const uint16_t* src, float* dst, size_t count) {
+#if defined(CPH_HALF_F16C_RUNTIME) || defined(CPH_HALF_F16C_ALWAYS)
+    if (UseHardware()) {
+        HalfToFloatF16C(src, dst, count);
+        return;
+    }
+#elif defined(CPH_HALF_NEON)
+    size_t done = 0;
+    for (; done + 4 <= count; done += 4) {
+        float16x4_t h = vreinterpret_f16_u16(vld1_u16(src + done));
+        vst1q_f32(dst + done, vcvt_f32_f16(h));
+    }
+    src += done;
+    dst += done;
+    count -= done;
+#endif
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = ToFloat(src[i]);
+    }
+}
+
+bool HasHardwareConversion() {
+    return UseHardware();
+}
+
+void ToImage(const ImageHalf& input, Image& output) {
+    if (output.width != input.width || output.height != input.height ||
+        output.channels != input.channels || output.data.size() != input.GetDataSize()) {
+        output = Image(input.width, input.height, input.channels, ImageInit::UNINITIALIZED);
+    }
+    output.color_space = input.color_space;
+    HalfToFloat(input.data.data(), output.data.data(), input.data.size());
+}
+
+void FromImage(const Image& input, ImageHalf& output) {
+    if (output.width != input.width || output.height != input.height ||
+        output.channels != input.channels || output.data.size() != input.GetDataSize()) {
+        output = ImageHalf(input.width, input.height, input.channels, ImageInit::UNINITIALIZED);
+    }
+    output.color_space = input.color_space;
+    FloatToHalf(input.data.data(), output.data.data(), input.data.size());
+}
+
+} // namespace HalfFloat
+
+} // namespace CinemaProHDR
@@ -1,4 +1,6 @@
 #include "cinema_pro_hdr/highlight_detail.h"
+#include "cinema_pro_hdr/recursive_gaussian.h"
+#include "cinema_pro_hdr/cpu_dispatch.h"
 #include "cinema_pro_hdr/error_handler.h"
 #include <cmath>
 #include <algorithm>
@@ -49,6 +51,112 @@ bool HighlightDetailProcessor::ProcessFrame(const Image& input, Image& output, f
     return ApplyUSM(input, output, pivot_threshold, params_.highlight_detail);
 }
 
+bool HighlightDetailProcessor::ProcessFramePlanar(const ImagePlanar& input, ImagePlanar& output, float pivot_threshold,
+                                                  float scale) {
+    return ProcessFramePlanar(input, output, pivot_threshold, scale, params_.highlight_detail);
+}
+
+bool HighlightDetailProcessor::ProcessFramePlanar(const ImagePlanar& input, ImagePlanar& output, float pivot_threshold,
+                                                  float scale, float intensity) {
+    if (!initialized_) {
+        last_error_ = "处理器未初始化";
+        return false;
+    }
+    
+    if (&input == &output || !input.IsValid()) {
+        last_error_ = "输入图像无效";
+        return false;
+    }
+    
+    if (intensity <= 0.0f) {
+        output = input;
+        output.DropLuma();
+        return true;
+    }
+    
+    return ApplyUSMPlanar(input, output, pivot_threshold, intensity, scale);
+}
+
+float HighlightDetailProcessor::ComputeMotionEnergyLuma(const float* current_luma, const float* previous_luma,
+                                                        size_t count, float pivot_threshold) {
+    /**
+     * 计算运动能量 - 运动保护机制的核心
+     * 
+     * 按照需求 7.2 实现帧间差分检测：
+     * - 帧差RMS能量计算，单位为PQ归一化
+     * - 仅在高光区域（x>p）计算运动
+     * - 阈值为0.02（PQ归一化单位）
+     * 
+     * 运动历史传入的是降采样亮度平面，逐帧代价约为整帧的1/16。
+     * 
+     * 满足需求：
+     * - 需求 7.2: 帧差RMS能量<阈值（默认0.02，单位PQ归一）
+     * - 需求 7.3: 运动保护防止闪烁增加>20%
+     */
+    
+    float total_energy = 0.0f;
+    int pixel_count = 0;
+    
+    for (size_t i = 0; i < count; ++i) {
+        if (current_luma[i] > pivot_threshold) {
+            float diff = current_luma[i] - previous_luma[i];
+            total_energy += diff * diff;
+            pixel_count++;
+        }
+    }
+    
+    if (pixel_count == 0) {
+        return 0.0f;
+    }
+    
+    float rms_energy = std::sqrt(total_energy / pixel_count);
+    return std::clamp(rms_energy, 0.0f, 1.0f);
+}
+
+bool HighlightDetailProcessor::EstimateMotion(MotionHistory& history, float pivot_threshold, MotionMap& map) {
+    if (!history.ComputeMotionMap(pivot_threshold, kMotionThreshold, map)) {
+        return false;
+    }
+    
+    // 记录运动能量历史（保持最近10帧），再逐块决定是否抑制
+    history.PushEnergy(map.GlobalEnergy());
+    ShouldSuppressDetail(map, history);
+    return true;
+}
+
+const MotionMap* HighlightDetailProcessor::UpdateMotionProtection(MotionHistory& history, const float* luma,
+                                                                  int width, int height, float pivot_threshold,
+                                                                  MotionMap& map) {
+    history.PushLuma(luma, width, height);
+    return EstimateMotion(history, pivot_threshold, map) ? &map : nullptr;
+}
+
+float HighlightDetailProcessor::MotionProtectedIntensity(float intensity, const MotionHistory& history) {
+    if (history.GetEnergyCount() == 0) {
+        return intensity;
+    }
+    return ShouldSuppressDetail(history.GetLatestEnergy(), history) ? intensity * 0.5f : intensity;
+}
+
+int HighlightDetailProcessor::ScaledUSMRadius(float scale, float sigma) {
+    // 核覆盖±2σ：默认σ=1时全分辨率半径为kUSMRadius
+    const float extent = 2.0f * ClampUSMSigma(sigma) * std::min(scale, 1.0f);
+    return std::max(1, static_cast<int>(std::ceil(extent)));
+}
+
+int HighlightDetailProcessor::USMHaloRadius(const UnsharpMaskOptions& options) {
+    const float sigma = ClampUSMSigma(options.sigma);
+    const int radius = ScaledUSMRadius(1.0f, sigma);
+    if (options.gaussian_method == GaussianMethod::RECURSIVE && sigma >= RecursiveGaussian::kMinSigma) {
+        return std::max(radius, static_cast<int>(std::ceil(RecursiveGaussian::kPaddingSigmas * sigma)));
+    }
+    return radius;
+}
+
+float HighlightDetailProcessor::ClampUSMSigma(float sigma) {
+    return std::isfinite(sigma) ? std::clamp(sigma, kMinUSMSigma, kMaxUSMSigma) : 1.0f;
+}
+
 bool HighlightDetailProcessor::ProcessFrameWithMotionProtection(const Image& current_frame, 
                                                                 const Image* previous_frame,
                                                                 Image& output, 
@@ -58,34 +166,29 @@ bool HighlightDetailProcessor::ProcessFrameWithMotionProtection(const Image& cur
         return false;
     }
     
-    float effective_intensity = params_.highlight_detail;
+    // 当前帧只以亮度金字塔进入历史（环形缓冲复用最旧槽位）
+    motion_history_.PushFrame(current_frame);
     
-    // 如果有前一帧，进行运动检测
-    if (previous_frame && previous_frame->IsValid() && has_previous_frame_) {
-        float motion_energy = ComputeMotionEnergy(current_frame, *previous_frame, pivot_threshold);
-        
-        // 记录运动能量历史
-        motion_energy_history_.push_back(motion_energy);
-        if (motion_energy_history_.size() > 10) { // 保持最近10帧的历史
-            motion_energy_history_.erase(motion_energy_history_.begin());
-        }
-        
-        // 根据运动能量调整强度
-        if (ShouldSuppressDetail(motion_energy)) {
-            effective_intensity *= 0.5f; // 运动保护：降低强度
-        }
+    // 没有前一帧：整帧按原强度处理
+    if (!previous_frame || !previous_frame->IsValid() ||
+        !EstimateMotion(motion_history_, pivot_threshold, motion_map_)) {
+        return ApplyUSM(current_frame, output, pivot_threshold, params_.highlight_detail);
     }
     
-    // 应用USM处理
-    bool result = ApplyUSM(current_frame, output, pivot_threshold, effective_intensity);
-    
-    // 更新前一帧
-    if (result) {
-        previous_frame_ = current_frame;
-        has_previous_frame_ = true;
+    // 按分块运动图局部降低强度（平面路径与 ApplyUSM 结果一致）
+    try {
+        ImagePlanar planar;
+        ImagePlanar result;
+        PlanarLayout::Deinterleave(current_frame, planar);
+        UnsharpMaskPlanar(planar, result, pivot_threshold, params_.highlight_detail, 1.0f, &motion_map_,
+                          usm_options_);
+        PlanarLayout::Interleave(result, output, &current_frame);
+        output.color_space = current_frame.color_space;
+        return true;
+    } catch (const std::exception& e) {
+        last_error_ = std::string("USM处理异常: ") + e.what();
+        return false;
     }
-    
-    return result;
 }
 
 bool HighlightDetailProcessor::ValidateFrequencyConstraints(const std::vector<Image>& frame_sequence, float fps) const {
@@ -134,9 +237,7 @@ bool HighlightDetailProcessor::ValidateFrequencyConstraints(const std::vector<Im
 }
 
 void HighlightDetailProcessor::Reset() {
-    has_previous_frame_ = false;
-    motion_energy_history_.clear();
-    previous_frame_.Clear();
+    motion_history_.Clear();
 }
 
 bool HighlightDetailProcessor::ApplyUSM(const Image& input, Image& output, float pivot_threshold, float intensity) {
@@ -145,7 +246,7 @@ bool HighlightDetailProcessor::ApplyUSM(const Image& input, Image& output, float
      * 
      * 按照需求 2.3 的规格实现：
      * - 仅作用于 x>p 区域（高光区域）
-     * - r=2px（高斯模糊半径）
+     * - r=2px（高斯模糊半径；默认σ=1，可经 UnsharpMaskOptions::sigma 调整）
      * - amount=intensity（由参数控制，范围[0,1]）
      * - thr=0.03（阈值，避免噪声放大）
      * 
@@ -163,8 +264,19 @@ bool HighlightDetailProcessor::ApplyUSM(const Image& input, Image& output, float
      */
     
     try {
+        // LUMA域：只有一个平面需要模糊，直接走平面内核（额外通道原样带回）
+        if (usm_options_.detail_domain == DetailDomain::LUMA && input.channels >= 3) {
+            ImagePlanar planar;
+            ImagePlanar result;
+            PlanarLayout::Deinterleave(input, planar);
+            UnsharpMaskPlanar(planar, result, pivot_threshold, intensity, 1.0f, nullptr, usm_options_);
+            PlanarLayout::Interleave(result, output, &input);
+            output.color_space = input.color_space;
+            return true;
+        }
+        
         // 初始化输出图像
-        output = Image(input.width, input.height, input.channels);
+        output = Image(input.width, input.height, input.channels, ImageInit::UNINITIALIZED);
         output.color_space = input.color_space;
         
         // 创建高光掩码
@@ -173,7 +285,8 @@ bool HighlightDetailProcessor::ApplyUSM(const Image& input, Image& output, float
         
         // 应用高斯模糊
         Image blurred;
-        ApplyGaussianBlur(input, blurred, 2, 1.0f); // r=2px, sigma=1.0
+        const float sigma = ClampUSMSigma(usm_options_.sigma);  // 默认 r=2px, sigma=1.0
+        ApplyGaussianBlur(input, blurred, ScaledUSMRadius(1.0f, sigma), sigma);
         
         // 计算细节层
         Image detail_layer;
@@ -192,14 +305,20 @@ bool HighlightDetailProcessor::ApplyUSM(const Image& input, Image& output, float
                 }
                 
                 float mask_value = mask_pixel[0]; // 掩码强度
+                const int color_channels = std::min(input.channels, 3);
                 
-                for (int c = 0; c < input.channels; ++c) {
+                for (int c = 0; c < color_channels; ++c) {
                     // 基础值 + 细节增强 * 掩码强度
                     output_pixel[c] = input_pixel[c] + detail_pixel[c] * mask_value;
                     
                     // 钳制到有效范围
                     output_pixel[c] = std::clamp(output_pixel[c], 0.0f, 1.0f);
                 }
+                
+                // 额外通道（Alpha等）不参与锐化，原样保留
+                for (int c = color_channels; c < input.channels; ++c) {
+                    output_pixel[c] = input_pixel[c];
+                }
             }
         }
         
@@ -211,63 +330,235 @@ bool HighlightDetailProcessor::ApplyUSM(const Image& input, Image& output, float
     }
 }
 
-float HighlightDetailProcessor::ComputeMotionEnergy(const Image& current, const Image& previous, float pivot_threshold) {
+bool HighlightDetailProcessor::ApplyUSMPlanar(const ImagePlanar& input, ImagePlanar& output, float pivot_threshold, float intensity,
+                                              float scale) {
+    try {
+        UnsharpMaskPlanar(input, output, pivot_threshold, intensity, scale, nullptr, usm_options_);
+        return true;
+    } catch (const std::exception& e) {
+        last_error_ = std::string("USM处理异常: ") + e.what();
+        return false;
+    }
+}
+
+void HighlightDetailProcessor::UnsharpMaskPlanar(const ImagePlanar& input, ImagePlanar& output, float pivot_threshold,
+                                                 float intensity, float scale, const MotionMap* motion_map,
+                                                 const UnsharpMaskOptions& options) {
     /**
-     * 计算运动能量 - 运动保护机制的核心
-     * 
-     * 按照需求 7.2 实现帧间差分检测：
-     * - 帧差RMS能量计算，单位为PQ归一化
-     * - 仅在高光区域（x>p）计算运动
-     * - 阈值为0.02（PQ归一化单位）
-     * 
-     * 方法：
-     * 1. 计算帧间差分（当前帧 - 前一帧）
-     * 2. 仅在高光区域计算能量（MaxRGB > pivot_threshold）
-     * 3. 计算RMS能量并归一化到[0,1]范围
-     * 4. 用于运动保护决策（>0.02时启用保护）
-     * 
-     * 满足需求：
-     * - 需求 7.2: 帧差RMS能量<阈值（默认0.02，单位PQ归一）
-     * - 需求 7.3: 运动保护防止闪烁增加>20%
+     * ApplyUSM 的平面版本：掩码、模糊、阈值与合成的运算顺序完全相同，
+     * 每个通道在连续平面上独立处理，行内循环可直接向量化。
+     * LUMA域只模糊MaxRGB平面：目标亮度 = 亮度 + 细节×掩码，RGB按目标/原亮度等比缩放。
      */
     
-    if (current.width != previous.width || current.height != previous.height) {
-        return 0.0f; // 尺寸不匹配
-    }
+    const int width = input.width;
+    const int height = input.height;
+    const size_t count = input.GetPixelCount();
+    const float sigma = ClampUSMSigma(options.sigma) * std::min(scale, 1.0f);
+    std::vector<float> kernel;
+    const int radius = ComputeUSMKernel(scale, kernel, options.sigma);
+    const int taps = static_cast<int>(kernel.size());
     
-    float total_energy = 0.0f;
-    int pixel_count = 0;
+    if (output.width != width || output.height != height || output.planes[0].size() != count) {
+        output = ImagePlanar(width, height, ImageInit::UNINITIALIZED);
+    }
+    output.color_space = input.color_space;
+    output.DropLuma();
+    
+    // 高光掩码：优先复用色调映射阶段生成的MaxRGB平面（LUMA域没有该平面时另行计算）
+    const bool luma_domain = options.detail_domain == DetailDomain::LUMA;
+    ImageBuffer mask(count);
+    const float* luma = input.HasLuma() ? input.luma.data() : nullptr;
+    const float* in_r = input.Plane(0);
+    const float* in_g = input.Plane(1);
+    const float* in_b = input.Plane(2);
+    HighlightMaskRow(luma, in_r, in_g, in_b, mask.data(), count, pivot_threshold);
+    ImageBuffer computed_luma;
+    if (!luma && luma_domain) {
+        computed_luma = ImageBuffer(count);
+        for (size_t i = 0; i < count; ++i) {
+            computed_luma[i] = std::max(in_r[i], std::max(in_g[i], in_b[i]));
+        }
+        luma = computed_luma.data();
+    }
     
-    for (int y = 0; y < current.height; ++y) {
-        for (int x = 0; x < current.width; ++x) {
-            const float* curr_pixel = current.GetPixel(x, y);
-            const float* prev_pixel = previous.GetPixel(x, y);
-            
-            if (!curr_pixel || !prev_pixel) continue;
-            
-            // 计算当前像素的亮度
-            float curr_luminance = std::max(curr_pixel[0], std::max(curr_pixel[1], curr_pixel[2]));
-            
-            // 仅在高光区域计算运动
-            if (curr_luminance > pivot_threshold) {
-                float prev_luminance = std::max(prev_pixel[0], std::max(prev_pixel[1], prev_pixel[2]));
-                float diff = curr_luminance - prev_luminance;
-                total_energy += diff * diff;
-                pixel_count++;
+    // 运动保护：逐像素细节强度系数并入掩码（三个通道共用）
+    if (motion_map && motion_map->Matches(width, height)) {
+        std::vector<float> row_scale(width);
+        for (int y = 0; y < height; ++y) {
+            motion_map->FillRowScale(y, width, row_scale.data());
+            float* mask_row = mask.data() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                mask_row[x] *= row_scale[x];
             }
         }
     }
     
-    if (pixel_count == 0) {
-        return 0.0f;
+    ImageBuffer temp(count);
+    ImageBuffer blurred(count);
+    const bool recursive = options.gaussian_method == GaussianMethod::RECURSIVE &&
+                           sigma >= RecursiveGaussian::kMinSigma;
+    const RecursiveGaussian recursive_blur(sigma);
+    std::vector<const float*> tap_rows(taps);
+    
+    auto blur_plane = [&](const float* src) {
+        if (recursive) {
+            recursive_blur.BlurPlane(src, blurred.data(), width, height, temp);
+            return;
+        }
+        
+        for (int y = 0; y < height; ++y) {
+            BlurRowHorizontal(src + static_cast<size_t>(y) * width, temp.data() + static_cast<size_t>(y) * width,
+                              width, kernel);
+        }
+        for (int y = 0; y < height; ++y) {
+            for (int k = 0; k < taps; ++k) {
+                int src_y = std::clamp(y + k - radius, 0, height - 1);
+                tap_rows[k] = temp.data() + static_cast<size_t>(src_y) * width;
+            }
+            BlurRowVertical(tap_rows.data(), kernel, blurred.data() + static_cast<size_t>(y) * width, width);
+        }
+    };
+    
+    if (luma_domain) {
+        blur_plane(luma);
+        const float* src_planes[3] = {in_r, in_g, in_b};
+        float* dst_planes[3] = {output.Plane(0), output.Plane(1), output.Plane(2)};
+        ComposeLumaDetailRow(luma, blurred.data(), mask.data(), src_planes, dst_planes, count, intensity);
+        return;
     }
     
-    // 归一化RMS能量
-    float rms_energy = std::sqrt(total_energy / pixel_count);
-    return std::clamp(rms_energy, 0.0f, 1.0f);
+    for (int c = 0; c < 3; ++c) {
+        const float* src = input.Plane(c);
+        blur_plane(src);
+        
+        // 细节层（thr=0.03）按掩码叠加回原图
+        ComposeDetailRow(src, blurred.data(), mask.data(), output.Plane(c), count, intensity);
+    }
+}
+
+int HighlightDetailProcessor::ComputeUSMKernel(float scale, std::vector<float>& kernel, float sigma) {
+    // 默认全分辨率 r=2px, sigma=1.0；代理分辨率下按比例缩小，保持相同的物理尺度
+    const int radius = ScaledUSMRadius(scale, sigma);
+    ComputeGaussianKernel(kernel, radius, ClampUSMSigma(sigma) * std::min(scale, 1.0f));
+    return radius;
+}
+
+namespace {
+
+CPH_KERNEL_INLINE void HighlightMaskRowKernelBody(const float* luma, const float* r, const float* g, const float* b,
+                                                  float* mask, size_t count, float pivot_threshold) {
+    for (size_t i = 0; i < count; ++i) {
+        float luminance = luma ? luma[i] : std::max(r[i], std::max(g[i], b[i]));
+        mask[i] = luminance > pivot_threshold ?
+            std::clamp((luminance - pivot_threshold) / (1.0f - pivot_threshold), 0.0f, 1.0f) : 0.0f;
+    }
 }
 
-bool HighlightDetailProcessor::ShouldSuppressDetail(float motion_energy) {
+CPH_KERNEL_INLINE void BlurRowHorizontalKernelBody(const float* row, float* out, int width, const float* kernel,
+                                                   int taps) {
+    // 边界钳制，内部区域免去钳制
+    const int radius = taps / 2;
+    for (int x = 0; x < width; ++x) {
+        float sum = 0.0f;
+        if (x >= radius && x + radius < width) {
+            const float* base = row + x - radius;
+            for (int k = 0; k < taps; ++k) {
+                sum += base[k] * kernel[k];
+            }
+        } else {
+            for (int k = 0; k < taps; ++k) {
+                int src_x = std::clamp(x + k - radius, 0, width - 1);
+                sum += row[src_x] * kernel[k];
+            }
+        }
+        out[x] = sum;
+    }
+}
+
+CPH_KERNEL_INLINE void BlurRowVerticalKernelBody(const float* const* rows, const float* kernel, int taps,
+                                                 float* out, int width) {
+    // 逐抽头累加整行，按x连续访问
+    std::fill(out, out + width, 0.0f);
+    for (int k = 0; k < taps; ++k) {
+        const float* row = rows[k];
+        const float weight = kernel[k];
+        for (int x = 0; x < width; ++x) {
+            out[x] += row[x] * weight;
+        }
+    }
+}
+
+CPH_KERNEL_INLINE void ComposeDetailRowKernelBody(const float* src, const float* blurred, const float* mask,
+                                                  float* dst, size_t count, float intensity) {
+    for (size_t i = 0; i < count; ++i) {
+        float diff = src[i] - blurred[i];
+        float detail = std::abs(diff) > 0.03f ? diff * intensity : 0.0f;
+        dst[i] = std::clamp(src[i] + detail * mask[i], 0.0f, 1.0f);
+    }
+}
+
+CPH_DISPATCH_KERNEL(HighlightMaskRowKernel,
+                    (const float* luma, const float* r, const float* g, const float* b, float* mask, size_t count,
+                     float pivot_threshold),
+                    (luma, r, g, b, mask, count, pivot_threshold))
+
+CPH_DISPATCH_KERNEL(BlurRowHorizontalKernel, (const float* row, float* out, int width, const float* kernel, int taps),
+                    (row, out, width, kernel, taps))
+
+CPH_DISPATCH_KERNEL(BlurRowVerticalKernel,
+                    (const float* const* rows, const float* kernel, int taps, float* out, int width),
+                    (rows, kernel, taps, out, width))
+
+CPH_DISPATCH_KERNEL(ComposeDetailRowKernel,
+                    (const float* src, const float* blurred, const float* mask, float* dst, size_t count,
+                     float intensity),
+                    (src, blurred, mask, dst, count, intensity))
+
+} // namespace
+
+void HighlightDetailProcessor::HighlightMaskRow(const float* luma, const float* r, const float* g, const float* b,
+                                                float* mask, size_t count, float pivot_threshold) {
+    HighlightMaskRowKernel(luma, r, g, b, mask, count, pivot_threshold);
+}
+
+void HighlightDetailProcessor::BlurRowHorizontal(const float* row, float* out, int width,
+                                                 const std::vector<float>& kernel) {
+    BlurRowHorizontalKernel(row, out, width, kernel.data(), static_cast<int>(kernel.size()));
+}
+
+void HighlightDetailProcessor::BlurRowVertical(const float* const* rows, const std::vector<float>& kernel,
+                                               float* out, int width) {
+    BlurRowVerticalKernel(rows, kernel.data(), static_cast<int>(kernel.size()), out, width);
+}
+
+void HighlightDetailProcessor::ComposeDetailRow(const float* src, const float* blurred, const float* mask,
+                                                float* dst, size_t count, float intensity) {
+    ComposeDetailRowKernel(src, blurred, mask, dst, count, intensity);
+}
+
+void HighlightDetailProcessor::ComposeLumaDetailRow(const float* luma, const float* blurred, const float* mask,
+                                                    const float* const* src, float* const* dst, size_t count,
+                                                    float intensity) {
+    // 单平面细节：按目标亮度等比缩放RGB，色度比例不变；亮度为0时退化为加法
+    for (size_t i = 0; i < count; ++i) {
+        float diff = luma[i] - blurred[i];
+        float detail = std::abs(diff) > 0.03f ? diff * intensity : 0.0f;
+        float target = std::clamp(luma[i] + detail * mask[i], 0.0f, 1.0f);
+        if (luma[i] > 1e-6f) {
+            float ratio = target / luma[i];
+            for (int c = 0; c < 3; ++c) {
+                dst[c][i] = std::clamp(src[c][i] * ratio, 0.0f, 1.0f);
+            }
+        } else {
+            float offset = target - luma[i];
+            for (int c = 0; c < 3; ++c) {
+                dst[c][i] = std::clamp(src[c][i] + offset, 0.0f, 1.0f);
+            }
+        }
+    }
+}
+
+bool HighlightDetailProcessor::ShouldSuppressDetail(float motion_energy, const MotionHistory& history) {
     /**
      * 运动保护决策 - 防止闪烁的关键机制
      * 
@@ -286,7 +577,7 @@ bool HighlightDetailProcessor::ShouldSuppressDetail(float motion_energy) {
      * - 需求 7.3: 开启/关闭对比不应增加20%以上闪烁
      */
     
-    const float motion_threshold = 0.02f; // PQ归一化单位
+    const float motion_threshold = kMotionThreshold; // PQ归一化单位
     
     // 当前帧检查
     if (motion_energy > motion_threshold) {
@@ -294,10 +585,8 @@ bool HighlightDetailProcessor::ShouldSuppressDetail(float motion_energy) {
     }
     
     // 历史平均检查
-    if (!motion_energy_history_.empty()) {
-        float avg_motion = std::accumulate(motion_energy_history_.begin(), 
-                                           motion_energy_history_.end(), 0.0f) / 
-                          motion_energy_history_.size();
+    if (history.GetEnergyCount() > 0) {
+        float avg_motion = history.GetAverageEnergy();
         
         if (avg_motion > motion_threshold * 0.5f) { // 更低的历史阈值
             return true;
@@ -307,6 +596,24 @@ bool HighlightDetailProcessor::ShouldSuppressDetail(float motion_energy) {
     return false;
 }
 
+bool HighlightDetailProcessor::ShouldSuppressDetail(MotionMap& map, const MotionHistory& history) {
+    /**
+     * 分块运动保护决策：规则与整帧版本相同，但只作用于运动超过阈值的块
+     * - 块能量 > 0.02：该块细节强度降低50%
+     * - 历史平均 > 0.01：持续运动的镜头仍整帧降低
+     * 块之间的系数由USM按块中心插值，避免块边界出现强度台阶
+     */
+    
+    const bool sustained = history.GetEnergyCount() > 0 && history.GetAverageEnergy() > kMotionThreshold * 0.5f;
+    bool suppressed = false;
+    for (size_t i = 0; i < map.energy.size(); ++i) {
+        bool suppress = sustained || map.energy[i] > kMotionThreshold;
+        map.detail_scale[i] = suppress ? 0.5f : 1.0f;
+        suppressed |= suppress;
+    }
+    return suppressed;
+}
+
 std::vector<float> HighlightDetailProcessor::ComputeTemporalSpectrum(const std::vector<Image>& frames, int x, int y) const {
     /**
      * 简化的频域分析 - 1-6Hz能量约束检查
@@ -382,15 +689,33 @@ void HighlightDetailProcessor::ComputeGaussianKernel(std::vector<float>& kernel,
 }
 
 void HighlightDetailProcessor::ApplyGaussianBlur(const Image& input, Image& output, int radius, float sigma) {
-    output = Image(input.width, input.height, input.channels);
+    output = Image(input.width, input.height, input.channels, ImageInit::UNINITIALIZED);
     output.color_space = input.color_space;
     
+    // 递归实现：逐通道取出连续平面模糊后写回（与半径无关）
+    if (usm_options_.gaussian_method == GaussianMethod::RECURSIVE && sigma >= RecursiveGaussian::kMinSigma) {
+        const RecursiveGaussian recursive_blur(sigma);
+        const size_t count = static_cast<size_t>(input.width) * input.height;
+        ImageBuffer plane(count);
+        ImageBuffer scratch;
+        for (int c = 0; c < input.channels; ++c) {
+            for (size_t i = 0; i < count; ++i) {
+                plane[i] = input.data[i * input.channels + c];
+            }
+            recursive_blur.BlurPlane(plane.data(), plane.data(), input.width, input.height, scratch);
+            for (size_t i = 0; i < count; ++i) {
+                output.data[i * output.channels + c] = plane[i];
+            }
+        }
+        return;
+    }
+    
     // 计算高斯核
     std::vector<float> kernel;
     ComputeGaussianKernel(kernel, radius, sigma);
     
     // 水平模糊
-    Image temp(input.width, input.height, input.channels);
+    Image temp(input.width, input.height, input.channels, ImageInit::UNINITIALIZED);
     for (int y = 0; y < input.height; ++y) {
         for (int x = 0; x < input.width; ++x) {
             float* temp_pixel = temp.GetPixel(x, y);
@@ -436,7 +761,7 @@ void HighlightDetailProcessor::ApplyGaussianBlur(const Image& input, Image& outp
 }
 
 void HighlightDetailProcessor::ComputeUnsharpMask(const Image& original, const Image& blurred, Image& mask, float amount, float threshold) {
-    mask = Image(original.width, original.height, original.channels);
+    mask = Image(original.width, original.height, original.channels, ImageInit::UNINITIALIZED);
     mask.color_space = original.color_space;
     
     for (int y = 0; y < original.height; ++y) {
@@ -478,7 +803,7 @@ void HighlightDetailProcessor::ClampImageValues(Image& image) {
 namespace HighlightDetailUtils {
 
 void ComputeHighlightMask(const Image& image, float pivot_threshold, Image& mask) {
-    mask = Image(image.width, image.height, 1); // 单通道掩码
+    mask = Image(image.width, image.height, 1, ImageInit::UNINITIALIZED); // 单通道掩码
     mask.color_space = image.color_space;
     
     for (int y = 0; y < image.height; ++y) {
@@ -583,7 +908,7 @@ float ComputeFrameDifference(const Image& frame1, const Image& frame2, const Ima
 }
 
 void GaussianBlur(const Image& input, Image& output, int radius, float sigma) {
-    output = Image(input.width, input.height, input.channels);
+    output = Image(input.width, input.height, input.channels, ImageInit::UNINITIALIZED);
     output.color_space = input.color_space;
     
     // 计算高斯核
@@ -604,7 +929,7 @@ void GaussianBlur(const Image& input, Image& output, int radius, float sigma) {
     }
     
     // 水平模糊
-    Image temp(input.width, input.height, input.channels);
+    Image temp(input.width, input.height, input.channels, ImageInit::UNINITIALIZED);
     for (int y = 0; y < input.height; ++y) {
         for (int x = 0; x < input.width; ++x) {
             float* temp_pixel = temp.GetPixel(x, y);
@@ -9,6 +9,15 @@ Image::Image(int w, int h, int c)
     data.resize(width * height * channels, 0.0f);
 }
 
+Image::Image(int w, int h, int c, ImageInit init)
+    : width(w), height(h), channels(c) {
+    if (init == ImageInit::ZERO) {
+        data.resize(width * height * channels, 0.0f);
+    } else {
+        data.resize(width * height * channels);
+    }
+}
+
 float* Image::GetPixel(int x, int y) {
     if (x < 0 || x >= width || y < 0 || y >= height) {
         return nullptr;
@@ -46,4 +55,13 @@ void Image::Clear() {
     std::fill(data.begin(), data.end(), 0.0f);
 }
 
+RenderRect RenderRect::Intersect(const RenderRect& other) const {
+    RenderRect result(std::max(x1, other.x1), std::max(y1, other.y1),
+                      std::min(x2, other.x2), std::min(y2, other.y2));
+    if (result.IsEmpty()) {
+        return RenderRect();
+    }
+    return result;
+}
+
 } // namespace CinemaProHDR
\ No newline at end of file
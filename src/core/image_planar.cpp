@@ -0,0 +1,255 @@
+#include "cinema_pro_hdr/image_planar.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace CinemaProHDR {
+
+ImagePlanar::ImagePlanar(int w, int h, ImageInit init)
+    : width(w), height(h) {
+    size_t count = GetPixelCount();
+    for (auto& plane : planes) {
+        if (init == ImageInit::ZERO) {
+            plane.resize(count, 0.0f);
+        } else {
+            plane.resize(count);
+        }
+    }
+}
+
+bool ImagePlanar::IsValid() const {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    size_t count = GetPixelCount();
+    for (const auto& plane : planes) {
+        if (plane.size() != count) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ImagePlanar::HasFiniteSamples() const {
+    if (!IsValid()) {
+        return false;
+    }
+
+    for (const auto& plane : planes) {
+        for (float value : plane) {
+            if (!std::isfinite(value)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void ImagePlanar::ComputeLuma() {
+    size_t count = GetPixelCount();
+    if (luma.size() != count) {
+        luma = ImageBuffer(count);
+    }
+
+    const float* r = Plane(0);
+    const float* g = Plane(1);
+    const float* b = Plane(2);
+    float* l = luma.data();
+    for (size_t i = 0; i < count; ++i) {
+        l[i] = std::max(r[i], std::max(g[i], b[i]));
+    }
+}
+
+namespace PlanarLayout {
+
+namespace {
+
+// 通道数为编译期常量时编译器可展开为shuffle序列
+template <int Channels>
+void DeinterleaveRows(const float* src, float* r, float* g, float* b, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        r[i] = src[i * Channels + 0];
+        g[i] = src[i * Channels + 1];
+        b[i] = src[i * Channels + 2];
+    }
+}
+
+void DeinterleaveGeneric(const float* src, float* r, float* g, float* b, size_t count, int channels) {
+    for (size_t i = 0; i < count; ++i) {
+        const float* pixel = src + i * channels;
+        r[i] = pixel[0];
+        g[i] = pixel[1];
+        b[i] = pixel[2];
+    }
+}
+
+template <int Channels>
+void InterleaveRows(const float* r, const float* g, const float* b, float* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i * Channels + 0] = r[i];
+        dst[i * Channels + 1] = g[i];
+        dst[i * Channels + 2] = b[i];
+    }
+}
+
+void InterleaveGeneric(const float* r, const float* g, const float* b, float* dst, size_t count, int channels) {
+    for (size_t i = 0; i < count; ++i) {
+        float* pixel = dst + i * channels;
+        pixel[0] = r[i];
+        pixel[1] = g[i];
+        pixel[2] = b[i];
+    }
+}
+
+} // namespace
+
+void DeinterleavePixels(const float* src, int channels, float* r, float* g, float* b, size_t count) {
+    switch (channels) {
+        case 3: DeinterleaveRows<3>(src, r, g, b, count); break;
+        case 4: DeinterleaveRows<4>(src, r, g, b, count); break;
+        default: DeinterleaveGeneric(src, r, g, b, count, channels); break;
+    }
+}
+
+void InterleavePixels(const float* r, const float* g, const float* b, float* dst, int channels, size_t count) {
+    switch (channels) {
+        case 3: InterleaveRows<3>(r, g, b, dst, count); break;
+        case 4: InterleaveRows<4>(r, g, b, dst, count); break;
+        default: InterleaveGeneric(r, g, b, dst, count, channels); break;
+    }
+}
+
+void Deinterleave(const Image& input, ImagePlanar& output) {
+    ImageInit init = input.channels < 3 ? ImageInit::ZERO : ImageInit::UNINITIALIZED;
+    if (output.width != input.width || output.height != input.height ||
+        output.planes[0].size() != output.GetPixelCount() || init == ImageInit::ZERO) {
+        output = ImagePlanar(input.width, input.height, init);
+    }
+    output.color_space = input.color_space;
+    output.DropLuma();
+
+    if (input.channels < 3) {
+        return;
+    }
+
+    DeinterleavePixels(input.data.data(), input.channels, output.Plane(0), output.Plane(1), output.Plane(2),
+                       output.GetPixelCount());
+}
+
+void Interleave(const ImagePlanar& input, Image& output, const Image* passthrough) {
+    if (passthrough && (passthrough->width != input.width || passthrough->height != input.height ||
+                        passthrough->channels < 3)) {
+        passthrough = nullptr;
+    }
+
+    int channels = passthrough ? passthrough->channels : 3;
+    if (output.width != input.width || output.height != input.height || output.channels != channels ||
+        output.data.size() != output.GetDataSize()) {
+        output = Image(input.width, input.height, channels, ImageInit::UNINITIALIZED);
+    }
+    output.color_space = input.color_space;
+
+    const size_t count = input.GetPixelCount();
+    float* dst = output.data.data();
+    InterleavePixels(input.Plane(0), input.Plane(1), input.Plane(2), dst, channels, count);
+
+    // 额外通道（Alpha等）原样保留；原地回写时已在位
+    if (passthrough && passthrough != &output && channels > 3) {
+        const float* src = passthrough->data.data();
+        for (size_t i = 0; i < count; ++i) {
+            for (int c = 3; c < channels; ++c) {
+                dst[i * channels + c] = src[i * channels + c];
+            }
+        }
+    }
+}
+
+namespace {
+
+// 半精度分块转换的块大小（像素），块内数据留在L1中
+constexpr size_t kHalfChunkPixels = 256;
+
+} // namespace
+
+void Deinterleave(const ImageHalf& input, ImagePlanar& output) {
+    ImageInit init = input.channels < 3 ? ImageInit::ZERO : ImageInit::UNINITIALIZED;
+    if (output.width != input.width || output.height != input.height ||
+        output.planes[0].size() != output.GetPixelCount() || init == ImageInit::ZERO) {
+        output = ImagePlanar(input.width, input.height, init);
+    }
+    output.color_space = input.color_space;
+    output.DropLuma();
+
+    if (input.channels < 3) {
+        return;
+    }
+
+    const size_t count = output.GetPixelCount();
+    const int channels = input.channels;
+    const size_t chunk = std::max<size_t>(1, kHalfChunkPixels * 4 / channels);
+    std::vector<float> buffer(chunk * channels);
+    float* r = output.Plane(0);
+    float* g = output.Plane(1);
+    float* b = output.Plane(2);
+
+    for (size_t begin = 0; begin < count; begin += chunk) {
+        const size_t n = std::min(chunk, count - begin);
+        HalfFloat::HalfToFloat(input.data.data() + begin * channels, buffer.data(), n * channels);
+        switch (channels) {
+            case 3: DeinterleaveRows<3>(buffer.data(), r + begin, g + begin, b + begin, n); break;
+            case 4: DeinterleaveRows<4>(buffer.data(), r + begin, g + begin, b + begin, n); break;
+            default: DeinterleaveGeneric(buffer.data(), r + begin, g + begin, b + begin, n, channels); break;
+        }
+    }
+}
+
+void Interleave(const ImagePlanar& input, ImageHalf& output, const ImageHalf* passthrough) {
+    if (passthrough && (passthrough->width != input.width || passthrough->height != input.height ||
+                        passthrough->channels < 3)) {
+        passthrough = nullptr;
+    }
+
+    int channels = passthrough ? passthrough->channels : 3;
+    if (output.width != input.width || output.height != input.height || output.channels != channels ||
+        output.data.size() != output.GetDataSize()) {
+        output = ImageHalf(input.width, input.height, channels, ImageInit::UNINITIALIZED);
+    }
+    output.color_space = input.color_space;
+
+    const size_t count = input.GetPixelCount();
+    float rgb[kHalfChunkPixels * 3];
+    uint16_t half[kHalfChunkPixels * 3];
+    const bool copy_extra = passthrough && passthrough != &output && channels > 3;
+
+    for (size_t begin = 0; begin < count; begin += kHalfChunkPixels) {
+        const size_t n = std::min(kHalfChunkPixels, count - begin);
+        InterleaveRows<3>(input.Plane(0) + begin, input.Plane(1) + begin, input.Plane(2) + begin, rgb, n);
+        HalfFloat::FloatToHalf(rgb, half, n * 3);
+
+        uint16_t* dst = output.data.data() + begin * channels;
+        if (channels == 3) {
+            std::copy(half, half + n * 3, dst);
+            continue;
+        }
+
+        const uint16_t* extra = copy_extra ? passthrough->data.data() + begin * channels : nullptr;
+        for (size_t i = 0; i < n; ++i) {
+            uint16_t* pixel = dst + i * channels;
+            pixel[0] = half[i * 3 + 0];
+            pixel[1] = half[i * 3 + 1];
+            pixel[2] = half[i * 3 + 2];
+            if (extra) {
+                for (int c = 3; c < channels; ++c) {
+                    pixel[c] = extra[i * channels + c];
+                }
+            }
+        }
+    }
+}
+
+} // namespace PlanarLayout
+
+} // namespace CinemaProHDR
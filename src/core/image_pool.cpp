@@ -0,0 +1,225 @@
+#include "cinema_pro_hdr/image_pool.h"
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace CinemaProHDR {
+
+namespace {
+
+inline size_t RoundUp(size_t value, size_t step) {
+    return (value + step - 1) / step * step;
+}
+
+} // namespace
+
+ImagePool& ImagePool::Instance() {
+    // 有意泄漏：静态对象析构后仍可能有 Image 归还缓冲
+    static ImagePool* instance = new ImagePool();
+    return *instance;
+}
+
+ImagePool::ImagePool()
+    : max_cached_bytes_(kAdaptiveCacheLimit)
+#if defined(__linux__)
+    , huge_pages_enabled_(true)
+#else
+    , huge_pages_enabled_(false)
+#endif
+{
+}
+
+ImagePool::~ImagePool() {
+    Trim();
+}
+
+size_t ImagePool::SizeClass(size_t bytes) {
+    if (bytes <= kAlignment) {
+        return kAlignment;
+    }
+    if (bytes >= kHugePageSize) {
+        return RoundUp(bytes, kHugePageSize);
+    }
+
+    // 以最高位的1/4为步长：相邻级别最多浪费25%
+    size_t top = size_t(1);
+    while ((top << 1) <= bytes) {
+        top <<= 1;
+    }
+    size_t step = top / 4 > kAlignment ? top / 4 : kAlignment;
+    return RoundUp(bytes, step);
+}
+
+void* ImagePool::AllocateBlock(size_t class_bytes) {
+    bool huge = huge_pages_enabled_ && class_bytes >= kHugePageSize;
+    size_t alignment = huge ? kHugePageSize : kAlignment;
+
+#if defined(_MSC_VER)
+    void* ptr = _aligned_malloc(class_bytes, alignment);
+#else
+    void* ptr = std::aligned_alloc(alignment, class_bytes);
+#endif
+    if (!ptr) {
+        return nullptr;
+    }
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (huge && madvise(ptr, class_bytes, MADV_HUGEPAGE) == 0) {
+        ++stats_.huge_page_blocks;
+    }
+#endif
+    return ptr;
+}
+
+void ImagePool::FreeBlock(void* ptr) {
+#if defined(_MSC_VER)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+void* ImagePool::Acquire(size_t bytes) {
+    size_t class_bytes = SizeClass(bytes);
+    std::lock_guard<std::mutex> lock(mutex_);
+    largest_class_ = std::max(largest_class_, class_bytes);
+
+    auto it = free_lists_.find(class_bytes);
+    if (it != free_lists_.end() && !it->second.empty()) {
+        void* ptr = it->second.back().ptr;
+        it->second.pop_back();
+        stats_.cached_bytes -= class_bytes;
+        stats_.outstanding_bytes += class_bytes;
+        ++stats_.hits;
+        return ptr;
+    }
+
+    void* ptr = AllocateBlock(class_bytes);
+    if (!ptr) {
+        // 内存紧张：先归还全部空闲缓存再重试一次
+        for (auto& entry : free_lists_) {
+            for (const CachedBlock& cached : entry.second) {
+                FreeBlock(cached.ptr);
+            }
+            entry.second.clear();
+        }
+        stats_.cached_bytes = 0;
+        ptr = AllocateBlock(class_bytes);
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+    }
+
+    stats_.outstanding_bytes += class_bytes;
+    ++stats_.misses;
+    return ptr;
+}
+
+void ImagePool::Release(void* ptr, size_t bytes) {
+    if (!ptr) {
+        return;
+    }
+
+    size_t class_bytes = SizeClass(bytes);
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.outstanding_bytes -= class_bytes;
+    ++stats_.releases;
+
+    // 刚归还的块最可能被下一帧复用：腾出空间时淘汰最久未用的空闲块，而不是丢弃它
+    const size_t limit = CacheLimitLocked();
+    if (class_bytes > limit) {
+        FreeBlock(ptr);
+        ++stats_.evictions;
+        return;
+    }
+    while (stats_.cached_bytes + class_bytes > limit && EvictOldestLocked()) {
+    }
+
+    free_lists_[class_bytes].push_back({ptr, release_tick_++});
+    stats_.cached_bytes += class_bytes;
+}
+
+size_t ImagePool::CacheLimitLocked() const {
+    if (max_cached_bytes_ != kAdaptiveCacheLimit) {
+        return max_cached_bytes_;
+    }
+    // 自适应：至少容纳两块最大尺寸级别（逐帧交替的输入/输出缓冲）
+    return std::max(kMinAdaptiveCacheBytes, 2 * largest_class_);
+}
+
+bool ImagePool::EvictOldestLocked() {
+    // 每级内按归还顺序排列，各级首元素中序号最小者即全局最久未用
+    std::vector<CachedBlock>* oldest = nullptr;
+    size_t oldest_class = 0;
+    for (auto& entry : free_lists_) {
+        if (!entry.second.empty() && (!oldest || entry.second.front().tick < oldest->front().tick)) {
+            oldest = &entry.second;
+            oldest_class = entry.first;
+        }
+    }
+    if (!oldest) {
+        return false;
+    }
+    FreeBlock(oldest->front().ptr);
+    oldest->erase(oldest->begin());
+    stats_.cached_bytes -= oldest_class;
+    ++stats_.evictions;
+    return true;
+}
+
+void ImagePool::Trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : free_lists_) {
+        for (const CachedBlock& block : entry.second) {
+            FreeBlock(block.ptr);
+        }
+    }
+    free_lists_.clear();
+    stats_.cached_bytes = 0;
+}
+
+void ImagePool::SetMaxCachedBytes(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_cached_bytes_ = bytes;
+
+    // 超出新上限的空闲块按最久未用立即释放
+    const size_t limit = CacheLimitLocked();
+    while (stats_.cached_bytes > limit && EvictOldestLocked()) {
+    }
+}
+
+size_t ImagePool::GetMaxCachedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return max_cached_bytes_;
+}
+
+void ImagePool::SetHugePagesEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    huge_pages_enabled_ = enabled;
+}
+
+bool ImagePool::IsHugePagesEnabled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return huge_pages_enabled_;
+}
+
+ImagePoolStats ImagePool::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ImagePoolStats stats = stats_;
+    stats.cache_limit_bytes = CacheLimitLocked();
+    return stats;
+}
+
+void ImagePool::ResetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.hits = 0;
+    stats_.misses = 0;
+    stats_.releases = 0;
+    stats_.evictions = 0;
+    stats_.huge_page_blocks = 0;
+}
+
+} // namespace CinemaProHDR
@@ -0,0 +1,307 @@
+#include "cinema_pro_hdr/log_sink.h"
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+
+namespace CinemaProHDR {
+
+namespace {
+
+// 单批最多写出的记录数：关闭时每批之间检查截止时间
+constexpr size_t kDrainBatch = 64;
+
+// 线程安全的本地时间转换（Windows CRT 只提供参数顺序相反的 localtime_s）
+std::tm LocalTime(std::time_t time) {
+    std::tm tm = {};
+#if defined(_WIN32)
+    localtime_s(&tm, &time);
+#else
+    localtime_r(&time, &tm);
+#endif
+    return tm;
+}
+
+void AppendJsonString(std::string& out, std::string_view text) {
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            static const char kHex[] = "0123456789abcdef";
+            out += "\\u00";
+            out += kHex[(c >> 4) & 0xf];
+            out += kHex[c & 0xf];
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+void AppendJsonField(std::string& out, const char* key, std::string_view value) {
+    out += ", \"";
+    out += key;
+    out += "\": ";
+    AppendJsonString(out, value);
+}
+
+template <typename T>
+void AppendJsonNumber(std::string& out, const char* key, T value) {
+    char text[32];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    out += ", \"";
+    out += key;
+    out += "\": ";
+    out.append(text, result.ptr);
+}
+
+} // namespace
+
+// ============================================================================
+// Outputs
+// ============================================================================
+
+bool StreamLogOutput::Write(std::string_view line) {
+    stream_.write(line.data(), static_cast<std::streamsize>(line.size()));
+    stream_.put('\n');
+    return static_cast<bool>(stream_);
+}
+
+void StreamLogOutput::Flush() {
+    stream_.flush();
+}
+
+FileLogOutput::FileLogOutput(const std::string& path)
+    : file_(path, std::ios::out | std::ios::app | std::ios::binary) {
+}
+
+bool FileLogOutput::Write(std::string_view line) {
+    if (!file_.is_open()) {
+        return false;
+    }
+    file_.write(line.data(), static_cast<std::streamsize>(line.size()));
+    file_.put('\n');
+    return static_cast<bool>(file_);
+}
+
+void FileLogOutput::Flush() {
+    file_.flush();
+}
+
+RotatingFileLogOutput::RotatingFileLogOutput(const std::string& path, size_t max_bytes, int max_files)
+    : path_(path), max_bytes_(max_bytes), max_files_(max_files) {
+    std::error_code ec;
+    const auto existing = std::filesystem::file_size(path_, ec);
+    size_ = ec ? 0 : static_cast<size_t>(existing);
+    file_.open(path_, std::ios::out | std::ios::app | std::ios::binary);
+}
+
+bool RotatingFileLogOutput::Write(std::string_view line) {
+    if (size_ > 0 && size_ + line.size() + 1 > max_bytes_) {
+        Rotate();
+    }
+    if (!file_.is_open()) {
+        return false;
+    }
+    file_.write(line.data(), static_cast<std::streamsize>(line.size()));
+    file_.put('\n');
+    size_ += line.size() + 1;
+    return static_cast<bool>(file_);
+}
+
+void RotatingFileLogOutput::Flush() {
+    file_.flush();
+}
+
+void RotatingFileLogOutput::Rotate() {
+    file_.close();
+    std::error_code ec;
+    if (max_files_ > 0) {
+        std::filesystem::remove(path_ + "." + std::to_string(max_files_), ec);
+        for (int i = max_files_ - 1; i >= 1; --i) {
+            std::filesystem::rename(path_ + "." + std::to_string(i), path_ + "." + std::to_string(i + 1), ec);
+        }
+        std::filesystem::rename(path_, path_ + ".1", ec);
+    }
+    file_.clear();
+    file_.open(path_, std::ios::out | std::ios::trunc | std::ios::binary);
+    size_ = 0;
+}
+
+// ============================================================================
+// Formatting
+// ============================================================================
+
+std::string FormatLogLine(const ErrorReport& report, LogFormat format) {
+    if (format == LogFormat::TEXT) {
+        return report.ToString();
+    }
+
+    char timestamp[32];
+    const std::tm tm = LocalTime(std::chrono::system_clock::to_time_t(report.timestamp));
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &tm);
+
+    std::string line = "{\"ts\": ";
+    AppendJsonString(line, timestamp);
+    AppendJsonField(line, "level", report.GetLevel());
+    if (!report.clip_guid.empty()) {
+        AppendJsonField(line, "clip_guid", report.clip_guid);
+    }
+    if (!report.timecode.empty()) {
+        AppendJsonField(line, "tc", report.timecode);
+    }
+    AppendJsonNumber(line, "code", static_cast<int>(report.code));
+    if (report.frame_index >= 0) {
+        AppendJsonNumber(line, "frame", report.frame_index);
+    }
+    if (!report.field_name.empty()) {
+        AppendJsonField(line, "field", report.field_name);
+        AppendJsonNumber(line, "val", std::isfinite(report.invalid_value) ? report.invalid_value : 0.0f);
+    }
+    if (!report.action_taken.empty()) {
+        AppendJsonField(line, "action", report.action_taken);
+    }
+    if (!report.message.empty()) {
+        AppendJsonField(line, "msg", report.message);
+    }
+    line += '}';
+    return line;
+}
+
+// ============================================================================
+// AsyncLogSink
+// ============================================================================
+
+AsyncLogSink::AsyncLogSink(std::unique_ptr<LogOutput> output)
+    : AsyncLogSink(std::move(output), Config()) {
+}
+
+AsyncLogSink::AsyncLogSink(std::unique_ptr<LogOutput> output, const Config& config)
+    : output_(std::move(output)), config_(config) {
+    worker_ = std::thread([this]() { Run(); });
+}
+
+AsyncLogSink::~AsyncLogSink() {
+    Shutdown();
+}
+
+bool AsyncLogSink::Submit(ErrorReport report) {
+    Entry entry;
+    entry.report = std::move(report);
+    return Enqueue(std::move(entry));
+}
+
+bool AsyncLogSink::SubmitLine(std::string line) {
+    Entry entry;
+    entry.raw = true;
+    entry.line = std::move(line);
+    return Enqueue(std::move(entry));
+}
+
+bool AsyncLogSink::Enqueue(Entry entry) {
+    if (stopping_.load(std::memory_order_acquire) || !queue_.Push(std::move(entry))) {
+        return false;
+    }
+    submitted_.fetch_add(1, std::memory_order_release);
+    // 后台线程休眠时唤醒；不持锁通知，信号丢失时由 flush_interval 兜底
+    if (sleeping_.load(std::memory_order_acquire)) {
+        wake_cv_.notify_one();
+    }
+    return true;
+}
+
+bool AsyncLogSink::Flush(std::chrono::milliseconds timeout) {
+    const uint64_t target = submitted_.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    if (!worker_.joinable()) {
+        return flushed_ >= target;
+    }
+    flush_requested_ = true;
+    wake_cv_.notify_one();
+    return flushed_cv_.wait_for(lock, timeout, [&]() { return flushed_ >= target; });
+}
+
+void AsyncLogSink::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        if (stopping_.exchange(true)) {
+            return;
+        }
+    }
+    wake_cv_.notify_one();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+AsyncLogSink& AsyncLogSink::Default() {
+    static AsyncLogSink sink(std::make_unique<StreamLogOutput>(std::cerr));
+    return sink;
+}
+
+size_t AsyncLogSink::DrainBatch() {
+    return queue_.Drain([this](Entry& entry) {
+        const bool ok = entry.raw ? output_->Write(entry.line)
+                                  : output_->Write(FormatLogLine(entry.report, config_.format));
+        if (ok) {
+            written_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }, kDrainBatch);
+}
+
+void AsyncLogSink::Run() {
+    uint64_t processed = 0;
+    bool dirty = false;
+    while (true) {
+        const size_t count = DrainBatch();
+        processed += count;
+        dirty |= count > 0;
+        if (count > 0) {
+            // 积压时每批之间检查关闭请求，关闭延迟不随积压量增长
+            if (stopping_.load(std::memory_order_acquire)) {
+                break;
+            }
+            continue;
+        }
+
+        if (dirty) {
+            output_->Flush();
+            dirty = false;
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        flushed_ = processed;
+        flushed_cv_.notify_all();
+        if (stopping_.load(std::memory_order_acquire)) {
+            break;
+        }
+        sleeping_.store(true, std::memory_order_release);
+        wake_cv_.wait_for(lock, config_.flush_interval, [&]() {
+            return stopping_.load(std::memory_order_acquire) || flush_requested_ || !queue_.IsEmpty();
+        });
+        sleeping_.store(false, std::memory_order_release);
+        flush_requested_ = false;
+    }
+
+    // 关闭：截止时间内写完剩余记录，其余丢弃并计数
+    const auto deadline = std::chrono::steady_clock::now() + config_.shutdown_timeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+        const size_t count = DrainBatch();
+        processed += count;
+        if (count == 0) {
+            break;
+        }
+    }
+    const size_t abandoned = queue_.Drain([](Entry&) {});
+    abandoned_.fetch_add(abandoned, std::memory_order_relaxed);
+    output_->Flush();
+
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    flushed_ = processed + abandoned;
+    flushed_cv_.notify_all();
+}
+
+} // namespace CinemaProHDR
@@ -0,0 +1,492 @@
+#include "cinema_pro_hdr/lut_processor.h"
+#include "cinema_pro_hdr/parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CPH_LUT_SSE 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CPH_LUT_NEON 1
+#endif
+
+namespace CinemaProHDR {
+
+namespace {
+
+// NaN安全的钳制：NaN视为下界
+inline float ClampNanSafe(float x, float lo, float hi) {
+    x = x > lo ? x : lo;
+    return x < hi ? x : hi;
+}
+
+// 跨平台对齐分配
+void* AlignedAlloc(size_t alignment, size_t bytes) {
+    bytes = (bytes + alignment - 1) / alignment * alignment;
+#if defined(_MSC_VER)
+    return _aligned_malloc(bytes, alignment);
+#else
+    return std::aligned_alloc(alignment, bytes);
+#endif
+}
+
+void AlignedFree(void* ptr) {
+#if defined(_MSC_VER)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+constexpr size_t kLatticeAlignment = 64;
+
+// 去掉首尾空白
+std::string Trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+bool ParseTriple(std::istringstream& iss, float* out) {
+    return static_cast<bool>(iss >> out[0] >> out[1] >> out[2]);
+}
+
+} // namespace
+
+// ============================================================================
+// CubeLUT / CubeLUTIO
+// ============================================================================
+
+bool CubeLUT::IsValid() const {
+    if (!Has1D() && !Has3D()) return false;
+    if (Has1D() && (size_1d < 2 || table_1d.size() != static_cast<size_t>(size_1d) * 3)) return false;
+    if (Has3D() && (size_3d < 2 ||
+        table_3d.size() != static_cast<size_t>(size_3d) * size_3d * size_3d * 3)) return false;
+
+    for (int c = 0; c < 3; ++c) {
+        if (!(domain_max_1d[c] > domain_min_1d[c])) return false;
+        if (!(domain_max_3d[c] > domain_min_3d[c])) return false;
+    }
+    return true;
+}
+
+namespace CubeLUTIO {
+
+bool ParseCube(const std::string& text, CubeLUT& lut, std::string& error) {
+    /**
+     * .cube 解析
+     *
+     * 支持的关键字：TITLE、LUT_1D_SIZE、LUT_3D_SIZE、DOMAIN_MIN、DOMAIN_MAX、
+     * LUT_1D_INPUT_RANGE、LUT_3D_INPUT_RANGE；以#开头的行为注释。
+     * 数据行顺序：先1D（若有）再3D，3D中R变化最快。
+     */
+    lut = CubeLUT();
+    std::vector<float> values;
+    bool has_domain_min = false;
+    bool has_domain_max = false;
+    float domain_min[3] = {0.0f, 0.0f, 0.0f};
+    float domain_max[3] = {1.0f, 1.0f, 1.0f};
+
+    std::istringstream stream(text);
+    std::string raw_line;
+    int line_number = 0;
+
+    while (std::getline(stream, raw_line)) {
+        ++line_number;
+        std::string line = Trim(raw_line);
+        if (line.empty() || line[0] == '#') continue;
+
+        char first = line[0];
+        bool is_data = (first >= '0' && first <= '9') || first == '-' || first == '+' || first == '.';
+
+        std::istringstream iss(line);
+        if (is_data) {
+            float rgb[3];
+            if (!ParseTriple(iss, rgb)) {
+                error = "数据行格式错误，行 " + std::to_string(line_number);
+                return false;
+            }
+            values.insert(values.end(), rgb, rgb + 3);
+            continue;
+        }
+
+        std::string keyword;
+        iss >> keyword;
+
+        if (keyword == "TITLE") {
+            size_t q1 = line.find('"');
+            size_t q2 = line.rfind('"');
+            lut.title = (q1 != std::string::npos && q2 > q1) ? line.substr(q1 + 1, q2 - q1 - 1) : "";
+        } else if (keyword == "LUT_1D_SIZE") {
+            if (!(iss >> lut.size_1d) || lut.size_1d < 2 || lut.size_1d > 65536) {
+                error = "LUT_1D_SIZE 无效，行 " + std::to_string(line_number);
+                return false;
+            }
+        } else if (keyword == "LUT_3D_SIZE") {
+            if (!(iss >> lut.size_3d) || lut.size_3d < 2 || lut.size_3d > 256) {
+                error = "LUT_3D_SIZE 无效，行 " + std::to_string(line_number);
+                return false;
+            }
+        } else if (keyword == "DOMAIN_MIN") {
+            if (!ParseTriple(iss, domain_min)) {
+                error = "DOMAIN_MIN 格式错误，行 " + std::to_string(line_number);
+                return false;
+            }
+            has_domain_min = true;
+        } else if (keyword == "DOMAIN_MAX") {
+            if (!ParseTriple(iss, domain_max)) {
+                error = "DOMAIN_MAX 格式错误，行 " + std::to_string(line_number);
+                return false;
+            }
+            has_domain_max = true;
+        } else if (keyword == "LUT_1D_INPUT_RANGE" || keyword == "LUT_3D_INPUT_RANGE") {
+            float lo = 0.0f, hi = 1.0f;
+            if (!(iss >> lo >> hi)) {
+                error = keyword + " 格式错误，行 " + std::to_string(line_number);
+                return false;
+            }
+            float* dmin = keyword == "LUT_1D_INPUT_RANGE" ? lut.domain_min_1d : lut.domain_min_3d;
+            float* dmax = keyword == "LUT_1D_INPUT_RANGE" ? lut.domain_max_1d : lut.domain_max_3d;
+            dmin[0] = dmin[1] = dmin[2] = lo;
+            dmax[0] = dmax[1] = dmax[2] = hi;
+        } else {
+            // 未知关键字按规范忽略
+        }
+    }
+
+    // DOMAIN_MIN/MAX 对两种LUT都生效
+    if (has_domain_min || has_domain_max) {
+        for (int c = 0; c < 3; ++c) {
+            lut.domain_min_1d[c] = lut.domain_min_3d[c] = domain_min[c];
+            lut.domain_max_1d[c] = lut.domain_max_3d[c] = domain_max[c];
+        }
+    }
+
+    size_t expected_1d = static_cast<size_t>(lut.size_1d) * 3;
+    size_t expected_3d = static_cast<size_t>(lut.size_3d) * lut.size_3d * lut.size_3d * 3;
+    if (values.size() != expected_1d + expected_3d) {
+        error = "数据行数量与LUT尺寸不匹配";
+        return false;
+    }
+
+    lut.table_1d.assign(values.begin(), values.begin() + expected_1d);
+    lut.table_3d.assign(values.begin() + expected_1d, values.end());
+
+    if (!lut.IsValid()) {
+        error = "LUT内容无效";
+        return false;
+    }
+
+    error.clear();
+    return true;
+}
+
+bool LoadCubeFile(const std::string& path, CubeLUT& lut, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "无法打开LUT文件: " + path;
+        return false;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return ParseCube(contents.str(), lut, error);
+}
+
+} // namespace CubeLUTIO
+
+// ============================================================================
+// LutProcessor Implementation
+// ============================================================================
+
+struct LutProcessor::Impl {
+    // 1D整形LUT（按通道平面存储，便于逐通道插值）
+    int size_1d = 0;
+    std::vector<float> shaper[3];
+    float scale_1d[3] = {0.0f, 0.0f, 0.0f};
+    float offset_1d[3] = {0.0f, 0.0f, 0.0f};
+
+    // 3D格点：每个节点RGBA四元组（A为填充），64字节对齐
+    int size_3d = 0;
+    float* lattice = nullptr;
+    float scale_3d[3] = {0.0f, 0.0f, 0.0f};
+    float offset_3d[3] = {0.0f, 0.0f, 0.0f};
+
+    ~Impl() { ReleaseLattice(); }
+
+    void ReleaseLattice() {
+        if (lattice) {
+            AlignedFree(lattice);
+            lattice = nullptr;
+        }
+        size_3d = 0;
+    }
+
+    bool Build(const CubeLUT& lut) {
+        ReleaseLattice();
+        size_1d = 0;
+
+        if (lut.Has1D()) {
+            size_1d = lut.size_1d;
+            for (int c = 0; c < 3; ++c) {
+                shaper[c].resize(size_1d);
+                for (int i = 0; i < size_1d; ++i) {
+                    shaper[c][i] = lut.table_1d[i * 3 + c];
+                }
+                // 输入域线性映射到 [0, N-1]
+                scale_1d[c] = (size_1d - 1) / (lut.domain_max_1d[c] - lut.domain_min_1d[c]);
+                offset_1d[c] = -lut.domain_min_1d[c] * scale_1d[c];
+            }
+        }
+
+        if (lut.Has3D()) {
+            size_3d = lut.size_3d;
+            size_t nodes = static_cast<size_t>(size_3d) * size_3d * size_3d;
+            lattice = static_cast<float*>(AlignedAlloc(kLatticeAlignment, nodes * 4 * sizeof(float)));
+            if (!lattice) {
+                size_3d = 0;
+                return false;
+            }
+            for (size_t n = 0; n < nodes; ++n) {
+                lattice[n * 4 + 0] = lut.table_3d[n * 3 + 0];
+                lattice[n * 4 + 1] = lut.table_3d[n * 3 + 1];
+                lattice[n * 4 + 2] = lut.table_3d[n * 3 + 2];
+                lattice[n * 4 + 3] = 0.0f;
+            }
+            for (int c = 0; c < 3; ++c) {
+                scale_3d[c] = (size_3d - 1) / (lut.domain_max_3d[c] - lut.domain_min_3d[c]);
+                offset_3d[c] = -lut.domain_min_3d[c] * scale_3d[c];
+            }
+        }
+
+        return true;
+    }
+
+    inline float Shape(int c, float x) const {
+        float max_index = static_cast<float>(size_1d - 1);
+        float f = ClampNanSafe(x * scale_1d[c] + offset_1d[c], 0.0f, max_index);
+        int i0 = std::min(static_cast<int>(f), size_1d - 2);
+        float t = f - static_cast<float>(i0);
+        const float* table = shaper[c].data();
+        return table[i0] + (table[i0 + 1] - table[i0]) * t;
+    }
+
+    inline void Tetrahedral(float r, float g, float b, float* out) const {
+        /**
+         * 四面体插值
+         *
+         * 将单位立方体按 dr/dg/db 的大小关系划分为6个四面体，
+         * 每个像素只取4个顶点（三线性需8个），结果与三线性同阶精度且
+         * 在灰轴上严格保持中性。
+         */
+        const int n = size_3d;
+        const float max_index = static_cast<float>(n - 1);
+
+        float fr = ClampNanSafe(r * scale_3d[0] + offset_3d[0], 0.0f, max_index);
+        float fg = ClampNanSafe(g * scale_3d[1] + offset_3d[1], 0.0f, max_index);
+        float fb = ClampNanSafe(b * scale_3d[2] + offset_3d[2], 0.0f, max_index);
+
+        int ir = std::min(static_cast<int>(fr), n - 2);
+        int ig = std::min(static_cast<int>(fg), n - 2);
+        int ib = std::min(static_cast<int>(fb), n - 2);
+
+        float dr = fr - static_cast<float>(ir);
+        float dg = fg - static_cast<float>(ig);
+        float db = fb - static_cast<float>(ib);
+
+        const size_t sr = 4;
+        const size_t sg = static_cast<size_t>(n) * 4;
+        const size_t sb = static_cast<size_t>(n) * n * 4;
+        const float* c000 = lattice + ib * sb + ig * sg + ir * sr;
+        const float* c111 = c000 + sr + sg + sb;
+
+        const float* c1;
+        const float* c2;
+        float w0, w1, w2, w3;
+
+        if (dr > dg) {
+            if (dg > db) {          // r > g > b
+                c1 = c000 + sr; c2 = c000 + sr + sg;
+                w0 = 1.0f - dr; w1 = dr - dg; w2 = dg - db; w3 = db;
+            } else if (dr > db) {   // r > b >= g
+                c1 = c000 + sr; c2 = c000 + sr + sb;
+                w0 = 1.0f - dr; w1 = dr - db; w2 = db - dg; w3 = dg;
+            } else {                // b >= r > g
+                c1 = c000 + sb; c2 = c000 + sr + sb;
+                w0 = 1.0f - db; w1 = db - dr; w2 = dr - dg; w3 = dg;
+            }
+        } else {
+            if (db > dg) {          // b > g >= r
+                c1 = c000 + sb; c2 = c000 + sg + sb;
+                w0 = 1.0f - db; w1 = db - dg; w2 = dg - dr; w3 = dr;
+            } else if (db > dr) {   // g >= b > r
+                c1 = c000 + sg; c2 = c000 + sg + sb;
+                w0 = 1.0f - dg; w1 = dg - db; w2 = db - dr; w3 = dr;
+            } else {                // g >= r >= b
+                c1 = c000 + sg; c2 = c000 + sr + sg;
+                w0 = 1.0f - dg; w1 = dg - dr; w2 = dr - db; w3 = db;
+            }
+        }
+
+#if defined(CPH_LUT_SSE)
+        __m128 acc = _mm_mul_ps(_mm_load_ps(c000), _mm_set1_ps(w0));
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_load_ps(c1), _mm_set1_ps(w1)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_load_ps(c2), _mm_set1_ps(w2)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_load_ps(c111), _mm_set1_ps(w3)));
+        alignas(16) float result[4];
+        _mm_store_ps(result, acc);
+        out[0] = result[0];
+        out[1] = result[1];
+        out[2] = result[2];
+#elif defined(CPH_LUT_NEON)
+        float32x4_t acc = vmulq_n_f32(vld1q_f32(c000), w0);
+        acc = vmlaq_n_f32(acc, vld1q_f32(c1), w1);
+        acc = vmlaq_n_f32(acc, vld1q_f32(c2), w2);
+        acc = vmlaq_n_f32(acc, vld1q_f32(c111), w3);
+        float result[4];
+        vst1q_f32(result, acc);
+        out[0] = result[0];
+        out[1] = result[1];
+        out[2] = result[2];
+#else
+        for (int c = 0; c < 3; ++c) {
+            out[c] = c000[c] * w0 + c1[c] * w1 + c2[c] * w2 + c111[c] * w3;
+        }
+#endif
+    }
+
+    inline void ApplyPixel(const float* in, float* out) const {
+        float rgb[3] = {in[0], in[1], in[2]};
+        if (size_1d > 0) {
+            rgb[0] = Shape(0, rgb[0]);
+            rgb[1] = Shape(1, rgb[1]);
+            rgb[2] = Shape(2, rgb[2]);
+        }
+        if (size_3d > 0) {
+            Tetrahedral(rgb[0], rgb[1], rgb[2], out);
+        } else {
+            out[0] = rgb[0];
+            out[1] = rgb[1];
+            out[2] = rgb[2];
+        }
+    }
+
+    void ApplySpan(const float* input, float* output, size_t pixel_count, int channels) const {
+        for (size_t i = 0; i < pixel_count; ++i) {
+            const float* src = input + i * channels;
+            float* dst = output + i * channels;
+            // 先完整读取源像素，支持原地处理
+            for (int c = 3; c < channels; ++c) {
+                dst[c] = src[c];
+            }
+            ApplyPixel(src, dst);
+        }
+    }
+};
+
+LutProcessor::LutProcessor() : pImpl(std::make_unique<Impl>()) {
+}
+
+LutProcessor::~LutProcessor() = default;
+
+bool LutProcessor::Initialize(const CubeLUT& lut) {
+    if (!lut.IsValid()) {
+        last_error_ = "LUT内容无效";
+        return false;
+    }
+    if (!pImpl->Build(lut)) {
+        last_error_ = "LUT格点内存分配失败";
+        return false;
+    }
+    last_error_.clear();
+    return true;
+}
+
+bool LutProcessor::LoadCubeFile(const std::string& path) {
+    CubeLUT lut;
+    if (!CubeLUTIO::LoadCubeFile(path, lut, last_error_)) {
+        return false;
+    }
+    return Initialize(lut);
+}
+
+bool LutProcessor::LoadCubeFromString(const std::string& text) {
+    CubeLUT lut;
+    if (!CubeLUTIO::ParseCube(text, lut, last_error_)) {
+        return false;
+    }
+    return Initialize(lut);
+}
+
+bool LutProcessor::IsInitialized() const {
+    return pImpl->size_1d > 0 || pImpl->size_3d > 0;
+}
+
+int LutProcessor::GetLatticeSize() const {
+    return pImpl->size_3d;
+}
+
+void LutProcessor::ApplyPixel(const float* rgb_in, float* rgb_out) const {
+    if (!IsInitialized()) {
+        rgb_out[0] = rgb_in[0];
+        rgb_out[1] = rgb_in[1];
+        rgb_out[2] = rgb_in[2];
+        return;
+    }
+    pImpl->ApplyPixel(rgb_in, rgb_out);
+}
+
+void LutProcessor::Apply(const float* input, float* output, size_t pixel_count, int channels) const {
+    if (!input || !output || pixel_count == 0 || channels < 3) {
+        return;
+    }
+    if (!IsInitialized()) {
+        if (input != output) {
+            std::memcpy(output, input, pixel_count * channels * sizeof(float));
+        }
+        return;
+    }
+    pImpl->ApplySpan(input, output, pixel_count, channels);
+}
+
+bool LutProcessor::ProcessFrame(const Image& input, Image& output) {
+    if (!IsInitialized()) {
+        last_error_ = "LUT未初始化";
+        return false;
+    }
+
+    if (input.width <= 0 || input.height <= 0 || input.channels < 3 ||
+        input.data.size() != input.GetDataSize()) {
+        last_error_ = "输入图像无效";
+        return false;
+    }
+
+    if (&output != &input) {
+        output = Image(input.width, input.height, input.channels, ImageInit::UNINITIALIZED);
+    }
+    output.color_space = input.color_space;
+
+    const size_t row_floats = static_cast<size_t>(input.width) * input.channels;
+    const float* src = input.data.data();
+    float* dst = output.data.data();
+    const Impl& impl = *pImpl;
+    const int width = input.width;
+    const int channels = input.channels;
+
+    // 按行并行；每块至少16行，避免小图过度切分
+    Parallel::ParallelFor(0, input.height, [&](int y_begin, int y_end) {
+        for (int y = y_begin; y < y_end; ++y) {
+            impl.ApplySpan(src + y * row_floats, dst + y * row_floats, width, channels);
+        }
+    }, thread_count_, 16);
+
+    last_error_.clear();
+    return true;
+}
+
+} // namespace CinemaProHDR
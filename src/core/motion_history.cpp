@@ -0,0 +1,341 @@
+#include "cinema_pro_hdr/motion_history.h"
+#include "cinema_pro_hdr/highlight_detail.h"
+#include <algorithm>
+#include <cmath>
+
+namespace CinemaProHDR {
+
+// ============================================================================
+// MotionMap
+// ============================================================================
+
+float MotionMap::GlobalEnergy() const {
+    double weighted = 0.0;
+    double total = 0.0;
+    for (size_t i = 0; i < energy.size(); ++i) {
+        weighted += static_cast<double>(energy[i]) * energy[i] * weight[i];
+        total += weight[i];
+    }
+    if (total <= 0.0) {
+        return 0.0f;
+    }
+    return std::clamp(static_cast<float>(std::sqrt(weighted / total)), 0.0f, 1.0f);
+}
+
+void MotionMap::FillRowScale(int y, int width, float* out) const {
+    if (tiles_x <= 0 || tiles_y <= 0) {
+        std::fill(out, out + width, 1.0f);
+        return;
+    }
+
+    // 纵向：在相邻两行块中心之间插值
+    const float inv_tile = 1.0f / static_cast<float>(tile_size);
+    float fy = std::clamp((y + 0.5f) * inv_tile - 0.5f, 0.0f, static_cast<float>(tiles_y - 1));
+    const int ty0 = static_cast<int>(fy);
+    const int ty1 = std::min(ty0 + 1, tiles_y - 1);
+    const float wy = fy - ty0;
+    const float* row0 = detail_scale.data() + static_cast<size_t>(ty0) * tiles_x;
+    const float* row1 = detail_scale.data() + static_cast<size_t>(ty1) * tiles_x;
+
+    for (int x = 0; x < width; ++x) {
+        float fx = std::clamp((x + 0.5f) * inv_tile - 0.5f, 0.0f, static_cast<float>(tiles_x - 1));
+        const int tx0 = static_cast<int>(fx);
+        const int tx1 = std::min(tx0 + 1, tiles_x - 1);
+        const float wx = fx - tx0;
+        float top = row0[tx0] + (row0[tx1] - row0[tx0]) * wx;
+        float bottom = row1[tx0] + (row1[tx1] - row1[tx0]) * wx;
+        out[x] = top + (bottom - top) * wy;
+    }
+}
+
+// ============================================================================
+// MotionHistory
+// ============================================================================
+
+MotionHistory::MotionHistory(size_t frame_capacity, size_t energy_capacity)
+    : frames_(std::max<size_t>(frame_capacity, 2)),
+      energies_(std::max<size_t>(energy_capacity, 1), 0.0f) {
+}
+
+MotionHistory::LumaFrame& MotionHistory::AdvanceFrame(int width, int height) {
+    // 表头前移到最旧的槽位，复用其内存
+    frame_head_ = (frame_head_ + 1) % frames_.size();
+    frame_count_ = std::min(frame_count_ + 1, frames_.size());
+
+    LumaFrame& frame = frames_[frame_head_];
+    frame.source_width = width;
+    frame.source_height = height;
+    for (int level = 0; level < kPyramidLevels; ++level) {
+        const int factor = LumaFrame::LevelFactor(level);
+        LumaPlane& plane = frame.levels[level];
+        plane.width = (width + factor - 1) / factor;
+        plane.height = (height + factor - 1) / factor;
+        plane.mean.assign(static_cast<size_t>(plane.width) * plane.height, 0.0f);
+        plane.peak.assign(plane.mean.size(), 0.0f);
+    }
+    return frame;
+}
+
+void MotionHistory::BuildCoarseLevels(LumaFrame& frame) {
+    // 每层由上一层2×2合并：均值取可用样本的平均，最大值取最大
+    for (int level = 1; level < kPyramidLevels; ++level) {
+        const LumaPlane& fine = frame.levels[level - 1];
+        LumaPlane& coarse = frame.levels[level];
+        for (int y = 0; y < coarse.height; ++y) {
+            const int fy0 = 2 * y;
+            const int fy1 = std::min(fy0 + 1, fine.height - 1);
+            for (int x = 0; x < coarse.width; ++x) {
+                const int fx0 = 2 * x;
+                const int fx1 = std::min(fx0 + 1, fine.width - 1);
+                const size_t i00 = static_cast<size_t>(fy0) * fine.width + fx0;
+                const size_t i01 = static_cast<size_t>(fy0) * fine.width + fx1;
+                const size_t i10 = static_cast<size_t>(fy1) * fine.width + fx0;
+                const size_t i11 = static_cast<size_t>(fy1) * fine.width + fx1;
+                const size_t out = static_cast<size_t>(y) * coarse.width + x;
+                coarse.mean[out] = 0.25f * (fine.mean[i00] + fine.mean[i01] + fine.mean[i10] + fine.mean[i11]);
+                coarse.peak[out] = std::max(std::max(fine.peak[i00], fine.peak[i01]),
+                                            std::max(fine.peak[i10], fine.peak[i11]));
+            }
+        }
+    }
+}
+
+void MotionHistory::PushLuma(const float* luma, int width, int height) {
+    LumaFrame& frame = AdvanceFrame(width, height);
+    LumaPlane& base = frame.levels[0];
+
+    // 逐行累加到块，最后按块内实际像素数归一化（右/下边缘的块可能不完整）
+    for (int y = 0; y < height; ++y) {
+        const float* row = luma + static_cast<size_t>(y) * width;
+        const size_t offset = static_cast<size_t>(y / kDownsampleFactor) * base.width;
+        float* mean = base.mean.data() + offset;
+        float* peak = base.peak.data() + offset;
+        for (int bx = 0; bx < base.width; ++bx) {
+            const int x0 = bx * kDownsampleFactor;
+            const int x1 = std::min(x0 + kDownsampleFactor, width);
+            float sum = 0.0f;
+            float max_value = peak[bx];
+            for (int x = x0; x < x1; ++x) {
+                sum += row[x];
+                max_value = std::max(max_value, row[x]);
+            }
+            mean[bx] += sum;
+            peak[bx] = max_value;
+        }
+    }
+
+    for (int by = 0; by < base.height; ++by) {
+        const int rows = std::min(kDownsampleFactor, height - by * kDownsampleFactor);
+        float* mean = base.mean.data() + static_cast<size_t>(by) * base.width;
+        for (int bx = 0; bx < base.width; ++bx) {
+            const int cols = std::min(kDownsampleFactor, width - bx * kDownsampleFactor);
+            mean[bx] /= static_cast<float>(rows * cols);
+        }
+    }
+
+    BuildCoarseLevels(frame);
+}
+
+void MotionHistory::PushFrame(const Image& frame) {
+    // 逐块计算MaxRGB的均值与最大值
+    LumaFrame& dst = AdvanceFrame(frame.width, frame.height);
+    LumaPlane& base = dst.levels[0];
+
+    for (int by = 0; by < base.height; ++by) {
+        const int y0 = by * kDownsampleFactor;
+        const int rows = std::min(kDownsampleFactor, frame.height - y0);
+        const size_t offset = static_cast<size_t>(by) * base.width;
+        for (int bx = 0; bx < base.width; ++bx) {
+            const int x0 = bx * kDownsampleFactor;
+            const int cols = std::min(kDownsampleFactor, frame.width - x0);
+            float sum = 0.0f;
+            float max_value = 0.0f;
+            for (int y = 0; y < rows; ++y) {
+                const float* pixel = frame.data.data() +
+                    (static_cast<size_t>(y0 + y) * frame.width + x0) * frame.channels;
+                for (int x = 0; x < cols; ++x, pixel += frame.channels) {
+                    float luminance = std::max(pixel[0], std::max(pixel[1], pixel[2]));
+                    sum += luminance;
+                    max_value = std::max(max_value, luminance);
+                }
+            }
+            base.mean[offset + bx] = sum / static_cast<float>(rows * cols);
+            base.peak[offset + bx] = max_value;
+        }
+    }
+
+    BuildCoarseLevels(dst);
+}
+
+const MotionHistory::LumaFrame* MotionHistory::GetFrame(size_t age) const {
+    if (age >= frame_count_) {
+        return nullptr;
+    }
+    return &frames_[(frame_head_ + frames_.size() - age) % frames_.size()];
+}
+
+bool MotionHistory::HasPrevious() const {
+    const LumaFrame* current = GetFrame(0);
+    const LumaFrame* previous = GetFrame(1);
+    return current && previous &&
+           current->source_width == previous->source_width &&
+           current->source_height == previous->source_height;
+}
+
+float MotionHistory::ComputeMotionEnergy(float pivot_threshold) const {
+    if (!HasPrevious()) {
+        return 0.0f;
+    }
+    const LumaPlane& current = GetFrame(0)->levels[0];
+    const LumaPlane& previous = GetFrame(1)->levels[0];
+    return HighlightDetailProcessor::ComputeMotionEnergyLuma(current.mean.data(), previous.mean.data(),
+                                                             current.mean.size(), pivot_threshold);
+}
+
+namespace {
+
+/**
+ * @brief 在某一层的矩形样本范围内累加高光区帧差平方和
+ * @return 参与计算的样本数
+ */
+int AccumulateTileEnergy(const MotionHistory::LumaPlane& current, const MotionHistory::LumaPlane& previous,
+                         int x0, int y0, int x1, int y1, float pivot_threshold, double& sum_sq) {
+    int count = 0;
+    for (int y = y0; y < y1; ++y) {
+        const size_t row = static_cast<size_t>(y) * current.width;
+        for (int x = x0; x < x1; ++x) {
+            const size_t i = row + x;
+            if (current.mean[i] > pivot_threshold) {
+                double diff = static_cast<double>(current.mean[i]) - previous.mean[i];
+                sum_sq += diff * diff;
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 粗层筛查：块内当前或前一帧最大值超过阈值的样本参与均值帧差
+ *
+ * 粗层均值会被块内暗部稀释，按最大值选样本才不会漏掉移入/移出高光的边缘样本。
+ * @return 参与计算的样本数（0表示块内没有高光）
+ */
+int AccumulateCoarseEnergy(const MotionHistory::LumaPlane& current, const MotionHistory::LumaPlane& previous,
+                           int x0, int y0, int x1, int y1, float pivot_threshold, double& sum_sq) {
+    int count = 0;
+    for (int y = y0; y < y1; ++y) {
+        const size_t row = static_cast<size_t>(y) * current.width;
+        for (int x = x0; x < x1; ++x) {
+            const size_t i = row + x;
+            if (current.peak[i] > pivot_threshold || previous.peak[i] > pivot_threshold) {
+                double diff = static_cast<double>(current.mean[i]) - previous.mean[i];
+                sum_sq += diff * diff;
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+bool MotionHistory::ComputeMotionMap(float pivot_threshold, float motion_threshold, MotionMap& map) const {
+    if (!HasPrevious()) {
+        return false;
+    }
+    const LumaFrame& current = *GetFrame(0);
+    const LumaFrame& previous = *GetFrame(1);
+
+    map.tile_size = kTileSize;
+    map.source_width = current.source_width;
+    map.source_height = current.source_height;
+    map.tiles_x = (current.source_width + kTileSize - 1) / kTileSize;
+    map.tiles_y = (current.source_height + kTileSize - 1) / kTileSize;
+    const size_t tile_count = static_cast<size_t>(map.tiles_x) * map.tiles_y;
+    map.energy.assign(tile_count, 0.0f);
+    map.weight.assign(tile_count, 0.0f);
+    map.detail_scale.assign(tile_count, 1.0f);
+    map.refined_tiles = 0;
+
+    const int coarse_level = kPyramidLevels - 1;
+    const LumaPlane& coarse_cur = current.levels[coarse_level];
+    const LumaPlane& coarse_prev = previous.levels[coarse_level];
+    const LumaPlane& fine_cur = current.levels[0];
+    const LumaPlane& fine_prev = previous.levels[0];
+    const int coarse_span = kTileSize / LumaFrame::LevelFactor(coarse_level);
+    const int fine_span = kTileSize / LumaFrame::LevelFactor(0);
+    const float coarse_weight = static_cast<float>(1 << (2 * coarse_level));  // 一个粗层样本对应的第0层样本数
+
+    for (int ty = 0; ty < map.tiles_y; ++ty) {
+        for (int tx = 0; tx < map.tiles_x; ++tx) {
+            const size_t tile = static_cast<size_t>(ty) * map.tiles_x + tx;
+            const int cx0 = tx * coarse_span;
+            const int cy0 = ty * coarse_span;
+            const int cx1 = std::min(cx0 + coarse_span, coarse_cur.width);
+            const int cy1 = std::min(cy0 + coarse_span, coarse_cur.height);
+
+            double sum_sq = 0.0;
+            int count = AccumulateCoarseEnergy(coarse_cur, coarse_prev, cx0, cy0, cx1, cy1, pivot_threshold, sum_sq);
+            // 块内（当前或前一帧）没有任何高光样本：没有需要保护的细节
+            if (count == 0) {
+                continue;
+            }
+            double coarse_energy = std::sqrt(sum_sq / count);
+
+            // 粗层能量未超过阈值时回到第0层，按与整帧能量相同的定义细化
+            // （粗层样本覆盖16×16像素，样本内部的移动不改变均值）
+            if (coarse_energy <= motion_threshold) {
+                const int fx0 = tx * fine_span;
+                const int fy0 = ty * fine_span;
+                const int fx1 = std::min(fx0 + fine_span, fine_cur.width);
+                const int fy1 = std::min(fy0 + fine_span, fine_cur.height);
+                sum_sq = 0.0;
+                count = AccumulateTileEnergy(fine_cur, fine_prev, fx0, fy0, fx1, fy1, pivot_threshold, sum_sq);
+                map.energy[tile] = count > 0 ? static_cast<float>(std::sqrt(sum_sq / count)) : 0.0f;
+                map.weight[tile] = static_cast<float>(count);
+                map.refined_tiles++;
+            } else {
+                map.energy[tile] = static_cast<float>(coarse_energy);
+                map.weight[tile] = count * coarse_weight;
+            }
+        }
+    }
+
+    return true;
+}
+
+void MotionHistory::PushEnergy(float energy) {
+    if (energy_count_ == energies_.size()) {
+        energy_sum_ -= energies_[energy_head_];
+    } else {
+        energy_count_++;
+    }
+    energies_[energy_head_] = energy;
+    energy_sum_ += energy;
+    energy_head_ = (energy_head_ + 1) % energies_.size();
+}
+
+float MotionHistory::GetLatestEnergy() const {
+    if (energy_count_ == 0) {
+        return 0.0f;
+    }
+    return energies_[(energy_head_ + energies_.size() - 1) % energies_.size()];
+}
+
+float MotionHistory::GetAverageEnergy() const {
+    if (energy_count_ == 0) {
+        return 0.0f;
+    }
+    return static_cast<float>(energy_sum_ / static_cast<double>(energy_count_));
+}
+
+void MotionHistory::Clear() {
+    frame_head_ = 0;
+    frame_count_ = 0;
+    energy_head_ = 0;
+    energy_count_ = 0;
+    energy_sum_ = 0.0;
+}
+
+} // namespace CinemaProHDR
@@ -0,0 +1,169 @@
+#include "cinema_pro_hdr/parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CinemaProHDR {
+namespace Parallel {
+
+namespace {
+
+// 进程内常驻工作线程上限（请求的线程数超出时按此截断）
+constexpr int kMaxPoolThreads = 256;
+
+/**
+ * @brief 一次 ParallelFor 调用：块按原子序号领取，调用线程与工作线程共同执行
+ */
+struct ParallelJob {
+    const std::function<void(int, int)>* body = nullptr;
+    int begin = 0;
+    int chunk = 0;
+    int remainder = 0;
+    int blocks = 0;
+
+    std::atomic<int> next{0};
+    std::atomic<int> done{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr error;
+
+    // 领取并执行剩余的块；返回时本线程已不再引用 body
+    void RunBlocks() {
+        for (int block = next++; block < blocks; block = next++) {
+            const int block_begin = begin + block * chunk + std::min(block, remainder);
+            const int block_end = block_begin + chunk + (block < remainder ? 1 : 0);
+            try {
+                (*body)(block_begin, block_end);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            if (done.fetch_add(1) + 1 == blocks) {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.notify_all();
+            }
+        }
+    }
+};
+
+/**
+ * @brief 常驻工作线程池：按需增长，进程退出时回收
+ *
+ * 每次调用向队列投放 (块数-1) 张领取票；工作线程取票后帮忙执行该调用剩余的块，
+ * 票对应的调用已完成时直接丢弃。调用线程总能独自完成自己的调用，因此嵌套或并发调用不会死锁。
+ */
+class WorkerPool {
+public:
+    static WorkerPool& Instance() {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    void Post(const std::shared_ptr<ParallelJob>& job, int helpers) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const int wanted = std::min(helpers, kMaxPoolThreads);
+            while (static_cast<int>(workers_.size()) < wanted) {
+                workers_.emplace_back([this]() { WorkerLoop(); });
+            }
+            for (int i = 0; i < helpers; ++i) {
+                tickets_.push_back(job);
+            }
+        }
+        if (helpers == 1) {
+            cv_.notify_one();
+        } else {
+            cv_.notify_all();
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::shared_ptr<ParallelJob>> tickets_;
+    std::vector<std::thread> workers_;
+    bool stopping_ = false;
+
+    void WorkerLoop() {
+        while (true) {
+            std::shared_ptr<ParallelJob> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return stopping_ || !tickets_.empty(); });
+                if (stopping_ && tickets_.empty()) {
+                    return;
+                }
+                job = std::move(tickets_.front());
+                tickets_.pop_front();
+            }
+            job->RunBlocks();
+        }
+    }
+};
+
+} // namespace
+
+int HardwareThreads() {
+    unsigned int count = std::thread::hardware_concurrency();
+    return count > 0 ? static_cast<int>(count) : 1;
+}
+
+void ParallelFor(int begin, int end,
+                 const std::function<void(int, int)>& body,
+                 int num_threads,
+                 int min_block) {
+    if (end <= begin) {
+        return;
+    }
+
+    int total = end - begin;
+    int threads = num_threads > 0 ? num_threads : HardwareThreads();
+    min_block = std::max(1, min_block);
+    threads = std::clamp(total / min_block, 1, threads);
+
+    if (threads == 1) {
+        body(begin, end);
+        return;
+    }
+
+    // 均匀切分，余数分摊到前几个块
+    auto job = std::make_shared<ParallelJob>();
+    job->body = &body;
+    job->begin = begin;
+    job->chunk = total / threads;
+    job->remainder = total % threads;
+    job->blocks = threads;
+
+    WorkerPool::Instance().Post(job, threads - 1);
+
+    // 调用线程也参与计算，然后等待其他线程领走的块完成
+    job->RunBlocks();
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finished.wait(lock, [&]() { return job->done.load() == job->blocks; });
+    if (job->error) {
+        std::rethrow_exception(job->error);
+    }
+}
+
+} // namespace Parallel
+} // namespace CinemaProHDR
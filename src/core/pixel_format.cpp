@@ -0,0 +1,385 @@
+#include "cinema_pro_hdr/pixel_format.h"
+#include "cinema_pro_hdr/color_space.h"
+#include <algorithm>
+#include <cstring>
+
+namespace CinemaProHDR {
+
+namespace {
+
+// BT.2020 非恒定亮度系数
+constexpr float kKr = 0.2627f;
+constexpr float kKb = 0.0593f;
+constexpr float kKg = 1.0f - kKr - kKb;
+constexpr float kCrToR = 2.0f * (1.0f - kKr);
+constexpr float kCbToB = 2.0f * (1.0f - kKb);
+
+// 10位窄范围量化
+constexpr float kLumaOffset = 64.0f;
+constexpr float kLumaRange = 876.0f;
+constexpr float kChromaOffset = 512.0f;
+constexpr float kChromaRange = 896.0f;
+constexpr int kMax10 = 1023;
+
+// V210：6像素/16字节，行按48像素（128字节）对齐
+constexpr int kV210GroupPixels = 6;
+constexpr size_t kV210GroupBytes = 16;
+
+inline void YCbCrToRGB(float y, float cb, float cr, float* r, float* g, float* b) {
+    *r = y + kCrToR * cr;
+    *b = y + kCbToB * cb;
+    *g = (y - kKr * *r - kKb * *b) / kKg;
+}
+
+inline float LumaOf(float r, float g, float b) {
+    return kKr * r + kKg * g + kKb * b;
+}
+
+// NaN安全的量化：NaN视为下界
+inline uint16_t Quantize(float code, int max_code) {
+    code = code > 0.0f ? code : 0.0f;
+    code = code < static_cast<float>(max_code) ? code : static_cast<float>(max_code);
+    return static_cast<uint16_t>(code + 0.5f);
+}
+
+inline uint16_t EncodeLuma10(float y) {
+    return Quantize(kLumaOffset + kLumaRange * y, kMax10);
+}
+
+inline uint16_t EncodeChroma10(float c) {
+    return Quantize(kChromaOffset + kChromaRange * c, kMax10);
+}
+
+inline float DecodeLuma10(uint32_t code) {
+    return (static_cast<float>(code) - kLumaOffset) * (1.0f / kLumaRange);
+}
+
+inline float DecodeChroma10(uint32_t code) {
+    return (static_cast<float>(code) - kChromaOffset) * (1.0f / kChromaRange);
+}
+
+inline uint32_t LoadWord(const uint8_t* p) {
+    uint32_t word;
+    std::memcpy(&word, p, sizeof(word));  // 小端主机
+    return word;
+}
+
+inline void StoreWord(uint8_t* p, uint32_t a, uint32_t b, uint32_t c) {
+    uint32_t word = (a & 0x3ffu) | ((b & 0x3ffu) << 10) | ((c & 0x3ffu) << 20);
+    std::memcpy(p, &word, sizeof(word));
+}
+
+int DefaultBitDepth(PixelFormat format) {
+    return format == PixelFormat::RGB48 ? 16 : 10;
+}
+
+// ---------------------------------------------------------------------------
+// RGB48
+// ---------------------------------------------------------------------------
+
+void DecodeRGB48(const PackedImage& input, ImagePlanar& output) {
+    // 按行走整数码值路径：BT.2020 PQ 仅归一化，其他原色经精确EOTF表线性化
+    for (int y = 0; y < input.height; ++y) {
+        const uint16_t* row = reinterpret_cast<const uint16_t*>(input.data.data() + y * input.stride);
+        size_t base = static_cast<size_t>(y) * input.width;
+        ColorSpaceConverter::ToWorkingPlanarFromCodes(row, 3, output.Plane(0) + base, output.Plane(1) + base,
+                                                      output.Plane(2) + base, input.width,
+                                                      input.color_space, input.bit_depth);
+    }
+}
+
+void EncodeRGB48(const ImagePlanar& input, PackedImage& output) {
+    const size_t width = static_cast<size_t>(output.width);
+    std::vector<float> scratch(width * 3);
+    for (int y = 0; y < output.height; ++y) {
+        uint16_t* row = reinterpret_cast<uint16_t*>(output.data.data() + y * output.stride);
+        size_t base = y * width;
+        for (int c = 0; c < 3; ++c) {
+            std::copy(input.Plane(c) + base, input.Plane(c) + base + width, scratch.data() + c * width);
+        }
+        ColorSpaceConverter::FromWorkingPlanarToCodes(scratch.data(), scratch.data() + width,
+                                                      scratch.data() + 2 * width, row, 3, width,
+                                                      output.color_space, output.bit_depth);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// P010（4:2:0）
+// ---------------------------------------------------------------------------
+
+void DecodeP010(const PackedImage& input, ImagePlanar& output) {
+    const uint8_t* chroma_plane = input.data.data() + input.stride * input.height;
+    for (int y = 0; y < input.height; ++y) {
+        const uint16_t* luma_row = reinterpret_cast<const uint16_t*>(input.data.data() + y * input.stride);
+        const uint16_t* chroma_row = reinterpret_cast<const uint16_t*>(chroma_plane + (y / 2) * input.stride);
+        size_t base = static_cast<size_t>(y) * input.width;
+        for (int x = 0; x < input.width; ++x) {
+            float luma = DecodeLuma10(luma_row[x] >> 6);
+            float cb = DecodeChroma10(chroma_row[(x / 2) * 2 + 0] >> 6);
+            float cr = DecodeChroma10(chroma_row[(x / 2) * 2 + 1] >> 6);
+            YCbCrToRGB(luma, cb, cr, output.Plane(0) + base + x, output.Plane(1) + base + x,
+                       output.Plane(2) + base + x);
+        }
+    }
+}
+
+void EncodeP010(const ImagePlanar& input, PackedImage& output) {
+    const float* r = input.Plane(0);
+    const float* g = input.Plane(1);
+    const float* b = input.Plane(2);
+    const size_t width = static_cast<size_t>(output.width);
+    uint8_t* chroma_plane = output.data.data() + output.stride * output.height;
+
+    for (int y = 0; y < output.height; ++y) {
+        uint16_t* luma_row = reinterpret_cast<uint16_t*>(output.data.data() + y * output.stride);
+        for (int x = 0; x < output.width; ++x) {
+            size_t i = y * width + x;
+            luma_row[x] = static_cast<uint16_t>(EncodeLuma10(LumaOf(r[i], g[i], b[i])) << 6);
+        }
+    }
+
+    // 色度：2×2块内R'G'B'平均后再求Cb/Cr（色差对R'G'B'线性）
+    for (int y = 0; y < output.height; y += 2) {
+        uint16_t* chroma_row = reinterpret_cast<uint16_t*>(chroma_plane + (y / 2) * output.stride);
+        for (int x = 0; x < output.width; x += 2) {
+            size_t i00 = y * width + x;
+            size_t i01 = i00 + 1;
+            size_t i10 = i00 + width;
+            size_t i11 = i10 + 1;
+            float ar = 0.25f * (r[i00] + r[i01] + r[i10] + r[i11]);
+            float ag = 0.25f * (g[i00] + g[i01] + g[i10] + g[i11]);
+            float ab = 0.25f * (b[i00] + b[i01] + b[i10] + b[i11]);
+            float luma = LumaOf(ar, ag, ab);
+            chroma_row[x + 0] = static_cast<uint16_t>(EncodeChroma10((ab - luma) / kCbToB) << 6);
+            chroma_row[x + 1] = static_cast<uint16_t>(EncodeChroma10((ar - luma) / kCrToR) << 6);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// V210（4:2:2）
+// ---------------------------------------------------------------------------
+
+void DecodeV210(const PackedImage& input, ImagePlanar& output) {
+    for (int y = 0; y < input.height; ++y) {
+        const uint8_t* row = input.data.data() + y * input.stride;
+        size_t base = static_cast<size_t>(y) * input.width;
+
+        for (int gx = 0; gx < input.width; gx += kV210GroupPixels) {
+            const uint8_t* group = row + (gx / kV210GroupPixels) * kV210GroupBytes;
+            uint32_t w0 = LoadWord(group + 0);
+            uint32_t w1 = LoadWord(group + 4);
+            uint32_t w2 = LoadWord(group + 8);
+            uint32_t w3 = LoadWord(group + 12);
+
+            // w0: Cb0 Y0 Cr0 | w1: Y1 Cb1 Y2 | w2: Cr1 Y3 Cb2 | w3: Y4 Cr2 Y5
+            uint32_t luma[6] = {
+                (w0 >> 10) & 0x3ffu, w1 & 0x3ffu, (w1 >> 20) & 0x3ffu,
+                (w2 >> 10) & 0x3ffu, w3 & 0x3ffu, (w3 >> 20) & 0x3ffu
+            };
+            uint32_t cb[3] = {w0 & 0x3ffu, (w1 >> 10) & 0x3ffu, (w2 >> 20) & 0x3ffu};
+            uint32_t cr[3] = {(w0 >> 20) & 0x3ffu, w2 & 0x3ffu, (w3 >> 10) & 0x3ffu};
+
+            int count = std::min(kV210GroupPixels, input.width - gx);
+            for (int k = 0; k < count; ++k) {
+                size_t i = base + gx + k;
+                YCbCrToRGB(DecodeLuma10(luma[k]), DecodeChroma10(cb[k / 2]), DecodeChroma10(cr[k / 2]),
+                           output.Plane(0) + i, output.Plane(1) + i, output.Plane(2) + i);
+            }
+        }
+    }
+}
+
+void EncodeV210(const ImagePlanar& input, PackedImage& output) {
+    const float* r = input.Plane(0);
+    const float* g = input.Plane(1);
+    const float* b = input.Plane(2);
+
+    for (int y = 0; y < output.height; ++y) {
+        uint8_t* row = output.data.data() + y * output.stride;
+        size_t base = static_cast<size_t>(y) * output.width;
+
+        for (int gx = 0; gx < output.width; gx += kV210GroupPixels) {
+            uint32_t luma[6] = {0, 0, 0, 0, 0, 0};
+            uint32_t cb[3] = {512, 512, 512};
+            uint32_t cr[3] = {512, 512, 512};
+
+            int count = std::min(kV210GroupPixels, output.width - gx);
+            for (int k = 0; k < count; ++k) {
+                size_t i = base + gx + k;
+                luma[k] = EncodeLuma10(LumaOf(r[i], g[i], b[i]));
+            }
+            for (int k = 0; k < count; k += 2) {
+                // 色度取水平像素对的平均；行尾落单像素单独使用
+                size_t i0 = base + gx + k;
+                size_t i1 = (k + 1 < count) ? i0 + 1 : i0;
+                float ar = 0.5f * (r[i0] + r[i1]);
+                float ag = 0.5f * (g[i0] + g[i1]);
+                float ab = 0.5f * (b[i0] + b[i1]);
+                float l = LumaOf(ar, ag, ab);
+                cb[k / 2] = EncodeChroma10((ab - l) / kCbToB);
+                cr[k / 2] = EncodeChroma10((ar - l) / kCrToR);
+            }
+
+            uint8_t* group = row + (gx / kV210GroupPixels) * kV210GroupBytes;
+            StoreWord(group + 0, cb[0], luma[0], cr[0]);
+            StoreWord(group + 4, luma[1], cb[1], luma[2]);
+            StoreWord(group + 8, cr[1], luma[3], cb[2]);
+            StoreWord(group + 12, luma[4], cr[2], luma[5]);
+        }
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// PackedImage
+// ============================================================================
+
+PackedImage::PackedImage(PixelFormat fmt, int w, int h, int depth)
+    : format(fmt), width(w), height(h) {
+    bit_depth = depth > 0 ? depth : DefaultBitDepth(fmt);
+    stride = MinStride(fmt, w);
+    data.resize(GetDataSize(), uint8_t(0));
+}
+
+size_t PackedImage::MinStride(PixelFormat format, int width) {
+    if (width <= 0) {
+        return 0;
+    }
+    switch (format) {
+        case PixelFormat::RGB48:
+            return static_cast<size_t>(width) * 3 * sizeof(uint16_t);
+        case PixelFormat::P010:
+            return static_cast<size_t>(width) * sizeof(uint16_t);
+        case PixelFormat::V210:
+            return (static_cast<size_t>(width) + 47) / 48 * 128;
+    }
+    return 0;
+}
+
+size_t PackedImage::GetDataSize() const {
+    if (height <= 0) {
+        return 0;
+    }
+    if (format == PixelFormat::P010) {
+        return stride * height + stride * (height / 2);
+    }
+    return stride * height;
+}
+
+bool PackedImage::IsValid() const {
+    if (width <= 0 || height <= 0 || stride < MinStride(format, width)) {
+        return false;
+    }
+
+    switch (format) {
+        case PixelFormat::RGB48:
+            if (bit_depth != 10 && bit_depth != 12 && bit_depth != 16) return false;
+            break;
+        case PixelFormat::P010:
+            if (bit_depth != 10 || (width % 2) != 0 || (height % 2) != 0) return false;
+            break;
+        case PixelFormat::V210:
+            if (bit_depth != 10) return false;
+            break;
+    }
+
+    // YCbCr矩阵按BT.2020定义，仅RGB48可承载其他原色
+    if (format != PixelFormat::RGB48 && color_space != ColorSpace::BT2020_PQ) {
+        return false;
+    }
+
+    // 16位格式按元素访问，行跨度需保持2字节对齐
+    if (format != PixelFormat::V210 && (stride % sizeof(uint16_t)) != 0) {
+        return false;
+    }
+
+    return data.size() >= GetDataSize();
+}
+
+// ============================================================================
+// PixelFormatIO
+// ============================================================================
+
+namespace PixelFormatIO {
+
+bool Decode(const PackedImage& input, ImagePlanar& output) {
+    if (!input.IsValid()) {
+        return false;
+    }
+
+    if (output.width != input.width || output.height != input.height ||
+        output.planes[0].size() != output.GetPixelCount()) {
+        output = ImagePlanar(input.width, input.height, ImageInit::UNINITIALIZED);
+    }
+    output.color_space = ColorSpace::BT2020_PQ;
+    output.DropLuma();
+
+    switch (input.format) {
+        case PixelFormat::RGB48: DecodeRGB48(input, output); break;
+        case PixelFormat::P010: DecodeP010(input, output); break;
+        case PixelFormat::V210: DecodeV210(input, output); break;
+    }
+    return true;
+}
+
+bool Decode(const PackedImage& input, Image& output) {
+    ImagePlanar planar;
+    if (!Decode(input, planar)) {
+        return false;
+    }
+    PlanarLayout::Interleave(planar, output);
+    return true;
+}
+
+bool Encode(const ImagePlanar& input, PackedImage& output) {
+    if (input.width <= 0 || input.height <= 0) {
+        return false;
+    }
+
+    if (output.bit_depth <= 0) {
+        output.bit_depth = DefaultBitDepth(output.format);
+    }
+    if (output.width != input.width || output.height != input.height ||
+        output.stride < PackedImage::MinStride(output.format, input.width)) {
+        output.width = input.width;
+        output.height = input.height;
+        output.stride = PackedImage::MinStride(output.format, input.width);
+    }
+    if (output.data.size() < output.GetDataSize()) {
+        output.data.resize(output.GetDataSize(), uint8_t(0));
+    }
+    if (!output.IsValid()) {
+        return false;
+    }
+
+    switch (output.format) {
+        case PixelFormat::RGB48: EncodeRGB48(input, output); break;
+        case PixelFormat::P010: EncodeP010(input, output); break;
+        case PixelFormat::V210: EncodeV210(input, output); break;
+    }
+    return true;
+}
+
+bool Encode(const Image& input, PackedImage& output) {
+    if (input.channels < 3) {
+        return false;
+    }
+    ImagePlanar planar;
+    PlanarLayout::Deinterleave(input, planar);
+    return Encode(planar, output);
+}
+
+std::string PixelFormatToString(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::RGB48: return "RGB48";
+        case PixelFormat::P010: return "P010";
+        case PixelFormat::V210: return "V210";
+        default: return "UNKNOWN";
+    }
+}
+
+} // namespace PixelFormatIO
+
+} // namespace CinemaProHDR
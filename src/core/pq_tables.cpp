@@ -0,0 +1,230 @@
+#include "cinema_pro_hdr/color_space.h"
+#include "cinema_pro_hdr/cpu_dispatch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+namespace CinemaProHDR {
+
+namespace {
+
+// 线性值上限（cd/m²）及其float位模式；OETF分段索引按位模式高位划分
+constexpr float kPQPeakNits = 10000.0f;
+constexpr uint32_t kPeakBits = 0x461C4000u;
+constexpr int kSegmentShift = 15;
+constexpr size_t kSegmentCount = (kPeakBits >> kSegmentShift) + 1;
+
+/**
+ * @brief 单一位深的PQ码值表
+ *
+ * eotf[k]       = PQ_EOTF(k / max)，逐位与标量函数一致
+ * thresholds[k] = 码值k的线性下界（PQ = (k - 0.5) / max 处，双精度求得），单调不减
+ * segments[s]   = 位模式 s << kSegmentShift 处的码值，用于把二分查找限制在少数候选内
+ */
+struct PQCodeTable {
+    int max_code = 0;
+    std::vector<float> eotf;
+    std::vector<float> thresholds;
+    std::vector<uint16_t> segments;
+};
+
+double PQ_EOTF_Double(double pq_value) {
+    const double m1 = 2610.0 / 16384.0;
+    const double m2 = 2523.0 / 32.0;
+    const double c1 = 3424.0 / 4096.0;
+    const double c2 = 2413.0 / 128.0;
+    const double c3 = 2392.0 / 128.0;
+
+    if (pq_value <= 0.0) return 0.0;
+    if (pq_value >= 1.0) return kPQPeakNits;
+    double p = std::pow(pq_value, 1.0 / m2);
+    double numerator = std::max(0.0, p - c1);
+    return std::pow(numerator / (c2 - c3 * p), 1.0 / m1) * kPQPeakNits;
+}
+
+inline float BitsFloat(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void BuildTable(PQCodeTable& table, int bit_depth) {
+    const int max_code = (1 << bit_depth) - 1;
+    const float max_f = static_cast<float>(max_code);
+    table.max_code = max_code;
+
+    table.eotf.resize(max_code + 1);
+    for (int k = 0; k <= max_code; ++k) {
+        table.eotf[k] = ColorSpaceConverter::PQ_EOTF(static_cast<float>(k) / max_f);
+    }
+
+    table.thresholds.resize(max_code + 1);
+    table.thresholds[0] = 0.0f;
+    for (int k = 1; k <= max_code; ++k) {
+        float t = static_cast<float>(PQ_EOTF_Double((k - 0.5) / max_code));
+        table.thresholds[k] = std::max(t, table.thresholds[k - 1]);
+    }
+
+    const float* first = table.thresholds.data() + 1;
+    const float* last = table.thresholds.data() + max_code + 1;
+    table.segments.resize(kSegmentCount + 1);
+    for (size_t s = 0; s < kSegmentCount; ++s) {
+        float start = BitsFloat(static_cast<uint32_t>(s) << kSegmentShift);
+        table.segments[s] = static_cast<uint16_t>(std::upper_bound(first, last, start) - first);
+    }
+    table.segments[kSegmentCount] = static_cast<uint16_t>(max_code);
+}
+
+int TableIndex(int bit_depth) {
+    switch (bit_depth) {
+        case 10: return 0;
+        case 12: return 1;
+        case 16: return 2;
+        default: return -1;
+    }
+}
+
+const PQCodeTable& GetTable(int bit_depth) {
+    static std::once_flag flags[3];
+    static PQCodeTable tables[3];
+    int index = TableIndex(bit_depth);
+    std::call_once(flags[index], [index, bit_depth]() { BuildTable(tables[index], bit_depth); });
+    return tables[index];
+}
+
+inline uint16_t LookupOETF(const PQCodeTable& table, float linear) {
+    // 与 PQ_OETF 的边界处理一致：非正值、NaN、Inf → 0；≥峰值 → 满码
+    if (!(linear > 0.0f)) return 0;
+    if (!(linear < kPQPeakNits)) {
+        return std::isinf(linear) ? 0 : static_cast<uint16_t>(table.max_code);
+    }
+
+    uint32_t bits;
+    std::memcpy(&bits, &linear, sizeof(bits));
+    size_t segment = bits >> kSegmentShift;
+    int lo = table.segments[segment];
+    int hi = table.segments[segment + 1];
+
+    const float* first = table.thresholds.data() + lo + 1;
+    const float* last = table.thresholds.data() + hi + 1;
+    return static_cast<uint16_t>(lo + (std::upper_bound(first, last, linear) - first));
+}
+
+// 纯查表，AVX2 及以上层级编译为 gather
+CPH_KERNEL_INLINE void LookupEOTFKernelBody(const uint16_t* codes, size_t code_stride, const float* eotf,
+                                            uint16_t max_code, float* linear, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        linear[i] = eotf[std::min(codes[i * code_stride], max_code)];
+    }
+}
+
+CPH_DISPATCH_KERNEL(LookupEOTFKernel,
+                    (const uint16_t* codes, size_t code_stride, const float* eotf, uint16_t max_code,
+                     float* linear, size_t count),
+                    (codes, code_stride, eotf, max_code, linear, count))
+
+} // namespace
+
+bool ColorSpaceConverter::HasPQCodeTables(int bit_depth) {
+    return TableIndex(bit_depth) >= 0;
+}
+
+void ColorSpaceConverter::PQ_EOTF_Codes(const uint16_t* codes, size_t code_stride, float* linear,
+                                        size_t count, int bit_depth) {
+    if (!HasPQCodeTables(bit_depth)) {
+        const float max_f = static_cast<float>((1 << bit_depth) - 1);
+        for (size_t i = 0; i < count; ++i) {
+            linear[i] = PQ_EOTF(static_cast<float>(codes[i * code_stride]) / max_f);
+        }
+        return;
+    }
+
+    const PQCodeTable& table = GetTable(bit_depth);
+    LookupEOTFKernel(codes, code_stride, table.eotf.data(), static_cast<uint16_t>(table.max_code), linear, count);
+}
+
+void ColorSpaceConverter::PQ_OETF_Codes(const float* linear, uint16_t* codes, size_t code_stride,
+                                        size_t count, int bit_depth) {
+    if (!HasPQCodeTables(bit_depth)) {
+        const int max_code = (1 << bit_depth) - 1;
+        const float max_f = static_cast<float>(max_code);
+        for (size_t i = 0; i < count; ++i) {
+            float code = PQ_OETF(linear[i]) * max_f;
+            codes[i * code_stride] = static_cast<uint16_t>(std::clamp(code, 0.0f, max_f) + 0.5f);
+        }
+        return;
+    }
+
+    const PQCodeTable& table = GetTable(bit_depth);
+    for (size_t i = 0; i < count; ++i) {
+        codes[i * code_stride] = LookupOETF(table, linear[i]);
+    }
+}
+
+void ColorSpaceConverter::ToWorkingPlanarFromCodes(const uint16_t* codes, size_t pixel_stride,
+                                                   float* r, float* g, float* b, size_t count,
+                                                   ColorSpace source_cs, int bit_depth) {
+    if (source_cs != ColorSpace::P3_D65 && source_cs != ColorSpace::ACESG) {
+        // 码值本身即工作域信号，只需归一化（REC709等无矩阵的色彩空间与 ToWorkingPixel 一致，不经EOTF）
+        const float max_f = static_cast<float>((1 << bit_depth) - 1);
+        for (size_t i = 0; i < count; ++i) {
+            const uint16_t* pixel = codes + i * pixel_stride;
+            r[i] = std::min(static_cast<float>(pixel[0]) / max_f, 1.0f);
+            g[i] = std::min(static_cast<float>(pixel[1]) / max_f, 1.0f);
+            b[i] = std::min(static_cast<float>(pixel[2]) / max_f, 1.0f);
+        }
+        return;
+    }
+
+    // 查表得到源原色下的线性值，其余步骤与浮点源完全相同
+    PQ_EOTF_Codes(codes + 0, pixel_stride, r, count, bit_depth);
+    PQ_EOTF_Codes(codes + 1, pixel_stride, g, count, bit_depth);
+    PQ_EOTF_Codes(codes + 2, pixel_stride, b, count, bit_depth);
+    ToWorkingPlanar(r, g, b, count, source_cs);
+}
+
+void ColorSpaceConverter::FromWorkingPlanarToCodes(float* r, float* g, float* b, uint16_t* codes,
+                                                   size_t pixel_stride, size_t count,
+                                                   ColorSpace target_cs, int bit_depth) {
+    const int max_code = (1 << bit_depth) - 1;
+    const float max_f = static_cast<float>(max_code);
+
+    if (target_cs != ColorSpace::P3_D65 && target_cs != ColorSpace::ACESG) {
+        // 与解码对称：无矩阵的色彩空间直接量化
+        for (size_t i = 0; i < count; ++i) {
+            uint16_t* pixel = codes + i * pixel_stride;
+            const float values[3] = {r[i], g[i], b[i]};
+            for (int c = 0; c < 3; ++c) {
+                float code = values[c] * max_f;
+                code = code > 0.0f ? code : 0.0f;  // NaN → 0
+                pixel[c] = static_cast<uint16_t>(std::min(code, max_f) + 0.5f);
+            }
+        }
+        return;
+    }
+
+    const float* matrix = nullptr;
+    switch (target_cs) {
+        case ColorSpace::P3_D65: matrix = BT2020_TO_P3D65_MATRIX; break;
+        case ColorSpace::ACESG: matrix = BT2020_TO_ACESG_MATRIX; break;
+        default: break;
+    }
+
+    float* planes[3] = {r, g, b};
+    for (float* plane : planes) {
+        for (size_t i = 0; i < count; ++i) {
+            plane[i] = PQ_EOTF(plane[i]);
+        }
+    }
+    if (matrix) {
+        MultiplyMatrix3x3Planar(matrix, r, g, b, count);
+    }
+
+    // 码值范围即目标色域边界：负值与NaN编码为0，超峰值编码为满码
+    PQ_OETF_Codes(r, codes + 0, pixel_stride, count, bit_depth);
+    PQ_OETF_Codes(g, codes + 1, pixel_stride, count, bit_depth);
+    PQ_OETF_Codes(b, codes + 2, pixel_stride, count, bit_depth);
+}
+
+} // namespace CinemaProHDR
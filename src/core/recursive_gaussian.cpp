@@ -0,0 +1,135 @@
+#include "cinema_pro_hdr/recursive_gaussian.h"
+#include "cinema_pro_hdr/cpu_dispatch.h"
+#include <algorithm>
+#include <cmath>
+
+namespace CinemaProHDR {
+
+namespace {
+
+/**
+ * @brief 分块转置（rows×cols → cols×rows），块内读写都落在缓存中
+ */
+void Transpose(const float* src, float* dst, int cols, int rows) {
+    constexpr int kBlock = 32;
+    for (int y0 = 0; y0 < rows; y0 += kBlock) {
+        const int y1 = std::min(y0 + kBlock, rows);
+        for (int x0 = 0; x0 < cols; x0 += kBlock) {
+            const int x1 = std::min(x0 + kBlock, cols);
+            for (int y = y0; y < y1; ++y) {
+                const float* row = src + static_cast<size_t>(y) * cols;
+                for (int x = x0; x < x1; ++x) {
+                    dst[static_cast<size_t>(x) * rows + y] = row[x];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief 一行递推：out = b·in + a1·s1 + a2·s2 + a3·s3（out 可与 in 相同）
+ */
+CPH_KERNEL_INLINE void RecurseRowKernelBody(const float* in, const float* s1, const float* s2, const float* s3,
+                                            float* out, int cols, float b, float a1, float a2, float a3) {
+    for (int x = 0; x < cols; ++x) {
+        out[x] = b * in[x] + a1 * s1[x] + a2 * s2[x] + a3 * s3[x];
+    }
+}
+
+CPH_DISPATCH_KERNEL(RecurseRowKernel,
+                    (const float* in, const float* s1, const float* s2, const float* s3, float* out, int cols,
+                     float b, float a1, float a2, float a3),
+                    (in, s1, s2, s3, out, cols, b, a1, a2, a3))
+
+} // namespace
+
+RecursiveGaussian::RecursiveGaussian(float sigma) {
+    /**
+     * Young & van Vliet (1995) 系数：
+     * q 由σ的分段经验公式得到，b0..b3 为三阶递推多项式系数，
+     * B = 1 - (b1+b2+b3)/b0 保证直流增益为1
+     */
+    sigma_ = std::max(sigma, kMinSigma);
+    const double s = sigma_;
+    const double q = s >= 2.5 ? 0.98711 * s - 0.96330 : 3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * s);
+    const double q2 = q * q;
+    const double q3 = q2 * q;
+
+    const double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    const double b1 = 2.44413 * q + 2.85619 * q2 + 1.26661 * q3;
+    const double b2 = -(1.4281 * q2 + 1.26661 * q3);
+    const double b3 = 0.422205 * q3;
+
+    a_[0] = static_cast<float>(b1 / b0);
+    a_[1] = static_cast<float>(b2 / b0);
+    a_[2] = static_cast<float>(b3 / b0);
+    b_ = static_cast<float>(1.0 - (b1 + b2 + b3) / b0);
+}
+
+int RecursiveGaussian::GetPadding() const {
+    return std::max(3, static_cast<int>(std::ceil(kPaddingSigmas * sigma_)));
+}
+
+void RecursiveGaussian::FilterColumns(const float* src, float* dst, int cols, int rows, float* work) const {
+    const float b = b_;
+    const float a1 = a_[0];
+    const float a2 = a_[1];
+    const float a3 = a_[2];
+    const size_t stride = static_cast<size_t>(cols);
+    const int padding = GetPadding();
+    const int total = rows + padding;
+
+    // 暂存：首行输入、末行输入（原地处理时会被覆盖）、延拓区末端的稳态值、延拓区各行
+    float* first = work;
+    float* last_input = work + stride;
+    float* steady = work + 2 * stride;
+    float* pad = work + 3 * stride;
+    std::copy(src, src + stride, first);
+    std::copy(src + (rows - 1) * stride, src + rows * stride, last_input);
+
+    auto row = [&](int y) { return y < rows ? dst + y * stride : pad + (y - rows) * stride; };
+
+    // 因果递推：左侧边界外为首样本的无限延拓，稳态输出即首样本本身；
+    // 右侧继续以末样本递推 padding 行，让反因果初值接近真实的延拓响应
+    for (int y = 0; y < total; ++y) {
+        const float* in = y < rows ? src + y * stride : last_input;
+        float* out = row(y);
+        const float* p1 = y >= 1 ? row(y - 1) : first;
+        const float* p2 = y >= 2 ? row(y - 2) : first;
+        const float* p3 = y >= 3 ? row(y - 3) : first;
+        RecurseRowKernel(in, p1, p2, p3, out, cols, b, a1, a2, a3);
+    }
+    std::copy(row(total - 1), row(total - 1) + stride, steady);
+
+    // 反因果递推：从延拓区末端的稳态开始，延拓区的输出只作为递推状态
+    for (int y = total - 1; y >= 0; --y) {
+        float* out = row(y);
+        const float* n1 = y + 1 < total ? row(y + 1) : steady;
+        const float* n2 = y + 2 < total ? row(y + 2) : steady;
+        const float* n3 = y + 3 < total ? row(y + 3) : steady;
+        RecurseRowKernel(out, n1, n2, n3, out, cols, b, a1, a2, a3);
+    }
+}
+
+void RecursiveGaussian::BlurPlane(const float* src, float* dst, int width, int height, ImageBuffer& scratch) const {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    const size_t count = static_cast<size_t>(width) * height;
+    const size_t work_size = static_cast<size_t>(3 + GetPadding()) * std::max(width, height);
+    if (scratch.size() < count + work_size) {
+        scratch.resize(count + work_size);
+    }
+    float* transposed = scratch.data();
+    float* work = scratch.data() + count;
+
+    // 垂直：整行递推
+    FilterColumns(src, dst, width, height, work);
+
+    // 水平：转置后同样按行递推，再转置回来
+    Transpose(dst, transposed, width, height);
+    FilterColumns(transposed, transposed, height, width, work);
+    Transpose(transposed, dst, height, width);
+}
+
+} // namespace CinemaProHDR
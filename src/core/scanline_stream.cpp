@@ -0,0 +1,217 @@
+#include "cinema_pro_hdr/scanline.h"
+#include "cinema_pro_hdr/color_space.h"
+#include "cinema_pro_hdr/highlight_detail.h"
+#include "cinema_pro_hdr/image_planar.h"
+#include <algorithm>
+
+namespace CinemaProHDR {
+
+ScanlineStream::ScanlineStream(std::shared_ptr<const CompiledPipeline> pipeline) : pipeline_(std::move(pipeline)) {}
+
+void ScanlineStream::Allocate(const ScanlineFormat& format, int radius) {
+    const int input_rows = radius + 1;
+    const int blur_rows = radius > 0 ? 2 * radius + 1 : 0;
+    if (format.width == width_ && format.channels == channels_ && input_rows == input_rows_ &&
+        blur_rows == blur_rows_) {
+        return;
+    }
+
+    width_ = format.width;
+    channels_ = format.channels;
+    input_rows_ = input_rows;
+    blur_rows_ = blur_rows;
+
+    const size_t row = static_cast<size_t>(width_);
+    input_ring_ = ImageBuffer(row * channels_ * input_rows_);
+    for (ImageBuffer& plane : work_ring_) {
+        plane = ImageBuffer(row * input_rows_);
+    }
+    for (ImageBuffer& plane : blur_ring_) {
+        plane = ImageBuffer(row * blur_rows_);
+    }
+    row_buffers_ = ImageBuffer(row * (5 + channels_));
+}
+
+size_t ScanlineStream::GetWorkingMemoryBytes() const {
+    size_t floats = input_ring_.size() + row_buffers_.size();
+    for (const ImageBuffer& plane : work_ring_) {
+        floats += plane.size();
+    }
+    for (const ImageBuffer& plane : blur_ring_) {
+        floats += plane.size();
+    }
+    return floats * sizeof(float);
+}
+
+bool ScanlineStream::ProcessFrame(const ScanlineFormat& format, ScanlineSource& source, ScanlineSink& sink,
+                                  StreamState& state) {
+    if (!pipeline_ || format.width <= 0 || format.height <= 0 || format.channels < 3) {
+        state.LogError(ErrorCode::NAN_INF, "Invalid scanline format");
+        return false;
+    }
+
+    const CphParams& params = pipeline_->GetParams();
+    const RenderPlan& plan = pipeline_->GetPlan(format.color_space);
+    auto detail_it = std::find(plan.stages.begin(), plan.stages.end(), RenderStage::HIGHLIGHT_DETAIL);
+    const bool has_detail = detail_it != plan.stages.end();
+    const std::vector<RenderStage> pre_stages(plan.stages.begin(), detail_it);
+    const std::vector<RenderStage> post_stages(has_detail ? detail_it + 1 : detail_it, plan.stages.end());
+
+    // LUMA域只模糊亮度行（模糊环的第0个平面），与 UnsharpMaskPlanar 的LUMA分支逐位一致；
+    // 行窗口无法做反因果递推，RECURSIVE 也使用同σ的直接卷积核
+    const UnsharpMaskOptions& usm_options = pipeline_->GetUnsharpMaskOptions();
+    const bool luma_domain = usm_options.detail_domain == DetailDomain::LUMA;
+    const int blur_planes = luma_domain ? 1 : 3;
+    std::vector<float> kernel;
+    const int radius = has_detail ? HighlightDetailProcessor::ComputeUSMKernel(1.0f, kernel, usm_options.sigma) : 0;
+    Allocate(format, radius);
+    histogram_.Clear();
+
+    // 色调映射写出的亮度平面保留到高光细节阶段（与 RunStage 的 DropLuma 规则一致）
+    bool luma_valid = false;
+    for (RenderStage stage : pre_stages) {
+        if (stage == RenderStage::TONE_MAPPING) {
+            luma_valid = true;
+        } else if (stage == RenderStage::SATURATION || stage == RenderStage::FROM_WORKING_DOMAIN) {
+            luma_valid = false;
+        }
+    }
+
+    const int width = format.width;
+    const int height = format.height;
+    const size_t row_size = static_cast<size_t>(width);
+    const size_t pixel_row_size = row_size * format.channels;
+
+    auto input_row = [&](int y) { return input_ring_.data() + (y % input_rows_) * pixel_row_size; };
+    auto work_row = [&](int plane, int y) { return work_ring_[plane].data() + (y % input_rows_) * row_size; };
+    auto blur_row = [&](int plane, int y) { return blur_ring_[plane].data() + (y % blur_rows_) * row_size; };
+    float* mask = row_buffers_.data();
+    float* blurred = mask + row_size;
+    float* out_planes[3] = {blurred + row_size, blurred + 2 * row_size, blurred + 3 * row_size};
+    float* output_row = blurred + 4 * row_size;
+
+    // 逐行阶段（高光细节除外）：与 CompiledPipeline::RunStage 的平面实现相同
+    auto run_row_stage = [&](RenderStage stage, float* r, float* g, float* b, float* luma) {
+        switch (stage) {
+            case RenderStage::TO_WORKING_DOMAIN:
+            case RenderStage::WORKING_DOMAIN_CLAMP:
+                ColorSpaceConverter::ToWorkingPlanar(r, g, b, row_size, plan.source_cs);
+                break;
+            case RenderStage::TONE_MAPPING:
+                pipeline_->ApplyToneMappingPixels(r, g, b, luma, row_size);
+                break;
+            case RenderStage::SATURATION:
+                ColorSpaceConverter::ApplySaturationPlanar(r, g, b, row_size, params.sat_base, params.sat_hi,
+                                                           params.pivot_pq, params.dci_compliance);
+                break;
+            case RenderStage::FROM_WORKING_DOMAIN:
+                ColorSpaceConverter::FromWorkingPlanar(r, g, b, row_size, plan.target_cs);
+                break;
+            case RenderStage::STATISTICS:
+                histogram_.AddPixels(r, g, b, row_size);
+                break;
+            case RenderStage::HIGHLIGHT_DETAIL:
+                break;
+        }
+    };
+
+    // 行进入：读取、拆分、前序阶段、水平模糊
+    auto enter_row = [&](int y) {
+        float* raw = input_row(y);
+        if (!source.ReadRow(y, raw)) {
+            state.LogError(ErrorCode::NAN_INF, "Scanline source failed", "row " + std::to_string(y));
+            return false;
+        }
+        float* r = work_row(0, y);
+        float* g = work_row(1, y);
+        float* b = work_row(2, y);
+        PlanarLayout::DeinterleavePixels(raw, format.channels, r, g, b, row_size);
+        for (RenderStage stage : pre_stages) {
+            run_row_stage(stage, r, g, b, work_row(3, y));
+        }
+        if (has_detail && luma_domain) {
+            // 色调映射未留下亮度行时按MaxRGB补算（与掩码的取值相同）
+            float* luma = work_row(3, y);
+            if (!luma_valid) {
+                for (size_t i = 0; i < row_size; ++i) {
+                    luma[i] = std::max(r[i], std::max(g[i], b[i]));
+                }
+            }
+            HighlightDetailProcessor::BlurRowHorizontal(luma, blur_row(0, y), width, kernel);
+        } else if (has_detail) {
+            for (int c = 0; c < 3; ++c) {
+                HighlightDetailProcessor::BlurRowHorizontal(work_row(c, y), blur_row(c, y), width, kernel);
+            }
+        }
+        return true;
+    };
+
+    // 行离开：垂直模糊窗口合成细节、后续阶段、交错写出
+    std::vector<const float*> tap_rows(kernel.size());
+    auto emit_row = [&](int y) {
+        float* planes[3] = {work_row(0, y), work_row(1, y), work_row(2, y)};
+        if (has_detail) {
+            HighlightDetailProcessor::HighlightMaskRow(luma_valid ? work_row(3, y) : nullptr, planes[0], planes[1],
+                                                       planes[2], mask, row_size, params.pivot_pq);
+            for (int c = 0; c < blur_planes; ++c) {
+                for (size_t k = 0; k < kernel.size(); ++k) {
+                    int src_y = std::clamp(y + static_cast<int>(k) - radius, 0, height - 1);
+                    tap_rows[k] = blur_row(c, src_y);
+                }
+                HighlightDetailProcessor::BlurRowVertical(tap_rows.data(), kernel, blurred, width);
+                if (!luma_domain) {
+                    HighlightDetailProcessor::ComposeDetailRow(planes[c], blurred, mask, out_planes[c], row_size,
+                                                               params.highlight_detail);
+                    planes[c] = out_planes[c];
+                }
+            }
+            if (luma_domain) {
+                HighlightDetailProcessor::ComposeLumaDetailRow(work_row(3, y), blurred, mask, planes, out_planes,
+                                                               row_size, params.highlight_detail);
+                for (int c = 0; c < 3; ++c) {
+                    planes[c] = out_planes[c];
+                }
+            }
+        }
+        for (RenderStage stage : post_stages) {
+            run_row_stage(stage, planes[0], planes[1], planes[2], nullptr);
+        }
+
+        std::copy(input_row(y), input_row(y) + pixel_row_size, output_row);
+        PlanarLayout::InterleavePixels(planes[0], planes[1], planes[2], output_row, format.channels, row_size);
+        if (!sink.WriteRow(y, output_row)) {
+            state.LogError(ErrorCode::NAN_INF, "Scanline sink failed", "row " + std::to_string(y));
+            return false;
+        }
+        return true;
+    };
+
+    // 行y在行y+半径进入后输出；帧尾的行由钳制的边界行补齐窗口
+    for (int y = 0; y < height; ++y) {
+        if (!enter_row(y)) {
+            return false;
+        }
+        if (y >= radius && !emit_row(y - radius)) {
+            return false;
+        }
+    }
+    for (int y = std::max(0, height - radius); y < height; ++y) {
+        if (!emit_row(y)) {
+            return false;
+        }
+    }
+
+    if (plan.HasStage(RenderStage::STATISTICS)) {
+        histogram_.Finalize(state.stats.pq_stats);
+        if (state.shot_analyzer) {
+            state.shot_analyzer->AddFrame(histogram_);
+        }
+        state.stats.frame_count++;
+        state.stats.timestamp = std::chrono::system_clock::now();
+        state.stats.monotonic = pipeline_->IsMonotonic();
+        state.stats.c1_continuous = pipeline_->IsC1Continuous();
+    }
+    return true;
+}
+
+} // namespace CinemaProHDR
@@ -0,0 +1,136 @@
+#include "cinema_pro_hdr/shot_analyzer.h"
+#include "cinema_pro_hdr/color_space.h"
+#include <algorithm>
+#include <cmath>
+
+namespace CinemaProHDR {
+
+ShotAnalyzer::ShotAnalyzer(const ShotAnalyzerConfig& config, ShotCallback callback)
+    : config_(config), callback_(std::move(callback)) {
+    target_min_pq_ = ColorSpaceConverter::PQ_OETF(config_.target_min_nits);
+    target_avg_pq_ = ColorSpaceConverter::PQ_OETF(config_.target_avg_nits);
+    target_max_pq_ = ColorSpaceConverter::PQ_OETF(config_.target_max_nits);
+    std::fill(previous_, previous_ + kDistributionBins, 0.0f);
+}
+
+bool ShotAnalyzer::AddFrame(const StatisticsHistogram& histogram) {
+    float current[kDistributionBins];
+    histogram.GetDistribution(current, kDistributionBins);
+    const bool has_samples = histogram.GetSampleCount() > 0;
+
+    // 切点：全变差距离须超过绝对阈值，并明显高于本镜头内的平均帧间距离（摇镜、闪烁不会被误判）
+    bool cut = false;
+    last_distance_ = 0.0f;
+    if (has_samples && has_previous_) {
+        float distance = 0.0f;
+        for (int i = 0; i < kDistributionBins; ++i) {
+            distance += std::abs(current[i] - previous_[i]);
+        }
+        distance *= 0.5f;
+        last_distance_ = distance;
+
+        const double mean = distance_count_ > 0 ? distance_sum_ / distance_count_ : 0.0;
+        cut = shot_.frame_count >= static_cast<uint64_t>(config_.min_shot_frames) &&
+              distance > config_.cut_threshold && distance > config_.adaptive_ratio * mean;
+        if (!cut) {
+            distance_sum_ += distance;
+            distance_count_++;
+        }
+    }
+
+    if (cut) {
+        CloseShot();
+    }
+    if (shot_.frame_count == 0) {
+        shot_.first_frame = frame_index_;
+    }
+    shot_.frame_count++;
+
+    if (has_samples) {
+        Statistics::PQStats stats;
+        histogram.Finalize(stats);
+        if (stats_frames_ == 0) {
+            shot_.min_pq = stats.min_pq;
+            shot_.max_pq = stats.max_pq;
+        } else {
+            shot_.min_pq = std::min(shot_.min_pq, stats.min_pq);
+            shot_.max_pq = std::max(shot_.max_pq, stats.max_pq);
+        }
+        avg_sum_ += stats.avg_pq;
+        stats_frames_++;
+
+        std::copy(current, current + kDistributionBins, previous_);
+        has_previous_ = true;
+    }
+
+    frame_index_++;
+    return cut;
+}
+
+bool ShotAnalyzer::Flush() {
+    if (shot_.frame_count == 0) {
+        return false;
+    }
+    CloseShot();
+    // 序列结束：下一帧开始新的镜头，不与本序列末帧比较
+    has_previous_ = false;
+    return true;
+}
+
+void ShotAnalyzer::Reset() {
+    shot_ = ShotMetadata();
+    stats_frames_ = 0;
+    avg_sum_ = 0.0;
+    distance_sum_ = 0.0;
+    distance_count_ = 0;
+    has_previous_ = false;
+    last_distance_ = 0.0f;
+    frame_index_ = 0;
+    shot_count_ = 0;
+}
+
+void ShotAnalyzer::FitToneMapping(ShotMetadata& shot) const {
+    const float target_range = target_max_pq_ - target_min_pq_;
+    const float range = shot.max_pq - shot.min_pq;
+    shot.gamma = 1.0f;
+
+    // 平坦镜头（或目标退化）：整个镜头映射到目标平均值
+    if (range < 1e-4f || target_range <= 0.0f) {
+        shot.gain = 0.0f;
+        shot.offset = target_range > 0.0f ? (target_avg_pq_ - target_min_pq_) / target_range : 0.0f;
+        return;
+    }
+
+    // 归一化窗口起点对齐镜头最小值；gain 受上限与 offset≥-1 的约束
+    shot.gain = std::min(1.0f / range, kMaxGain);
+    if (shot.min_pq > 0.0f) {
+        shot.gain = std::min(shot.gain, 1.0f / shot.min_pq);
+    }
+    shot.offset = -shot.min_pq * shot.gain;
+
+    // x_avg^gamma = t_avg（均为归一化位置），两端留出余量避免对数发散
+    constexpr float kEdge = 1e-4f;
+    const float x_avg = std::clamp(shot.gain * shot.avg_pq + shot.offset, kEdge, 1.0f - kEdge);
+    const float t_avg = std::clamp((target_avg_pq_ - target_min_pq_) / target_range, kEdge, 1.0f - kEdge);
+    shot.gamma = std::clamp(std::log(t_avg) / std::log(x_avg), kMinGamma, kMaxGamma);
+}
+
+void ShotAnalyzer::CloseShot() {
+    if (shot_.frame_count == 0) {
+        return;
+    }
+    shot_.avg_pq = stats_frames_ > 0 ? static_cast<float>(avg_sum_ / stats_frames_) : 0.0f;
+    FitToneMapping(shot_);
+    shot_count_++;
+    if (callback_) {
+        callback_(shot_);
+    }
+
+    shot_ = ShotMetadata();
+    stats_frames_ = 0;
+    avg_sum_ = 0.0;
+    distance_sum_ = 0.0;
+    distance_count_ = 0;
+}
+
+} // namespace CinemaProHDR
@@ -0,0 +1,681 @@
+#include "cinema_pro_hdr/sidecar_validator.h"
+#include "cinema_pro_hdr/shot_analyzer.h"
+#include "cinema_pro_hdr/sidecar_writer.h"
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <string_view>
+
+namespace CinemaProHDR {
+
+namespace {
+
+constexpr int kMaxNestingDepth = 64;  // 跳过未知字段时允许的嵌套深度
+
+enum class FieldKind { NUMBER, INTEGER, STRING };
+enum class StringFormat { ANY, WORK_CS, GUID, TIMECODE_INOUT };
+
+/**
+ * @brief Schema中的一个叶子字段
+ */
+struct FieldSpec {
+    std::string_view key;
+    FieldKind kind;
+    bool required;
+    float min_value = 0.0f;
+    float max_value = 0.0f;
+    ErrorCode range_code = ErrorCode::RANGE_PIVOT;  // 越界时报告的错误码
+    StringFormat format = StringFormat::ANY;
+};
+
+FieldSpec Number(std::string_view key, float min_value, float max_value) {
+    return {key, FieldKind::NUMBER, true, min_value, max_value};
+}
+
+// cph_meta 的调色参数：范围与 CphParams::IsValid、ParamValidator 共用 ParamRanges
+FieldSpec Param(std::string_view key, const ParamRange& range, bool required = false) {
+    return {key, FieldKind::NUMBER, required, range.min_value, range.max_value};
+}
+
+// 版本号与曲线ID是枚举而非可调范围，越界按Schema不符处理
+FieldSpec Enumerated(std::string_view key, int min_value, int max_value) {
+    return {key, FieldKind::INTEGER, true, static_cast<float>(min_value), static_cast<float>(max_value),
+            ErrorCode::SCHEMA_MISSING};
+}
+
+FieldSpec String(std::string_view key, bool required, StringFormat format) {
+    FieldSpec spec{key, FieldKind::STRING, required};
+    spec.format = format;
+    return spec;
+}
+
+const FieldSpec kSt2094Fields[] = {
+    Number("minPqEncodedMaxRGB", 0.0f, 10000.0f),
+    Number("avgPqEncodedMaxRGB", 0.0f, 10000.0f),
+    Number("maxPqEncodedMaxRGB", 0.0f, 10000.0f),
+    Number("offset", -1.0f, 1.0f),
+    Number("gain", 0.0f, ShotAnalyzer::kMaxGain),
+    Number("gamma", ShotAnalyzer::kMinGamma, ShotAnalyzer::kMaxGamma)
+};
+
+const FieldSpec kCphMetaFields[] = {
+    Enumerated("cph_version", 2, 2),
+    Enumerated("cph_curve_id", static_cast<int>(CurveType::PPR), static_cast<int>(CurveType::RLOG)),
+    Param("pivot", ParamRanges::PIVOT_PQ, true),
+    Param("gamma_s", ParamRanges::GAMMA_S),
+    Param("gamma_h", ParamRanges::GAMMA_H),
+    Param("shoulder", ParamRanges::SHOULDER_H),
+    Param("black_lift", ParamRanges::BLACK_LIFT),
+    Param("highlight_detail", ParamRanges::HIGHLIGHT_DETAIL),
+    Param("sat_base", ParamRanges::SAT_BASE),
+    Param("sat_hi", ParamRanges::SAT_HI),
+    String("work_cs", true, StringFormat::WORK_CS),
+    String("hash_clip_guid", false, StringFormat::GUID),
+    String("timecode_inout", false, StringFormat::TIMECODE_INOUT),
+    String("generator", false, StringFormat::ANY)
+};
+
+// HH:MM:SS:FF-HH:MM:SS:FF，每位取值上限同Schema的正则（[0-2][0-9]:[0-5][0-9]:...）
+bool IsValidTimecodeRange(std::string_view text) {
+    static const char kPattern[] = "29:59:59:59-29:59:59:59";
+    if (text.size() != sizeof(kPattern) - 1) {
+        return false;
+    }
+    for (size_t i = 0; i < text.size(); ++i) {
+        const char expected = kPattern[i];
+        const bool ok = (expected == ':' || expected == '-') ? text[i] == expected
+                                                             : text[i] >= '0' && text[i] <= expected;
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+int HexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void AppendUtf8(std::string& out, uint32_t code_point) {
+    if (code_point < 0x80) {
+        out.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+/**
+ * @brief 单遍校验解析器
+ *
+ * 成员函数返回false表示遇到语法错误（已报告），调用方应立即停止；
+ * 字段级错误只记录，不中断解析。
+ */
+class Parser {
+public:
+    Parser(const char* text, size_t size, SidecarCheckResult& result)
+        : begin_(text), p_(text), end_(text + size), result_(result) {}
+
+    void ParseDocument() {
+        // 容忍UTF-8 BOM
+        if (end_ - p_ >= 3 && std::string_view(p_, 3) == "\xEF\xBB\xBF") {
+            p_ += 3;
+        }
+        SkipSpace();
+        if (p_ == end_) {
+            SyntaxError("empty document");
+            return;
+        }
+        if (*p_ != '{') {
+            SyntaxError("expected object");
+            return;
+        }
+        if (!ParseRecord(true)) {
+            return;
+        }
+        SkipSpace();
+        if (p_ != end_) {
+            SyntaxError("unexpected content after document");
+        }
+    }
+
+private:
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+    SidecarCheckResult& result_;
+    std::string scratch_;  // 含转义字符串的解码缓冲
+
+    // 当前记录的标识，记录结束后回填到该记录的错误中
+    std::string record_guid_;
+    std::string record_timecode_;
+    long long segment_ = -1;  // 当前记录在 segments 中的下标，单记录文档为-1
+
+    void SkipSpace() {
+        while (p_ != end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) {
+            ++p_;
+        }
+    }
+
+    char Peek() {
+        SkipSpace();
+        return p_ != end_ ? *p_ : '\0';
+    }
+
+    bool Consume(char c) {
+        if (Peek() == c) {
+            ++p_;
+            return true;
+        }
+        return false;
+    }
+
+    bool Expect(char c) {
+        if (Consume(c)) {
+            return true;
+        }
+        const char message[] = {'e', 'x', 'p', 'e', 'c', 't', 'e', 'd', ' ', '\'', c, '\'', '\0'};
+        SyntaxError(message);
+        return false;
+    }
+
+    // 错误字段的JSON路径只在报告时拼接
+    std::string FieldPath(std::string_view block, std::string_view key) const {
+        std::string field;
+        if (segment_ >= 0) {
+            field = "segments[" + std::to_string(segment_) + "]";
+        }
+        for (std::string_view part : {block, key}) {
+            if (part.empty()) {
+                continue;
+            }
+            if (!field.empty()) {
+                field += '.';
+            }
+            field.append(part.data(), part.size());
+        }
+        return field;
+    }
+
+    void Report(ErrorCode code, std::string field, const std::string& message, float value = 0.0f) {
+        ErrorReport error(code, message);
+        error.field_name = std::move(field);
+        error.invalid_value = value;
+        result_.errors.push_back(std::move(error));
+    }
+
+    void SyntaxError(const char* what) {
+        // 行列号只在出错时计算
+        size_t line = 1;
+        const char* line_start = begin_;
+        for (const char* c = begin_; c < p_; ++c) {
+            if (*c == '\n') {
+                line++;
+                line_start = c + 1;
+            }
+        }
+        Report(ErrorCode::SCHEMA_MISSING, std::string(),
+               "Syntax error at line " + std::to_string(line) + ", column " +
+               std::to_string(p_ - line_start + 1) + ": " + what);
+    }
+
+    /**
+     * @brief 解析字符串（p_ 指向引号）；无转义时 out 直接指向原文，否则指向 scratch_
+     */
+    bool ParseString(std::string_view& out) {
+        if (Peek() != '"') {
+            SyntaxError("expected string");
+            return false;
+        }
+        const char* start = ++p_;
+        while (p_ != end_ && *p_ != '"' && *p_ != '\\' && static_cast<unsigned char>(*p_) >= 0x20) {
+            ++p_;
+        }
+        if (p_ != end_ && *p_ == '"') {
+            out = std::string_view(start, static_cast<size_t>(p_ - start));
+            ++p_;
+            return true;
+        }
+
+        scratch_.assign(start, p_);
+        while (p_ != end_ && *p_ != '"') {
+            const char c = *p_;
+            if (static_cast<unsigned char>(c) < 0x20) {
+                SyntaxError("control character in string");
+                return false;
+            }
+            if (c != '\\') {
+                scratch_.push_back(c);
+                ++p_;
+                continue;
+            }
+            if (end_ - p_ < 2) {
+                break;
+            }
+            const char escape = p_[1];
+            p_ += 2;
+            switch (escape) {
+                case '"': scratch_.push_back('"'); break;
+                case '\\': scratch_.push_back('\\'); break;
+                case '/': scratch_.push_back('/'); break;
+                case 'b': scratch_.push_back('\b'); break;
+                case 'f': scratch_.push_back('\f'); break;
+                case 'n': scratch_.push_back('\n'); break;
+                case 'r': scratch_.push_back('\r'); break;
+                case 't': scratch_.push_back('\t'); break;
+                case 'u': {
+                    uint32_t code_point = 0;
+                    if (!ParseHex4(code_point)) {
+                        return false;
+                    }
+                    // 代理对合并为一个码点
+                    if (code_point >= 0xD800 && code_point < 0xDC00 && end_ - p_ >= 6 &&
+                        p_[0] == '\\' && p_[1] == 'u') {
+                        p_ += 2;
+                        uint32_t low = 0;
+                        if (!ParseHex4(low)) {
+                            return false;
+                        }
+                        if (low >= 0xDC00 && low < 0xE000) {
+                            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                        } else {
+                            AppendUtf8(scratch_, code_point);
+                            code_point = low;
+                        }
+                    }
+                    AppendUtf8(scratch_, code_point);
+                    break;
+                }
+                default:
+                    p_ -= 1;
+                    SyntaxError("invalid escape sequence");
+                    return false;
+            }
+        }
+        if (p_ == end_) {
+            SyntaxError("unterminated string");
+            return false;
+        }
+        ++p_;
+        out = scratch_;
+        return true;
+    }
+
+    bool ParseHex4(uint32_t& value) {
+        if (end_ - p_ < 4) {
+            SyntaxError("truncated \\u escape");
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            const int digit = HexValue(p_[i]);
+            if (digit < 0) {
+                SyntaxError("invalid \\u escape");
+                return false;
+            }
+            value = (value << 4) | static_cast<uint32_t>(digit);
+        }
+        p_ += 4;
+        return true;
+    }
+
+    /**
+     * @brief 按JSON数值文法扫描后用 from_chars 转换；超出double范围时 finite 为false
+     */
+    bool ParseNumber(double& value, bool& finite) {
+        const char* start = p_;
+        const char* c = p_;
+        if (c != end_ && *c == '-') ++c;
+        if (c == end_ || !IsDigit(*c)) {
+            SyntaxError("invalid number");
+            return false;
+        }
+        if (*c == '0') {
+            ++c;
+        } else {
+            while (c != end_ && IsDigit(*c)) ++c;
+        }
+        if (c != end_ && *c == '.') {
+            ++c;
+            if (c == end_ || !IsDigit(*c)) {
+                p_ = c;
+                SyntaxError("invalid number");
+                return false;
+            }
+            while (c != end_ && IsDigit(*c)) ++c;
+        }
+        if (c != end_ && (*c == 'e' || *c == 'E')) {
+            ++c;
+            if (c != end_ && (*c == '+' || *c == '-')) ++c;
+            if (c == end_ || !IsDigit(*c)) {
+                p_ = c;
+                SyntaxError("invalid number");
+                return false;
+            }
+            while (c != end_ && IsDigit(*c)) ++c;
+        }
+
+        const auto parsed = std::from_chars(start, c, value);
+        finite = parsed.ec == std::errc();
+        p_ = c;
+        return true;
+    }
+
+    bool ParseLiteral(const char* literal) {
+        const std::string_view text(literal);
+        if (static_cast<size_t>(end_ - p_) < text.size() || std::string_view(p_, text.size()) != text) {
+            SyntaxError("invalid literal");
+            return false;
+        }
+        p_ += text.size();
+        return true;
+    }
+
+    /**
+     * @brief 跳过任意JSON值（未知字段、类型不符的字段），仍检查语法
+     */
+    bool SkipValue(int depth) {
+        if (depth > kMaxNestingDepth) {
+            SyntaxError("nesting too deep");
+            return false;
+        }
+        std::string_view text;
+        double number = 0.0;
+        bool finite = true;
+        switch (Peek()) {
+            case '{':
+                ++p_;
+                if (Consume('}')) {
+                    return true;
+                }
+                do {
+                    if (!ParseString(text) || !Expect(':') || !SkipValue(depth + 1)) {
+                        return false;
+                    }
+                } while (Consume(','));
+                return Expect('}');
+            case '[':
+                ++p_;
+                if (Consume(']')) {
+                    return true;
+                }
+                do {
+                    if (!SkipValue(depth + 1)) {
+                        return false;
+                    }
+                } while (Consume(','));
+                return Expect(']');
+            case '"':
+                return ParseString(text);
+            case 't':
+                return ParseLiteral("true");
+            case 'f':
+                return ParseLiteral("false");
+            case 'n':
+                return ParseLiteral("null");
+            default:
+                return ParseNumber(number, finite);
+        }
+    }
+
+    /**
+     * @brief 逐成员遍历对象；on_member 在值之前收到键，负责解析或跳过值
+     */
+    template <typename OnMember>
+    bool ParseObject(OnMember&& on_member) {
+        if (!Expect('{')) {
+            return false;
+        }
+        if (Consume('}')) {
+            return true;
+        }
+        do {
+            std::string_view key;
+            if (!ParseString(key)) {
+                return false;
+            }
+            // 键可能位于 scratch_，值解析前复制出来
+            std::string key_copy;
+            if (key.data() == scratch_.data()) {
+                key_copy.assign(key.data(), key.size());
+                key = key_copy;
+            }
+            if (!Expect(':') || !on_member(key)) {
+                return false;
+            }
+        } while (Consume(','));
+        return Expect('}');
+    }
+
+    bool ReportTypeAndSkip(std::string field, const char* expected) {
+        Report(ErrorCode::SCHEMA_MISSING, std::move(field), std::string("Expected ") + expected);
+        return SkipValue(0);
+    }
+
+    /**
+     * @brief 解析一条记录；top_level 时也接受 {"segments": [...]} 容器
+     */
+    bool ParseRecord(bool top_level) {
+        const size_t first_error = result_.errors.size();
+        record_guid_.clear();
+        record_timecode_.clear();
+
+        bool seen_st2094 = false;
+        bool seen_meta = false;
+        bool seen_segments = false;
+        const bool ok = ParseObject([&](std::string_view key) {
+            if (key == "st2094_10" || key == "cph_meta") {
+                bool& seen = key == "st2094_10" ? seen_st2094 : seen_meta;
+                const std::string_view block = key == "st2094_10" ? "st2094_10" : "cph_meta";
+                if (seen) {
+                    Report(ErrorCode::SCHEMA_MISSING, FieldPath({}, block), "Duplicate field");
+                }
+                seen = true;
+                if (Peek() != '{') {
+                    return ReportTypeAndSkip(FieldPath({}, block), "object");
+                }
+                return block == "st2094_10" ? ParseBlock(block, kSt2094Fields) : ParseBlock(block, kCphMetaFields);
+            }
+            if (top_level && key == "segments" && !seen_segments) {
+                seen_segments = true;
+                return ParseSegments();
+            }
+            Report(ErrorCode::SCHEMA_MISSING, FieldPath({}, key), "Unknown field");
+            return SkipValue(0);
+        });
+        if (!ok) {
+            return false;
+        }
+
+        if (seen_segments) {
+            if (seen_st2094 || seen_meta) {
+                Report(ErrorCode::SCHEMA_MISSING, "segments", "Document mixes a record with a segments array");
+            }
+            return true;
+        }
+
+        if (!seen_st2094) {
+            Report(ErrorCode::SCHEMA_MISSING, FieldPath({}, "st2094_10"), "Missing required field");
+        }
+        if (!seen_meta) {
+            Report(ErrorCode::SCHEMA_MISSING, FieldPath({}, "cph_meta"), "Missing required field");
+        }
+        result_.record_count++;
+
+        // 错误报告带上记录自身的片段标识，便于在归档中定位
+        for (size_t i = first_error; i < result_.errors.size(); ++i) {
+            result_.errors[i].clip_guid = record_guid_;
+            result_.errors[i].timecode = record_timecode_;
+        }
+        return true;
+    }
+
+    bool ParseSegments() {
+        if (Peek() != '[') {
+            return ReportTypeAndSkip("segments", "array");
+        }
+        ++p_;
+        if (Consume(']')) {
+            return true;
+        }
+        segment_ = 0;
+        do {
+            if (Peek() != '{') {
+                if (!ReportTypeAndSkip(FieldPath({}, {}), "object")) {
+                    return false;
+                }
+            } else if (!ParseRecord(false)) {
+                return false;
+            }
+            segment_++;
+        } while (Consume(','));
+        segment_ = -1;
+        return Expect(']');
+    }
+
+    template <size_t N>
+    bool ParseBlock(std::string_view block, const FieldSpec (&specs)[N]) {
+        static_assert(N <= 32, "seen mask holds 32 fields");
+        uint32_t seen = 0;
+        size_t next = 0;  // 写出端按表顺序输出字段，从上一个匹配之后开始找通常一次命中
+        const bool ok = ParseObject([&](std::string_view key) {
+            for (size_t n = 0; n < N; ++n) {
+                const size_t i = (next + n) % N;
+                if (key != specs[i].key) {
+                    continue;
+                }
+                next = i + 1;
+                if (seen & (1u << i)) {
+                    Report(ErrorCode::SCHEMA_MISSING, FieldPath(block, key), "Duplicate field");
+                }
+                seen |= 1u << i;
+                return ParseField(block, specs[i]);
+            }
+            Report(ErrorCode::SCHEMA_MISSING, FieldPath(block, key), "Unknown field");
+            return SkipValue(0);
+        });
+        if (!ok) {
+            return false;
+        }
+        for (size_t i = 0; i < N; ++i) {
+            if (specs[i].required && !(seen & (1u << i))) {
+                Report(ErrorCode::SCHEMA_MISSING, FieldPath(block, specs[i].key), "Missing required field");
+            }
+        }
+        return true;
+    }
+
+    bool ParseField(std::string_view block, const FieldSpec& spec) {
+        const char c = Peek();
+        if (spec.kind == FieldKind::STRING) {
+            if (c != '"') {
+                return ReportTypeAndSkip(FieldPath(block, spec.key), "string");
+            }
+            std::string_view text;
+            if (!ParseString(text)) {
+                return false;
+            }
+            CheckString(block, spec, text);
+            return true;
+        }
+
+        const bool is_integer = spec.kind == FieldKind::INTEGER;
+        if (c != '-' && !IsDigit(c)) {
+            return ReportTypeAndSkip(FieldPath(block, spec.key), is_integer ? "integer" : "number");
+        }
+        double number = 0.0;
+        bool finite = true;
+        if (!ParseNumber(number, finite)) {
+            return false;
+        }
+
+        // 按渲染端实际载入的 float 比较范围（0.05 的 double 略小于 0.05f）
+        const float value = static_cast<float>(number);
+        if (!finite || !std::isfinite(value)) {
+            Report(ErrorCode::NAN_INF, FieldPath(block, spec.key), "Number not representable as float");
+        } else if (is_integer && number != std::floor(number)) {
+            Report(ErrorCode::SCHEMA_MISSING, FieldPath(block, spec.key), "Expected integer", value);
+        } else if (!(value >= spec.min_value && value <= spec.max_value)) {
+            Report(spec.range_code, FieldPath(block, spec.key), "Parameter out of range", value);
+        }
+        return true;
+    }
+
+    void CheckString(std::string_view block, const FieldSpec& spec, std::string_view text) {
+        switch (spec.format) {
+            case StringFormat::ANY:
+                break;
+            case StringFormat::WORK_CS:
+                if (text != "BT2020_PQ") {
+                    Report(ErrorCode::SCHEMA_MISSING, FieldPath(block, spec.key), "Unsupported working color space");
+                }
+                break;
+            case StringFormat::GUID:
+                if (SidecarWriter::IsValidGuid(text)) {
+                    record_guid_.assign(text.data(), text.size());
+                } else {
+                    Report(ErrorCode::SCHEMA_MISSING, FieldPath(block, spec.key), "Invalid UUID");
+                }
+                break;
+            case StringFormat::TIMECODE_INOUT:
+                if (IsValidTimecodeRange(text)) {
+                    record_timecode_.assign(text.data(), text.size());
+                } else {
+                    Report(ErrorCode::SCHEMA_MISSING, FieldPath(block, spec.key), "Invalid timecode range");
+                }
+                break;
+        }
+    }
+};
+
+} // namespace
+
+namespace SidecarValidator {
+
+SidecarCheckResult Validate(const char* text, size_t size) {
+    SidecarCheckResult result;
+    Parser parser(text, size, result);
+    parser.ParseDocument();
+    result.valid = result.errors.empty();
+    return result;
+}
+
+SidecarCheckResult ValidateFile(const std::string& path) {
+    std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+    std::string text;
+    if (file.is_open()) {
+        const std::streamoff size = file.tellg();
+        if (size >= 0) {
+            text.resize(static_cast<size_t>(size));
+            file.seekg(0);
+            file.read(&text[0], size);
+        }
+    }
+    if (!file.is_open() || !file) {
+        SidecarCheckResult result;
+        ErrorReport error(ErrorCode::SCHEMA_MISSING, "Cannot read sidecar: " + path);
+        result.errors.push_back(error);
+        return result;
+    }
+    return Validate(text.data(), text.size());
+}
+
+} // namespace SidecarValidator
+
+} // namespace CinemaProHDR
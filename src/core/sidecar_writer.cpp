@@ -0,0 +1,230 @@
+#include "cinema_pro_hdr/sidecar_writer.h"
+#include <charconv>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+
+namespace CinemaProHDR {
+
+SidecarWriter::~SidecarWriter() {
+    if (file_.is_open()) {
+        Close();
+    }
+}
+
+bool SidecarWriter::Open(const std::string& path, const CphParams& params, const SidecarClipInfo& clip) {
+    if (file_.is_open()) {
+        last_error_ = "Sidecar already open";
+        return false;
+    }
+    if (!IsValidGuid(clip.clip_guid)) {
+        last_error_ = "hash_clip_guid is not a UUID: " + clip.clip_guid;
+        return false;
+    }
+    if (clip.fps <= 0) {
+        last_error_ = "Invalid frame rate";
+        return false;
+    }
+    if (clip.generator.size() > kMaxGeneratorLength) {
+        last_error_ = "Generator name too long";
+        return false;
+    }
+
+    file_.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file_.is_open()) {
+        last_error_ = "Cannot create sidecar: " + path;
+        return false;
+    }
+
+    params_ = params;
+    clip_ = clip;
+    record_count_ = 0;
+    length_ = 0;
+    Append("{\"segments\": [");
+    return Flush();
+}
+
+bool SidecarWriter::WriteRecord(const ShotMetadata& shot) {
+    if (!file_.is_open()) {
+        last_error_ = "Sidecar not open";
+        return false;
+    }
+    if (shot.frame_count == 0) {
+        last_error_ = "Empty segment";
+        return false;
+    }
+
+    // 时间码区间：入点为首帧，出点为末帧（含）
+    char timecode[2 * kTimecodeLength + 2];
+    const uint64_t in_frame = clip_.start_frame + shot.first_frame;
+    if (!FormatTimecode(in_frame, clip_.fps, timecode) ||
+        !FormatTimecode(in_frame + shot.frame_count - 1, clip_.fps, timecode + kTimecodeLength + 1)) {
+        last_error_ = "Segment outside 24h timecode range";
+        return false;
+    }
+    timecode[kTimecodeLength] = '-';
+    timecode[2 * kTimecodeLength + 1] = '\0';
+
+    length_ = 0;
+    Append(record_count_ == 0 ? "\n{" : ",\n{");
+
+    Append("\"st2094_10\": {");
+    AppendField("minPqEncodedMaxRGB", shot.min_pq);
+    AppendField("avgPqEncodedMaxRGB", shot.avg_pq);
+    AppendField("maxPqEncodedMaxRGB", shot.max_pq);
+    AppendField("offset", shot.offset);
+    AppendField("gain", shot.gain);
+    AppendField("gamma", shot.gamma, true);
+    Append("}, ");
+
+    Append("\"cph_meta\": {\"cph_version\": 2, \"cph_curve_id\": ");
+    AppendInteger(static_cast<int>(params_.curve));
+    Append(", ");
+    AppendField("pivot", params_.pivot_pq);
+    AppendField("gamma_s", params_.gamma_s);
+    AppendField("gamma_h", params_.gamma_h);
+    AppendField("shoulder", params_.shoulder_h);
+    AppendField("black_lift", params_.black_lift);
+    AppendField("highlight_detail", params_.highlight_detail);
+    AppendField("sat_base", params_.sat_base);
+    AppendField("sat_hi", params_.sat_hi);
+    Append("\"work_cs\": \"BT2020_PQ\", \"hash_clip_guid\": ");
+    AppendString(clip_.clip_guid);
+    Append(", \"timecode_inout\": ");
+    Append("\"");
+    Append(timecode);
+    Append("\", \"generator\": ");
+    AppendString(clip_.generator);
+    Append("}}");
+
+    if (!Flush()) {
+        return false;
+    }
+    record_count_++;
+    return true;
+}
+
+bool SidecarWriter::Close() {
+    if (!file_.is_open()) {
+        return false;
+    }
+    length_ = 0;
+    Append(record_count_ == 0 ? "]}\n" : "\n]}\n");
+    bool ok = Flush();
+    file_.close();
+    if (ok && file_.fail()) {
+        last_error_ = "Failed to close sidecar";
+        ok = false;
+    }
+    return ok;
+}
+
+bool SidecarWriter::FormatTimecode(uint64_t frame, int fps, char* out) {
+    if (fps <= 0) {
+        return false;
+    }
+    const uint64_t rate = static_cast<uint64_t>(fps);
+    const uint64_t total_seconds = frame / rate;
+    if (total_seconds >= 24 * 3600 || fps > 99) {
+        return false;
+    }
+    const unsigned fields[4] = {
+        static_cast<unsigned>(total_seconds / 3600),
+        static_cast<unsigned>(total_seconds / 60 % 60),
+        static_cast<unsigned>(total_seconds % 60),
+        static_cast<unsigned>(frame % rate)
+    };
+    for (int i = 0; i < 4; ++i) {
+        out[i * 3] = static_cast<char>('0' + fields[i] / 10);
+        out[i * 3 + 1] = static_cast<char>('0' + fields[i] % 10);
+        if (i < 3) {
+            out[i * 3 + 2] = ':';
+        }
+    }
+    return true;
+}
+
+bool SidecarWriter::IsValidGuid(std::string_view guid) {
+    if (guid.size() != 36) {
+        return false;
+    }
+    for (size_t i = 0; i < guid.size(); ++i) {
+        const bool dash = i == 8 || i == 13 || i == 18 || i == 23;
+        if (dash ? guid[i] != '-' : !std::isxdigit(static_cast<unsigned char>(guid[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SidecarWriter::Append(const char* text) {
+    const size_t size = std::strlen(text);
+    const size_t n = std::min(size, kRecordBufferSize - length_);
+    std::memcpy(buffer_ + length_, text, n);
+    length_ += n;
+}
+
+void SidecarWriter::AppendString(const std::string& text) {
+    // JSON转义：引号、反斜杠与控制字符
+    Append("\"");
+    for (char c : text) {
+        char escaped[8];
+        if (c == '"' || c == '\\') {
+            escaped[0] = '\\';
+            escaped[1] = c;
+            escaped[2] = '\0';
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            static const char kHex[] = "0123456789abcdef";
+            std::memcpy(escaped, "\\u00", 4);
+            escaped[4] = kHex[(c >> 4) & 0xf];
+            escaped[5] = kHex[c & 0xf];
+            escaped[6] = '\0';
+        } else {
+            escaped[0] = c;
+            escaped[1] = '\0';
+        }
+        Append(escaped);
+    }
+    Append("\"");
+}
+
+void SidecarWriter::AppendNumber(float value) {
+    // to_chars 与区域设置无关，输出可逐位往返的最短表示；JSON不能表示非有限值
+    char text[32];
+    auto result = std::to_chars(text, text + sizeof(text) - 1, std::isfinite(value) ? value : 0.0f);
+    *result.ptr = '\0';
+    Append(text);
+}
+
+void SidecarWriter::AppendInteger(long long value) {
+    char text[24];
+    auto result = std::to_chars(text, text + sizeof(text) - 1, value);
+    *result.ptr = '\0';
+    Append(text);
+}
+
+void SidecarWriter::AppendField(const char* name, float value, bool last) {
+    Append("\"");
+    Append(name);
+    Append("\": ");
+    AppendNumber(value);
+    if (!last) {
+        Append(", ");
+    }
+}
+
+bool SidecarWriter::Flush() {
+    if (length_ >= kRecordBufferSize) {
+        last_error_ = "Sidecar record exceeds buffer";
+        return false;
+    }
+    file_.write(buffer_, static_cast<std::streamsize>(length_));
+    file_.flush();
+    if (!file_) {
+        last_error_ = "Sidecar write failed";
+        return false;
+    }
+    return true;
+}
+
+} // namespace CinemaProHDR
@@ -0,0 +1,91 @@
+#include "cinema_pro_hdr/stage_cache.h"
+#include "cinema_pro_hdr/processor.h"
+
+namespace CinemaProHDR {
+
+size_t StageCache::ImageBytes(const ImagePlanar& image) {
+    size_t samples = image.planes[0].size() + image.planes[1].size() + image.planes[2].size() + image.luma.size();
+    return samples * sizeof(float);
+}
+
+size_t StageCache::SuggestedMaxBytes(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return 0;
+    }
+    return size_t(kCheckpointsPerFrame) * 4 * static_cast<size_t>(width) * static_cast<size_t>(height) * sizeof(float);
+}
+
+const ImagePlanar* StageCache::Find(uint64_t frame_id, RenderStage stage, uint64_t param_hash) {
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (it->frame_id == frame_id && it->stage == stage && it->param_hash == param_hash) {
+            entries_.splice(entries_.begin(), entries_, it);
+            stats_.hits++;
+            return &entries_.front().image;
+        }
+    }
+    stats_.misses++;
+    return nullptr;
+}
+
+bool StageCache::Store(uint64_t frame_id, RenderStage stage, uint64_t param_hash, const ImagePlanar& image) {
+    // 同一(帧, 阶段)的旧结果已过期（依赖参数已变化），直接替换
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (it->frame_id == frame_id && it->stage == stage) {
+            cached_bytes_ -= it->bytes;
+            entries_.erase(it);
+            break;
+        }
+    }
+
+    const size_t bytes = ImageBytes(image);
+    if (bytes == 0 || bytes > max_bytes_) {
+        if (bytes > 0 && max_bytes_ > 0) {
+            stats_.rejected++;
+        }
+        return false;
+    }
+
+    EvictToFit(bytes);
+    entries_.push_front(Entry{frame_id, stage, param_hash, bytes, image});
+    cached_bytes_ += bytes;
+    stats_.stores++;
+    return true;
+}
+
+void StageCache::InvalidateFrame(uint64_t frame_id) {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->frame_id == frame_id) {
+            cached_bytes_ -= it->bytes;
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void StageCache::Clear() {
+    entries_.clear();
+    cached_bytes_ = 0;
+}
+
+void StageCache::SetMaxBytes(size_t max_bytes) {
+    max_bytes_ = max_bytes;
+    EvictToFit(0);
+}
+
+void StageCache::EvictToFit(size_t incoming_bytes) {
+    while (!entries_.empty() && cached_bytes_ + incoming_bytes > max_bytes_) {
+        cached_bytes_ -= entries_.back().bytes;
+        entries_.pop_back();
+        stats_.evictions++;
+    }
+}
+
+StageCacheStats StageCache::GetStats() const {
+    StageCacheStats stats = stats_;
+    stats.entries = entries_.size();
+    stats.cached_bytes = cached_bytes_;
+    return stats;
+}
+
+} // namespace CinemaProHDR
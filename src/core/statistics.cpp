@@ -1,8 +1,30 @@
 #include "cinema_pro_hdr/core.h"
+#include "cinema_pro_hdr/cpu_dispatch.h"
 #include <cmath>
+#include <algorithm>
 
 namespace CinemaProHDR {
 
+namespace {
+
+// 直方图的可向量化部分：MaxRGB与分箱下标（非有限像素的下标为-1），散射更新仍逐样本进行
+CPH_KERNEL_INLINE void HistogramBinKernelBody(const float* r, const float* g, const float* b, float* values,
+                                              int* indices, size_t count, int bins) {
+    for (size_t i = 0; i < count; ++i) {
+        const bool finite = std::isfinite(r[i]) && std::isfinite(g[i]) && std::isfinite(b[i]);
+        const float value = std::max(r[i], std::max(g[i], b[i]));
+        values[i] = value;
+        indices[i] = finite ? std::clamp(static_cast<int>(value * bins), 0, bins - 1) : -1;
+    }
+}
+
+CPH_DISPATCH_KERNEL(HistogramBinKernel,
+                    (const float* r, const float* g, const float* b, float* values, int* indices, size_t count,
+                     int bins),
+                    (r, g, b, values, indices, count, bins))
+
+} // namespace
+
 void Statistics::Reset() {
     pq_stats.min_pq = 0.0f;
     pq_stats.avg_pq = 0.0f;
@@ -44,4 +66,195 @@ bool Statistics::IsValid() const {
     return true;
 }
 
+void StatisticsAccumulator::AddPixels(const float* r, const float* g, const float* b, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (std::isfinite(r[i]) && std::isfinite(g[i]) && std::isfinite(b[i])) {
+            samples_.push_back(std::max(r[i], std::max(g[i], b[i])));
+        }
+    }
+}
+
+void StatisticsAccumulator::Merge(const StatisticsAccumulator& other) {
+    samples_.insert(samples_.end(), other.samples_.begin(), other.samples_.end());
+}
+
+bool StatisticsAccumulator::Finalize(Statistics::PQStats& pq_stats) {
+    if (samples_.empty()) {
+        return false;
+    }
+    
+    // 排序后求值：结果与样本的加入顺序（区域划分）无关
+    std::sort(samples_.begin(), samples_.end());
+    
+    // Calculate 1% trimmed statistics
+    size_t trim_count = samples_.size() / 100; // 1%
+    size_t start_idx = trim_count;
+    size_t end_idx = samples_.size() - trim_count;
+    
+    if (start_idx < end_idx) {
+        pq_stats.min_pq = samples_[start_idx];
+        pq_stats.max_pq = samples_[end_idx - 1];
+        
+        // Calculate trimmed mean
+        float sum = 0.0f;
+        for (size_t i = start_idx; i < end_idx; ++i) {
+            sum += samples_[i];
+        }
+        pq_stats.avg_pq = sum / (end_idx - start_idx);
+        
+        // Calculate variance
+        float variance_sum = 0.0f;
+        for (size_t i = start_idx; i < end_idx; ++i) {
+            float diff = samples_[i] - pq_stats.avg_pq;
+            variance_sum += diff * diff;
+        }
+        pq_stats.variance = variance_sum / (end_idx - start_idx);
+    }
+    
+    return true;
+}
+
+StatisticsHistogram::StatisticsHistogram() : bins_(kBins) {}
+
+void StatisticsHistogram::AddToBin(int index, float value) {
+    Bin& bin = bins_[index];
+    if (bin.count == 0) {
+        bin.min = bin.max = value;
+    } else {
+        bin.min = std::min(bin.min, value);
+        bin.max = std::max(bin.max, value);
+    }
+    bin.count++;
+    bin.sum += value;
+    bin.sum_sq += static_cast<double>(value) * value;
+    total_++;
+}
+
+void StatisticsHistogram::Add(float max_rgb) {
+    if (std::isfinite(max_rgb)) {
+        AddToBin(std::clamp(static_cast<int>(max_rgb * kBins), 0, kBins - 1), max_rgb);
+    }
+}
+
+void StatisticsHistogram::AddPixels(const float* r, const float* g, const float* b, size_t count,
+                                    StatisticsAccumulator* samples) {
+    constexpr size_t kChunk = 256;
+    float values[kChunk];
+    int indices[kChunk];
+
+    for (size_t begin = 0; begin < count; begin += kChunk) {
+        const size_t n = std::min(kChunk, count - begin);
+        HistogramBinKernel(r + begin, g + begin, b + begin, values, indices, n, kBins);
+
+        for (size_t i = 0; i < n; ++i) {
+            if (indices[i] < 0) {
+                continue;
+            }
+            AddToBin(indices[i], values[i]);
+            if (samples) {
+                samples->Add(values[i]);
+            }
+        }
+    }
+}
+
+void StatisticsHistogram::GetDistribution(float* distribution, int bins) const {
+    std::fill(distribution, distribution + bins, 0.0f);
+    if (total_ == 0 || bins <= 0 || kBins % bins != 0) {
+        return;
+    }
+    const int fold = kBins / bins;
+    const double scale = 1.0 / static_cast<double>(total_);
+    for (int i = 0; i < bins; ++i) {
+        uint64_t count = 0;
+        for (int j = 0; j < fold; ++j) {
+            count += bins_[i * fold + j].count;
+        }
+        distribution[i] = static_cast<float>(count * scale);
+    }
+}
+
+void StatisticsHistogram::Merge(const StatisticsHistogram& other) {
+    for (int i = 0; i < kBins; ++i) {
+        const Bin& source = other.bins_[i];
+        if (source.count == 0) {
+            continue;
+        }
+        Bin& bin = bins_[i];
+        if (bin.count == 0) {
+            bin.min = source.min;
+            bin.max = source.max;
+        } else {
+            bin.min = std::min(bin.min, source.min);
+            bin.max = std::max(bin.max, source.max);
+        }
+        bin.count += source.count;
+        bin.sum += source.sum;
+        bin.sum_sq += source.sum_sq;
+    }
+    total_ += other.total_;
+}
+
+void StatisticsHistogram::Clear() {
+    std::fill(bins_.begin(), bins_.end(), Bin());
+    total_ = 0;
+}
+
+bool StatisticsHistogram::Finalize(Statistics::PQStats& pq_stats) const {
+    if (total_ == 0) {
+        return false;
+    }
+    
+    // 与 StatisticsAccumulator 相同的1%截尾：保留排序后的 [start, end) 名次
+    const uint64_t trim_count = total_ / 100;
+    const uint64_t start = trim_count;
+    const uint64_t end = total_ - trim_count;
+    if (start >= end) {
+        return true;
+    }
+    
+    // 箱内第rank个样本：在箱的取值范围内线性插值
+    auto value_at = [](const Bin& bin, uint64_t rank) {
+        if (bin.count <= 1) {
+            return bin.min;
+        }
+        float t = static_cast<float>(rank) / static_cast<float>(bin.count - 1);
+        return bin.min + (bin.max - bin.min) * t;
+    };
+    
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    uint64_t rank = 0;
+    for (const Bin& bin : bins_) {
+        if (bin.count == 0) {
+            continue;
+        }
+        const uint64_t bin_begin = rank;
+        const uint64_t bin_end = rank + bin.count;
+        rank = bin_end;
+        if (bin_end <= start || bin_begin >= end) {
+            continue;
+        }
+        
+        if (start >= bin_begin && start < bin_end) {
+            pq_stats.min_pq = value_at(bin, start - bin_begin);
+        }
+        if (end - 1 >= bin_begin && end - 1 < bin_end) {
+            pq_stats.max_pq = value_at(bin, end - 1 - bin_begin);
+        }
+        
+        // 部分截尾的箱按样本数比例计入
+        const uint64_t kept = std::min(bin_end, end) - std::max(bin_begin, start);
+        const double fraction = static_cast<double>(kept) / static_cast<double>(bin.count);
+        sum += bin.sum * fraction;
+        sum_sq += bin.sum_sq * fraction;
+    }
+    
+    const double n = static_cast<double>(end - start);
+    const double mean = sum / n;
+    pq_stats.avg_pq = static_cast<float>(mean);
+    pq_stats.variance = static_cast<float>(std::max(0.0, sum_sq / n - mean * mean));
+    return true;
+}
+
 } // namespace CinemaProHDR
\ No newline at end of file
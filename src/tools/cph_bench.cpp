@@ -0,0 +1,234 @@
+/**
+ * @file cph_bench.cpp
+ * @brief Cinema Pro HDR 基准测试与PGO训练负载
+ *
+ * 以三套预设（Cinema-Flat / Cinema-Punch / Cinema-Highlight）处理合成帧，
+ * 分别测量整帧（CompiledPipeline）与扫描线（ScanlineStream）两条路径的吞吐。
+ * --train 模式运行较小的固定负载，供 CPH_PGO=GENERATE 构建采集剖析数据。
+ *
+ * 用法：cph_bench [--preset flat|punch|highlight|all] [--width W] [--height H]
+ *                 [--frames N] [--source pq|p3] [--train]
+ */
+
+#include "cinema_pro_hdr/pipeline.h"
+#include "cinema_pro_hdr/scanline.h"
+#include "cinema_pro_hdr/cpu_dispatch.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace CinemaProHDR;
+
+namespace {
+
+struct BenchPreset {
+    const char* name;
+    CphParams params;
+};
+
+// 与 src/dctl/parameter_mapping.h 中的三套预设一致
+std::vector<BenchPreset> MakePresets() {
+    CphParams flat;
+    flat.pivot_pq = 0.18f; flat.gamma_s = 1.10f; flat.gamma_h = 1.05f; flat.shoulder_h = 1.0f;
+    flat.black_lift = 0.003f; flat.highlight_detail = 0.2f; flat.sat_base = 1.00f; flat.sat_hi = 0.95f;
+
+    CphParams punch;
+    punch.pivot_pq = 0.18f; punch.gamma_s = 1.40f; punch.gamma_h = 1.10f; punch.shoulder_h = 1.8f;
+    punch.black_lift = 0.002f; punch.highlight_detail = 0.4f; punch.sat_base = 1.05f; punch.sat_hi = 1.00f;
+
+    CphParams highlight;
+    highlight.pivot_pq = 0.20f; highlight.gamma_s = 1.20f; highlight.gamma_h = 0.95f; highlight.shoulder_h = 1.2f;
+    highlight.black_lift = 0.004f; highlight.highlight_detail = 0.6f; highlight.sat_base = 0.98f;
+    highlight.sat_hi = 0.92f;
+
+    return {{"flat", flat}, {"punch", punch}, {"highlight", highlight}};
+}
+
+struct BenchOptions {
+    std::string preset = "all";
+    int width = 3840;
+    int height = 2160;
+    int frames = 10;
+    ColorSpace source = ColorSpace::BT2020_PQ;
+    bool train = false;
+};
+
+/**
+ * @brief 合成帧：横向渐变、纵向起伏与逐帧平移的高光点阵，覆盖阴影到峰值的全部曲线段
+ */
+Image MakeFrame(int width, int height, int index, ColorSpace cs) {
+    Image frame(width, height, 3);
+    frame.color_space = cs;
+    for (int y = 0; y < height; ++y) {
+        const float wave = 0.5f + 0.5f * std::sin(0.013f * y);
+        for (int x = 0; x < width; ++x) {
+            float* pixel = frame.GetPixel(x, y);
+            const float ramp = static_cast<float>(x) / width;
+            const bool spot = ((x + 3 * index) / 24 + y / 24) % 7 == 0;
+            pixel[0] = spot ? 0.95f : 0.05f + 0.7f * ramp;
+            pixel[1] = spot ? 0.92f : 0.05f + 0.6f * ramp * wave;
+            pixel[2] = spot ? 0.88f : 0.1f + 0.3f * wave;
+        }
+    }
+    return frame;
+}
+
+class FrameSource : public ScanlineSource {
+public:
+    explicit FrameSource(const Image& image) : image_(image) {}
+    bool ReadRow(int y, float* row) override {
+        const size_t size = static_cast<size_t>(image_.width) * image_.channels;
+        std::memcpy(row, image_.data.data() + y * size, size * sizeof(float));
+        return true;
+    }
+private:
+    const Image& image_;
+};
+
+class DiscardSink : public ScanlineSink {
+public:
+    bool WriteRow(int, const float*) override { return true; }
+};
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void PrintResult(const char* preset, const char* path, double total_ms, const BenchOptions& options) {
+    const double frame_ms = total_ms / options.frames;
+    const double mpix = static_cast<double>(options.width) * options.height / 1.0e6;
+    std::cout << std::left << std::setw(10) << preset << std::setw(10) << path << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << frame_ms << " ms/frame" << std::setw(10)
+              << mpix / (frame_ms / 1000.0) << " MPix/s" << std::endl;
+}
+
+bool RunPreset(const BenchPreset& preset, const BenchOptions& options) {
+    std::vector<ErrorReport> errors;
+    std::shared_ptr<const CompiledPipeline> pipeline = CompiledPipeline::Compile(preset.params, errors);
+    if (!pipeline) {
+        std::cerr << "Failed to compile preset " << preset.name << ": "
+                  << (errors.empty() ? std::string() : errors.front().ToString()) << std::endl;
+        return false;
+    }
+
+    // 预先生成两帧交替输入，计时只覆盖处理
+    const Image inputs[2] = {MakeFrame(options.width, options.height, 0, options.source),
+                             MakeFrame(options.width, options.height, 1, options.source)};
+    Image output;
+    StreamState state;
+    state.motion_protection = true;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.frames; ++i) {
+        if (!pipeline->ProcessFrame(inputs[i % 2], output, state)) {
+            std::cerr << "Frame processing failed: " << state.GetLastError() << std::endl;
+            return false;
+        }
+    }
+    const double frame_ms = ElapsedMs(start);
+
+    ScanlineStream stream(pipeline);
+    ScanlineFormat format;
+    format.width = options.width;
+    format.height = options.height;
+    format.color_space = options.source;
+    DiscardSink sink;
+    StreamState stream_state;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.frames; ++i) {
+        FrameSource source(inputs[i % 2]);
+        if (!stream.ProcessFrame(format, source, sink, stream_state)) {
+            std::cerr << "Scanline processing failed: " << stream_state.GetLastError() << std::endl;
+            return false;
+        }
+    }
+    const double scanline_ms = ElapsedMs(start);
+
+    if (!options.train) {
+        PrintResult(preset.name, "frame", frame_ms, options);
+        PrintResult(preset.name, "scanline", scanline_ms, options);
+    }
+    return true;
+}
+
+bool ParseArgs(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--train") {
+            // 训练负载：960×540、每套预设两种源色彩空间各2帧（剖析只需覆盖分支分布，不需要大帧）
+            options.train = true;
+            options.width = 960;
+            options.height = 540;
+            options.frames = 2;
+        } else if (arg == "--preset" && has_value) {
+            options.preset = argv[++i];
+        } else if (arg == "--width" && has_value) {
+            options.width = std::atoi(argv[++i]);
+        } else if (arg == "--height" && has_value) {
+            options.height = std::atoi(argv[++i]);
+        } else if (arg == "--frames" && has_value) {
+            options.frames = std::atoi(argv[++i]);
+        } else if (arg == "--source" && has_value) {
+            const std::string source = argv[++i];
+            if (source == "pq") {
+                options.source = ColorSpace::BT2020_PQ;
+            } else if (source == "p3") {
+                options.source = ColorSpace::P3_D65;
+            } else {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    return options.width > 0 && options.height > 0 && options.frames > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!ParseArgs(argc, argv, options)) {
+        std::cerr << "Usage: cph_bench [--preset flat|punch|highlight|all] [--width W] [--height H]"
+                  << " [--frames N] [--source pq|p3] [--train]" << std::endl;
+        return 2;
+    }
+
+    if (!options.train) {
+        std::cout << "cph_bench " << options.width << "x" << options.height << ", " << options.frames
+                  << " frames, CPU tier " << CpuDispatch::TierToString(CpuDispatch::GetActiveTier()) << std::endl;
+    }
+
+    int ran = 0;
+    for (const BenchPreset& preset : MakePresets()) {
+        if (options.preset != "all" && options.preset != preset.name) {
+            continue;
+        }
+        ran++;
+        if (!RunPreset(preset, options)) {
+            return 1;
+        }
+        if (options.train) {
+            // 非PQ源覆盖入域/出域的矩阵与曲线路径
+            BenchOptions p3 = options;
+            p3.source = ColorSpace::P3_D65;
+            if (!RunPreset(preset, p3)) {
+                return 1;
+            }
+        }
+    }
+
+    if (ran == 0) {
+        std::cerr << "Unknown preset: " << options.preset << std::endl;
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file cph_json_check.cpp
+ * @brief Cinema Pro HDR 侧车JSON批量校验工具
+ *
+ * 校验单个文件或整个目录树中的侧车文件，逐字段报告错误码（见 SidecarValidator）。
+ * 文件按路径排序后由工作线程动态领取，结果按排序顺序输出，与线程数无关。
+ * 退出码：0 全部合法，1 存在不合法文件，2 参数或路径错误。
+ *
+ * 用法：cph_json_check [--threads N] [--ext .json] [--quiet] PATH...
+ */
+
+#include "cinema_pro_hdr/sidecar_validator.h"
+#include "cinema_pro_hdr/parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace CinemaProHDR;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct CheckOptions {
+    int threads = 0;                // <=0 表示硬件线程数
+    std::string extension = ".json";
+    bool quiet = false;             // 只输出汇总
+    std::vector<std::string> paths;
+};
+
+const char* ErrorCodeName(ErrorCode code) {
+    switch (code) {
+        case ErrorCode::SUCCESS: return "SUCCESS";
+        case ErrorCode::SCHEMA_MISSING: return "SCHEMA_MISSING";
+        case ErrorCode::RANGE_PIVOT: return "RANGE_PIVOT";
+        case ErrorCode::RANGE_KNEE: return "RANGE_KNEE";
+        case ErrorCode::NAN_INF: return "NAN_INF";
+        case ErrorCode::DET_MISMATCH: return "DET_MISMATCH";
+        case ErrorCode::HL_FLICKER: return "HL_FLICKER";
+        case ErrorCode::DCI_BOUND: return "DCI_BOUND";
+        case ErrorCode::GAMUT_OOG: return "GAMUT_OOG";
+    }
+    return "UNKNOWN";
+}
+
+bool ParseArgs(int argc, char** argv, CheckOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--threads" && has_value) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (arg == "--ext" && has_value) {
+            options.extension = argv[++i];
+        } else if (arg == "--quiet") {
+            options.quiet = true;
+        } else if (!arg.empty() && arg[0] == '-') {
+            return false;
+        } else {
+            options.paths.push_back(arg);
+        }
+    }
+    return !options.paths.empty();
+}
+
+/**
+ * @brief 展开命令行路径：文件直接加入，目录递归收集指定扩展名的普通文件
+ */
+bool CollectFiles(const CheckOptions& options, std::vector<std::string>& files) {
+    for (const auto& path : options.paths) {
+        std::error_code ec;
+        if (fs::is_regular_file(path, ec)) {
+            files.push_back(path);
+            continue;
+        }
+        if (!fs::is_directory(path, ec)) {
+            std::cerr << "No such file or directory: " << path << std::endl;
+            return false;
+        }
+        fs::recursive_directory_iterator it(path, fs::directory_options::skip_permission_denied, ec);
+        for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            if (it->is_regular_file(ec) && it->path().extension() == options.extension) {
+                files.push_back(it->path().string());
+            }
+        }
+        if (ec) {
+            std::cerr << "Cannot scan " << path << ": " << ec.message() << std::endl;
+            return false;
+        }
+    }
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+    return true;
+}
+
+void PrintErrors(const std::string& path, const SidecarCheckResult& result) {
+    for (const auto& error : result.errors) {
+        std::cout << path << ": " << ErrorCodeName(error.code);
+        if (!error.field_name.empty()) {
+            std::cout << " " << error.field_name;
+        }
+        std::cout << " - " << error.message;
+        if (error.code == ErrorCode::RANGE_PIVOT) {
+            std::cout << " (" << error.invalid_value << ")";
+        }
+        if (!error.timecode.empty()) {
+            std::cout << " [" << error.timecode << "]";
+        }
+        std::cout << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    CheckOptions options;
+    if (!ParseArgs(argc, argv, options)) {
+        std::cerr << "Usage: cph_json_check [--threads N] [--ext .json] [--quiet] PATH..." << std::endl;
+        return 2;
+    }
+
+    std::vector<std::string> files;
+    if (!CollectFiles(options, files)) {
+        return 2;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // 每个工作线程循环领取下一个文件，大小悬殊的文件不会让某个线程独自拖尾
+    std::vector<SidecarCheckResult> results(files.size());
+    std::atomic<size_t> next{0};
+    const int threads = options.threads > 0 ? options.threads : Parallel::HardwareThreads();
+    Parallel::ParallelFor(0, std::max(1, std::min<int>(threads, static_cast<int>(files.size()))),
+        [&](int, int) {
+            for (size_t i = next++; i < files.size(); i = next++) {
+                results[i] = SidecarValidator::ValidateFile(files[i]);
+            }
+        },
+        threads);
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t invalid = 0;
+    size_t records = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        records += results[i].record_count;
+        if (!results[i].valid) {
+            invalid++;
+            if (!options.quiet) {
+                PrintErrors(files[i], results[i]);
+            }
+        }
+    }
+    std::cout << "Checked " << files.size() << " files (" << records << " records): "
+              << files.size() - invalid << " valid, " << invalid << " invalid in "
+              << std::fixed << std::setprecision(3) << seconds << " s" << std::endl;
+    return invalid == 0 ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file cph_throttle_bench.cpp
+ * @brief LogThrottler 并发吞吐微基准
+ *
+ * N 个线程同时调用 ShouldLog，对比无锁 LogThrottler 与互斥锁+哈希表的参考实现
+ * （即改造前的节流器）。两种负载：
+ * - hot：所有线程报同一个错误码（单个槽位上的最坏竞争）
+ * - mixed：线程 i 报错误码 i % 9（不同错误码互不干扰的情形）
+ *
+ * 用法：cph_throttle_bench [--threads N] [--events N]
+ */
+
+#include "cinema_pro_hdr/error_handler.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace CinemaProHDR;
+
+namespace {
+
+constexpr int kErrorCodeCount = static_cast<int>(ErrorCode::GAMUT_OOG) + 1;
+
+struct ThrottleBenchOptions {
+    int threads = 32;
+    int events = 200000;  // 每线程调用次数
+};
+
+/**
+ * @brief 参考实现：每次调用加锁并查哈希表
+ */
+class MutexThrottler {
+public:
+    bool ShouldLog(ErrorCode error_code) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& info = map_[error_code];
+        auto now = std::chrono::steady_clock::now();
+        if (now - info.window_start >= std::chrono::seconds(1)) {
+            info.count = 0;
+            info.window_start = now;
+        }
+        if (info.count >= 10) {
+            info.throttled_count++;
+            if (info.throttled_count == 1) {
+                info.first_throttled = now;
+            }
+            info.last_throttled = now;
+            return false;
+        }
+        info.count++;
+        return true;
+    }
+
+private:
+    struct Info {
+        int count = 0;
+        std::chrono::steady_clock::time_point window_start;
+        int throttled_count = 0;
+        std::chrono::steady_clock::time_point first_throttled;
+        std::chrono::steady_clock::time_point last_throttled;
+    };
+    std::unordered_map<ErrorCode, Info> map_;
+    std::mutex mutex_;
+};
+
+struct RunResult {
+    double ms = 0.0;
+    uint64_t accepted = 0;
+};
+
+template <typename Throttler>
+RunResult Run(Throttler& throttler, const ThrottleBenchOptions& options, bool mixed) {
+    std::atomic<uint64_t> accepted{0};
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    threads.reserve(options.threads);
+
+    for (int t = 0; t < options.threads; ++t) {
+        threads.emplace_back([&, t]() {
+            const ErrorCode code = mixed ? static_cast<ErrorCode>(t % kErrorCodeCount) : ErrorCode::NAN_INF;
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            uint64_t local = 0;
+            for (int i = 0; i < options.events; ++i) {
+                local += throttler.ShouldLog(code) ? 1 : 0;
+            }
+            accepted.fetch_add(local);
+        });
+    }
+
+    // 所有线程就绪后同时起跑，计时不含线程创建
+    while (ready.load() < options.threads) {
+        std::this_thread::yield();
+    }
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    RunResult result;
+    result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    result.accepted = accepted.load();
+    return result;
+}
+
+void PrintResult(const char* impl, const char* load, const RunResult& result, const ThrottleBenchOptions& options) {
+    const double total = static_cast<double>(options.threads) * options.events;
+    std::cout << std::left << std::setw(10) << impl << std::setw(8) << load << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << result.ms << " ms" << std::setw(10)
+              << total / (result.ms * 1000.0) << " M calls/s" << std::setw(8) << result.accepted << " logged"
+              << std::endl;
+}
+
+bool ParseArgs(int argc, char** argv, ThrottleBenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--threads" && has_value) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (arg == "--events" && has_value) {
+            options.events = std::atoi(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return options.threads > 0 && options.events > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    ThrottleBenchOptions options;
+    if (!ParseArgs(argc, argv, options)) {
+        std::cerr << "Usage: cph_throttle_bench [--threads N] [--events N]" << std::endl;
+        return 2;
+    }
+
+    std::cout << "cph_throttle_bench " << options.threads << " threads x " << options.events << " calls, "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+    for (bool mixed : {false, true}) {
+        const char* load = mixed ? "mixed" : "hot";
+        MutexThrottler reference;
+        PrintResult("mutex", load, Run(reference, options, mixed), options);
+        LogThrottler throttler;
+        PrintResult("lockfree", load, Run(throttler, options, mixed), options);
+    }
+    return 0;
+}
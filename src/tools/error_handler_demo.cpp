@@ -13,6 +13,7 @@
 #include "cinema_pro_hdr/error_handler.h"
 #include <iostream>
 #include <iomanip>
+#include <atomic>
 #include <thread>
 #include <chrono>
 #include <limits>
@@ -1,5 +1,6 @@
 #include "test_framework.h"
 #include "cinema_pro_hdr/color_space.h"
+#include <algorithm>
 #include <cmath>
 
 using namespace CinemaProHDR;
@@ -96,6 +97,48 @@ TEST(ColorSpace_WorkingDomainConversion) {
     return true;
 }
 
+TEST(ColorSpace_WorkingDomainPreservesAlpha) {
+    const int width = 16;
+    const int height = 8;
+
+    // 先归还一块填满脏数据的同尺寸缓冲，使输出复用它
+    {
+        Image dirty(width, height, 4, ImageInit::UNINITIALIZED);
+        std::fill(dirty.data.begin(), dirty.data.end(), 7.0f);
+    }
+
+    Image input(width, height, 4);
+    input.color_space = ColorSpace::P3_D65;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            float* pixel = input.GetPixel(x, y);
+            pixel[0] = 0.1f + 0.05f * x;
+            pixel[1] = 0.2f;
+            pixel[2] = 0.3f;
+            pixel[3] = static_cast<float>(x + y * width) / (width * height);
+        }
+    }
+
+    Image working;
+    ColorSpaceConverter::ToWorkingDomain(input, working);
+    {
+        Image dirty(width, height, 4, ImageInit::UNINITIALIZED);
+        std::fill(dirty.data.begin(), dirty.data.end(), 7.0f);
+    }
+    Image output;
+    ColorSpaceConverter::FromWorkingDomain(working, output, ColorSpace::P3_D65);
+
+    ASSERT_EQ(4, working.channels);
+    ASSERT_EQ(4, output.channels);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            ASSERT_EQ(input.GetPixel(x, y)[3], working.GetPixel(x, y)[3]);
+            ASSERT_EQ(input.GetPixel(x, y)[3], output.GetPixel(x, y)[3]);
+        }
+    }
+    return true;
+}
+
 TEST(ColorSpace_ValidColorSpaces) {
     ASSERT_TRUE(ColorSpaceConverter::IsValidColorSpace(ColorSpace::BT2020_PQ));
     ASSERT_TRUE(ColorSpaceConverter::IsValidColorSpace(ColorSpace::P3_D65));
@@ -0,0 +1,143 @@
+#include "test_framework.h"
+#include "test_frames.h"
+#include "cinema_pro_hdr/cpu_dispatch.h"
+#include "cinema_pro_hdr/pipeline.h"
+#include "cinema_pro_hdr/scanline.h"
+#include "cinema_pro_hdr/recursive_gaussian.h"
+#include "cinema_pro_hdr/color_space.h"
+
+using namespace CinemaProHDR;
+
+namespace {
+
+struct DispatchResult {
+    Image frame;
+    Statistics::PQStats stats;
+    Image streamed;
+    std::vector<float> blurred;
+    std::vector<float> decoded;
+};
+
+class FrameRowSource : public ScanlineSource {
+public:
+    explicit FrameRowSource(const Image& image) : image_(image) {}
+    bool ReadRow(int y, float* row) override {
+        const size_t size = static_cast<size_t>(image_.width) * image_.channels;
+        std::copy(image_.data.begin() + y * size, image_.data.begin() + (y + 1) * size, row);
+        return true;
+    }
+private:
+    const Image& image_;
+};
+
+class FrameRowSink : public ScanlineSink {
+public:
+    explicit FrameRowSink(Image& image) : image_(image) {}
+    bool WriteRow(int y, const float* row) override {
+        const size_t size = static_cast<size_t>(image_.width) * image_.channels;
+        std::copy(row, row + size, image_.data.begin() + y * size);
+        return true;
+    }
+private:
+    Image& image_;
+};
+
+bool RunDispatchedKernels(const std::shared_ptr<const CompiledPipeline>& pipeline, const Image& input,
+                          DispatchResult& result) {
+    StreamState state;
+    if (!pipeline->ProcessFrame(input, result.frame, state)) {
+        return false;
+    }
+    result.stats = state.stats.pq_stats;
+
+    ScanlineStream stream(pipeline);
+    ScanlineFormat format;
+    format.width = input.width;
+    format.height = input.height;
+    format.color_space = input.color_space;
+    result.streamed = Image(input.width, input.height, 3);
+    FrameRowSource source(input);
+    FrameRowSink sink(result.streamed);
+    StreamState stream_state;
+    if (!stream.ProcessFrame(format, source, sink, stream_state)) {
+        return false;
+    }
+
+    RecursiveGaussian gaussian(3.0f);
+    ImageBuffer scratch;
+    std::vector<float> plane(result.frame.data.begin(), result.frame.data.begin() + input.width * input.height);
+    result.blurred.resize(plane.size());
+    gaussian.BlurPlane(plane.data(), result.blurred.data(), input.width, input.height, scratch);
+
+    std::vector<uint16_t> codes(1031);
+    for (size_t i = 0; i < codes.size(); ++i) {
+        codes[i] = static_cast<uint16_t>((i * 37) % 1100);  // 含超出10位范围的码值
+    }
+    result.decoded.resize(codes.size());
+    ColorSpaceConverter::PQ_EOTF_Codes(codes.data(), 1, result.decoded.data(), codes.size(), 10);
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief 测试层级名称解析与强制层级的钳制
+ */
+TEST(CpuDispatch_TierSelection) {
+    CpuTier tier;
+    ASSERT_TRUE(CpuDispatch::ParseTier("AVX2", tier));
+    ASSERT_TRUE(tier == CpuTier::AVX2);
+    ASSERT_TRUE(CpuDispatch::ParseTier("sse4.2", tier));
+    ASSERT_TRUE(tier == CpuTier::SSE42);
+    ASSERT_TRUE(CpuDispatch::ParseTier(CpuDispatch::TierToString(CpuTier::AVX512), tier));
+    ASSERT_TRUE(tier == CpuTier::AVX512);
+    ASSERT_FALSE(CpuDispatch::ParseTier("neon", tier));
+
+    // 不能强制硬件不支持的层级
+    const CpuTier hardware = CpuDispatch::GetHardwareTier();
+    ASSERT_TRUE(CpuDispatch::SetActiveTier(CpuTier::AVX512) == hardware);
+    ASSERT_TRUE(CpuDispatch::GetActiveTier() == hardware);
+    ASSERT_TRUE(CpuDispatch::SetActiveTier(CpuTier::BASELINE) == CpuTier::BASELINE);
+    ASSERT_TRUE(CpuDispatch::GetActiveTier() == CpuTier::BASELINE);
+    CpuDispatch::ResetActiveTier();
+
+    return true;
+}
+
+/**
+ * @brief 测试各层级的内核结果逐位一致（整帧、扫描线、递归高斯、PQ查表、统计）
+ */
+TEST(CpuDispatch_TiersBitExact) {
+    CphParams params;
+    params.highlight_detail = 0.7f;
+    params.sat_base = 1.15f;
+    std::vector<ErrorReport> errors;
+    std::shared_ptr<const CompiledPipeline> pipeline = CompiledPipeline::Compile(params, errors);
+    ASSERT_TRUE(pipeline != nullptr);
+
+    // 宽度取非向量宽度整数倍，覆盖各层级的尾部循环
+    Image input = TestFrames::MakeFrame({53, 19});
+    input.color_space = ColorSpace::P3_D65;
+
+    CpuDispatch::SetActiveTier(CpuTier::BASELINE);
+    DispatchResult reference;
+    ASSERT_TRUE(RunDispatchedKernels(pipeline, input, reference));
+
+    const CpuTier tiers[] = {CpuTier::SSE42, CpuTier::AVX2, CpuTier::AVX512};
+    for (CpuTier tier : tiers) {
+        if (CpuDispatch::SetActiveTier(tier) != tier) {
+            continue;
+        }
+        DispatchResult result;
+        ASSERT_TRUE(RunDispatchedKernels(pipeline, input, result));
+        ASSERT_TRUE(result.frame.data == reference.frame.data);
+        ASSERT_TRUE(result.streamed.data == reference.streamed.data);
+        ASSERT_TRUE(result.blurred == reference.blurred);
+        ASSERT_TRUE(result.decoded == reference.decoded);
+        ASSERT_EQ(reference.stats.avg_pq, result.stats.avg_pq);
+        ASSERT_EQ(reference.stats.variance, result.stats.variance);
+    }
+    CpuDispatch::ResetActiveTier();
+
+    return true;
+}
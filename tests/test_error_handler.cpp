@@ -1,9 +1,12 @@
 #include "cinema_pro_hdr/error_handler.h"
 #include "test_framework.h"
+#include <atomic>
 #include <thread>
 #include <chrono>
 #include <cmath>
 #include <limits>
+#include <string>
+#include <vector>
 
 using namespace CinemaProHDR;
 using namespace TestFramework;
@@ -156,6 +159,48 @@ TEST(LogThrottler_IndependentCounting) {
     return true;
 }
 
+/**
+ * @brief 测试日志节流器 - 并发调用不超限，聚合报告计数完整
+ */
+TEST(LogThrottler_ConcurrentLimit) {
+    LogThrottler throttler;
+    const int thread_count = 8;
+    const int events = 5000;
+    std::atomic<int> accepted{0};
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < events; ++i) {
+                if (throttler.ShouldLog(ErrorCode::NAN_INF)) {
+                    accepted++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start);
+
+    // 每个（可能跨越的）1秒窗口最多10条
+    ASSERT_TRUE(accepted.load() >= 1);
+    ASSERT_TRUE(accepted.load() <= 10 * (static_cast<int>(elapsed.count()) + 2));
+
+    const int throttled = thread_count * events - accepted.load();
+    std::string report = throttler.GetAggregateReport(ErrorCode::NAN_INF);
+    ASSERT_TRUE(report.find("被节流 " + std::to_string(throttled) + " 次") != std::string::npos);
+    ASSERT_TRUE(throttler.GetAggregateReport(ErrorCode::RANGE_PIVOT).empty());
+
+    // 重置后立即恢复名额
+    throttler.Reset();
+    ASSERT_TRUE(throttler.GetAggregateReport(ErrorCode::NAN_INF).empty());
+    ASSERT_TRUE(throttler.ShouldLog(ErrorCode::NAN_INF));
+
+    return true;
+}
+
 /**
  * @brief 测试错误处理器 - 回退策略
  */
@@ -206,6 +251,29 @@ TEST(ErrorHandler_ParameterValidation) {
     return true;
 }
 
+/**
+ * @brief 测试错误处理器 - 修正覆盖 ParamRanges 中的每个字段
+ */
+TEST(ErrorHandler_CorrectsEveryParamRange) {
+    ErrorHandler handler;
+    CphParams params;
+    
+    auto for_each_range = [](const auto& visit) {
+        for (const ParamRange& range : ParamRanges::PPR) visit(range);
+        for (const ParamRange& range : ParamRanges::RLOG) visit(range);
+        for (const ParamRange& range : ParamRanges::COMMON) visit(range);
+    };
+    for_each_range([&params](const ParamRange& range) { params.*range.field = range.max_value + 100.0f; });
+    
+    ASSERT_TRUE(handler.ValidateAndCorrectParams(params));
+    bool all_in_range = true;
+    for_each_range([&](const ParamRange& range) { all_in_range &= range.Contains(params.*range.field); });
+    ASSERT_TRUE(all_in_range);
+    ASSERT_FALSE(handler.ValidateAndCorrectParams(params));
+    
+    return true;
+}
+
 /**
  * @brief 测试错误处理器 - NaN/Inf处理
  */
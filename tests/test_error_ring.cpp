@@ -0,0 +1,173 @@
+#include "test_framework.h"
+#include "cinema_pro_hdr/error_ring.h"
+#include "cinema_pro_hdr/processor.h"
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CinemaProHDR;
+
+/**
+ * @brief 测试环的顺序、满时丢弃与槽位复用
+ */
+TEST(ErrorRing_OrderAndOverflow) {
+    ErrorRing ring;
+    ErrorEvent event;
+    for (size_t i = 0; i < ErrorRing::kCapacity + 10; ++i) {
+        event.frame_index = static_cast<int64_t>(i);
+        ring.Push(event);
+    }
+    ASSERT_EQ(10u, ring.GetDroppedCount());
+
+    int64_t expected = 0;
+    bool ordered = true;
+    size_t drained = ring.Drain([&](const ErrorEvent& e) { ordered &= e.frame_index == expected++; });
+    ASSERT_EQ(ErrorRing::kCapacity, drained);
+    ASSERT_TRUE(ordered);
+
+    // 排空后槽位可再次写入
+    event.frame_index = 7;
+    ASSERT_TRUE(ring.Push(event));
+    ASSERT_EQ(1u, ring.Drain([&](const ErrorEvent& e) { ordered &= e.frame_index == 7; }));
+    ASSERT_TRUE(ordered);
+    ASSERT_EQ(0u, ring.Drain([](const ErrorEvent&) {}));
+    return true;
+}
+
+/**
+ * @brief 测试事件展开：字段名、截断的细节文本与帧号
+ */
+TEST(ErrorRing_EventMaterialization) {
+    ASSERT_TRUE(ErrorFieldFromName("sat_hi") == ErrorField::SAT_HI);
+    ASSERT_TRUE(ErrorFieldFromName("unknown") == ErrorField::NONE);
+    ASSERT_EQ(std::string("toe"), std::string(ErrorFieldName(ErrorField::TOE)));
+
+    ErrorEventLog log;
+    log.Record(ErrorCode::RANGE_PIVOT, "Invalid parameter", "Parameter out of range", ErrorField::PIVOT_PQ, 0.4f);
+    log.Record(ErrorCode::NAN_INF, "Processing exception", std::string(200, 'x'), ErrorField::NONE, 0.0f, 42);
+
+    std::vector<ErrorReport> history = log.GetHistory();
+    ASSERT_EQ(2u, history.size());
+    ASSERT_TRUE(history[0].message == "Invalid parameter: Parameter out of range");
+    ASSERT_TRUE(history[0].field_name == "pivot_pq");
+    ASSERT_NEAR(0.4f, history[0].invalid_value, 1e-6f);
+    ASSERT_EQ(std::string("Processing exception: ").size() + ErrorEvent::kDetailLength, history[1].message.size());
+    ASSERT_EQ(42, history[1].frame_index);
+    ASSERT_TRUE(log.GetLastError().find("frame=42") != std::string::npos);
+
+    // 读取不消费历史
+    ASSERT_EQ(2u, log.GetHistory().size());
+    log.Clear();
+    ASSERT_TRUE(log.GetHistory().empty());
+    ASSERT_TRUE(log.GetLastError().empty());
+    ASSERT_EQ(0u, log.GetCounters().recorded);
+
+    // 截断不拆开多字节字符：前缀"x"后第63字节落在第21个汉字中间，退回后保留20个完整汉字
+    std::string chinese;
+    for (int i = 0; i < 30; ++i) {
+        chinese += "参";
+    }
+    log.Record(ErrorCode::NAN_INF, "Processing exception", "x" + chinese);
+    history = log.GetHistory();
+    ASSERT_EQ(1u, history.size());
+    ASSERT_TRUE(history.back().message == "Processing exception: x" + chinese.substr(0, 20 * 3));
+    return true;
+}
+
+/**
+ * @brief 测试多线程并发记录：历史有界，每个事件要么保留、要么计入丢弃/挤出
+ */
+TEST(ErrorRing_ConcurrentProducersBounded) {
+    ErrorEventLog log;
+    const int kThreads = 8;
+    const int kEventsPerThread = 5000;
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kThreads; ++t) {
+        producers.emplace_back([&log, t]() {
+            for (int i = 0; i < kEventsPerThread; ++i) {
+                log.Record(ErrorCode::NAN_INF, "Invalid input image", {}, ErrorField::NONE, 0.0f, t);
+            }
+        });
+    }
+    // 生产期间并发读取
+    size_t max_size = 0;
+    for (int i = 0; i < 50; ++i) {
+        max_size = std::max(max_size, log.GetHistory().size());
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    std::vector<ErrorReport> history = log.GetHistory();
+    ErrorEventCounters counters = log.GetCounters();
+    ASSERT_TRUE(max_size <= ErrorEventLog::kCapacity);
+    ASSERT_EQ(ErrorEventLog::kCapacity, history.size());
+    ASSERT_EQ(static_cast<uint64_t>(kThreads * kEventsPerThread), counters.recorded + counters.dropped);
+    ASSERT_EQ(counters.recorded, counters.evicted + history.size());
+    return true;
+}
+
+/**
+ * @brief 测试环满且从未读取时，最近错误仍随每次记录更新
+ */
+TEST(ErrorRing_LastErrorCurrentWhenRingFull) {
+    ErrorEventLog log;
+    const int64_t kEvents = 3 * static_cast<int64_t>(ErrorEventLog::kCapacity);
+    for (int64_t frame = 0; frame < kEvents; ++frame) {
+        log.Record(ErrorCode::NAN_INF, "Invalid input image", {}, ErrorField::NONE, 0.0f, frame);
+    }
+    const std::string expected = "frame=" + std::to_string(kEvents - 1);
+    ASSERT_TRUE(log.GetLastError().find(expected) != std::string::npos);
+
+    // 只计入成功入环的事件
+    ErrorEventCounters counters = log.GetCounters();
+    ASSERT_EQ(ErrorEventLog::kCapacity, counters.recorded);
+    ASSERT_EQ(static_cast<uint64_t>(kEvents) - ErrorEventLog::kCapacity, counters.dropped);
+    ASSERT_EQ(0u, counters.evicted);
+
+    // 排空后新事件照常入环
+    log.Record(ErrorCode::NAN_INF, "Invalid input image", "late", ErrorField::NONE, 0.0f, kEvents);
+    ASSERT_TRUE(log.GetLastError().find("late") != std::string::npos);
+    ASSERT_EQ(kEvents, log.GetHistory().back().frame_index);
+    log.Clear();
+    ASSERT_TRUE(log.GetLastError().empty());
+    return true;
+}
+
+/**
+ * @brief 测试处理器逐帧报错时历史有界，参数错误保留字段信息
+ */
+TEST(ErrorRing_ProcessorHistoryBounded) {
+    CphProcessor processor;
+    CphParams params;
+    params.pivot_pq = 0.5f;
+    ASSERT_FALSE(processor.Initialize(params));
+    std::vector<ErrorReport> history = processor.GetErrorHistory();
+    ASSERT_EQ(1u, history.size());
+    ASSERT_TRUE(history[0].field_name == "pivot_pq");
+    ASSERT_TRUE(history[0].code == ErrorCode::RANGE_PIVOT);
+
+    params.pivot_pq = 0.18f;
+    ASSERT_TRUE(processor.Initialize(params));
+    Image invalid;
+    Image output;
+    for (uint64_t frame = 0; frame < 3 * ErrorEventLog::kCapacity; ++frame) {
+        ASSERT_FALSE(processor.ProcessFrame(invalid, output, frame));
+        if (frame % 64 == 0) {
+            processor.GetErrorHistory();
+        }
+    }
+
+    history = processor.GetErrorHistory();
+    ASSERT_EQ(ErrorEventLog::kCapacity, history.size());
+    ASSERT_EQ(static_cast<int64_t>(3 * ErrorEventLog::kCapacity - 1), history.back().frame_index);
+    ErrorEventCounters counters = processor.GetErrorCounters();
+    ASSERT_EQ(3 * ErrorEventLog::kCapacity + 1, counters.recorded);
+    ASSERT_TRUE(counters.evicted > 0);
+
+    processor.ClearErrors();
+    ASSERT_TRUE(processor.GetLastError().empty());
+    return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "cinema_pro_hdr/core.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+// Shared synthetic frames for processing tests
+namespace TestFrames {
+
+/**
+ * @brief 合成测试帧规格
+ *
+ * 背景为水平渐变（R）、2像素周期纹理（G）与正弦条纹（B），其上叠加高光：
+ * - frame_index < 0：静态周期光斑（覆盖掩码边界与USM邻域）
+ * - frame_index >= 0：12×12高光方块，每帧右移3像素（运动保护与片段测试）
+ * 额外通道（Alpha等）为随x缓变的值，用于检查原样保留。
+ */
+struct FrameSpec {
+    int width = 48;
+    int height = 32;
+    int channels = 3;
+    int frame_index = -1;
+};
+
+inline CinemaProHDR::Image MakeFrame(const FrameSpec& spec) {
+    CinemaProHDR::Image frame(spec.width, spec.height, spec.channels);
+    for (int y = 0; y < spec.height; ++y) {
+        for (int x = 0; x < spec.width; ++x) {
+            float* pixel = frame.GetPixel(x, y);
+            bool spot = spec.frame_index < 0 ?
+                (x / 5 + y / 3) % 4 == 0 :
+                std::abs(x - 8 - 3 * spec.frame_index) < 6 && std::abs(y - spec.height / 2) < 6;
+            float stripe = std::sin(0.3f * y);
+            pixel[0] = spot ? 0.95f : 0.2f + 0.6f * x / spec.width;
+            pixel[1] = spot ? 0.9f : 0.3f + 0.1f * ((x + y) % 4);
+            pixel[2] = spot ? 0.85f : 0.25f + 0.5f * stripe * stripe;
+            for (int c = 3; c < spec.channels; ++c) {
+                pixel[c] = 0.1f * c + 0.001f * x;
+            }
+        }
+    }
+    return frame;
+}
+
+/**
+ * @brief 连续count帧的高光平移片段（frame_index从0递增）
+ */
+inline std::vector<CinemaProHDR::Image> MakeClip(int count, FrameSpec spec = FrameSpec()) {
+    std::vector<CinemaProHDR::Image> frames;
+    frames.reserve(count);
+    for (int f = 0; f < count; ++f) {
+        spec.frame_index = f;
+        frames.push_back(MakeFrame(spec));
+    }
+    return frames;
+}
+
+} // namespace TestFrames
@@ -0,0 +1,137 @@
+#include "test_framework.h"
+#include "cinema_pro_hdr/half_float.h"
+#include "cinema_pro_hdr/processor.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+using namespace CinemaProHDR;
+
+/**
+ * @brief 测试标量转换的特征值与舍入规则
+ */
+TEST(Half_ScalarKnownValues) {
+    ASSERT_EQ(0x3c00, HalfFloat::FromFloat(1.0f));
+    ASSERT_EQ(0xc000, HalfFloat::FromFloat(-2.0f));
+    ASSERT_EQ(0x7bff, HalfFloat::FromFloat(65504.0f));
+    ASSERT_EQ(0x7c00, HalfFloat::FromFloat(65520.0f));          // 舍入溢出为Inf
+    ASSERT_EQ(0x7c00, HalfFloat::FromFloat(std::numeric_limits<float>::infinity()));
+    ASSERT_EQ(0x0001, HalfFloat::FromFloat(std::ldexp(1.0f, -24))); // 最小非规格化数
+    ASSERT_EQ(0x0000, HalfFloat::FromFloat(std::ldexp(1.0f, -25))); // 平局舍入到偶数
+    ASSERT_EQ(0x0001, HalfFloat::FromFloat(std::ldexp(1.5f, -25)));
+    ASSERT_EQ(0x3c00, HalfFloat::FromFloat(1.0f + std::ldexp(1.0f, -11)));        // 平局→偶数
+    ASSERT_EQ(0x3c02, HalfFloat::FromFloat(1.0f + 3.0f * std::ldexp(1.0f, -11))); // 平局→偶数
+    ASSERT_TRUE(std::isnan(HalfFloat::ToFloat(HalfFloat::FromFloat(std::nanf("")))));
+
+    ASSERT_EQ(1.0f, HalfFloat::ToFloat(0x3c00));
+    ASSERT_EQ(65504.0f, HalfFloat::ToFloat(0x7bff));
+    ASSERT_EQ(std::ldexp(1.0f, -24), HalfFloat::ToFloat(0x0001));
+    ASSERT_TRUE(std::isinf(HalfFloat::ToFloat(0xfc00)));
+
+    return true;
+}
+
+/**
+ * @brief 测试全部65536个半精度值的往返与批量路径一致性
+ */
+TEST(Half_ExhaustiveRoundTripAndBatch) {
+    std::vector<uint16_t> all(65536);
+    for (size_t i = 0; i < all.size(); ++i) all[i] = static_cast<uint16_t>(i);
+
+    std::vector<float> batch(all.size());
+    HalfFloat::HalfToFloat(all.data(), batch.data(), all.size());
+
+    std::vector<uint16_t> back(all.size());
+    HalfFloat::FloatToHalf(batch.data(), back.data(), batch.size());
+
+    for (size_t i = 0; i < all.size(); ++i) {
+        float scalar = HalfFloat::ToFloat(all[i]);
+        if (std::isnan(scalar)) {
+            ASSERT_TRUE(std::isnan(batch[i]));
+            ASSERT_EQ(0x7c00, back[i] & 0x7c00);
+            continue;
+        }
+        ASSERT_TRUE(std::memcmp(&scalar, &batch[i], sizeof(float)) == 0);
+        ASSERT_EQ(all[i], back[i]);
+    }
+
+    return true;
+}
+
+/**
+ * @brief 测试批量 float→half 与标量实现逐位一致（含舍入边界）
+ */
+TEST(Half_BatchMatchesScalar) {
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<uint32_t> bits_dist;
+    std::vector<float> values;
+    for (int i = 0; i < 20000; ++i) {
+        uint32_t bits = bits_dist(rng);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (!std::isnan(value)) values.push_back(value);
+    }
+    // 常用PQ区间内的值
+    for (int i = 0; i <= 4096; ++i) values.push_back(i / 4096.0f);
+
+    std::vector<uint16_t> batch(values.size());
+    HalfFloat::FloatToHalf(values.data(), batch.data(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(HalfFloat::FromFloat(values[i]), batch[i]);
+    }
+
+    return true;
+}
+
+/**
+ * @brief 测试半精度帧处理与FP32路径一致，Alpha位模式原样保留
+ */
+TEST(Half_ProcessFrameMatchesFloat) {
+    ImageHalf input(45, 27, 4);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    for (uint16_t& v : input.data) v = HalfFloat::FromFloat(dist(rng));
+    ASSERT_TRUE(input.IsValid());
+
+    Image input_float;
+    HalfFloat::ToImage(input, input_float);
+
+    const PixelLayout layouts[] = {PixelLayout::PLANAR, PixelLayout::INTERLEAVED};
+    for (PixelLayout layout : layouts) {
+        CphParams params;
+        CphProcessor reference;
+        ASSERT_TRUE(reference.Initialize(params));
+        reference.SetPreferredLayout(layout);
+        Image expected;
+        ASSERT_TRUE(reference.ProcessFrame(input_float, expected));
+
+        CphProcessor processor;
+        ASSERT_TRUE(processor.Initialize(params));
+        processor.SetPreferredLayout(layout);
+        ImageHalf output;
+        ASSERT_TRUE(processor.ProcessFrame(input, output));
+        ASSERT_EQ(4, output.channels);
+
+        for (int y = 0; y < input.height; ++y) {
+            for (int x = 0; x < input.width; ++x) {
+                const uint16_t* actual = output.GetPixel(x, y);
+                const float* wanted = expected.GetPixel(x, y);
+                for (int c = 0; c < 3; ++c) {
+                    ASSERT_EQ(HalfFloat::FromFloat(wanted[c]), actual[c]);
+                }
+                ASSERT_EQ(input.GetPixel(x, y)[3], actual[3]);
+            }
+        }
+    }
+
+    // 含Inf编码的输入被拒绝
+    ImageHalf invalid(4, 4, 3);
+    invalid.data[5] = 0x7c00;
+    CphProcessor processor;
+    ASSERT_TRUE(processor.Initialize(CphParams()));
+    ImageHalf output;
+    ASSERT_FALSE(processor.ProcessFrame(invalid, output));
+
+    return true;
+}
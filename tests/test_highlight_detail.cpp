@@ -626,4 +626,63 @@ TEST(HighlightDetail_MainProcessorIntegration) {
     ASSERT_TRUE(output_no_detail.IsValid());
     
     return true;
-}
\ No newline at end of file
+}
+/**
+ * @brief 测试LUMA细节域：只增强亮度，高光色相（通道比例）保持不变
+ */
+TEST(HighlightDetail_LumaDomainPreservesHue) {
+    CphParams params;
+    params.highlight_detail = 1.0f;
+    params.pivot_pq = 0.3f;
+    
+    HighlightDetailProcessor rgb_processor;
+    HighlightDetailProcessor luma_processor;
+    ASSERT_TRUE(rgb_processor.Initialize(params));
+    ASSERT_TRUE(luma_processor.Initialize(params));
+    ASSERT_TRUE(luma_processor.GetDetailDomain() == DetailDomain::RGB);
+    luma_processor.SetDetailDomain(DetailDomain::LUMA);
+    
+    // 带Alpha的彩色高光纹理
+    Image input(48, 32, 4);
+    for (int y = 0; y < input.height; ++y) {
+        for (int x = 0; x < input.width; ++x) {
+            float* pixel = input.GetPixel(x, y);
+            float level = 0.55f + 0.2f * std::sin(x * 0.9f) * std::cos(y * 0.7f);
+            pixel[0] = level;
+            pixel[1] = level * 0.6f;
+            pixel[2] = level * 0.3f;
+            pixel[3] = 0.25f;
+        }
+    }
+    
+    Image rgb_output;
+    Image luma_output;
+    ASSERT_TRUE(rgb_processor.ProcessFrame(input, rgb_output, params.pivot_pq));
+    ASSERT_TRUE(luma_processor.ProcessFrame(input, luma_output, params.pivot_pq));
+    ASSERT_EQ(input.channels, luma_output.channels);
+    
+    bool enhanced = false;
+    for (int y = 0; y < input.height; ++y) {
+        for (int x = 0; x < input.width; ++x) {
+            const float* src = input.GetPixel(x, y);
+            const float* out = luma_output.GetPixel(x, y);
+            ASSERT_NEAR(src[1] / src[0], out[1] / out[0], 1e-4f);
+            ASSERT_NEAR(src[2] / src[0], out[2] / out[0], 1e-4f);
+            ASSERT_NEAR(0.25f, out[3], 1e-6f);
+            enhanced |= std::abs(out[0] - src[0]) > 1e-3f;
+        }
+    }
+    ASSERT_TRUE(enhanced);
+    ASSERT_FALSE(rgb_output.data == luma_output.data);
+    
+    // 平面路径与交错路径一致
+    ImagePlanar planar;
+    ImagePlanar planar_output;
+    PlanarLayout::Deinterleave(input, planar);
+    ASSERT_TRUE(luma_processor.ProcessFramePlanar(planar, planar_output, params.pivot_pq));
+    Image interleaved;
+    PlanarLayout::Interleave(planar_output, interleaved, &input);
+    ASSERT_TRUE(interleaved.data == luma_output.data);
+    
+    return true;
+}
@@ -0,0 +1,177 @@
+#include "test_framework.h"
+#include "cinema_pro_hdr/image_planar.h"
+#include "cinema_pro_hdr/color_space.h"
+#include "cinema_pro_hdr/highlight_detail.h"
+#include <cstdint>
+#include <limits>
+#include <random>
+
+using namespace CinemaProHDR;
+
+namespace {
+
+Image MakeRandomImage(int width, int height, int channels, unsigned seed) {
+    Image image(width, height, channels);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    for (float& v : image.data) v = dist(rng);
+    return image;
+}
+
+} // namespace
+
+/**
+ * @brief 测试交错↔平面往返转换与额外通道保留
+ */
+TEST(Planar_RoundTripPreservesAlpha) {
+    Image input = MakeRandomImage(37, 23, 4, 11);
+
+    ImagePlanar planar;
+    PlanarLayout::Deinterleave(input, planar);
+    ASSERT_EQ(input.width, planar.width);
+    ASSERT_EQ(input.height, planar.height);
+    ASSERT_FALSE(planar.HasLuma());
+    for (int c = 0; c < 3; ++c) {
+        ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(planar.Plane(c)) % ImagePool::kAlignment);
+    }
+    ASSERT_EQ(input.GetPixel(5, 7)[1], planar.Plane(1)[7 * input.width + 5]);
+
+    Image output;
+    PlanarLayout::Interleave(planar, output, &input);
+    ASSERT_EQ(4, output.channels);
+    ASSERT_TRUE(output.data == input.data);
+
+    // 无额外通道来源时输出三通道
+    Image rgb_only;
+    PlanarLayout::Interleave(planar, rgb_only);
+    ASSERT_EQ(3, rgb_only.channels);
+    ASSERT_EQ(input.GetPixel(36, 22)[2], rgb_only.GetPixel(36, 22)[2]);
+
+    planar.ComputeLuma();
+    ASSERT_TRUE(planar.HasLuma());
+    const float* pixel = input.GetPixel(3, 4);
+    ASSERT_EQ(std::max(pixel[0], std::max(pixel[1], pixel[2])), planar.luma[4 * input.width + 3]);
+
+    return true;
+}
+
+/**
+ * @brief 测试 IsValid 只检查结构，数值检查由 HasFiniteSamples 单独完成
+ */
+TEST(Planar_StructuralValidity) {
+    ImagePlanar planar(8, 4);
+    ASSERT_TRUE(planar.IsValid());
+    ASSERT_TRUE(planar.HasFiniteSamples());
+
+    planar.Plane(1)[5] = std::numeric_limits<float>::quiet_NaN();
+    ASSERT_TRUE(planar.IsValid());
+    ASSERT_FALSE(planar.HasFiniteSamples());
+
+    planar.planes[2].resize(3);
+    ASSERT_FALSE(planar.IsValid());
+    ASSERT_FALSE(planar.HasFiniteSamples());
+    ASSERT_FALSE(ImagePlanar().IsValid());
+    return true;
+}
+
+/**
+ * @brief 测试平面工作域转换与逐像素转换一致
+ */
+TEST(Planar_WorkingDomainMatchesPerPixel) {
+    Image input = MakeRandomImage(19, 13, 3, 5);
+    for (float& v : input.data) v *= 1000.0f; // 线性光 cd/m²
+    input.data[4] = std::nanf("");
+
+    const ColorSpace spaces[] = {ColorSpace::P3_D65, ColorSpace::ACESG, ColorSpace::BT2020_PQ};
+    for (ColorSpace cs : spaces) {
+        input.color_space = cs;
+        Image reference = input;
+        ColorSpaceConverter::ToWorkingDomainInPlace(reference);
+
+        ImagePlanar planar;
+        PlanarLayout::Deinterleave(input, planar);
+        ColorSpaceConverter::ToWorkingPlanar(planar.Plane(0), planar.Plane(1), planar.Plane(2),
+                                             planar.GetPixelCount(), cs);
+        Image actual;
+        PlanarLayout::Interleave(planar, actual);
+        ASSERT_TRUE(actual.data == reference.data);
+
+        // 回到目标色彩空间
+        ColorSpaceConverter::FromWorkingDomainInPlace(reference, cs);
+        ColorSpaceConverter::FromWorkingPlanar(planar.Plane(0), planar.Plane(1), planar.Plane(2),
+                                               planar.GetPixelCount(), cs);
+        PlanarLayout::Interleave(planar, actual);
+        ASSERT_TRUE(actual.data == reference.data);
+    }
+
+    return true;
+}
+
+/**
+ * @brief 测试平面OKLab饱和度与逐像素路径一致（含DCI感知夹持）
+ */
+TEST(Planar_SaturationMatchesPerPixel) {
+    Image input = MakeRandomImage(41, 17, 3, 9);
+    const bool modes[] = {false, true};
+
+    for (bool dci : modes) {
+        Image reference = input;
+        for (int y = 0; y < reference.height; ++y) {
+            for (int x = 0; x < reference.width; ++x) {
+                float* pixel = reference.GetPixel(x, y);
+                float lum = std::clamp(std::max(pixel[0], std::max(pixel[1], pixel[2])), 0.0f, 1.0f);
+                ColorSpaceConverter::ApplySaturation(pixel, 1.4f, 0.8f, 0.18f, lum);
+                ColorSpaceConverter::ApplyGamutProcessing(pixel, ColorSpace::BT2020_PQ, dci);
+                NumericalUtils::SaturateRGB(pixel);
+            }
+        }
+
+        ImagePlanar planar;
+        PlanarLayout::Deinterleave(input, planar);
+        ColorSpaceConverter::ApplySaturationPlanar(planar.Plane(0), planar.Plane(1), planar.Plane(2),
+                                                   planar.GetPixelCount(), 1.4f, 0.8f, 0.18f, dci);
+        Image actual;
+        PlanarLayout::Interleave(planar, actual);
+
+        for (size_t i = 0; i < reference.data.size(); ++i) {
+            ASSERT_NEAR(reference.data[i], actual.data[i], 1e-6f);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief 测试平面USM与交错USM一致，且亮度平面可作为掩码来源
+ */
+TEST(Planar_USMMatchesInterleaved) {
+    CphParams params;
+    params.highlight_detail = 0.6f;
+    HighlightDetailProcessor processor;
+    ASSERT_TRUE(processor.Initialize(params));
+
+    Image input = MakeRandomImage(53, 29, 3, 21);
+    Image reference;
+    ASSERT_TRUE(processor.ProcessFrame(input, reference, params.pivot_pq));
+
+    ImagePlanar planar, planar_out;
+    PlanarLayout::Deinterleave(input, planar);
+    ASSERT_TRUE(processor.ProcessFramePlanar(planar, planar_out, params.pivot_pq));
+    Image actual;
+    PlanarLayout::Interleave(planar_out, actual);
+    for (size_t i = 0; i < reference.data.size(); ++i) {
+        ASSERT_NEAR(reference.data[i], actual.data[i], 1e-6f);
+    }
+
+    planar.ComputeLuma();
+    ASSERT_TRUE(processor.ProcessFramePlanar(planar, planar_out, params.pivot_pq));
+    PlanarLayout::Interleave(planar_out, actual);
+    for (size_t i = 0; i < reference.data.size(); ++i) {
+        ASSERT_NEAR(reference.data[i], actual.data[i], 1e-6f);
+    }
+
+    // 输入输出不能为同一对象
+    ASSERT_FALSE(processor.ProcessFramePlanar(planar, planar, params.pivot_pq));
+
+    return true;
+}
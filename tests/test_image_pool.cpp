@@ -0,0 +1,186 @@
+#include "test_framework.h"
+#include "cinema_pro_hdr/core.h"
+#include <cstdint>
+
+using namespace CinemaProHDR;
+
+/**
+ * @brief 测试尺寸分级：单调、不小于请求、浪费不超过25%
+ */
+TEST(ImagePool_SizeClass) {
+    ASSERT_EQ(ImagePool::kAlignment, ImagePool::SizeClass(1));
+    ASSERT_EQ(4096u, ImagePool::SizeClass(4096));
+    ASSERT_EQ(5120u, ImagePool::SizeClass(4097));
+
+    // 8K RGB float 按2MB粒度分级
+    size_t frame_8k = size_t(7680) * 4320 * 3 * sizeof(float);
+    size_t class_8k = ImagePool::SizeClass(frame_8k);
+    ASSERT_TRUE(class_8k >= frame_8k);
+    ASSERT_EQ(0u, class_8k % ImagePool::kHugePageSize);
+
+    size_t previous = 0;
+    for (size_t bytes = 1; bytes < (size_t(8) << 20); bytes = bytes * 3 / 2 + 7) {
+        size_t cls = ImagePool::SizeClass(bytes);
+        ASSERT_TRUE(cls >= bytes);
+        ASSERT_TRUE(cls >= previous);
+        ASSERT_EQ(0u, cls % ImagePool::kAlignment);
+        if (bytes >= ImagePool::kHugePageSize) {
+            ASSERT_TRUE(cls < bytes + ImagePool::kHugePageSize);
+        } else if (bytes > 256) {
+            ASSERT_TRUE(cls <= bytes + bytes / 4 + ImagePool::kAlignment);
+        }
+        previous = cls;
+    }
+
+    return true;
+}
+
+/**
+ * @brief 测试缓冲回收命中与对齐
+ */
+TEST(ImagePool_RecyclesAlignedBuffers) {
+    ImagePool& pool = ImagePool::Instance();
+    ImagePoolStats before = pool.GetStats();
+
+    const void* first_ptr = nullptr;
+    {
+        Image img(1237, 541, 3, ImageInit::UNINITIALIZED);
+        first_ptr = img.data.data();
+        ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(first_ptr) % ImagePool::kAlignment);
+    }
+
+    // 同尺寸再次申请应命中刚归还的块
+    Image again(1237, 541, 3, ImageInit::UNINITIALIZED);
+    ASSERT_TRUE(again.data.data() == first_ptr);
+
+    ImagePoolStats after = pool.GetStats();
+    ASSERT_TRUE(after.hits >= before.hits + 1);
+    ASSERT_TRUE(after.releases >= before.releases + 1);
+    ASSERT_TRUE(after.HitRate() > 0.0);
+
+    return true;
+}
+
+/**
+ * @brief 测试未初始化构造与默认清零构造
+ */
+TEST(ImagePool_ImageInitPolicies) {
+    {
+        // 弄脏一个块，归还后被复用
+        Image dirty(64, 32, 3, ImageInit::UNINITIALIZED);
+        for (float& v : dirty.data) v = 0.75f;
+    }
+
+    Image zeroed(64, 32, 3);
+    ASSERT_EQ(size_t(64 * 32 * 3), zeroed.data.size());
+    for (float v : zeroed.data) {
+        ASSERT_EQ(0.0f, v);
+    }
+
+    Image raw(64, 32, 3, ImageInit::UNINITIALIZED);
+    ASSERT_EQ(size_t(64 * 32 * 3), raw.data.size());
+    ASSERT_EQ(64, raw.width);
+
+    // 拷贝与移动保持内容
+    raw.Clear();
+    raw.GetPixel(3, 4)[1] = 0.5f;
+    Image copy = raw;
+    ASSERT_EQ(0.5f, copy.GetPixel(3, 4)[1]);
+    Image moved = std::move(copy);
+    ASSERT_EQ(0.5f, moved.GetPixel(3, 4)[1]);
+
+    return true;
+}
+
+/**
+ * @brief 测试缓存上限与清空
+ */
+TEST(ImagePool_CacheLimitAndTrim) {
+    ImagePool& pool = ImagePool::Instance();
+    size_t saved_limit = pool.GetMaxCachedBytes();
+
+    pool.Trim();
+    ASSERT_EQ(0u, pool.GetStats().cached_bytes);
+
+    pool.SetMaxCachedBytes(0);
+    ImagePoolStats before = pool.GetStats();
+    {
+        Image img(256, 256, 3, ImageInit::UNINITIALIZED);
+    }
+    ImagePoolStats after = pool.GetStats();
+    ASSERT_EQ(before.evictions + 1, after.evictions);
+    ASSERT_EQ(0u, after.cached_bytes);
+
+    pool.SetMaxCachedBytes(saved_limit);
+    {
+        Image img(256, 256, 3, ImageInit::UNINITIALIZED);
+    }
+    ASSERT_TRUE(pool.GetStats().cached_bytes >= ImagePool::SizeClass(256 * 256 * 3 * sizeof(float)));
+
+    pool.Trim();
+    ASSERT_EQ(0u, pool.GetStats().cached_bytes);
+
+    return true;
+}
+
+/**
+ * @brief 测试默认自适应上限：8K帧缓冲归还后再次申请命中缓存
+ */
+TEST(ImagePool_Adaptive8KReuse) {
+    ImagePool& pool = ImagePool::Instance();
+    ASSERT_EQ(ImagePool::kAdaptiveCacheLimit, pool.GetMaxCachedBytes());
+    pool.Trim();
+
+    const size_t frame_8k = size_t(7680) * 4320 * 3 * sizeof(float);
+    const void* first_ptr = nullptr;
+    {
+        Image img(7680, 4320, 3, ImageInit::UNINITIALIZED);
+        first_ptr = img.data.data();
+    }
+    ImagePoolStats released = pool.GetStats();
+    ASSERT_TRUE(released.cache_limit_bytes >= 2 * ImagePool::SizeClass(frame_8k));
+    ASSERT_EQ(ImagePool::SizeClass(frame_8k), released.cached_bytes);
+
+    Image again(7680, 4320, 3, ImageInit::UNINITIALIZED);
+    ASSERT_TRUE(again.data.data() == first_ptr);
+    ASSERT_EQ(released.hits + 1, pool.GetStats().hits);
+
+    again = Image();
+    pool.Trim();
+    return true;
+}
+
+/**
+ * @brief 测试超出上限时淘汰最久未用的空闲块，保留刚归还的块
+ */
+TEST(ImagePool_EvictsLeastRecentlyUsed) {
+    ImagePool& pool = ImagePool::Instance();
+    const size_t saved_limit = pool.GetMaxCachedBytes();
+    pool.Trim();
+
+    const size_t block = ImagePool::kHugePageSize;
+    pool.SetMaxCachedBytes(3 * block);
+    void* oldest = pool.Acquire(block);
+    void* middle = pool.Acquire(2 * block);
+    void* newest = pool.Acquire(block);
+    pool.Release(oldest, block);
+    pool.Release(middle, 2 * block);
+    ImagePoolStats before = pool.GetStats();
+
+    // 缓存已满：归还 newest 时淘汰最久未用的 oldest
+    pool.Release(newest, block);
+    ImagePoolStats after = pool.GetStats();
+    ASSERT_EQ(before.evictions + 1, after.evictions);
+    ASSERT_EQ(3 * block, after.cached_bytes);
+    ASSERT_TRUE(pool.Acquire(block) == newest);
+    pool.Release(newest, block);
+
+    // 单块超过上限时直接释放
+    void* huge = pool.Acquire(4 * block);
+    pool.Release(huge, 4 * block);
+    ASSERT_EQ(3 * block, pool.GetStats().cached_bytes);
+
+    pool.SetMaxCachedBytes(saved_limit);
+    pool.Trim();
+    return true;
+}
@@ -0,0 +1,222 @@
+#include "test_framework.h"
+#include "cinema_pro_hdr/log_sink.h"
+#include "cinema_pro_hdr/error_handler.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CinemaProHDR;
+
+namespace {
+
+// 收集写出的行；可选每行延迟以模拟慢磁盘
+class CaptureLogOutput : public LogOutput {
+public:
+    explicit CaptureLogOutput(std::chrono::milliseconds delay = std::chrono::milliseconds(0)) : delay_(delay) {}
+
+    bool Write(std::string_view line) override {
+        if (delay_.count() > 0) {
+            std::this_thread::sleep_for(delay_);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        lines_.emplace_back(line);
+        return true;
+    }
+
+    std::vector<std::string> GetLines() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lines_;
+    }
+
+private:
+    std::chrono::milliseconds delay_;
+    std::mutex mutex_;
+    std::vector<std::string> lines_;
+};
+
+std::string ReadFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream oss;
+    oss << file.rdbuf();
+    return oss.str();
+}
+
+bool FileExists(const std::string& path) {
+    return std::ifstream(path).good();
+}
+
+} // namespace
+
+/**
+ * @brief 测试行格式：TEXT 与 ToString 一致，JSON 转义并包含全部字段
+ */
+TEST(LogSink_FormatLine) {
+    ErrorReport report(ErrorCode::RANGE_PIVOT, "bad \"pivot\"");
+    report.clip_guid = "clip-1";
+    report.timecode = "01:00:00:00";
+    report.field_name = "pivot_pq";
+    report.invalid_value = 0.5f;
+    report.action_taken = "PARAM_CORRECT";
+    report.frame_index = 12;
+
+    ASSERT_TRUE(FormatLogLine(report, LogFormat::TEXT) == report.ToString());
+    ASSERT_TRUE(report.ToString().find("[WARN][clip-1][01:00:00:00] code=") != std::string::npos);
+
+    std::string json = FormatLogLine(report, LogFormat::JSON);
+    ASSERT_TRUE(json.rfind("{\"ts\": \"", 0) == 0);
+    ASSERT_TRUE(json.find("\"level\": \"WARN\"") != std::string::npos);
+    ASSERT_TRUE(json.find("\"clip_guid\": \"clip-1\"") != std::string::npos);
+    ASSERT_TRUE(json.find("\"tc\": \"01:00:00:00\"") != std::string::npos);
+    ASSERT_TRUE(json.find("\"frame\": 12") != std::string::npos);
+    ASSERT_TRUE(json.find("\"field\": \"pivot_pq\", \"val\": 0.5") != std::string::npos);
+    ASSERT_TRUE(json.find("\"msg\": \"bad \\\"pivot\\\"\"}") != std::string::npos);
+    ASSERT_TRUE(json.find('\n') == std::string::npos);
+    return true;
+}
+
+/**
+ * @brief 测试多线程投递后 Flush 等到全部写出
+ */
+TEST(LogSink_ConcurrentSubmitAndFlush) {
+    auto output = std::make_unique<CaptureLogOutput>();
+    CaptureLogOutput* capture = output.get();
+    AsyncLogSink sink(std::move(output));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&sink, t]() {
+            for (int i = 0; i < 50; ++i) {
+                sink.SubmitLine("thread " + std::to_string(t) + " line " + std::to_string(i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_TRUE(sink.Flush(std::chrono::seconds(5)));
+    ASSERT_EQ(200u, capture->GetLines().size());
+    ASSERT_EQ(200u, sink.GetWrittenCount());
+    ASSERT_EQ(0u, sink.GetDroppedCount());
+    return true;
+}
+
+/**
+ * @brief 测试慢输出端不阻塞投递方，队列满时丢弃，关闭在期限内完成
+ */
+TEST(LogSink_SlowOutputNeverBlocks) {
+    AsyncLogSink::Config config;
+    config.shutdown_timeout = std::chrono::milliseconds(50);
+    AsyncLogSink sink(std::make_unique<CaptureLogOutput>(std::chrono::milliseconds(5)), config);
+
+    // 同步写出需要约 10 秒
+    const size_t total = 2 * AsyncLogSink::kQueueCapacity;
+    auto start = std::chrono::steady_clock::now();
+    size_t accepted = 0;
+    for (size_t i = 0; i < total; ++i) {
+        accepted += sink.Submit(ErrorReport(ErrorCode::NAN_INF, "flood")) ? 1 : 0;
+    }
+    auto submit_time = std::chrono::steady_clock::now() - start;
+    ASSERT_TRUE(submit_time < std::chrono::seconds(1));
+    ASSERT_TRUE(accepted < total);
+
+    start = std::chrono::steady_clock::now();
+    sink.Shutdown();
+    auto shutdown_time = std::chrono::steady_clock::now() - start;
+    ASSERT_TRUE(shutdown_time < std::chrono::seconds(2));
+    ASSERT_EQ(total, sink.GetWrittenCount() + sink.GetDroppedCount());
+    ASSERT_FALSE(sink.SubmitLine("after shutdown"));
+    return true;
+}
+
+/**
+ * @brief 测试文件输出与关闭时写完剩余记录
+ */
+TEST(LogSink_FileOutputFlushesOnShutdown) {
+    const std::string path = "cph_test_log_sink.log";
+    std::remove(path.c_str());
+    {
+        AsyncLogSink::Config config;
+        config.format = LogFormat::JSON;
+        AsyncLogSink sink(std::make_unique<FileLogOutput>(path), config);
+        for (int i = 0; i < 20; ++i) {
+            ErrorReport report(ErrorCode::DCI_BOUND, "out of bound");
+            report.frame_index = i;
+            sink.Submit(report);
+        }
+    }
+    std::string text = ReadFile(path);
+    std::remove(path.c_str());
+    ASSERT_EQ(20, std::count(text.begin(), text.end(), '\n'));
+    ASSERT_TRUE(text.find("\"frame\": 19") != std::string::npos);
+    return true;
+}
+
+/**
+ * @brief 测试按大小滚动：path.1、path.2 保留，更旧的被删除
+ */
+TEST(LogSink_RotatingFile) {
+    const std::string path = "cph_test_log_rotate.log";
+    auto cleanup = [&]() {
+        for (const char* suffix : {"", ".1", ".2", ".3"}) {
+            std::remove((path + suffix).c_str());
+        }
+    };
+    cleanup();
+
+    AsyncLogSink sink(std::make_unique<RotatingFileLogOutput>(path, 100, 2));
+    const std::string line(39, 'x');  // 含换行 40 字节，每个文件 2 行
+    for (int i = 0; i < 10; ++i) {
+        sink.SubmitLine(line);
+    }
+    ASSERT_TRUE(sink.Flush(std::chrono::seconds(5)));
+
+    const bool current = FileExists(path);
+    const bool first = FileExists(path + ".1");
+    const bool second = FileExists(path + ".2");
+    const bool third = FileExists(path + ".3");
+    const std::string current_text = ReadFile(path);
+    sink.Shutdown();
+    cleanup();
+
+    ASSERT_TRUE(current && first && second);
+    ASSERT_FALSE(third);
+    ASSERT_EQ(80u, current_text.size());
+    return true;
+}
+
+/**
+ * @brief 测试 ErrorHandler 经日志汇输出，回调在锁外执行（可重入）
+ */
+TEST(LogSink_ErrorHandlerIntegration) {
+    auto output = std::make_unique<CaptureLogOutput>();
+    CaptureLogOutput* capture = output.get();
+    auto sink = std::make_shared<AsyncLogSink>(std::move(output));
+
+    ErrorHandler handler;
+    handler.SetLogSink(sink);
+    int calls = 0;
+    ErrorCode seen = ErrorCode::SUCCESS;
+    // 一次性回调：在回调内注销自身，持锁调用时会死锁
+    handler.SetErrorCallback([&](const ErrorReport& report) {
+        calls++;
+        seen = report.code;
+        handler.SetErrorCallback(nullptr);
+    });
+
+    handler.HandleError(ErrorCode::GAMUT_OOG, "gamut", "", 0.0f, "clip-9", "01:00:00:01");
+    handler.HandleError(ErrorCode::GAMUT_OOG, "gamut again");
+    ASSERT_EQ(1, calls);
+    ASSERT_TRUE(seen == ErrorCode::GAMUT_OOG);
+
+    ASSERT_TRUE(sink->Flush(std::chrono::seconds(5)));
+    std::vector<std::string> lines = capture->GetLines();
+    ASSERT_EQ(2u, lines.size());
+    ASSERT_TRUE(lines[0].find("[ERROR][clip-9][01:00:00:01] code=") != std::string::npos);
+    ASSERT_TRUE(lines[0].find("action=FALLBACK2094") != std::string::npos);
+    return true;
+}
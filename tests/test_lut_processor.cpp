@@ -0,0 +1,308 @@
+#include "test_framework.h"
+#include "cinema_pro_hdr/lut_processor.h"
+#include "cinema_pro_hdr/processor.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+using namespace CinemaProHDR;
+
+namespace {
+
+// 生成指定尺寸的恒等3D LUT文本
+std::string MakeIdentityCube(int size) {
+    std::ostringstream oss;
+    oss << "TITLE \"identity\"\n";
+    oss << "# 测试用恒等LUT\n";
+    oss << "LUT_3D_SIZE " << size << "\n";
+    for (int b = 0; b < size; ++b) {
+        for (int g = 0; g < size; ++g) {
+            for (int r = 0; r < size; ++r) {
+                oss << r / float(size - 1) << " " << g / float(size - 1) << " " << b / float(size - 1) << "\n";
+            }
+        }
+    }
+    return oss.str();
+}
+
+// 用完整管线在格点上求值，烘焙为3D LUT（R变化最快）
+bool BakeFromProcessor(const CphParams& params, int size, CubeLUT& lut) {
+    CphProcessor processor;
+    if (!processor.Initialize(params)) return false;
+
+    Image lattice(size * size, size, 3);
+    lattice.color_space = ColorSpace::BT2020_PQ;
+    for (int b = 0; b < size; ++b) {
+        for (int g = 0; g < size; ++g) {
+            for (int r = 0; r < size; ++r) {
+                float* pixel = lattice.GetPixel(g * size + r, b);
+                pixel[0] = r / float(size - 1);
+                pixel[1] = g / float(size - 1);
+                pixel[2] = b / float(size - 1);
+            }
+        }
+    }
+
+    Image baked;
+    if (!processor.ProcessFrame(lattice, baked)) return false;
+
+    lut = CubeLUT();
+    lut.size_3d = size;
+    lut.table_3d.assign(baked.data.begin(), baked.data.end());
+    return lut.IsValid();
+}
+
+// 三套预设（需求文档“预设快照”）；LUT无法表达空间算子，高光细节置0
+std::vector<CphParams> GoldenPresets() {
+    CphParams flat;
+    flat.pivot_pq = 0.18f; flat.gamma_s = 1.10f; flat.gamma_h = 1.05f; flat.shoulder_h = 1.0f;
+    flat.black_lift = 0.003f; flat.sat_base = 1.00f; flat.sat_hi = 0.95f;
+
+    CphParams punch;
+    punch.pivot_pq = 0.18f; punch.gamma_s = 1.40f; punch.gamma_h = 1.10f; punch.shoulder_h = 1.8f;
+    punch.black_lift = 0.002f; punch.sat_base = 1.05f; punch.sat_hi = 1.00f;
+
+    CphParams highlight;
+    highlight.pivot_pq = 0.20f; highlight.gamma_s = 1.20f; highlight.gamma_h = 0.95f; highlight.shoulder_h = 1.2f;
+    highlight.black_lift = 0.004f; highlight.sat_base = 0.98f; highlight.sat_hi = 0.92f;
+
+    std::vector<CphParams> presets = {flat, punch, highlight};
+    for (auto& preset : presets) {
+        preset.highlight_detail = 0.0f;
+    }
+    return presets;
+}
+
+} // namespace
+
+/**
+ * @brief 测试.cube解析与恒等LUT
+ */
+TEST(Lut_ParseIdentityCube) {
+    CubeLUT lut;
+    std::string error;
+    ASSERT_TRUE(CubeLUTIO::ParseCube(MakeIdentityCube(5), lut, error));
+    ASSERT_EQ(5, lut.size_3d);
+    ASSERT_EQ(0, lut.size_1d);
+    ASSERT_TRUE(lut.title == "identity");
+
+    LutProcessor processor;
+    ASSERT_TRUE(processor.Initialize(lut));
+    ASSERT_EQ(5, processor.GetLatticeSize());
+
+    const float samples[][3] = {
+        {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.3f, 0.7f, 0.1f},
+        {0.95f, 0.05f, 0.5f}, {0.123f, 0.456f, 0.789f}
+    };
+    for (const auto& s : samples) {
+        float out[3];
+        processor.ApplyPixel(s, out);
+        ASSERT_NEAR(s[0], out[0], 1e-5f);
+        ASSERT_NEAR(s[1], out[1], 1e-5f);
+        ASSERT_NEAR(s[2], out[2], 1e-5f);
+    }
+
+    return true;
+}
+
+/**
+ * @brief 测试.cube解析错误处理
+ */
+TEST(Lut_ParseErrors) {
+    CubeLUT lut;
+    std::string error;
+
+    // 数据行数量不足
+    ASSERT_FALSE(CubeLUTIO::ParseCube("LUT_3D_SIZE 2\n0 0 0\n1 1 1\n", lut, error));
+    ASSERT_FALSE(error.empty());
+
+    // 非法尺寸
+    ASSERT_FALSE(CubeLUTIO::ParseCube("LUT_3D_SIZE 1\n0 0 0\n", lut, error));
+
+    // 数据行格式错误
+    ASSERT_FALSE(CubeLUTIO::ParseCube("LUT_1D_SIZE 2\n0 0\n1 1 1\n", lut, error));
+
+    // 空内容
+    ASSERT_FALSE(CubeLUTIO::ParseCube("# only comment\n", lut, error));
+
+    LutProcessor processor;
+    ASSERT_FALSE(processor.LoadCubeFromString("LUT_3D_SIZE 2\n"));
+    ASSERT_FALSE(processor.GetLastError().empty());
+
+    Image input(4, 4, 3);
+    Image output;
+    ASSERT_FALSE(processor.ProcessFrame(input, output));
+
+    return true;
+}
+
+/**
+ * @brief 测试1D整形LUT与输入域
+ */
+TEST(Lut_Shaper1D) {
+    // 输入域 [0,2]，输出为输入的一半
+    std::string text =
+        "LUT_1D_SIZE 3\n"
+        "DOMAIN_MIN 0 0 0\n"
+        "DOMAIN_MAX 2 2 2\n"
+        "0 0 0\n"
+        "0.5 0.5 0.5\n"
+        "1 1 1\n";
+
+    LutProcessor processor;
+    ASSERT_TRUE(processor.LoadCubeFromString(text));
+
+    float in[3] = {0.5f, 1.5f, 3.0f};
+    float out[3];
+    processor.ApplyPixel(in, out);
+    ASSERT_NEAR(0.25f, out[0], 1e-6f);
+    ASSERT_NEAR(0.75f, out[1], 1e-6f);
+    ASSERT_NEAR(1.0f, out[2], 1e-6f);   // 超出输入域被钳制
+
+    // NaN输入按下界处理
+    float nan_in[3] = {std::nanf(""), 0.0f, 0.0f};
+    processor.ApplyPixel(nan_in, out);
+    ASSERT_TRUE(std::isfinite(out[0]));
+
+    return true;
+}
+
+/**
+ * @brief 测试四面体插值精确重建仿射函数
+ */
+TEST(Lut_TetrahedralReproducesAffine) {
+    // 四面体插值对仿射函数是精确的
+    const int size = 9;
+    CubeLUT lut;
+    lut.size_3d = size;
+    for (int b = 0; b < size; ++b) {
+        for (int g = 0; g < size; ++g) {
+            for (int r = 0; r < size; ++r) {
+                float fr = r / float(size - 1), fg = g / float(size - 1), fb = b / float(size - 1);
+                lut.table_3d.push_back(0.5f * fr + 0.2f * fg + 0.1f);
+                lut.table_3d.push_back(0.1f * fr + 0.7f * fg + 0.2f * fb);
+                lut.table_3d.push_back(0.3f * fb + 0.05f);
+            }
+        }
+    }
+
+    LutProcessor processor;
+    ASSERT_TRUE(processor.Initialize(lut));
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    for (int i = 0; i < 1000; ++i) {
+        float in[3] = {dist(rng), dist(rng), dist(rng)};
+        float out[3];
+        processor.ApplyPixel(in, out);
+        ASSERT_NEAR(0.5f * in[0] + 0.2f * in[1] + 0.1f, out[0], 1e-5f);
+        ASSERT_NEAR(0.1f * in[0] + 0.7f * in[1] + 0.2f * in[2], out[1], 1e-5f);
+        ASSERT_NEAR(0.3f * in[2] + 0.05f, out[2], 1e-5f);
+    }
+
+    return true;
+}
+
+/**
+ * @brief 测试.cube文件读取
+ */
+TEST(Lut_LoadCubeFile) {
+    std::string path = "cph_test_identity.cube";
+    {
+        std::ofstream file(path);
+        file << MakeIdentityCube(3);
+    }
+
+    LutProcessor processor;
+    ASSERT_TRUE(processor.LoadCubeFile(path));
+    ASSERT_EQ(3, processor.GetLatticeSize());
+    std::remove(path.c_str());
+
+    ASSERT_FALSE(processor.LoadCubeFile("nonexistent_dir/none.cube"));
+    ASSERT_FALSE(processor.GetLastError().empty());
+
+    return true;
+}
+
+/**
+ * @brief 测试整帧多线程应用与单线程结果一致，额外通道原样保留
+ */
+TEST(Lut_ProcessFrameMultithreaded) {
+    CubeLUT lut;
+    ASSERT_TRUE(BakeFromProcessor(GoldenPresets()[1], 17, lut));
+
+    Image input(97, 61, 4);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    for (float& v : input.data) v = dist(rng);
+
+    LutProcessor single;
+    ASSERT_TRUE(single.Initialize(lut));
+    single.SetThreadCount(1);
+
+    LutProcessor multi;
+    ASSERT_TRUE(multi.Initialize(lut));
+    multi.SetThreadCount(4);
+
+    Image out_single, out_multi;
+    ASSERT_TRUE(single.ProcessFrame(input, out_single));
+    ASSERT_TRUE(multi.ProcessFrame(input, out_multi));
+
+    ASSERT_EQ(input.width, out_multi.width);
+    ASSERT_EQ(input.channels, out_multi.channels);
+    ASSERT_TRUE(out_single.data == out_multi.data);
+
+    // Alpha通道原样保留
+    ASSERT_EQ(input.GetPixel(13, 17)[3], out_multi.GetPixel(13, 17)[3]);
+
+    // 跨度接口原地处理与整帧结果一致
+    std::vector<float> span(input.data.begin(), input.data.end());
+    multi.Apply(span.data(), span.data(), input.width * input.height, 4);
+    ASSERT_TRUE(span == std::vector<float>(out_multi.data.begin(), out_multi.data.end()));
+
+    return true;
+}
+
+/**
+ * @brief 对照 CphProcessor::ProcessFrame 验证三套预设的LUT预览误差
+ */
+TEST(Lut_MatchesProcessorOnGoldenPresets) {
+    std::mt19937 rng(2025);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+
+    Image input(128, 64, 3);
+    input.color_space = ColorSpace::BT2020_PQ;
+    for (float& v : input.data) v = dist(rng);
+
+    for (const auto& preset : GoldenPresets()) {
+        CubeLUT lut;
+        ASSERT_TRUE(BakeFromProcessor(preset, 65, lut));
+
+        CphProcessor reference;
+        ASSERT_TRUE(reference.Initialize(preset));
+        Image expected;
+        ASSERT_TRUE(reference.ProcessFrame(input, expected));
+
+        LutProcessor preview;
+        ASSERT_TRUE(preview.Initialize(lut));
+        Image actual;
+        ASSERT_TRUE(preview.ProcessFrame(input, actual));
+
+        double sum_error = 0.0;
+        float max_error = 0.0f;
+        for (size_t i = 0; i < expected.data.size(); ++i) {
+            float error = std::abs(expected.data[i] - actual.data[i]);
+            sum_error += error;
+            max_error = std::max(max_error, error);
+        }
+        float mean_error = static_cast<float>(sum_error / expected.data.size());
+
+        // PQ归一域：均值误差 < 1/4 个10-bit码值，最大误差 < 4个10-bit码值
+        ASSERT_LT(mean_error, 0.25f / 1023.0f);
+        ASSERT_LT(max_error, 4.0f / 1023.0f);
+    }
+
+    return true;
+}
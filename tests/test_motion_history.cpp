@@ -0,0 +1,257 @@
+#include "test_framework.h"
+#include "cinema_pro_hdr/motion_history.h"
+#include "cinema_pro_hdr/highlight_detail.h"
+#include <cmath>
+
+using namespace CinemaProHDR;
+
+/**
+ * @brief 测试亮度降采样：不完整的边缘块按实际像素数平均
+ */
+TEST(MotionHistory_DownsampleLuma) {
+    const int width = 10;
+    const int height = 6;
+    std::vector<float> luma(width * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            luma[y * width + x] = static_cast<float>(x);
+        }
+    }
+    
+    MotionHistory history;
+    history.PushLuma(luma.data(), width, height);
+    const MotionHistory::LumaFrame* frame = history.GetFrame(0);
+    ASSERT_TRUE(frame != nullptr);
+    const MotionHistory::LumaPlane& level0 = frame->levels[0];
+    ASSERT_EQ(3, level0.width);
+    ASSERT_EQ(2, level0.height);
+    ASSERT_NEAR(1.5f, level0.mean[0], 1e-6f);
+    ASSERT_NEAR(5.5f, level0.mean[1], 1e-6f);
+    ASSERT_NEAR(8.5f, level0.mean[2], 1e-6f);   // 右边缘块只有2列
+    ASSERT_NEAR(8.5f, level0.mean[5], 1e-6f);   // 下边缘块只有2行
+    ASSERT_NEAR(3.0f, level0.peak[0], 1e-6f);
+    ASSERT_NEAR(9.0f, level0.peak[2], 1e-6f);
+    
+    // 交错帧路径得到同样的平面
+    Image image(width, height, 3);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            float* pixel = image.GetPixel(x, y);
+            pixel[0] = 0.0f;
+            pixel[1] = static_cast<float>(x);
+            pixel[2] = 0.5f * x;
+        }
+    }
+    history.PushFrame(image);
+    ASSERT_TRUE(history.GetFrame(0)->levels[0].mean == history.GetFrame(1)->levels[0].mean);
+    ASSERT_TRUE(history.GetFrame(0)->levels[0].peak == history.GetFrame(1)->levels[0].peak);
+    
+    return true;
+}
+
+/**
+ * @brief 测试环形缓冲：槽位轮转复用，尺寸变化时没有可比的前一帧
+ */
+TEST(MotionHistory_RingRotation) {
+    MotionHistory history(3);
+    std::vector<float> frame(16 * 8);
+    for (int i = 0; i < 5; ++i) {
+        std::fill(frame.begin(), frame.end(), 0.1f * i);
+        history.PushLuma(frame.data(), 16, 8);
+    }
+    ASSERT_EQ(size_t(3), history.GetFrameCount());
+    ASSERT_NEAR(0.4f, history.GetFrame(0)->levels[0].mean[0], 1e-6f);
+    ASSERT_NEAR(0.3f, history.GetFrame(1)->levels[0].mean[0], 1e-6f);
+    ASSERT_NEAR(0.2f, history.GetFrame(2)->levels[0].mean[0], 1e-6f);
+    ASSERT_TRUE(history.GetFrame(3) == nullptr);
+    ASSERT_TRUE(history.HasPrevious());
+    
+    // 高光区域帧差RMS：0.4 vs 0.3（pivot 0.35）
+    ASSERT_NEAR(0.1f, history.ComputeMotionEnergy(0.35f), 1e-5f);
+    ASSERT_NEAR(0.0f, history.ComputeMotionEnergy(0.5f), 1e-6f);
+    
+    std::vector<float> other(12 * 8, 0.9f);
+    history.PushLuma(other.data(), 12, 8);
+    ASSERT_FALSE(history.HasPrevious());
+    ASSERT_NEAR(0.0f, history.ComputeMotionEnergy(0.1f), 1e-6f);
+    
+    history.Clear();
+    ASSERT_EQ(size_t(0), history.GetFrameCount());
+    ASSERT_TRUE(history.GetFrame(0) == nullptr);
+    
+    return true;
+}
+
+/**
+ * @brief 测试运动能量历史：定长窗口内的平均值与最新值
+ */
+TEST(MotionHistory_EnergyWindow) {
+    MotionHistory history(2, 4);
+    ASSERT_NEAR(0.0f, history.GetAverageEnergy(), 1e-6f);
+    for (int i = 1; i <= 6; ++i) {
+        history.PushEnergy(0.01f * i);
+    }
+    // 窗口内为 0.03, 0.04, 0.05, 0.06
+    ASSERT_EQ(size_t(4), history.GetEnergyCount());
+    ASSERT_NEAR(0.06f, history.GetLatestEnergy(), 1e-6f);
+    ASSERT_NEAR(0.045f, history.GetAverageEnergy(), 1e-6f);
+    
+    // 运动保护：最新能量超过0.02时强度减半
+    ASSERT_NEAR(0.4f, HighlightDetailProcessor::MotionProtectedIntensity(0.8f, history), 1e-6f);
+    MotionHistory quiet;
+    ASSERT_NEAR(0.8f, HighlightDetailProcessor::MotionProtectedIntensity(0.8f, quiet), 1e-6f);
+    quiet.PushEnergy(0.001f);
+    ASSERT_NEAR(0.8f, HighlightDetailProcessor::MotionProtectedIntensity(0.8f, quiet), 1e-6f);
+    
+    return true;
+}
+
+/**
+ * @brief 测试金字塔：各层尺寸向上取整，均值与最大值由上一层2×2构建
+ */
+TEST(MotionHistory_PyramidLevels) {
+    const int width = 72;
+    const int height = 40;
+    std::vector<float> luma(width * height, 0.1f);
+    luma[5 * width + 6] = 0.9f;   // 单个亮点
+    
+    MotionHistory history;
+    history.PushLuma(luma.data(), width, height);
+    const MotionHistory::LumaFrame* frame = history.GetFrame(0);
+    ASSERT_TRUE(frame != nullptr);
+    ASSERT_EQ(width, frame->source_width);
+    ASSERT_EQ(height, frame->source_height);
+    
+    const int expected_width[MotionHistory::kPyramidLevels] = {18, 9, 5};
+    const int expected_height[MotionHistory::kPyramidLevels] = {10, 5, 3};
+    for (int level = 0; level < MotionHistory::kPyramidLevels; ++level) {
+        const MotionHistory::LumaPlane& plane = frame->levels[level];
+        ASSERT_EQ(expected_width[level], plane.width);
+        ASSERT_EQ(expected_height[level], plane.height);
+        ASSERT_EQ(static_cast<size_t>(plane.width * plane.height), plane.mean.size());
+        
+        // 亮点所在样本：最大值保留峰值，均值按覆盖像素数稀释
+        const int factor = MotionHistory::LumaFrame::LevelFactor(level);
+        const size_t index = static_cast<size_t>(5 / factor) * plane.width + 6 / factor;
+        const float area = static_cast<float>(factor * factor);
+        ASSERT_NEAR(0.9f, plane.peak[index], 1e-6f);
+        ASSERT_NEAR(0.1f + 0.8f / area, plane.mean[index], 1e-5f);
+        ASSERT_NEAR(0.1f, plane.peak[plane.peak.size() - 1], 1e-6f);
+    }
+    
+    return true;
+}
+
+/**
+ * @brief 测试分块运动图：只有高光移动的块有能量，静止暗部不细化
+ */
+TEST(MotionHistory_MotionMapLocalizesMotion) {
+    const int width = 256;
+    const int height = 128;
+    auto make_frame = [&](int offset) {
+        std::vector<float> luma(width * height, 0.1f);
+        for (int y = 16; y < 48; ++y) {
+            for (int x = 16 + offset; x < 48 + offset; ++x) {
+                luma[y * width + x] = 0.9f;
+            }
+        }
+        return luma;
+    };
+    
+    MotionHistory history;
+    MotionMap map;
+    std::vector<float> first = make_frame(0);
+    history.PushLuma(first.data(), width, height);
+    ASSERT_FALSE(history.ComputeMotionMap(0.5f, 0.02f, map));
+    
+    std::vector<float> second = make_frame(8);
+    history.PushLuma(second.data(), width, height);
+    ASSERT_TRUE(history.ComputeMotionMap(0.5f, 0.02f, map));
+    ASSERT_TRUE(map.Matches(width, height));
+    ASSERT_EQ(4, map.tiles_x);
+    ASSERT_EQ(2, map.tiles_y);
+    
+    // 高光只在左上块内移动
+    ASSERT_TRUE(map.energy[0] > 0.02f);
+    for (size_t tile = 1; tile < map.energy.size(); ++tile) {
+        ASSERT_NEAR(0.0f, map.energy[tile], 1e-6f);
+    }
+    ASSERT_EQ(0, map.refined_tiles);   // 粗层能量已超过阈值，无需细化
+    
+    // 只在粗层样本内部移动（均值不变）时回到第0层
+    std::vector<float> third = make_frame(8);
+    for (int y = 16; y < 48; ++y) {
+        std::swap(third[y * width + 24], third[y * width + 20]);
+    }
+    MotionHistory subtle;
+    MotionMap subtle_map;
+    subtle.PushLuma(second.data(), width, height);
+    subtle.PushLuma(third.data(), width, height);
+    ASSERT_TRUE(subtle.ComputeMotionMap(0.5f, 0.02f, subtle_map));
+    ASSERT_EQ(1, subtle_map.refined_tiles);
+    ASSERT_TRUE(subtle_map.energy[0] > 0.0f);
+    ASSERT_TRUE(map.GlobalEnergy() > 0.0f);
+    ASSERT_TRUE(map.GlobalEnergy() <= map.energy[0]);
+    
+    // 抑制只作用于运动块，插值系数在远处回到1
+    HighlightDetailProcessor::ShouldSuppressDetail(map, history);
+    ASSERT_NEAR(0.5f, map.detail_scale[0], 1e-6f);
+    ASSERT_NEAR(1.0f, map.detail_scale[3], 1e-6f);
+    std::vector<float> row(width);
+    map.FillRowScale(0, width, row.data());
+    ASSERT_NEAR(0.5f, row[0], 1e-6f);
+    ASSERT_NEAR(1.0f, row[width - 1], 1e-6f);
+    
+    return true;
+}
+
+/**
+ * @brief 测试局部运动保护：远离运动区域的像素与不保护时一致
+ */
+TEST(MotionHistory_LocalSuppression) {
+    const int width = 256;
+    const int height = 64;
+    auto make_image = [&](int offset) {
+        Image image(width, height, 3);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                float* pixel = image.GetPixel(x, y);
+                float texture = 0.7f + 0.1f * std::sin(x * 0.7f) * std::cos(y * 0.5f);
+                bool moving = x >= 8 + offset && x < 40 + offset && y >= 16 && y < 48;
+                pixel[0] = pixel[1] = pixel[2] = moving ? 0.95f : texture;
+            }
+        }
+        return image;
+    };
+    
+    CphParams params;
+    params.highlight_detail = 0.8f;
+    HighlightDetailProcessor protected_processor;
+    HighlightDetailProcessor plain_processor;
+    ASSERT_TRUE(protected_processor.Initialize(params));
+    ASSERT_TRUE(plain_processor.Initialize(params));
+    
+    Image first = make_image(0);
+    Image second = make_image(12);
+    Image protected_output;
+    Image plain_output;
+    ASSERT_TRUE(protected_processor.ProcessFrameWithMotionProtection(first, nullptr, protected_output, 0.5f));
+    ASSERT_TRUE(protected_processor.ProcessFrameWithMotionProtection(second, &first, protected_output, 0.5f));
+    ASSERT_TRUE(plain_processor.ProcessFrame(second, plain_output, 0.5f));
+    
+    // 运动块内细节被削弱，最右一块（距离运动块超过一个块中心间距）保持不变
+    bool reduced = false;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            if (std::abs(protected_output.GetPixel(x, y)[1] - plain_output.GetPixel(x, y)[1]) > 1e-4f) {
+                reduced = true;
+            }
+        }
+        for (int x = 224; x < width; ++x) {
+            ASSERT_NEAR(plain_output.GetPixel(x, y)[1], protected_output.GetPixel(x, y)[1], 1e-6f);
+        }
+    }
+    ASSERT_TRUE(reduced);
+    
+    return true;
+}
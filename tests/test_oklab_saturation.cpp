@@ -2,6 +2,8 @@
 #include "cinema_pro_hdr/color_space.h"
 #include "cinema_pro_hdr/core.h"
 #include <cmath>
+#include <limits>
+#include <vector>
 #include <iostream>
 
 using namespace CinemaProHDR;
@@ -341,4 +343,46 @@ TEST(OKLabSaturationIntegration) {
     std::cout << "  ✅ 完整饱和度处理流程测试通过" << std::endl;
     
     return true;
-}
\ No newline at end of file
+}
+// 测试平面OKLab转换与逐像素结果一致（含非有限像素与原地调用）
+TEST(OKLabPlanarMatchesScalar) {
+    const size_t count = 37;
+    std::vector<float> r(count), g(count), b(count);
+    for (size_t i = 0; i < count; ++i) {
+        r[i] = 0.03f * static_cast<float>(i);
+        g[i] = 0.5f + 0.01f * static_cast<float>(i % 7);
+        b[i] = 1.2f - 0.02f * static_cast<float>(i);
+    }
+    r[5] = std::numeric_limits<float>::quiet_NaN();
+    g[11] = std::numeric_limits<float>::infinity();
+
+    std::vector<float> L(count), a(count), ok_b(count);
+    ColorSpaceConverter::RGB_to_OKLab_Planar(r.data(), g.data(), b.data(),
+                                             L.data(), a.data(), ok_b.data(), count);
+    for (size_t i = 0; i < count; ++i) {
+        float rgb[3] = {r[i], g[i], b[i]};
+        float oklab[3];
+        ColorSpaceConverter::RGB_to_OKLab(rgb, oklab);
+        ASSERT_NEAR(oklab[0], L[i], 1e-5f);
+        ASSERT_NEAR(oklab[1], a[i], 1e-5f);
+        ASSERT_NEAR(oklab[2], ok_b[i], 1e-5f);
+    }
+
+    // 原地反变换：输出平面即输入平面
+    std::vector<float> expected(count * 3);
+    for (size_t i = 0; i < count; ++i) {
+        float oklab[3] = {L[i], a[i], ok_b[i]};
+        ColorSpaceConverter::OKLab_to_RGB(oklab, &expected[i * 3]);
+    }
+    ColorSpaceConverter::OKLab_to_RGB_Planar(L.data(), a.data(), ok_b.data(),
+                                             L.data(), a.data(), ok_b.data(), count);
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_NEAR(expected[i * 3 + 0], L[i], 1e-5f);
+        ASSERT_NEAR(expected[i * 3 + 1], a[i], 1e-5f);
+        ASSERT_NEAR(expected[i * 3 + 2], ok_b[i], 1e-5f);
+    }
+    ASSERT_EQ(0.0f, L[5]);
+    ASSERT_EQ(0.0f, a[11]);
+
+    return true;
+}
@@ -0,0 +1,52 @@
+#include "test_framework.h"
+#include "cinema_pro_hdr/parallel.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace CinemaProHDR;
+
+/**
+ * @brief 测试区间完整覆盖且每个元素只处理一次（多次调用复用常驻线程）
+ */
+TEST(Parallel_CoversRangeExactlyOnce) {
+    for (int round = 0; round < 50; ++round) {
+        std::vector<std::atomic<int>> hits(1037);
+        Parallel::ParallelFor(0, static_cast<int>(hits.size()), [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                hits[i]++;
+            }
+        }, 4 + round % 5);
+        for (const auto& hit : hits) {
+            ASSERT_EQ(1, hit.load());
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 测试嵌套调用不死锁，块内异常由调用线程重新抛出
+ */
+TEST(Parallel_NestedAndExceptions) {
+    std::atomic<int> total{0};
+    Parallel::ParallelFor(0, 8, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            Parallel::ParallelFor(0, 100, [&](int b, int e) { total += e - b; }, 4);
+        }
+    }, 8);
+    ASSERT_EQ(800, total.load());
+
+    bool thrown = false;
+    try {
+        Parallel::ParallelFor(0, 64, [](int begin, int) {
+            if (begin > 0) {
+                throw std::runtime_error("block failed");
+            }
+        }, 4);
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    ASSERT_TRUE(thrown);
+    return true;
+}
@@ -0,0 +1,141 @@
+#include "test_framework.h"
+#include "test_frames.h"
+#include "cinema_pro_hdr/pipeline.h"
+#include <thread>
+
+using namespace CinemaProHDR;
+
+/**
+ * @brief 测试编译管线：参数校验失败返回空，结果与处理器平面路径一致
+ */
+TEST(Pipeline_CompileAndMatchProcessor) {
+    CphParams invalid;
+    invalid.pivot_pq = 2.0f;
+    std::vector<ErrorReport> errors;
+    ASSERT_TRUE(CompiledPipeline::Compile(invalid, errors) == nullptr);
+    ASSERT_FALSE(errors.empty());
+    
+    CphParams params;
+    params.highlight_detail = 0.5f;
+    params.sat_base = 1.2f;
+    errors.clear();
+    std::shared_ptr<const CompiledPipeline> pipeline = CompiledPipeline::Compile(params, errors);
+    ASSERT_TRUE(pipeline != nullptr);
+    ASSERT_TRUE(pipeline->GetPlan(ColorSpace::P3_D65).HasStage(RenderStage::FROM_WORKING_DOMAIN));
+    ASSERT_TRUE(pipeline->GetPlan(ColorSpace::P3_D65).layout == PixelLayout::PLANAR);
+    
+    CphProcessor processor;
+    processor.SetPreferredLayout(PixelLayout::PLANAR);
+    ASSERT_TRUE(processor.Initialize(params));
+    ASSERT_TRUE(processor.GetCompiledPipeline() != nullptr);
+    
+    Image input = TestFrames::MakeFrame({40, 28, 3, 0});
+    Image expected;
+    ASSERT_TRUE(processor.ProcessFrame(input, expected));
+    
+    StreamState state;
+    Image output;
+    ASSERT_TRUE(pipeline->ProcessFrame(input, output, state));
+    ASSERT_TRUE(output.data == expected.data);
+    ASSERT_EQ(1, state.stats.frame_count);
+    ASSERT_NEAR(processor.GetStatistics().pq_stats.avg_pq, state.stats.pq_stats.avg_pq, 1e-6f);
+    ASSERT_TRUE(state.stats.monotonic);
+    
+    return true;
+}
+
+/**
+ * @brief 测试多个渲染线程共享一份管线，各自的流状态互不影响
+ */
+TEST(Pipeline_SharedAcrossThreads) {
+    CphParams params;
+    params.highlight_detail = 0.7f;
+    std::vector<ErrorReport> errors;
+    std::shared_ptr<const CompiledPipeline> pipeline = CompiledPipeline::Compile(params, errors);
+    ASSERT_TRUE(pipeline != nullptr);
+    
+    const int kThreads = 4;
+    const int kFrames = 6;
+    
+    // 参考：单线程、每条流依次处理
+    std::vector<std::vector<Image>> expected(kThreads, std::vector<Image>(kFrames));
+    for (int t = 0; t < kThreads; ++t) {
+        StreamState state;
+        state.motion_protection = (t % 2 == 1);
+        for (int f = 0; f < kFrames; ++f) {
+            if (!pipeline->ProcessFrame(TestFrames::MakeFrame({40, 28, 3, f + t}), expected[t][f], state)) return false;
+        }
+    }
+    
+    std::vector<std::vector<Image>> results(kThreads, std::vector<Image>(kFrames));
+    std::vector<int> frame_counts(kThreads, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            StreamState state;
+            state.motion_protection = (t % 2 == 1);
+            for (int f = 0; f < kFrames; ++f) {
+                pipeline->ProcessFrame(TestFrames::MakeFrame({40, 28, 3, f + t}), results[t][f], state);
+            }
+            frame_counts[t] = state.stats.frame_count;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    for (int t = 0; t < kThreads; ++t) {
+        ASSERT_EQ(kFrames, frame_counts[t]);
+        for (int f = 0; f < kFrames; ++f) {
+            ASSERT_TRUE(results[t][f].data == expected[t][f].data);
+        }
+    }
+    
+    // 运动保护只改变有前一帧的帧
+    StreamState plain;
+    StreamState protected_state;
+    protected_state.motion_protection = true;
+    Image a, b;
+    for (int f = 0; f < 3; ++f) {
+        ASSERT_TRUE(pipeline->ProcessFrame(TestFrames::MakeFrame({40, 28, 3, f}), a, plain));
+        ASSERT_TRUE(pipeline->ProcessFrame(TestFrames::MakeFrame({40, 28, 3, f}), b, protected_state));
+        if (f == 0) {
+            ASSERT_TRUE(a.data == b.data);
+        }
+    }
+    ASSERT_FALSE(a.data == b.data);
+    ASSERT_EQ(size_t(2), protected_state.motion.GetEnergyCount());
+    
+    protected_state.Reset();
+    ASSERT_EQ(0, protected_state.stats.frame_count);
+    ASSERT_EQ(size_t(0), protected_state.motion.GetFrameCount());
+    ASSERT_TRUE(protected_state.motion_protection);
+    
+    return true;
+}
+
+/**
+ * @brief 测试流状态的错误历史有界：逐帧报错不会增长，最近错误保持最新
+ */
+TEST(Pipeline_StreamErrorsBounded) {
+    std::vector<ErrorReport> errors;
+    std::shared_ptr<const CompiledPipeline> pipeline = CompiledPipeline::Compile(CphParams(), errors);
+    ASSERT_TRUE(pipeline != nullptr);
+    
+    StreamState state;
+    Image invalid;
+    Image output;
+    for (size_t frame = 0; frame < 3 * ErrorEventLog::kCapacity; ++frame) {
+        ASSERT_FALSE(pipeline->ProcessFrame(invalid, output, state));
+    }
+    ASSERT_TRUE(state.GetLastError().find("Invalid input image") != std::string::npos);
+    ASSERT_EQ(ErrorEventLog::kCapacity, state.errors.GetHistory().size());
+    ErrorEventCounters counters = state.errors.GetCounters();
+    ASSERT_EQ(3 * ErrorEventLog::kCapacity, counters.recorded + counters.dropped);
+    
+    state.Reset();
+    ASSERT_TRUE(state.GetLastError().empty());
+    ASSERT_TRUE(state.errors.GetHistory().empty());
+    
+    return true;
+}
@@ -0,0 +1,199 @@
+#include "test_framework.h"
+#include "cinema_pro_hdr/color_space.h"
+#include "cinema_pro_hdr/pixel_format.h"
+#include "cinema_pro_hdr/processor.h"
+#include <cmath>
+#include <random>
+
+using namespace CinemaProHDR;
+
+/**
+ * @brief 测试RGB48在各位深下码值精确往返
+ */
+TEST(PixelFormat_RGB48RoundTrip) {
+    const int depths[] = {10, 12, 16};
+    for (int depth : depths) {
+        PackedImage input(PixelFormat::RGB48, 17, 5, depth);
+        ASSERT_TRUE(input.IsValid());
+        std::mt19937 rng(depth);
+        std::uniform_int_distribution<int> dist(0, (1 << depth) - 1);
+        uint16_t* samples = reinterpret_cast<uint16_t*>(input.data.data());
+        for (size_t i = 0; i < input.data.size() / 2; ++i) samples[i] = static_cast<uint16_t>(dist(rng));
+
+        ImagePlanar planar;
+        ASSERT_TRUE(PixelFormatIO::Decode(input, planar));
+        ASSERT_NEAR(samples[1] / float((1 << depth) - 1), planar.Plane(1)[0], 1e-6f);
+
+        PackedImage output(PixelFormat::RGB48, 0, 0, depth);
+        ASSERT_TRUE(PixelFormatIO::Encode(planar, output));
+        ASSERT_EQ(input.data.size(), output.data.size());
+        ASSERT_TRUE(input.data == output.data);
+    }
+
+    return true;
+}
+
+/**
+ * @brief 测试P010/V210：色度块内颜色一致时往返误差在量化级别内
+ */
+TEST(PixelFormat_YCbCrRoundTrip) {
+    const PixelFormat formats[] = {PixelFormat::P010, PixelFormat::V210};
+    for (PixelFormat format : formats) {
+        // V210 宽度非6的倍数，覆盖行尾不完整分组
+        Image input(26, 8, 3);
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> dist(0.05f, 0.95f);
+        for (int y = 0; y < input.height; y += 2) {
+            for (int x = 0; x < input.width; x += 2) {
+                float rgb[3] = {dist(rng), dist(rng), dist(rng)};
+                for (int dy = 0; dy < 2; ++dy) {
+                    for (int dx = 0; dx < 2; ++dx) {
+                        float* pixel = input.GetPixel(x + dx, y + dy);
+                        for (int c = 0; c < 3; ++c) pixel[c] = rgb[c];
+                    }
+                }
+            }
+        }
+
+        PackedImage packed(format, input.width, input.height);
+        ASSERT_TRUE(packed.IsValid());
+        ASSERT_TRUE(PixelFormatIO::Encode(input, packed));
+
+        Image decoded;
+        ASSERT_TRUE(PixelFormatIO::Decode(packed, decoded));
+        ASSERT_EQ(input.width, decoded.width);
+        ASSERT_EQ(input.height, decoded.height);
+        for (size_t i = 0; i < input.data.size(); ++i) {
+            ASSERT_NEAR(input.data[i], decoded.data[i], 4e-3f);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief 测试格式约束：P010要求偶数尺寸，行跨度不得小于最小值
+ */
+TEST(PixelFormat_Validation) {
+    ASSERT_EQ(size_t(128), PackedImage::MinStride(PixelFormat::V210, 48));
+    ASSERT_EQ(size_t(256), PackedImage::MinStride(PixelFormat::V210, 49));
+    ASSERT_EQ(size_t(60), PackedImage::MinStride(PixelFormat::RGB48, 10));
+
+    PackedImage odd(PixelFormat::P010, 5, 4);
+    ASSERT_FALSE(odd.IsValid());
+
+    PackedImage p010(PixelFormat::P010, 4, 4);
+    ASSERT_TRUE(p010.IsValid());
+    ASSERT_EQ(size_t(4 * 2 * 4 + 4 * 2 * 2), p010.GetDataSize());
+    p010.stride = 4;
+    ASSERT_FALSE(p010.IsValid());
+
+    PackedImage rgb(PixelFormat::RGB48, 4, 4, 8);
+    ASSERT_FALSE(rgb.IsValid());
+
+    ImagePlanar planar;
+    ASSERT_FALSE(PixelFormatIO::Decode(odd, planar));
+
+    return true;
+}
+
+/**
+ * @brief 测试打包帧处理与FP32路径逐码值一致
+ */
+TEST(PixelFormat_ProcessFrameMatchesFloat) {
+    const PixelFormat formats[] = {PixelFormat::RGB48, PixelFormat::P010, PixelFormat::V210};
+    for (PixelFormat format : formats) {
+        PackedImage input(format, 38, 14);
+        std::mt19937 rng(5);
+        std::uniform_int_distribution<int> dist(64, 940);
+        if (format == PixelFormat::RGB48) {
+            uint16_t* samples = reinterpret_cast<uint16_t*>(input.data.data());
+            for (size_t i = 0; i < input.data.size() / 2; ++i) samples[i] = static_cast<uint16_t>(dist(rng) * 64);
+        } else {
+            Image source(input.width, input.height, 3);
+            for (float& v : source.data) v = dist(rng) / 1023.0f;
+            ASSERT_TRUE(PixelFormatIO::Encode(source, input));
+        }
+
+        Image input_float;
+        ASSERT_TRUE(PixelFormatIO::Decode(input, input_float));
+
+        CphParams params;
+        CphProcessor reference;
+        ASSERT_TRUE(reference.Initialize(params));
+        Image processed;
+        ASSERT_TRUE(reference.ProcessFrame(input_float, processed));
+        PackedImage expected(format, input.width, input.height, input.bit_depth);
+        ASSERT_TRUE(PixelFormatIO::Encode(processed, expected));
+
+        CphProcessor processor;
+        ASSERT_TRUE(processor.Initialize(params));
+        PackedImage output;
+        ASSERT_TRUE(processor.ProcessFrame(input, output));
+        ASSERT_TRUE(format == output.format);
+        ASSERT_EQ(input.bit_depth, output.bit_depth);
+        ASSERT_TRUE(expected.data == output.data);
+        ASSERT_EQ(1, processor.GetStatistics().frame_count);
+    }
+
+    return true;
+}
+
+/**
+ * @brief 测试非BT.2020原色的RGB48：经精确PQ码值表进出工作域，码值往返无损
+ */
+TEST(PixelFormat_RGB48OtherPrimariesRoundTrip) {
+    PackedImage input(PixelFormat::RGB48, 64, 4, 12);
+    input.color_space = ColorSpace::P3_D65;
+    ASSERT_TRUE(input.IsValid());
+    uint16_t* samples = reinterpret_cast<uint16_t*>(input.data.data());
+    for (size_t i = 0; i < input.data.size() / 2; ++i) samples[i] = static_cast<uint16_t>((i * 37) % 4096);
+
+    ImagePlanar planar;
+    ASSERT_TRUE(PixelFormatIO::Decode(input, planar));
+    ASSERT_TRUE(planar.color_space == ColorSpace::BT2020_PQ);
+
+    PackedImage output(PixelFormat::RGB48, 0, 0, 12);
+    output.color_space = ColorSpace::P3_D65;
+    ASSERT_TRUE(PixelFormatIO::Encode(planar, output));
+    ASSERT_TRUE(input.data == output.data);
+
+    // YCbCr格式只接受BT.2020原色
+    PackedImage v210(PixelFormat::V210, 12, 2);
+    v210.color_space = ColorSpace::P3_D65;
+    ASSERT_FALSE(v210.IsValid());
+
+    return true;
+}
+
+/**
+ * @brief 测试REC709标记的RGB48：解码与浮点源（ToWorkingPixel）一致，编码往返无损
+ */
+TEST(PixelFormat_RGB48Rec709MatchesFloat) {
+    PackedImage input(PixelFormat::RGB48, 3, 1, 16);
+    input.color_space = ColorSpace::REC709;
+    ASSERT_TRUE(input.IsValid());
+    uint16_t* samples = reinterpret_cast<uint16_t*>(input.data.data());
+    const uint16_t codes[3] = {20000, 30000, 40000};
+    for (int i = 0; i < 9; ++i) samples[i] = codes[(i + i / 3) % 3];
+
+    Image decoded;
+    ASSERT_TRUE(PixelFormatIO::Decode(input, decoded));
+    for (int x = 0; x < 3; ++x) {
+        float src[3];
+        float expected[3];
+        for (int c = 0; c < 3; ++c) src[c] = samples[x * 3 + c] / 65535.0f;
+        ColorSpaceConverter::ToWorkingPixel(src, expected, ColorSpace::REC709);
+        for (int c = 0; c < 3; ++c) {
+            ASSERT_NEAR(expected[c], decoded.GetPixel(x, 0)[c], 1e-6f);
+        }
+    }
+    ASSERT_NEAR(0.305f, decoded.GetPixel(0, 0)[0], 1e-3f);
+
+    PackedImage output(PixelFormat::RGB48, 0, 0, 16);
+    output.color_space = ColorSpace::REC709;
+    ASSERT_TRUE(PixelFormatIO::Encode(decoded, output));
+    ASSERT_TRUE(input.data == output.data);
+
+    return true;
+}
@@ -1,5 +1,9 @@
 #include "test_framework.h"
 #include "cinema_pro_hdr/color_space.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
 
 using namespace CinemaProHDR;
 
@@ -75,4 +79,66 @@ TEST(PQFunctions_PrecisionTest) {
     }
     
     return true;
-}
\ No newline at end of file
+}
+TEST(PQFunctions_CodeTablesExactAtCodePoints) {
+    const int depths[] = {10, 12, 16};
+    for (int depth : depths) {
+        ASSERT_TRUE(ColorSpaceConverter::HasPQCodeTables(depth));
+        const int max_code = (1 << depth) - 1;
+        
+        std::vector<uint16_t> codes(max_code + 1);
+        for (int k = 0; k <= max_code; ++k) codes[k] = static_cast<uint16_t>(k);
+        
+        // EOTF表与标量函数逐位一致
+        std::vector<float> linear(codes.size());
+        ColorSpaceConverter::PQ_EOTF_Codes(codes.data(), 1, linear.data(), codes.size(), depth);
+        for (int k = 0; k <= max_code; ++k) {
+            ASSERT_EQ(ColorSpaceConverter::PQ_EOTF(static_cast<float>(k) / max_code), linear[k]);
+        }
+        
+        // OETF逆表在码值点上精确往返
+        std::vector<uint16_t> back(codes.size());
+        ColorSpaceConverter::PQ_OETF_Codes(linear.data(), back.data(), 1, linear.size(), depth);
+        for (int k = 0; k <= max_code; ++k) {
+            ASSERT_EQ(k, back[k]);
+        }
+    }
+    
+    ASSERT_FALSE(ColorSpaceConverter::HasPQCodeTables(8));
+    
+    return true;
+}
+
+TEST(PQFunctions_CodeTableOETFMatchesFunction) {
+    const int depth = 12;
+    const float max_f = 4095.0f;
+    
+    // 对数均匀扫描：单调，且与量化后的PQ_OETF相差不超过一个码值
+    std::vector<float> sweep;
+    for (int i = 0; i <= 200000; ++i) {
+        sweep.push_back(std::pow(10.0f, -7.0f + 11.0f * i / 200000.0f));
+    }
+    std::vector<uint16_t> codes(sweep.size());
+    ColorSpaceConverter::PQ_OETF_Codes(sweep.data(), codes.data(), 1, sweep.size(), depth);
+    
+    int mismatches = 0;
+    for (size_t i = 0; i < sweep.size(); ++i) {
+        int expected = static_cast<int>(std::min(ColorSpaceConverter::PQ_OETF(sweep[i]) * max_f, max_f) + 0.5f);
+        ASSERT_LE(std::abs(expected - codes[i]), 1);
+        if (expected != codes[i]) ++mismatches;
+        if (i > 0) ASSERT_GE(codes[i], codes[i - 1]);
+    }
+    // 差异仅来自单精度PQ_OETF在判决边界附近的舍入噪声
+    ASSERT_LT(mismatches, static_cast<int>(sweep.size() / 100));
+    
+    // 边界处理与标量函数一致
+    const float edges[] = {-1.0f, 0.0f, std::nanf(""), std::numeric_limits<float>::infinity(), 10000.0f, 20000.0f};
+    const uint16_t expected_edges[] = {0, 0, 0, 0, 4095, 4095};
+    uint16_t edge_codes[6];
+    ColorSpaceConverter::PQ_OETF_Codes(edges, edge_codes, 1, 6, depth);
+    for (int i = 0; i < 6; ++i) {
+        ASSERT_EQ(expected_edges[i], edge_codes[i]);
+    }
+    
+    return true;
+}
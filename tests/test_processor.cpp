@@ -1,5 +1,13 @@
 #include "test_framework.h"
+#include "test_frames.h"
 #include "cinema_pro_hdr/processor.h"
+#include "cinema_pro_hdr/color_space.h"
+#include "cinema_pro_hdr/highlight_detail.h"
+#include "cinema_pro_hdr/pipeline.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
 
 using namespace CinemaProHDR;
 
@@ -137,4 +145,694 @@ TEST(Processor_ModeSettings) {
     ASSERT_TRUE(processor.GetLastError().empty());
     
     return true;
-}
\ No newline at end of file
+}
+TEST(Processor_RenderPlanDefault) {
+    CphProcessor processor;
+    CphParams params; // highlight_detail=0.2, sat_hi=0.95
+    
+    ASSERT_TRUE(processor.Initialize(params));
+    
+    const RenderPlan& plan = processor.GetRenderPlan();
+    ASSERT_TRUE(plan.HasStage(RenderStage::WORKING_DOMAIN_CLAMP));
+    ASSERT_FALSE(plan.HasStage(RenderStage::TO_WORKING_DOMAIN));
+    ASSERT_TRUE(plan.HasStage(RenderStage::TONE_MAPPING));
+    ASSERT_TRUE(plan.HasStage(RenderStage::HIGHLIGHT_DETAIL));
+    ASSERT_TRUE(plan.HasStage(RenderStage::SATURATION));
+    ASSERT_FALSE(plan.HasStage(RenderStage::FROM_WORKING_DOMAIN));
+    ASSERT_TRUE(plan.HasStage(RenderStage::STATISTICS));
+    ASSERT_FALSE(plan.ToString().empty());
+    
+    return true;
+}
+
+TEST(Processor_RenderPlanElidesIdentityStages) {
+    CphParams params;
+    params.highlight_detail = 0.0f;
+    params.sat_base = 1.0f;
+    params.sat_hi = 1.0f;
+    
+    RenderPlan plan = RenderPlan::Compile(params, ColorSpace::BT2020_PQ, ColorSpace::BT2020_PQ);
+    ASSERT_EQ(3, plan.stages.size()); // 钳制 -> 曲线 -> 统计
+    ASSERT_FALSE(plan.HasStage(RenderStage::HIGHLIGHT_DETAIL));
+    ASSERT_FALSE(plan.HasStage(RenderStage::SATURATION));
+    
+    // DCI模式下感知夹持总是执行，饱和度阶段不能裁剪
+    params.dci_compliance = true;
+    plan = RenderPlan::Compile(params, ColorSpace::BT2020_PQ, ColorSpace::BT2020_PQ);
+    ASSERT_TRUE(plan.HasStage(RenderStage::SATURATION));
+    
+    // 非工作域色彩空间需要完整的转换阶段
+    plan = RenderPlan::Compile(params, ColorSpace::P3_D65, ColorSpace::P3_D65);
+    ASSERT_TRUE(plan.HasStage(RenderStage::TO_WORKING_DOMAIN));
+    ASSERT_TRUE(plan.HasStage(RenderStage::FROM_WORKING_DOMAIN));
+    
+    return true;
+}
+
+TEST(Processor_RenderPlanRecompiledOnModeAndColorSpaceChange) {
+    CphProcessor processor;
+    CphParams params;
+    params.sat_base = 1.0f;
+    params.sat_hi = 1.0f;
+    
+    ASSERT_TRUE(processor.Initialize(params));
+    ASSERT_FALSE(processor.GetRenderPlan().HasStage(RenderStage::SATURATION));
+    
+    processor.SetDCIComplianceMode(true);
+    ASSERT_TRUE(processor.GetRenderPlan().HasStage(RenderStage::SATURATION));
+    
+    Image input(16, 16, 3);
+    input.color_space = ColorSpace::P3_D65;
+    for (float& v : input.data) v = 100.0f; // 线性光 cd/m²
+    
+    Image output;
+    ASSERT_TRUE(processor.ProcessFrame(input, output));
+    ASSERT_TRUE(output.color_space == ColorSpace::P3_D65);
+    ASSERT_TRUE(processor.GetRenderPlan().source_cs == ColorSpace::P3_D65);
+    ASSERT_TRUE(processor.GetRenderPlan().HasStage(RenderStage::FROM_WORKING_DOMAIN));
+    
+    return true;
+}
+
+TEST(Processor_ElidedSaturationMatchesFullPath) {
+    // 被裁剪的饱和度阶段是恒等：与强制执行该阶段的结果一致
+    CphParams elided;
+    elided.highlight_detail = 0.0f;
+    elided.sat_base = 1.0f;
+    elided.sat_hi = 1.0f;
+    
+    CphProcessor fast;
+    ASSERT_TRUE(fast.Initialize(elided));
+    ASSERT_FALSE(fast.GetRenderPlan().HasStage(RenderStage::SATURATION));
+    
+    Image input(32, 32, 3);
+    input.color_space = ColorSpace::BT2020_PQ;
+    for (int y = 0; y < input.height; ++y) {
+        for (int x = 0; x < input.width; ++x) {
+            float* pixel = input.GetPixel(x, y);
+            pixel[0] = x / 31.0f;
+            pixel[1] = y / 31.0f;
+            pixel[2] = (x + y) / 62.0f;
+        }
+    }
+    
+    Image fast_output;
+    ASSERT_TRUE(fast.ProcessFrame(input, fast_output));
+    
+    // 参考：在裁剪结果上逐像素补做饱和度与色域处理（sat=1）
+    Image reference = fast_output;
+    for (int y = 0; y < reference.height; ++y) {
+        for (int x = 0; x < reference.width; ++x) {
+            float* pixel = reference.GetPixel(x, y);
+            float lum = std::max(pixel[0], std::max(pixel[1], pixel[2]));
+            ColorSpaceConverter::ApplySaturation(pixel, 1.0f, 1.0f, elided.pivot_pq, lum);
+            ColorSpaceConverter::ApplyGamutProcessing(pixel, ColorSpace::BT2020_PQ, false);
+        }
+    }
+    
+    for (size_t i = 0; i < fast_output.data.size(); ++i) {
+        ASSERT_NEAR(reference.data[i], fast_output.data[i], 1e-5f);
+    }
+    
+    return true;
+}
+
+TEST(Processor_RenderStageErrorMetadata) {
+    // 阶段失败按实际阶段记录："Render stage failed: <阶段名>: <原因>"
+    ASSERT_TRUE(RenderStageErrorCode(RenderStage::HIGHLIGHT_DETAIL) == ErrorCode::HL_FLICKER);
+    ASSERT_TRUE(RenderStageErrorCode(RenderStage::SATURATION) == ErrorCode::NAN_INF);
+    ASSERT_EQ(std::string("ToneMapping"), RenderStageToString(RenderStage::TONE_MAPPING));
+    ASSERT_EQ(std::string("FromWorkingDomain"), RenderStageToString(RenderStage::FROM_WORKING_DOMAIN));
+    
+    return true;
+}
+
+TEST(Processor_RenderPlanSelectsLayout) {
+    CphParams params;
+    RenderPlan plan = RenderPlan::Compile(params, ColorSpace::BT2020_PQ, ColorSpace::BT2020_PQ);
+    ASSERT_TRUE(plan.layout == PixelLayout::PLANAR);
+    
+    // 只剩逐像素曲线时，边界转换无法摊销
+    params.highlight_detail = 0.0f;
+    params.sat_base = 1.0f;
+    params.sat_hi = 1.0f;
+    plan = RenderPlan::Compile(params, ColorSpace::BT2020_PQ, ColorSpace::BT2020_PQ);
+    ASSERT_TRUE(plan.layout == PixelLayout::INTERLEAVED);
+    
+    plan = RenderPlan::Compile(params, ColorSpace::BT2020_PQ, ColorSpace::BT2020_PQ, PixelLayout::PLANAR);
+    ASSERT_TRUE(plan.layout == PixelLayout::PLANAR);
+    
+    return true;
+}
+
+TEST(Processor_PlanarLayoutMatchesInterleaved) {
+    Image input(61, 37, 4);
+    for (int y = 0; y < input.height; ++y) {
+        for (int x = 0; x < input.width; ++x) {
+            float* pixel = input.GetPixel(x, y);
+            pixel[0] = std::fmod(x * 0.037f + y * 0.011f, 1.0f);
+            pixel[1] = std::fmod(x * 0.013f + y * 0.029f, 1.0f);
+            pixel[2] = std::fmod((x ^ y) * 0.021f, 1.0f);
+            pixel[3] = 0.5f + 0.001f * x;
+        }
+    }
+    
+    CphParams params;
+    params.highlight_detail = 0.4f;
+    params.sat_base = 1.05f;
+    params.sat_hi = 0.9f;
+    
+    const bool dci_modes[] = {false, true};
+    for (bool dci : dci_modes) {
+        params.dci_compliance = dci;
+        
+        CphProcessor interleaved;
+        ASSERT_TRUE(interleaved.Initialize(params));
+        interleaved.SetPreferredLayout(PixelLayout::INTERLEAVED);
+        
+        CphProcessor planar;
+        ASSERT_TRUE(planar.Initialize(params));
+        planar.SetPreferredLayout(PixelLayout::PLANAR);
+        ASSERT_TRUE(planar.GetRenderPlan().layout == PixelLayout::PLANAR);
+        
+        Image expected, actual;
+        ASSERT_TRUE(interleaved.ProcessFrame(input, expected));
+        ASSERT_TRUE(planar.ProcessFrame(input, actual));
+        
+        ASSERT_EQ(expected.channels, actual.channels);
+        for (size_t i = 0; i < expected.data.size(); ++i) {
+            ASSERT_NEAR(expected.data[i], actual.data[i], 1e-5f);
+        }
+        ASSERT_EQ(input.GetPixel(60, 36)[3], actual.GetPixel(60, 36)[3]);
+        
+        Statistics a = interleaved.GetStatistics();
+        Statistics b = planar.GetStatistics();
+        ASSERT_NEAR(a.pq_stats.avg_pq, b.pq_stats.avg_pq, 1e-5f);
+        ASSERT_NEAR(a.pq_stats.max_pq, b.pq_stats.max_pq, 1e-5f);
+    }
+    
+    return true;
+}
+
+TEST(Processor_RegionTilesMatchFullFrame) {
+    Image input(53, 41, 4);
+    for (int y = 0; y < input.height; ++y) {
+        for (int x = 0; x < input.width; ++x) {
+            float* pixel = input.GetPixel(x, y);
+            pixel[0] = std::fmod(x * 0.041f + y * 0.017f, 1.0f);
+            pixel[1] = std::fmod(x * 0.019f + y * 0.031f, 1.0f);
+            pixel[2] = std::fmod((x * y) * 0.007f, 1.0f);
+            pixel[3] = 0.25f + 0.002f * y;
+        }
+    }
+    
+    CphParams params;
+    params.highlight_detail = 0.6f;
+    params.sat_base = 1.1f;
+    params.sat_hi = 0.9f;
+    
+    CphProcessor reference;
+    ASSERT_TRUE(reference.Initialize(params));
+    reference.SetPreferredLayout(PixelLayout::PLANAR);
+    Image expected;
+    ASSERT_TRUE(reference.ProcessFrame(input, expected));
+    ASSERT_EQ(HighlightDetailProcessor::kUSMRadius, reference.GetRenderPlan().HaloRadius());
+    
+    // 不规则分块，分块边界落在帧内部，覆盖整帧
+    CphProcessor tiled;
+    ASSERT_TRUE(tiled.Initialize(params));
+    Image output(input.width, input.height, input.channels);
+    const int xs[] = {0, 7, 8, 30, 53};
+    const int ys[] = {0, 1, 20, 41};
+    for (int j = 0; j + 1 < 4; ++j) {
+        for (int i = 0; i + 1 < 5; ++i) {
+            ASSERT_TRUE(tiled.ProcessRegion(input, output, RenderRect(xs[i], ys[j], xs[i + 1], ys[j + 1])));
+        }
+    }
+    ASSERT_EQ(0, tiled.GetStatistics().frame_count);
+    tiled.EndFrame();
+    
+    for (size_t i = 0; i < expected.data.size(); ++i) {
+        ASSERT_EQ(expected.data[i], output.data[i]);
+    }
+    
+    // 按区域分箱、按帧提交的统计与整帧精确统计的差异小于一个箱宽
+    const float bin_width = 1.0f / StatisticsHistogram::kBins;
+    Statistics a = reference.GetStatistics();
+    Statistics b = tiled.GetStatistics();
+    ASSERT_EQ(1, b.frame_count);
+    ASSERT_NEAR(a.pq_stats.min_pq, b.pq_stats.min_pq, bin_width);
+    ASSERT_NEAR(a.pq_stats.avg_pq, b.pq_stats.avg_pq, bin_width);
+    ASSERT_NEAR(a.pq_stats.max_pq, b.pq_stats.max_pq, bin_width);
+    ASSERT_NEAR(a.pq_stats.variance, b.pq_stats.variance, bin_width);
+    
+    // 宿主线程并发渲染分块（共享同一处理器与预分配输出）
+    CphProcessor concurrent;
+    ASSERT_TRUE(concurrent.Initialize(params));
+    Image concurrent_output;
+    concurrent.PrepareRegionOutput(input, concurrent_output);
+    std::vector<std::thread> workers;
+    for (int j = 0; j + 1 < 4; ++j) {
+        workers.emplace_back([&, j]() {
+            for (int i = 0; i + 1 < 5; ++i) {
+                concurrent.ProcessRegion(input, concurrent_output, RenderRect(xs[i], ys[j], xs[i + 1], ys[j + 1]));
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+    concurrent.EndFrame();
+    ASSERT_TRUE(concurrent_output.data == expected.data);
+    ASSERT_NEAR(b.pq_stats.avg_pq, concurrent.GetStatistics().pq_stats.avg_pq, 1e-6f);
+    
+    // 较大σ：光晕随核半径扩大，分块结果仍与整帧一致
+    UnsharpMaskOptions wide;
+    wide.sigma = 3.0f;
+    ASSERT_EQ(6, reference.GetRenderPlan().HaloRadius(wide));
+    reference.SetUnsharpMaskOptions(wide);
+    tiled.SetUnsharpMaskOptions(wide);
+    Image wide_expected;
+    ASSERT_TRUE(reference.ProcessFrame(input, wide_expected));
+    ASSERT_FALSE(wide_expected.data == expected.data);
+    for (int j = 0; j + 1 < 4; ++j) {
+        for (int i = 0; i + 1 < 5; ++i) {
+            ASSERT_TRUE(tiled.ProcessRegion(input, output, RenderRect(xs[i], ys[j], xs[i + 1], ys[j + 1])));
+        }
+    }
+    ASSERT_TRUE(output.data == wide_expected.data);
+    
+    return true;
+}
+
+TEST(Processor_RegionWritesOnlyWindow) {
+    Image input(20, 12, 3);
+    for (size_t i = 0; i < input.data.size(); ++i) {
+        input.data[i] = std::fmod(i * 0.0137f, 1.0f);
+    }
+    
+    CphProcessor processor;
+    ASSERT_TRUE(processor.Initialize(CphParams()));
+    
+    Image output(input.width, input.height, 3);
+    std::fill(output.data.begin(), output.data.end(), -1.0f);
+    
+    // 窗口超出帧边界时按帧裁剪
+    ASSERT_TRUE(processor.ProcessRegion(input, output, RenderRect(15, 8, 40, 40)));
+    for (int y = 0; y < input.height; ++y) {
+        for (int x = 0; x < input.width; ++x) {
+            bool inside = x >= 15 && y >= 8;
+            ASSERT_EQ(inside, output.GetPixel(x, y)[0] >= 0.0f);
+        }
+    }
+    
+    ASSERT_FALSE(processor.ProcessRegion(input, output, RenderRect(30, 0, 40, 5)));
+    ASSERT_FALSE(processor.ProcessRegion(input, output, RenderRect(5, 5, 5, 9)));
+    
+    // 输出须预先按输入分配：尺寸或色彩空间不符时失败且不改动输出
+    Image unprepared;
+    ASSERT_FALSE(processor.ProcessRegion(input, unprepared, RenderRect(0, 0, 4, 4)));
+    ASSERT_TRUE(unprepared.data.empty());
+    output.color_space = ColorSpace::P3_D65;
+    ASSERT_FALSE(processor.ProcessRegion(input, output, RenderRect(0, 0, 4, 4)));
+    ASSERT_TRUE(output.color_space == ColorSpace::P3_D65);
+    processor.PrepareRegionOutput(input, unprepared);
+    processor.PrepareRegionOutput(input, output);
+    ASSERT_TRUE(output.color_space == input.color_space);
+    ASSERT_TRUE(processor.ProcessRegion(input, unprepared, RenderRect(0, 0, 4, 4)));
+    ASSERT_TRUE(processor.ProcessRegion(input, output, RenderRect(0, 0, 4, 4)));
+    
+    return true;
+}
+
+TEST(Processor_ProxyQualityModes) {
+    Image input(64, 48, 4);
+    for (int y = 0; y < input.height; ++y) {
+        for (int x = 0; x < input.width; ++x) {
+            float* pixel = input.GetPixel(x, y);
+            pixel[0] = 0.1f + 0.8f * x / input.width;
+            pixel[1] = 0.2f + 0.6f * y / input.height;
+            pixel[2] = 0.3f + 0.2f * (x + y) / (input.width + input.height);
+            pixel[3] = (x % 4 == 0) ? 1.0f : 0.0f;
+        }
+    }
+    
+    CphParams params;
+    params.highlight_detail = 0.5f;
+    params.sat_base = 1.1f;
+    
+    CphProcessor reference;
+    ASSERT_TRUE(reference.Initialize(params));
+    Image expected;
+    ASSERT_TRUE(reference.ProcessFrame(input, expected));
+    
+    CphProcessor processor;
+    ASSERT_TRUE(processor.Initialize(params));
+    ASSERT_EQ(4, ProxyScaleFactor(ProcessingQuality::PROXY_QUARTER));
+    
+    // 代理尺寸输出：Alpha按块平均
+    processor.SetProcessingQuality(ProcessingQuality::PROXY_QUARTER, false);
+    Image proxy;
+    ASSERT_TRUE(processor.ProcessFrame(input, proxy));
+    ASSERT_EQ(16, proxy.width);
+    ASSERT_EQ(12, proxy.height);
+    ASSERT_EQ(4, proxy.channels);
+    ASSERT_NEAR(0.25f, proxy.GetPixel(3, 5)[3], 1e-6f);
+    ASSERT_TRUE(processor.NeedsFullQualityRender());
+    
+    // 上采样回原尺寸：平滑内容下接近全质量结果，Alpha取自输入
+    const ProcessingQuality proxies[] = {ProcessingQuality::PROXY_HALF, ProcessingQuality::PROXY_QUARTER};
+    for (ProcessingQuality quality : proxies) {
+        processor.SetProcessingQuality(quality);
+        Image upsampled;
+        ASSERT_TRUE(processor.ProcessFrame(input, upsampled));
+        ASSERT_EQ(input.width, upsampled.width);
+        ASSERT_EQ(input.height, upsampled.height);
+        for (int y = 0; y < input.height; ++y) {
+            for (int x = 0; x < input.width; ++x) {
+                for (int c = 0; c < 3; ++c) {
+                    ASSERT_NEAR(expected.GetPixel(x, y)[c], upsampled.GetPixel(x, y)[c], 0.02f);
+                }
+                ASSERT_EQ(input.GetPixel(x, y)[3], upsampled.GetPixel(x, y)[3]);
+            }
+        }
+    }
+    
+    // 切回全质量：同一参数快照，结果与独立的全质量处理器一致
+    processor.SetProcessingQuality(ProcessingQuality::FULL);
+    Image full;
+    ASSERT_TRUE(processor.ProcessFrame(input, full));
+    ASSERT_FALSE(processor.NeedsFullQualityRender());
+    ASSERT_TRUE(full.data == expected.data);
+    
+    return true;
+}
+
+TEST(Processor_StageCacheIncrementalRerender) {
+    Image input(40, 24, 3);
+    for (int y = 0; y < input.height; ++y) {
+        for (int x = 0; x < input.width; ++x) {
+            float* pixel = input.GetPixel(x, y);
+            pixel[0] = 0.1f + 0.8f * x / input.width;
+            pixel[1] = (x + y) % 5 == 0 ? 0.9f : 0.3f;
+            pixel[2] = 0.2f + 0.6f * y / input.height;
+        }
+    }
+    
+    CphParams params;
+    params.highlight_detail = 0.4f;
+    
+    // 参考：每组参数由全新的平面布局处理器整帧计算
+    auto render_reference = [&input](const CphParams& p, Image& out) {
+        CphProcessor reference;
+        reference.SetPreferredLayout(PixelLayout::PLANAR);
+        return reference.Initialize(p) && reference.ProcessFrame(input, out);
+    };
+    
+    CphProcessor processor;
+    ASSERT_TRUE(processor.Initialize(params));
+    Image output;
+    // 默认禁用：带帧ID的路径不缓存任何检查点
+    ASSERT_TRUE(processor.ProcessFrame(input, output, 7));
+    ASSERT_EQ(size_t(0), processor.GetStageCacheStats().entries);
+    processor.SetStageCacheBudget(StageCache::SuggestedMaxBytes(input.width, input.height));
+    ASSERT_TRUE(processor.ProcessFrame(input, output, 7));
+    StageCacheStats stats = processor.GetStageCacheStats();
+    ASSERT_EQ(uint64_t(0), stats.hits);
+    ASSERT_EQ(size_t(2), stats.entries);
+    
+    // 只改饱和度：命中高光细节检查点，结果与整帧重算一致
+    params.sat_base = 1.3f;
+    ASSERT_TRUE(processor.Initialize(params));
+    ASSERT_TRUE(processor.ProcessFrame(input, output, 7));
+    ASSERT_EQ(uint64_t(1), processor.GetStageCacheStats().hits);
+    Image expected;
+    ASSERT_TRUE(render_reference(params, expected));
+    ASSERT_TRUE(output.data == expected.data);
+    
+    // 改高光细节：高光细节检查点失效，命中色调映射检查点
+    params.highlight_detail = 0.8f;
+    ASSERT_TRUE(processor.Initialize(params));
+    ASSERT_TRUE(processor.ProcessFrame(input, output, 7));
+    stats = processor.GetStageCacheStats();
+    ASSERT_EQ(uint64_t(2), stats.hits);
+    ASSERT_EQ(size_t(2), stats.entries);
+    ASSERT_TRUE(render_reference(params, expected));
+    ASSERT_TRUE(output.data == expected.data);
+    
+    // 不同帧ID不命中；预算为0时禁用缓存
+    ASSERT_TRUE(processor.ProcessFrame(input, output, 8));
+    ASSERT_EQ(uint64_t(2), processor.GetStageCacheStats().hits);
+    ASSERT_EQ(uint64_t(0), processor.GetStageCacheStats().rejected);
+    
+    // 预算小于单个检查点：不保存且计入 rejected
+    processor.SetStageCacheBudget(StageCache::SuggestedMaxBytes(input.width, input.height) / 4);
+    ASSERT_EQ(size_t(0), processor.GetStageCacheStats().entries);
+    ASSERT_TRUE(processor.ProcessFrame(input, output, 9));
+    ASSERT_EQ(size_t(0), processor.GetStageCacheStats().entries);
+    ASSERT_EQ(uint64_t(2), processor.GetStageCacheStats().rejected);
+    processor.SetStageCacheBudget(0);
+    ASSERT_EQ(size_t(0), processor.GetStageCacheStats().entries);
+    ASSERT_TRUE(processor.ProcessFrame(input, output, 7));
+    ASSERT_EQ(size_t(0), processor.GetStageCacheStats().entries);
+    ASSERT_TRUE(output.data == expected.data);
+    
+    return true;
+}
+
+TEST(Processor_UnsharpMaskOptionsReachAllPaths) {
+    // 彩色高光纹理（带Alpha），LUMA域与RGB域的结果不同
+    Image input(40, 28, 4);
+    for (int y = 0; y < input.height; ++y) {
+        for (int x = 0; x < input.width; ++x) {
+            float* pixel = input.GetPixel(x, y);
+            float level = 0.6f + 0.3f * std::sin(x * 0.9f) * std::cos(y * 0.7f);
+            pixel[0] = level;
+            pixel[1] = level * 0.7f;
+            pixel[2] = level * 0.4f;
+            pixel[3] = 0.5f;
+        }
+    }
+    
+    CphParams params;
+    params.highlight_detail = 1.0f;
+    params.pivot_pq = 0.3f;
+    UnsharpMaskOptions luma_options;
+    luma_options.detail_domain = DetailDomain::LUMA;
+    
+    CphProcessor rgb;
+    rgb.SetPreferredLayout(PixelLayout::PLANAR);
+    ASSERT_TRUE(rgb.Initialize(params));
+    Image rgb_output;
+    ASSERT_TRUE(rgb.ProcessFrame(input, rgb_output));
+    
+    // 初始化前设置（平面布局）与初始化后设置（交错布局）一致
+    CphProcessor planar;
+    planar.SetPreferredLayout(PixelLayout::PLANAR);
+    planar.SetUnsharpMaskOptions(luma_options);
+    ASSERT_TRUE(planar.Initialize(params));
+    Image expected;
+    ASSERT_TRUE(planar.ProcessFrame(input, expected));
+    ASSERT_FALSE(expected.data == rgb_output.data);
+    
+    CphProcessor interleaved;
+    interleaved.SetPreferredLayout(PixelLayout::INTERLEAVED);
+    ASSERT_TRUE(interleaved.Initialize(params));
+    interleaved.SetUnsharpMaskOptions(luma_options);
+    ASSERT_TRUE(interleaved.GetUnsharpMaskOptions().detail_domain == DetailDomain::LUMA);
+    Image actual;
+    ASSERT_TRUE(interleaved.ProcessFrame(input, actual));
+    for (size_t i = 0; i < expected.data.size(); ++i) {
+        ASSERT_NEAR(expected.data[i], actual.data[i], 1e-5f);
+    }
+    
+    // 编译管线与区域处理
+    std::shared_ptr<const CompiledPipeline> pipeline = planar.GetCompiledPipeline();
+    ASSERT_TRUE(pipeline->GetUnsharpMaskOptions().detail_domain == DetailDomain::LUMA);
+    StreamState state;
+    ASSERT_TRUE(pipeline->ProcessFrame(input, actual, state));
+    ASSERT_TRUE(actual.data == expected.data);
+    
+    Image region_output(input.width, input.height, 4);
+    ASSERT_TRUE(planar.ProcessRegion(input, region_output, RenderRect(0, 0, 40, 13)));
+    ASSERT_TRUE(planar.ProcessRegion(input, region_output, RenderRect(0, 13, 40, 28)));
+    for (size_t i = 0; i < expected.data.size(); ++i) {
+        ASSERT_NEAR(expected.data[i], region_output.data[i], 1e-6f);
+    }
+    
+    // 阶段缓存按选项失效：切回RGB域后不会命中LUMA域的检查点
+    planar.SetStageCacheBudget(StageCache::SuggestedMaxBytes(input.width, input.height));
+    ASSERT_TRUE(planar.ProcessFrame(input, actual, 3));
+    ASSERT_TRUE(actual.data == expected.data);
+    planar.SetUnsharpMaskOptions(UnsharpMaskOptions());
+    ASSERT_TRUE(planar.ProcessFrame(input, actual, 3));
+    ASSERT_TRUE(actual.data == rgb_output.data);
+    
+    return true;
+}
+
+namespace {
+
+// 内存帧来源/去向（测试用）
+class VectorFrameSource : public FrameSource {
+public:
+    explicit VectorFrameSource(const std::vector<Image>& frames) : frames_(frames) {}
+    bool ReadFrame(Image& frame) override {
+        if (next_ >= frames_.size()) return false;
+        frame = frames_[next_++];
+        return true;
+    }
+    
+private:
+    const std::vector<Image>& frames_;
+    size_t next_ = 0;
+};
+
+class VectorFrameSink : public FrameSink {
+public:
+    bool WriteFrame(int64_t index, const Image& frame) override {
+        if (index != static_cast<int64_t>(frames.size())) in_order = false;
+        frames.push_back(frame);
+        return true;
+    }
+    
+    std::vector<Image> frames;
+    bool in_order = true;
+};
+
+// 第 throw_at 次调用时抛出异常的来源/去向
+class ThrowingFrameSource : public VectorFrameSource {
+public:
+    ThrowingFrameSource(const std::vector<Image>& frames, int throw_at)
+        : VectorFrameSource(frames), throw_at_(throw_at) {}
+    bool ReadFrame(Image& frame) override {
+        if (calls_++ == throw_at_) throw std::runtime_error("decoder lost");
+        return VectorFrameSource::ReadFrame(frame);
+    }
+    
+private:
+    int throw_at_;
+    int calls_ = 0;
+};
+
+class ThrowingFrameSink : public VectorFrameSink {
+public:
+    explicit ThrowingFrameSink(int64_t throw_at) : throw_at_(throw_at) {}
+    bool WriteFrame(int64_t index, const Image& frame) override {
+        if (index == throw_at_) throw std::runtime_error("disk full");
+        return VectorFrameSink::WriteFrame(index, frame);
+    }
+    
+private:
+    int64_t throw_at_;
+};
+
+} // namespace
+
+TEST(Processor_ClipMatchesSequentialFrames) {
+    const std::vector<Image> clip = TestFrames::MakeClip(9);
+    CphParams params;
+    params.highlight_detail = 0.6f;
+    
+    CphProcessor reference;
+    reference.SetPreferredLayout(PixelLayout::PLANAR);
+    ASSERT_TRUE(reference.Initialize(params));
+    std::vector<Image> expected(clip.size());
+    for (size_t i = 0; i < clip.size(); ++i) {
+        ASSERT_TRUE(reference.ProcessFrame(clip[i], expected[i]));
+    }
+    
+    CphProcessor processor;
+    ASSERT_TRUE(processor.Initialize(params));
+    VectorFrameSource source(clip);
+    VectorFrameSink sink;
+    ClipOptions options;
+    options.worker_count = 4;
+    options.max_frames_in_flight = 3;
+    ClipResult result = processor.ProcessClip(source, sink, options);
+    ASSERT_TRUE(result.success);
+    ASSERT_EQ(int64_t(9), result.frames_read);
+    ASSERT_EQ(int64_t(9), result.frames_written);
+    ASSERT_TRUE(sink.in_order);
+    for (size_t i = 0; i < clip.size(); ++i) {
+        ASSERT_TRUE(sink.frames[i].data == expected[i].data);
+    }
+    
+    // 统计按帧序合并，与逐帧处理一致
+    Statistics clip_stats = processor.GetStatistics();
+    Statistics reference_stats = reference.GetStatistics();
+    ASSERT_EQ(reference_stats.frame_count, clip_stats.frame_count);
+    ASSERT_NEAR(reference_stats.pq_stats.avg_pq, clip_stats.pq_stats.avg_pq, 1e-6f);
+    ASSERT_NEAR(reference_stats.pq_stats.max_pq, clip_stats.pq_stats.max_pq, 1e-6f);
+    
+    return true;
+}
+
+TEST(Processor_ClipMotionProtectionDeterministic) {
+    const std::vector<Image> clip = TestFrames::MakeClip(8);
+    CphParams params;
+    params.highlight_detail = 1.0f;
+    
+    auto run = [&clip, &params](int workers, bool motion, std::vector<Image>& out) {
+        CphProcessor processor;
+        if (!processor.Initialize(params)) return false;
+        VectorFrameSource source(clip);
+        VectorFrameSink sink;
+        ClipOptions options;
+        options.worker_count = workers;
+        options.motion_protection = motion;
+        bool ok = processor.ProcessClip(source, sink, options).success && sink.in_order;
+        out = sink.frames;
+        return ok;
+    };
+    
+    std::vector<Image> serial, parallel, unprotected;
+    ASSERT_TRUE(run(1, true, serial));
+    ASSERT_TRUE(run(4, true, parallel));
+    ASSERT_TRUE(run(4, false, unprotected));
+    ASSERT_EQ(clip.size(), parallel.size());
+    
+    // 依赖边保证结果与线程数无关；首帧没有前一帧，不受保护影响
+    for (size_t i = 0; i < clip.size(); ++i) {
+        ASSERT_TRUE(serial[i].data == parallel[i].data);
+    }
+    ASSERT_TRUE(parallel[0].data == unprotected[0].data);
+    ASSERT_FALSE(parallel[3].data == unprotected[3].data);
+    
+    return true;
+}
+
+TEST(Processor_ClipHostExceptionsAbort) {
+    const std::vector<Image> clip = TestFrames::MakeClip(8);
+    CphProcessor processor;
+    ASSERT_TRUE(processor.Initialize(CphParams()));
+    ClipOptions options;
+    options.worker_count = 4;
+    // 中止前已写出的帧仍可能在之后记录曲线告警，因此在历史中查找而不是只看最后一条
+    auto logged = [&](const char* text) {
+        for (const ErrorReport& report : processor.GetErrorHistory()) {
+            if (report.message.find(text) != std::string::npos) {
+                return true;
+            }
+        }
+        return false;
+    };
+    
+    // 来源抛出：片段中止并记录，异常不逸出工作线程
+    ThrowingFrameSource source(clip, 3);
+    VectorFrameSink sink;
+    ClipResult result = processor.ProcessClip(source, sink, options);
+    ASSERT_FALSE(result.success);
+    ASSERT_TRUE(logged("Frame source exception: decoder lost"));
+    ASSERT_TRUE(sink.in_order);
+    
+    // 去向抛出：此前的帧按序写出，之后中止
+    processor.ClearErrors();
+    VectorFrameSource good_source(clip);
+    ThrowingFrameSink throwing_sink(2);
+    result = processor.ProcessClip(good_source, throwing_sink, options);
+    ASSERT_FALSE(result.success);
+    ASSERT_EQ(int64_t(2), result.frames_written);
+    ASSERT_EQ(size_t(2), throwing_sink.frames.size());
+    ASSERT_TRUE(logged("Frame sink exception: disk full"));
+    
+    return true;
+}
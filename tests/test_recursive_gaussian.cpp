@@ -0,0 +1,153 @@
+#include "test_framework.h"
+#include "cinema_pro_hdr/recursive_gaussian.h"
+#include "cinema_pro_hdr/highlight_detail.h"
+#include "cinema_pro_hdr/image_planar.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace CinemaProHDR;
+
+namespace {
+
+Image MakeBlurTestImage(int width, int height) {
+    Image image(width, height, 3);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            float* pixel = image.GetPixel(x, y);
+            bool square = (x / 9 + y / 7) % 2 == 0;
+            pixel[0] = square ? 0.9f : 0.1f;
+            pixel[1] = 0.5f + 0.4f * std::sin(x * 0.3f) * std::cos(y * 0.2f);
+            pixel[2] = static_cast<float>(x + y) / (width + height);
+        }
+    }
+    return image;
+}
+
+} // namespace
+
+/**
+ * @brief 测试递归高斯与直接卷积（HighlightDetailUtils::GaussianBlur，半径4σ）的一致性，包括钳制边界
+ */
+TEST(RecursiveGaussian_MatchesDirectBlur) {
+    const int width = 96;
+    const int height = 80;
+    Image input = MakeBlurTestImage(width, height);
+    ImagePlanar planar;
+    PlanarLayout::Deinterleave(input, planar);
+    
+    const float sigmas[] = {1.0f, 2.0f, 4.0f, 8.0f};
+    for (float sigma : sigmas) {
+        Image reference;
+        HighlightDetailUtils::GaussianBlur(input, reference, static_cast<int>(std::ceil(4.0f * sigma)), sigma);
+        
+        RecursiveGaussian blur(sigma);
+        ImageBuffer scratch;
+        ImageBuffer result(planar.GetPixelCount());
+        const int margin = static_cast<int>(std::ceil(3.0f * sigma));
+        for (int c = 0; c < 3; ++c) {
+            blur.BlurPlane(planar.Plane(c), result.data(), width, height, scratch);
+            float interior_error = 0.0f;
+            float edge_error = 0.0f;
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    float error = std::abs(result[y * width + x] - reference.GetPixel(x, y)[c]);
+                    bool interior = x >= margin && x < width - margin && y >= margin && y < height - margin;
+                    (interior ? interior_error : edge_error) = std::max(interior ? interior_error : edge_error, error);
+                }
+            }
+            // IIR对高斯形状的近似误差随σ增大而减小（硬边缘反差0.8）
+            const float tolerance = sigma < 4.0f ? 0.06f : 0.02f;
+            ASSERT_TRUE(interior_error < tolerance);
+            ASSERT_TRUE(edge_error < tolerance);
+        }
+    }
+    
+    return true;
+}
+
+/**
+ * @brief 测试直流增益、原地处理与极小尺寸
+ */
+TEST(RecursiveGaussian_ConstantAndInPlace) {
+    RecursiveGaussian blur(6.0f);
+    ImageBuffer scratch;
+    
+    const int sizes[][2] = {{1, 1}, {1, 7}, {5, 1}, {2, 3}, {33, 17}};
+    for (const auto& size : sizes) {
+        std::vector<float> plane(size[0] * size[1], 0.6f);
+        blur.BlurPlane(plane.data(), plane.data(), size[0], size[1], scratch);
+        for (float value : plane) {
+            ASSERT_NEAR(0.6f, value, 1e-4f);
+        }
+    }
+    
+    // 原地与非原地结果一致
+    const int width = 40;
+    const int height = 24;
+    std::vector<float> src(width * height);
+    for (size_t i = 0; i < src.size(); ++i) {
+        src[i] = static_cast<float>((i * 37) % 11) / 10.0f;
+    }
+    std::vector<float> out(src.size());
+    std::vector<float> in_place = src;
+    blur.BlurPlane(src.data(), out.data(), width, height, scratch);
+    blur.BlurPlane(in_place.data(), in_place.data(), width, height, scratch);
+    ASSERT_TRUE(out == in_place);
+    
+    // σ低于下限时钳制
+    ASSERT_NEAR(RecursiveGaussian::kMinSigma, RecursiveGaussian(0.1f).GetSigma(), 1e-6f);
+    
+    return true;
+}
+
+/**
+ * @brief 测试高光细节处理器的模糊实现选择（大σ）：交错与平面路径一致，结果接近直接卷积
+ */
+TEST(RecursiveGaussian_HighlightDetailSelection) {
+    CphParams params;
+    params.highlight_detail = 0.8f;
+    params.pivot_pq = 0.3f;
+    
+    HighlightDetailProcessor default_sigma;
+    HighlightDetailProcessor direct;
+    HighlightDetailProcessor recursive;
+    ASSERT_TRUE(default_sigma.Initialize(params));
+    ASSERT_TRUE(direct.Initialize(params));
+    ASSERT_TRUE(recursive.Initialize(params));
+    ASSERT_TRUE(direct.GetGaussianMethod() == GaussianMethod::DIRECT);
+    UnsharpMaskOptions options;
+    options.sigma = 4.0f;
+    direct.SetUnsharpMaskOptions(options);
+    options.gaussian_method = GaussianMethod::RECURSIVE;
+    recursive.SetUnsharpMaskOptions(options);
+    ASSERT_EQ(8, HighlightDetailProcessor::ScaledUSMRadius(1.0f, options.sigma));
+    ASSERT_EQ(HighlightDetailProcessor::kUSMRadius, HighlightDetailProcessor::ScaledUSMRadius(1.0f));
+    
+    Image input = MakeBlurTestImage(64, 48);
+    Image default_output;
+    Image direct_output;
+    Image recursive_output;
+    ASSERT_TRUE(default_sigma.ProcessFrame(input, default_output, params.pivot_pq));
+    ASSERT_TRUE(direct.ProcessFrame(input, direct_output, params.pivot_pq));
+    ASSERT_TRUE(recursive.ProcessFrame(input, recursive_output, params.pivot_pq));
+    ASSERT_FALSE(default_output.data == direct_output.data);
+    ASSERT_FALSE(direct_output.data == recursive_output.data);
+    
+    ImagePlanar planar;
+    ImagePlanar planar_output;
+    PlanarLayout::Deinterleave(input, planar);
+    ASSERT_TRUE(recursive.ProcessFramePlanar(planar, planar_output, params.pivot_pq));
+    Image interleaved;
+    PlanarLayout::Interleave(planar_output, interleaved, &input);
+    
+    float max_diff = 0.0f;
+    float max_path_diff = 0.0f;
+    for (size_t i = 0; i < recursive_output.data.size(); ++i) {
+        max_diff = std::max(max_diff, std::abs(recursive_output.data[i] - direct_output.data[i]));
+        max_path_diff = std::max(max_path_diff, std::abs(recursive_output.data[i] - interleaved.data[i]));
+    }
+    ASSERT_TRUE(max_path_diff < 1e-5f);
+    ASSERT_TRUE(max_diff < 0.05f);
+    
+    return true;
+}
@@ -0,0 +1,178 @@
+#include "test_framework.h"
+#include "test_frames.h"
+#include "cinema_pro_hdr/scanline.h"
+#include "cinema_pro_hdr/highlight_detail.h"
+
+using namespace CinemaProHDR;
+
+namespace {
+
+// 从整帧按行读出
+class ImageRowSource : public ScanlineSource {
+public:
+    explicit ImageRowSource(const Image& image, int fail_at = -1) : image_(image), fail_at_(fail_at) {}
+    
+    bool ReadRow(int y, float* row) override {
+        if (y == fail_at_ || y != next_) {
+            return false;
+        }
+        next_++;
+        const size_t size = static_cast<size_t>(image_.width) * image_.channels;
+        std::copy(image_.data.begin() + y * size, image_.data.begin() + (y + 1) * size, row);
+        return true;
+    }
+    
+private:
+    const Image& image_;
+    int fail_at_;
+    int next_ = 0;
+};
+
+// 按行写回整帧，并检查行序
+class ImageRowSink : public ScanlineSink {
+public:
+    ImageRowSink(int width, int height, int channels) : image(width, height, channels) {}
+    
+    bool WriteRow(int y, const float* row) override {
+        if (y != next_) {
+            return false;
+        }
+        next_++;
+        const size_t size = static_cast<size_t>(image.width) * image.channels;
+        std::copy(row, row + size, image.data.begin() + y * size);
+        return true;
+    }
+    
+    Image image;
+    
+private:
+    int next_ = 0;
+};
+
+} // namespace
+
+/**
+ * @brief 测试扫描线处理与整帧处理逐位一致（含Alpha通道、非PQ色彩空间、极矮的帧、两种细节域与较大σ）
+ */
+TEST(Scanline_MatchesFrameProcessing) {
+    CphParams params;
+    params.highlight_detail = 0.6f;
+    params.sat_base = 1.2f;
+    
+    const int sizes[][3] = {{37, 23, 4}, {16, 1, 3}, {9, 2, 3}, {12, 5, 4}};
+    const ColorSpace spaces[] = {ColorSpace::BT2020_PQ, ColorSpace::P3_D65};
+    UnsharpMaskOptions option_sets[3];
+    option_sets[1].detail_domain = DetailDomain::LUMA;
+    option_sets[2].sigma = 2.5f;  // 半径5，窗口11行
+    for (const UnsharpMaskOptions& usm_options : option_sets) {
+        for (ColorSpace cs : spaces) {
+            std::vector<ErrorReport> errors;
+            std::shared_ptr<const CompiledPipeline> pipeline = CompiledPipeline::Compile(params, errors, usm_options);
+            ASSERT_TRUE(pipeline != nullptr);
+            ScanlineStream stream(pipeline);
+            
+            for (const auto& size : sizes) {
+                Image input = TestFrames::MakeFrame({size[0], size[1], size[2]});
+                input.color_space = cs;
+                
+                StreamState frame_state;
+                Image expected;
+                ASSERT_TRUE(pipeline->ProcessFrame(input, expected, frame_state));
+                
+                ScanlineFormat format;
+                format.width = size[0];
+                format.height = size[1];
+                format.channels = size[2];
+                format.color_space = cs;
+                ImageRowSource source(input);
+                ImageRowSink sink(size[0], size[1], size[2]);
+                StreamState state;
+                ASSERT_TRUE(stream.ProcessFrame(format, source, sink, state));
+                ASSERT_TRUE(sink.image.data == expected.data);
+                
+                // 定长直方图统计与精确统计的差异在一个箱宽以内
+                const float bin = 1.0f / StatisticsHistogram::kBins;
+                ASSERT_EQ(1, state.stats.frame_count);
+                ASSERT_NEAR(frame_state.stats.pq_stats.min_pq, state.stats.pq_stats.min_pq, bin);
+                ASSERT_NEAR(frame_state.stats.pq_stats.max_pq, state.stats.pq_stats.max_pq, bin);
+                ASSERT_NEAR(frame_state.stats.pq_stats.avg_pq, state.stats.pq_stats.avg_pq, bin);
+                ASSERT_NEAR(frame_state.stats.pq_stats.variance, state.stats.pq_stats.variance, bin);
+            }
+        }
+    }
+    
+    return true;
+}
+
+/**
+ * @brief 测试工作内存只与宽度和窗口行数有关
+ */
+TEST(Scanline_BoundedWorkingMemory) {
+    CphParams params;
+    params.highlight_detail = 0.5f;
+    std::vector<ErrorReport> errors;
+    ScanlineStream stream(CompiledPipeline::Compile(params, errors));
+    
+    const int width = 512;
+    const int height = 384;
+    Image input = TestFrames::MakeFrame({width, height, 3});
+    ScanlineFormat format;
+    format.width = width;
+    format.height = height;
+    ImageRowSource source(input);
+    ImageRowSink sink(width, height, 3);
+    StreamState state;
+    ASSERT_TRUE(stream.ProcessFrame(format, source, sink, state));
+    
+    // USM半径2：输入窗口3行，模糊窗口5行
+    ASSERT_EQ(HighlightDetailProcessor::kUSMRadius + 1, stream.GetWindowRows());
+    const size_t frame_bytes = input.data.size() * sizeof(float);
+    const size_t window_bytes = stream.GetWorkingMemoryBytes();
+    ASSERT_TRUE(window_bytes < frame_bytes / 10);
+    
+    // 帧高加倍不改变工作内存
+    Image tall = TestFrames::MakeFrame({width, 2 * height, 3});
+    format.height = 2 * height;
+    ImageRowSource tall_source(tall);
+    ImageRowSink tall_sink(width, 2 * height, 3);
+    ASSERT_TRUE(stream.ProcessFrame(format, tall_source, tall_sink, state));
+    ASSERT_EQ(window_bytes, stream.GetWorkingMemoryBytes());
+    ASSERT_EQ(2, state.stats.frame_count);
+    
+    // 没有高光细节阶段时每行进入即离开
+    params.highlight_detail = 0.0f;
+    ScanlineStream plain(CompiledPipeline::Compile(params, errors));
+    ImageRowSource plain_source(input);
+    ImageRowSink plain_sink(width, height, 3);
+    format.height = height;
+    ASSERT_TRUE(plain.ProcessFrame(format, plain_source, plain_sink, state));
+    ASSERT_EQ(1, plain.GetWindowRows());
+    
+    return true;
+}
+
+/**
+ * @brief 测试来源失败与非法格式
+ */
+TEST(Scanline_SourceFailure) {
+    CphParams params;
+    params.highlight_detail = 0.5f;
+    std::vector<ErrorReport> errors;
+    ScanlineStream stream(CompiledPipeline::Compile(params, errors));
+    
+    Image input = TestFrames::MakeFrame({8, 8, 3});
+    ScanlineFormat format;
+    format.width = 8;
+    format.height = 8;
+    ImageRowSource source(input, 5);
+    ImageRowSink sink(8, 8, 3);
+    StreamState state;
+    ASSERT_FALSE(stream.ProcessFrame(format, source, sink, state));
+    ASSERT_TRUE(state.GetLastError().find("Scanline source failed: row 5") != std::string::npos);
+    ASSERT_EQ(0, state.stats.frame_count);
+    
+    format.channels = 2;
+    ASSERT_FALSE(stream.ProcessFrame(format, source, sink, state));
+    
+    return true;
+}
@@ -0,0 +1,257 @@
+#include "test_framework.h"
+#include "cinema_pro_hdr/shot_analyzer.h"
+#include "cinema_pro_hdr/color_space.h"
+#include "cinema_pro_hdr/pipeline.h"
+#include "cinema_pro_hdr/scanline.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace CinemaProHDR;
+
+namespace {
+
+// 灰阶平面：取值在 [lo, hi] 内按像素序号与帧号轻微起伏
+StatisticsHistogram MakeFrameHistogram(float lo, float hi, int frame) {
+    const size_t count = 4096;
+    std::vector<float> plane(count);
+    for (size_t i = 0; i < count; ++i) {
+        float t = static_cast<float>((i * 37 + frame * 11) % count) / count;
+        plane[i] = lo + (hi - lo) * t;
+    }
+    StatisticsHistogram histogram;
+    histogram.AddPixels(plane.data(), plane.data(), plane.data(), count);
+    return histogram;
+}
+
+float ApplyShotMapping(const ShotMetadata& shot, float x, float target_min, float target_max) {
+    float normalized = std::clamp(shot.gain * x + shot.offset, 0.0f, 1.0f);
+    return target_min + (target_max - target_min) * std::pow(normalized, shot.gamma);
+}
+
+} // namespace
+
+/**
+ * @brief 测试硬切分成独立镜头，记录按顺序交付
+ */
+TEST(ShotAnalyzer_DetectsCuts) {
+    std::vector<ShotMetadata> shots;
+    ShotAnalyzer analyzer(ShotAnalyzerConfig(), [&](const ShotMetadata& shot) { shots.push_back(shot); });
+
+    const float ranges[][2] = {{0.05f, 0.25f}, {0.45f, 0.85f}, {0.2f, 0.5f}};
+    int cuts = 0;
+    for (int s = 0; s < 3; ++s) {
+        for (int f = 0; f < 20; ++f) {
+            if (analyzer.AddFrame(MakeFrameHistogram(ranges[s][0], ranges[s][1], f))) {
+                cuts++;
+            }
+        }
+    }
+    ASSERT_EQ(2, cuts);
+    ASSERT_EQ(2u, shots.size());
+    ASSERT_TRUE(analyzer.Flush());
+    ASSERT_FALSE(analyzer.Flush());
+    ASSERT_EQ(3u, shots.size());
+    ASSERT_EQ(3u, analyzer.GetShotCount());
+
+    for (int s = 0; s < 3; ++s) {
+        ASSERT_EQ(static_cast<uint64_t>(s * 20), shots[s].first_frame);
+        ASSERT_EQ(20u, shots[s].frame_count);
+        // 1%截尾后的最小、最大值落在本镜头的取值范围内
+        ASSERT_NEAR(ranges[s][0], shots[s].min_pq, 0.01f);
+        ASSERT_NEAR(ranges[s][1], shots[s].max_pq, 0.01f);
+        ASSERT_NEAR(0.5f * (ranges[s][0] + ranges[s][1]), shots[s].avg_pq, 0.01f);
+    }
+
+    return true;
+}
+
+/**
+ * @brief 测试缓慢变化（渐亮）不被判为切点
+ */
+TEST(ShotAnalyzer_GradualChangeStaysOneShot) {
+    ShotAnalyzer analyzer;
+    for (int f = 0; f < 120; ++f) {
+        float lo = 0.05f + 0.004f * f;
+        ASSERT_FALSE(analyzer.AddFrame(MakeFrameHistogram(lo, lo + 0.2f, f)));
+        ASSERT_LT(analyzer.GetLastDistance(), 0.35f);
+    }
+    ASSERT_EQ(0u, analyzer.GetShotCount());
+    ASSERT_EQ(120u, analyzer.GetFrameCount());
+
+    return true;
+}
+
+/**
+ * @brief 测试映射参数把镜头最小/平均/最大值映射到目标显示的对应位置
+ */
+TEST(ShotAnalyzer_FitsTargetDisplay) {
+    ShotAnalyzerConfig config;
+    ShotAnalyzer analyzer(config);
+    const float target_min = ColorSpaceConverter::PQ_OETF(config.target_min_nits);
+    const float target_avg = ColorSpaceConverter::PQ_OETF(config.target_avg_nits);
+    const float target_max = ColorSpaceConverter::PQ_OETF(config.target_max_nits);
+
+    ShotMetadata shot;
+    shot.min_pq = 0.02f;
+    shot.avg_pq = 0.35f;
+    shot.max_pq = 0.78f;
+    analyzer.FitToneMapping(shot);
+    ASSERT_NEAR(target_min, ApplyShotMapping(shot, shot.min_pq, target_min, target_max), 1e-5f);
+    ASSERT_NEAR(target_avg, ApplyShotMapping(shot, shot.avg_pq, target_min, target_max), 1e-4f);
+    ASSERT_NEAR(target_max, ApplyShotMapping(shot, shot.max_pq, target_min, target_max), 1e-5f);
+
+    // 平坦镜头整体映射到目标平均值
+    ShotMetadata flat;
+    flat.min_pq = flat.avg_pq = flat.max_pq = 0.4f;
+    analyzer.FitToneMapping(flat);
+    ASSERT_NEAR(target_avg, ApplyShotMapping(flat, 0.4f, target_min, target_max), 1e-5f);
+
+    return true;
+}
+
+/**
+ * @brief 测试整帧与扫描线处理在统计阶段喂入分析器，两条路径判定一致
+ */
+TEST(ShotAnalyzer_FedByPipeline) {
+    CphParams params;
+    std::vector<ErrorReport> errors;
+    std::shared_ptr<const CompiledPipeline> pipeline = CompiledPipeline::Compile(params, errors);
+    ASSERT_TRUE(pipeline != nullptr);
+
+    ShotAnalyzer frame_analyzer;
+    ShotAnalyzer scan_analyzer;
+    StreamState frame_state;
+    frame_state.shot_analyzer = &frame_analyzer;
+    StreamState scan_state;
+    scan_state.shot_analyzer = &scan_analyzer;
+    ScanlineStream stream(pipeline);
+
+    const int width = 32;
+    const int height = 16;
+    for (int f = 0; f < 16; ++f) {
+        const float base = f < 8 ? 0.1f : 0.6f;
+        Image input(width, height, 3);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                float* pixel = input.GetPixel(x, y);
+                pixel[0] = pixel[1] = pixel[2] = base + 0.2f * x / width + 0.001f * f;
+            }
+        }
+        Image output;
+        ASSERT_TRUE(pipeline->ProcessFrame(input, output, frame_state));
+
+        class Source : public ScanlineSource {
+        public:
+            explicit Source(const Image& image) : image_(image) {}
+            bool ReadRow(int y, float* row) override {
+                std::copy(image_.GetPixel(0, y), image_.GetPixel(0, y) + image_.width * 3, row);
+                return true;
+            }
+        private:
+            const Image& image_;
+        } source(input);
+        class Sink : public ScanlineSink {
+        public:
+            bool WriteRow(int, const float*) override { return true; }
+        } sink;
+        ScanlineFormat format;
+        format.width = width;
+        format.height = height;
+        ASSERT_TRUE(stream.ProcessFrame(format, source, sink, scan_state));
+    }
+
+    ASSERT_EQ(16u, frame_analyzer.GetFrameCount());
+    ASSERT_EQ(16u, scan_analyzer.GetFrameCount());
+    ASSERT_EQ(1u, frame_analyzer.GetShotCount());
+    ASSERT_EQ(1u, scan_analyzer.GetShotCount());
+
+    return true;
+}
+
+/**
+ * @brief 测试处理器各路径（交错、平面、区域、片段）喂入镜头分析器，代理帧不喂入
+ */
+TEST(ShotAnalyzer_FedByProcessor) {
+    const int width = 32;
+    const int height = 16;
+    std::vector<Image> clip;
+    for (int f = 0; f < 16; ++f) {
+        const float base = f < 8 ? 0.1f : 0.6f;
+        Image input(width, height, 3);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                float* pixel = input.GetPixel(x, y);
+                pixel[0] = pixel[1] = pixel[2] = base + 0.2f * x / width + 0.001f * f;
+            }
+        }
+        clip.push_back(input);
+    }
+
+    const PixelLayout layouts[] = {PixelLayout::INTERLEAVED, PixelLayout::PLANAR};
+    for (PixelLayout layout : layouts) {
+        CphProcessor processor;
+        processor.SetPreferredLayout(layout);
+        ASSERT_TRUE(processor.Initialize(CphParams()));
+        ShotAnalyzer analyzer;
+        processor.SetShotAnalyzer(&analyzer);
+        Image output;
+        for (const Image& frame : clip) {
+            ASSERT_TRUE(processor.ProcessFrame(frame, output));
+        }
+        processor.SetProcessingQuality(ProcessingQuality::PROXY_HALF);
+        ASSERT_TRUE(processor.ProcessFrame(clip[0], output));
+        ASSERT_EQ(16u, analyzer.GetFrameCount());
+        ASSERT_EQ(1u, analyzer.GetShotCount());
+        processor.SetShotAnalyzer(nullptr);
+        processor.SetProcessingQuality(ProcessingQuality::FULL);
+        ASSERT_TRUE(processor.ProcessFrame(clip[0], output));
+        ASSERT_EQ(16u, analyzer.GetFrameCount());
+    }
+
+    // 区域处理：EndFrame提交一帧
+    CphProcessor regions;
+    ASSERT_TRUE(regions.Initialize(CphParams()));
+    ShotAnalyzer region_analyzer;
+    regions.SetShotAnalyzer(&region_analyzer);
+    Image region_output(width, height, 3);
+    for (const Image& frame : clip) {
+        ASSERT_TRUE(regions.ProcessRegion(frame, region_output, RenderRect(0, 0, width, height / 2)));
+        ASSERT_TRUE(regions.ProcessRegion(frame, region_output, RenderRect(0, height / 2, width, height)));
+        regions.EndFrame();
+    }
+    ASSERT_EQ(16u, region_analyzer.GetFrameCount());
+    ASSERT_EQ(1u, region_analyzer.GetShotCount());
+
+    // 片段处理：按帧序喂入，切点与线程数无关
+    class ClipSource : public FrameSource {
+    public:
+        explicit ClipSource(const std::vector<Image>& frames) : frames_(frames) {}
+        bool ReadFrame(Image& frame) override {
+            if (next_ >= frames_.size()) return false;
+            frame = frames_[next_++];
+            return true;
+        }
+    private:
+        const std::vector<Image>& frames_;
+        size_t next_ = 0;
+    } source(clip);
+    class NullSink : public FrameSink {
+    public:
+        bool WriteFrame(int64_t, const Image&) override { return true; }
+    } sink;
+    CphProcessor clip_processor;
+    ASSERT_TRUE(clip_processor.Initialize(CphParams()));
+    std::vector<ShotMetadata> shots;
+    ShotAnalyzer clip_analyzer(ShotAnalyzerConfig(), [&](const ShotMetadata& shot) { shots.push_back(shot); });
+    clip_processor.SetShotAnalyzer(&clip_analyzer);
+    ClipOptions options;
+    options.worker_count = 4;
+    ASSERT_TRUE(clip_processor.ProcessClip(source, sink, options).success);
+    ASSERT_EQ(16u, clip_analyzer.GetFrameCount());
+    ASSERT_TRUE(clip_analyzer.Flush());
+    ASSERT_EQ(size_t(2), shots.size());
+    ASSERT_EQ(uint64_t(8), shots[1].first_frame);
+
+    return true;
+}
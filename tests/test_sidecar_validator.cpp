@@ -0,0 +1,150 @@
+#include "test_framework.h"
+#include "cinema_pro_hdr/sidecar_validator.h"
+#include "cinema_pro_hdr/sidecar_writer.h"
+#include "cinema_pro_hdr/processor.h"
+#include <cstdio>
+
+using namespace CinemaProHDR;
+
+namespace {
+
+const char* kValidRecord =
+    "{\"st2094_10\": {\"minPqEncodedMaxRGB\": 0.01, \"avgPqEncodedMaxRGB\": 0.3, "
+    "\"maxPqEncodedMaxRGB\": 0.75, \"offset\": -0.0135, \"gain\": 1.35, \"gamma\": 1.2},\n"
+    " \"cph_meta\": {\"cph_version\": 2, \"cph_curve_id\": 0, \"pivot\": 0.05, \"shoulder\": 1.5,"
+    " \"work_cs\": \"BT2020_PQ\", \"hash_clip_guid\": \"3f2a9c4e-1b7d-4e0a-9c55-7d2e8f10ab34\","
+    " \"timecode_inout\": \"01:00:00:00-01:00:01:23\", \"generator\": \"grade \\\"v2\\\" \\u00e9\"}}";
+
+SidecarCheckResult Check(const std::string& text) {
+    return SidecarValidator::Validate(text.data(), text.size());
+}
+
+std::string Replace(std::string text, const std::string& from, const std::string& to) {
+    text.replace(text.find(from), from.size(), to);
+    return text;
+}
+
+bool HasError(const SidecarCheckResult& result, ErrorCode code, const std::string& field) {
+    for (const auto& error : result.errors) {
+        if (error.code == code && error.field_name == field) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+/**
+ * @brief 测试合法的单记录文档（范围端点按 float 比较，pivot=0.05 合法）
+ */
+TEST(SidecarValidator_AcceptsValidRecord) {
+    SidecarCheckResult result = Check(kValidRecord);
+    ASSERT_TRUE(result.valid);
+    ASSERT_EQ(1u, result.record_count);
+    ASSERT_TRUE(result.errors.empty());
+    return true;
+}
+
+/**
+ * @brief 测试逐字段错误码：越界、缺失、未知字段、类型与格式
+ */
+TEST(SidecarValidator_ReportsFieldErrors) {
+    std::string text = Replace(kValidRecord, "\"pivot\": 0.05", "\"pivot\": 0.31");
+    text = Replace(text, "\"gain\": 1.35", "\"gain\": 4.5");
+    text = Replace(text, "\"shoulder\": 1.5,", "\"shoulder\": \"1.5\", \"extra\": [1, {\"a\": null}],");
+    text = Replace(text, "\"cph_version\": 2", "\"cph_version\": 3");
+    text = Replace(text, "01:00:01:23", "01:00:01:73");
+    text = Replace(text, "\"offset\": -0.0135, ", "");
+
+    SidecarCheckResult result = Check(text);
+    ASSERT_FALSE(result.valid);
+    ASSERT_EQ(7u, result.errors.size());
+    ASSERT_TRUE(HasError(result, ErrorCode::RANGE_PIVOT, "cph_meta.pivot"));
+    ASSERT_TRUE(HasError(result, ErrorCode::RANGE_PIVOT, "st2094_10.gain"));
+    ASSERT_TRUE(HasError(result, ErrorCode::SCHEMA_MISSING, "cph_meta.shoulder"));
+    ASSERT_TRUE(HasError(result, ErrorCode::SCHEMA_MISSING, "cph_meta.extra"));
+    ASSERT_TRUE(HasError(result, ErrorCode::SCHEMA_MISSING, "cph_meta.cph_version"));
+    ASSERT_TRUE(HasError(result, ErrorCode::SCHEMA_MISSING, "st2094_10.offset"));
+    ASSERT_TRUE(HasError(result, ErrorCode::SCHEMA_MISSING, "cph_meta.timecode_inout"));
+
+    // 越界值与记录标识随错误一并报告
+    for (const auto& error : result.errors) {
+        if (error.field_name == "cph_meta.pivot") {
+            ASSERT_NEAR(0.31f, error.invalid_value, 1e-6f);
+        }
+        ASSERT_TRUE(error.clip_guid == "3f2a9c4e-1b7d-4e0a-9c55-7d2e8f10ab34");
+    }
+
+    result = Check(Replace(kValidRecord, "\"pivot\": 0.05", "\"pivot\": 1e999"));
+    ASSERT_TRUE(HasError(result, ErrorCode::NAN_INF, "cph_meta.pivot"));
+    result = Check(Replace(kValidRecord, "\"work_cs\": \"BT2020_PQ\", ", ""));
+    ASSERT_TRUE(HasError(result, ErrorCode::SCHEMA_MISSING, "cph_meta.work_cs"));
+    return true;
+}
+
+/**
+ * @brief 测试语法错误：报告行号并停止解析
+ */
+TEST(SidecarValidator_RejectsMalformedJson) {
+    const char* cases[] = {"", "[]", "{\"st2094_10\": {\"gain\": 01}}", "{\"cph_meta\": {"};
+    for (int i = 0; i < 4; ++i) {
+        SidecarCheckResult result = Check(cases[i]);
+        ASSERT_FALSE(result.valid);
+        ASSERT_EQ(1u, result.errors.size());
+        ASSERT_TRUE(result.errors[0].message.find("Syntax error") == 0);
+    }
+
+    SidecarCheckResult result = Check(std::string(kValidRecord) + ",");
+    ASSERT_EQ(1u, result.errors.size());
+    ASSERT_TRUE(result.errors[0].message.find("line 2") != std::string::npos);
+    return true;
+}
+
+/**
+ * @brief 测试 SidecarWriter 的输出可通过校验，段错误带数组下标
+ */
+TEST(SidecarValidator_RoundTripsWriterOutput) {
+    const std::string path = "cph_test_validator.json";
+    CphParams params;
+    params.curve = CurveType::RLOG;
+    SidecarClipInfo clip;
+    clip.clip_guid = "3f2a9c4e-1b7d-4e0a-9c55-7d2e8f10ab34";
+    clip.start_frame = 86400;
+
+    SidecarWriter writer;
+    ASSERT_TRUE(writer.Open(path, params, clip));
+    ShotMetadata shot;
+    for (uint64_t i = 0; i < 3; ++i) {
+        shot.first_frame = i * 24;
+        shot.frame_count = 24;
+        shot.max_pq = 0.5f;
+        ASSERT_TRUE(writer.WriteRecord(shot));
+    }
+    ASSERT_TRUE(writer.Close());
+
+    SidecarCheckResult result = SidecarValidator::ValidateFile(path);
+    std::remove(path.c_str());
+    ASSERT_TRUE(result.valid);
+    ASSERT_EQ(3u, result.record_count);
+
+    // 写出端与校验端共用同一张范围表：CphParams 判定越界的参数在侧车中同样越界
+    params.sat_hi = ParamRanges::SAT_HI.max_value + 0.01f;
+    ASSERT_FALSE(params.IsValid());
+    std::vector<ErrorReport> errors;
+    ASSERT_FALSE(ParamValidator::ValidateCommonParams(params, errors));
+    ASSERT_TRUE(errors.size() == 1 && errors[0].field_name == "sat_hi");
+
+    std::string segments = std::string("{\"segments\": [\n") + kValidRecord + ",\n" + kValidRecord + "\n]}";
+    ASSERT_TRUE(Check(segments).valid);
+    segments = Replace(segments, "01:00:01:23\", \"generator\": \"grade \\\"v2\\\" \\u00e9\"}}\n]",
+                       "01:00:01:23\", \"sat_hi\": 2.5}}\n]");
+    result = Check(segments);
+    ASSERT_EQ(2u, result.record_count);
+    ASSERT_TRUE(HasError(result, ErrorCode::RANGE_PIVOT, "segments[1].cph_meta.sat_hi"));
+    ASSERT_TRUE(result.errors[0].timecode == "01:00:00:00-01:00:01:23");
+
+    result = SidecarValidator::ValidateFile("cph_test_missing_sidecar.json");
+    ASSERT_FALSE(result.valid);
+    return true;
+}
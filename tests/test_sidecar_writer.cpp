@@ -0,0 +1,116 @@
+#include "test_framework.h"
+#include "cinema_pro_hdr/sidecar_writer.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace CinemaProHDR;
+
+namespace {
+
+const char* kTestGuid = "3f2a9c4e-1b7d-4e0a-9c55-7d2e8f10ab34";
+
+std::string ReadFile(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+ShotMetadata MakeShot(uint64_t first_frame, uint64_t frame_count) {
+    ShotMetadata shot;
+    shot.first_frame = first_frame;
+    shot.frame_count = frame_count;
+    shot.min_pq = 0.01f;
+    shot.avg_pq = 0.3f;
+    shot.max_pq = 0.75f;
+    shot.offset = -0.0135f;
+    shot.gain = 1.35f;
+    shot.gamma = 1.2f;
+    return shot;
+}
+
+} // namespace
+
+/**
+ * @brief 测试时间码格式化与UUID检查
+ */
+TEST(Sidecar_TimecodeAndGuid) {
+    char timecode[SidecarWriter::kTimecodeLength + 1] = {};
+    ASSERT_TRUE(SidecarWriter::FormatTimecode(86400, 24, timecode));
+    ASSERT_TRUE(std::string(timecode) == "01:00:00:00");
+    ASSERT_TRUE(SidecarWriter::FormatTimecode(86400 + 60 * 25 + 23, 25, timecode));
+    ASSERT_TRUE(std::string(timecode) == "00:58:36:23");
+    ASSERT_FALSE(SidecarWriter::FormatTimecode(24ull * 3600 * 24, 24, timecode));
+    ASSERT_FALSE(SidecarWriter::FormatTimecode(0, 0, timecode));
+
+    ASSERT_TRUE(SidecarWriter::IsValidGuid(kTestGuid));
+    ASSERT_FALSE(SidecarWriter::IsValidGuid("3f2a9c4e1b7d4e0a9c557d2e8f10ab34"));
+    ASSERT_FALSE(SidecarWriter::IsValidGuid("3f2a9c4e-1b7d-4e0a-9c55-7d2e8f10ab3g"));
+
+    return true;
+}
+
+/**
+ * @brief 测试逐镜头追加写出：记录按时间码分段，文档在Close后闭合
+ */
+TEST(Sidecar_StreamsShotRecords) {
+    const std::string path = "cph_test_sidecar.json";
+    CphParams params;
+    params.pivot_pq = 0.2f;
+    SidecarClipInfo clip;
+    clip.clip_guid = kTestGuid;
+    clip.start_frame = 86400;
+    clip.generator = "cph \"test\"";
+
+    SidecarWriter writer;
+    ASSERT_TRUE(writer.Open(path, params, clip));
+    ASSERT_TRUE(writer.WriteRecord(MakeShot(0, 48)));
+
+    // 记录写出后立即落盘
+    std::string partial = ReadFile(path);
+    ASSERT_TRUE(partial.find("\"timecode_inout\": \"01:00:00:00-01:00:01:23\"") != std::string::npos);
+
+    ASSERT_TRUE(writer.WriteRecord(MakeShot(48, 1)));
+    ASSERT_FALSE(writer.WriteRecord(MakeShot(49, 0)));
+    ASSERT_TRUE(writer.Close());
+    ASSERT_EQ(2u, writer.GetRecordCount());
+
+    std::string text = ReadFile(path);
+    std::remove(path.c_str());
+    ASSERT_TRUE(text.rfind("{\"segments\": [", 0) == 0);
+    ASSERT_TRUE(text.find("\n]}\n") == text.size() - 4);
+    ASSERT_TRUE(text.find("\"timecode_inout\": \"01:00:02:00-01:00:02:00\"") != std::string::npos);
+    ASSERT_TRUE(text.find("\"hash_clip_guid\": \"3f2a9c4e-1b7d-4e0a-9c55-7d2e8f10ab34\"") != std::string::npos);
+    ASSERT_TRUE(text.find("\"generator\": \"cph \\\"test\\\"\"") != std::string::npos);
+    ASSERT_TRUE(text.find("\"pivot\": 0.2,") != std::string::npos);
+    ASSERT_TRUE(text.find("\"gamma\": 1.2}") != std::string::npos);
+    ASSERT_EQ(std::count(text.begin(), text.end(), '{'), std::count(text.begin(), text.end(), '}'));
+    ASSERT_EQ(2, std::count(text.begin(), text.end(), '\n') - 2);
+
+    return true;
+}
+
+/**
+ * @brief 测试非法输入：无效UUID、未打开、空文档
+ */
+TEST(Sidecar_RejectsInvalidInput) {
+    const std::string path = "cph_test_sidecar_empty.json";
+    SidecarClipInfo clip;
+    clip.clip_guid = "not-a-guid";
+    SidecarWriter writer;
+    ASSERT_FALSE(writer.Open(path, CphParams(), clip));
+    ASSERT_FALSE(writer.GetLastError().empty());
+    ASSERT_FALSE(writer.WriteRecord(MakeShot(0, 10)));
+
+    clip.clip_guid = kTestGuid;
+    ASSERT_TRUE(writer.Open(path, CphParams(), clip));
+    ASSERT_TRUE(writer.Close());
+    ASSERT_FALSE(writer.Close());
+    std::string text = ReadFile(path);
+    std::remove(path.c_str());
+    ASSERT_TRUE(text == "{\"segments\": []}\n");
+
+    return true;
+}
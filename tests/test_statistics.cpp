@@ -1,5 +1,8 @@
 #include "test_framework.h"
 #include "cinema_pro_hdr/core.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 using namespace CinemaProHDR;
 
@@ -103,4 +106,72 @@ TEST(Statistics_LogicalConsistency) {
     ASSERT_TRUE(stats.IsValid());
     
     return true;
-}
\ No newline at end of file
+}
+TEST(StatisticsHistogram_MergeMatchesSinglePass) {
+    std::vector<float> r(1000), g(1000), b(1000);
+    for (size_t i = 0; i < r.size(); ++i) {
+        r[i] = static_cast<float>(i) / 1000.0f;
+        g[i] = 0.5f * r[i];
+        b[i] = 0.25f;
+    }
+    
+    StatisticsHistogram whole;
+    whole.AddPixels(r.data(), g.data(), b.data(), r.size());
+    
+    // 两个区域分别分箱后合并
+    StatisticsHistogram top, bottom;
+    top.AddPixels(r.data(), g.data(), b.data(), 400);
+    bottom.AddPixels(r.data() + 400, g.data() + 400, b.data() + 400, 600);
+    top.Merge(bottom);
+    ASSERT_EQ(whole.GetSampleCount(), top.GetSampleCount());
+    
+    Statistics::PQStats expected, merged;
+    ASSERT_TRUE(whole.Finalize(expected));
+    ASSERT_TRUE(top.Finalize(merged));
+    ASSERT_NEAR(expected.min_pq, merged.min_pq, 1e-6f);
+    ASSERT_NEAR(expected.avg_pq, merged.avg_pq, 1e-6f);
+    ASSERT_NEAR(expected.max_pq, merged.max_pq, 1e-6f);
+    ASSERT_NEAR(expected.variance, merged.variance, 1e-6f);
+    
+    return true;
+}
+
+TEST(StatisticsHistogram_SharedPassFillsAccumulator) {
+    std::vector<float> r(1000), g(1000), b(1000);
+    for (size_t i = 0; i < r.size(); ++i) {
+        r[i] = static_cast<float>(i) / 1000.0f;
+        g[i] = 0.5f * r[i];
+        b[i] = 0.25f;
+    }
+    r[7] = std::numeric_limits<float>::quiet_NaN();
+    
+    // 同一遍：直方图与精确样本都跳过非有限像素
+    StatisticsAccumulator shared;
+    StatisticsHistogram histogram;
+    histogram.AddPixels(r.data(), g.data(), b.data(), r.size(), &shared);
+    StatisticsAccumulator separate;
+    separate.AddPixels(r.data(), g.data(), b.data(), r.size());
+    ASSERT_EQ(separate.GetSampleCount(), shared.GetSampleCount());
+    ASSERT_EQ(uint64_t(999), histogram.GetSampleCount());
+    
+    Statistics::PQStats expected, actual;
+    ASSERT_TRUE(separate.Finalize(expected));
+    ASSERT_TRUE(shared.Finalize(actual));
+    ASSERT_EQ(expected.avg_pq, actual.avg_pq);
+    ASSERT_EQ(expected.variance, actual.variance);
+    
+    // 逐样本加入与按平面加入结果一致
+    StatisticsHistogram single;
+    for (size_t i = 0; i < r.size(); ++i) {
+        if (i != 7) {
+            single.Add(std::max(r[i], std::max(g[i], b[i])));
+        }
+    }
+    Statistics::PQStats planes_stats, single_stats;
+    ASSERT_TRUE(histogram.Finalize(planes_stats));
+    ASSERT_TRUE(single.Finalize(single_stats));
+    ASSERT_EQ(planes_stats.avg_pq, single_stats.avg_pq);
+    ASSERT_EQ(planes_stats.max_pq, single_stats.max_pq);
+    
+    return true;
+}